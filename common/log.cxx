@@ -7,6 +7,8 @@ using std::vsnprintf;
 //for va_list, va_start
 #include <stdarg.h>
 
+#include <chrono>
+
 #include <iostream>
 using std::ofstream;
 
@@ -33,13 +35,46 @@ string Log::output_directory = "./logs";
 
 map<thread::id, string> Log::log_ids;
 map<string, LogFile*> Log::output_files;
+set<string> Log::released_ids;
 
 shared_mutex Log::log_ids_mutex;
+atomic<int32_t> Log::file_generation(0);
+
+bool Log::async = false;
+int32_t Log::buffer_capacity = 4096;
+vector<LogBuffer*> Log::buffers;
+mutex Log::buffers_mutex;
+mutex Log::drain_mutex;
+thread* Log::drainer = NULL;
+atomic<bool> Log::drainer_running(false);
+mutex Log::drainer_wait_mutex;
+condition_variable Log::drainer_condition;
+
+/**
+ * Per thread state, cached so the common case of writing a message never has
+ * to look anything up in the shared maps.
+ */
+struct LogThreadState {
+    string human_readable_id;
+    bool has_id = false;
+    LogFile *log_file = NULL;
+    int32_t file_generation = -1;
+    LogBuffer *buffer = NULL;
+};
+
+static thread_local LogThreadState thread_state;
 
 LogFile::LogFile(FILE* _file) {
     file = _file;
 }
 
+LogBuffer::LogBuffer(int32_t capacity) : records(capacity), head(0), tail(0) {
+    for (int32_t i = 0; i < capacity; i++) {
+        records[i].to_std = false;
+        records[i].log_file = NULL;
+    }
+}
+
 void Log::register_command_line_arguments() {
     //CommandLine::create_group("Log", "");
     //CommandLine::
@@ -93,9 +128,17 @@ void Log::initialize(const vector<string> &arguments) {
 
     get_argument(arguments, "--max_header_length", false, max_header_length);
     get_argument(arguments, "--max_message_length", false, max_message_length);
+    get_argument(arguments, "--log_buffer_capacity", false, buffer_capacity);
 
 
     mkpath(output_directory.c_str(), 0777);
+
+    if (argument_exists(arguments, "--log_async") && drainer == NULL) {
+        async = true;
+        drainer_running = true;
+        drainer = new thread(drainer_loop);
+        atexit(stop_drainer);
+    }
 }
 
 void Log::set_rank(int32_t _process_rank) {
@@ -120,9 +163,15 @@ void Log::set_id(string human_readable_id) {
     log_ids[id] = human_readable_id;
 
     log_ids_mutex.unlock();
+
+    thread_state.human_readable_id = human_readable_id;
+    thread_state.has_id = true;
+    thread_state.log_file = NULL;
 }
 
 void Log::release_id(string human_readable_id) {
+    //make sure nothing is still queued up for this file before closing it
+    flush();
 
     //cerr << "locking thread from human readable id: '" << human_readable_id << "'" << endl;
     log_ids_mutex.lock();
@@ -141,219 +190,228 @@ void Log::release_id(string human_readable_id) {
 
         delete log_file;
         output_files.erase(human_readable_id);
+        released_ids.insert(human_readable_id);
+        file_generation++;
+    }
+
+    //forget the cached id, so a later message from this thread looks its id up again
+    if (thread_state.has_id && thread_state.human_readable_id == human_readable_id) {
+        thread_state.human_readable_id = "";
+        thread_state.has_id = false;
+        thread_state.log_file = NULL;
+        thread_state.file_generation = -1;
     }
 
     log_ids_mutex.unlock();
 }
 
 
+string Log::get_id() {
+    if (thread_state.has_id) return thread_state.human_readable_id;
+
+    string human_readable_id = "";
+    log_ids_mutex.lock_shared();
+    if (log_ids.count(std::this_thread::get_id()) > 0) human_readable_id = log_ids[std::this_thread::get_id()];
+    log_ids_mutex.unlock_shared();
+
+    return human_readable_id;
+}
+
+LogFile* Log::get_log_file(const string &human_readable_id) {
+    if (thread_state.log_file != NULL && thread_state.file_generation == file_generation) {
+        return thread_state.log_file;
+    }
+
+    //check and see if we've already opened a file for this human readable id, if we haven't
+    //open a new one for it
+    log_ids_mutex.lock();
+    LogFile* log_file = NULL;
+    if (output_files.count(human_readable_id) == 0) {
+        string output_filename = output_directory + "/" + human_readable_id;
+        FILE *outfile = fopen(output_filename.c_str(), released_ids.count(human_readable_id) > 0 ? "a" : "w");
+        log_file = new LogFile(outfile);
+        output_files[human_readable_id] = log_file;
+    } else {
+        log_file = output_files[human_readable_id];
+    }
+    thread_state.log_file = log_file;
+    thread_state.file_generation = file_generation;
+    log_ids_mutex.unlock();
+
+    return log_file;
+}
+
 void Log::write_message(bool print_header, int8_t message_level, const char *message_type, const char *format, va_list arguments) {
 
-    thread::id id = std::this_thread::get_id();
+    if (!thread_state.has_id) {
+        thread::id id = std::this_thread::get_id();
 
-    if (log_ids.count(id) == 0) {
-        cerr << "ERROR: could not write message from thread '" << id << "' because it did not have a human readable id assigned (please use the Log::set_id(string) function before writing to the Log on any thread)." << endl;
-        cerr << "message:" << endl;
-        vprintf(format, arguments);
-        cerr << endl;
-        exit(1);
+        log_ids_mutex.lock_shared();
+        bool found = log_ids.count(id) > 0;
+        if (found) thread_state.human_readable_id = log_ids[id];
+        log_ids_mutex.unlock_shared();
+
+        if (!found) {
+            cerr << "ERROR: could not write message from thread '" << id << "' because it did not have a human readable id assigned (please use the Log::set_id(string) function before writing to the Log on any thread)." << endl;
+            cerr << "message:" << endl;
+            vprintf(format, arguments);
+            cerr << endl;
+            exit(1);
+        }
+        thread_state.has_id = true;
     }
 
-    string human_readable_id = log_ids[id];
+    const string &human_readable_id = thread_state.human_readable_id;
 
     //print the message header into a string
     char header_buffer[max_header_length];
+    header_buffer[0] = '\0';
     //we only need to print the header for some messages
     if (print_header) {
         //snprintf(header_buffer, max_header_length, "[%-8s %-20s]", message_type, human_readable_id.c_str());
-        snprintf(header_buffer, max_header_length, "[%-7s %-21s]", message_type, human_readable_id.c_str());
+        snprintf(header_buffer, max_header_length, "[%-7s %-21s] ", message_type, human_readable_id.c_str());
     }
 
     //print the actual message contents into a string
     char message_buffer[max_message_length];
     vsnprintf(message_buffer, max_message_length, format, arguments);
 
-    if (std_message_level >= message_level) {
-        if (print_header) {
-            printf("%s %s", header_buffer, message_buffer);
-        } else {
-            printf("%s", message_buffer);
-        }
-    }
-
-    if (file_message_level >= message_level) {
-        LogFile* log_file = NULL;
+    bool to_std = std_message_level >= message_level;
+    LogFile* log_file = NULL;
+    if (file_message_level >= message_level) log_file = get_log_file(human_readable_id);
 
-        //check and see if we've already opened a file for this human readable id, if we haven't
-        //open a new one for it
+    emit(to_std, log_file, header_buffer, message_buffer);
 
-        if (output_files.count(human_readable_id) == 0) {
-            string output_filename = output_directory + "/" + human_readable_id;
-            FILE *outfile = fopen(output_filename.c_str(), "w");
-            log_file = new LogFile(outfile);
-            output_files[human_readable_id] = log_file;
-        } else {
-            log_file = output_files[human_readable_id];
-        }
+    //the program is about to exit, make sure the fatal message actually makes it out
+    if (message_level == FATAL) flush();
+}
 
-        //lock this log_file in case multiple threads are trying to write
-        //to the same file
-        log_file->file_mutex.lock();
-        if (print_header) {
-            fprintf(log_file->file, "%s %s", header_buffer, message_buffer);
-        } else {
-            fprintf(log_file->file, "%s", message_buffer);
+void Log::emit(bool to_std, LogFile *log_file, const char *header, const char *message) {
+    if (!async) {
+        if (to_std) printf("%s%s", header, message);
+
+        if (log_file != NULL) {
+            //lock this log_file in case multiple threads are trying to write
+            //to the same file
+            log_file->file_mutex.lock();
+            fprintf(log_file->file, "%s%s", header, message);
+            fflush(log_file->file);
+            log_file->file_mutex.unlock();
         }
-        fflush(log_file->file);
-        log_file->file_mutex.unlock();
+        return;
     }
-}
-
-bool Log::at_level(int8_t level) {
-    return level >= std_message_level || level >= file_message_level;
-}
-
-void Log::fatal(const char *format, ...) {
-    //don't write if this is the wrong process rank
-    if (restricted_rank >= 0 && restricted_rank != process_rank) return;
-
-    //not writing this type of message to either std out or a file
-    if (std_message_level < FATAL && file_message_level < FATAL) return;
-
-    va_list arguments;
-    va_start(arguments, format);
-    write_message(true, FATAL, "FATAL", format, arguments);
-}
 
-void Log::error(const char* format, ...) {
-    //don't write if this is the wrong process rank
-    if (restricted_rank >= 0 && restricted_rank != process_rank) return;
-
-    //not writing this type of message to either std out or a file
-    if (std_message_level < ERROR && file_message_level < ERROR) return;
-
-    va_list arguments;
-    va_start(arguments, format);
-    write_message(true, ERROR, "ERROR", format, arguments);
-}
-
-void Log::warning(const char* format, ...) {
-    //don't write if this is the wrong process rank
-    if (restricted_rank >= 0 && restricted_rank != process_rank) return;
-
-    //not writing this type of message to either std out or a file
-    if (std_message_level < WARNING && file_message_level < WARNING) return;
+    if (thread_state.buffer == NULL) {
+        thread_state.buffer = new LogBuffer(buffer_capacity);
+        buffers_mutex.lock();
+        buffers.push_back(thread_state.buffer);
+        buffers_mutex.unlock();
+    }
 
-    va_list arguments;
-    va_start(arguments, format);
-    write_message(true, WARNING, "WARNING", format, arguments);
-}
+    LogBuffer *buffer = thread_state.buffer;
+    uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    uint64_t capacity = buffer->records.size();
 
-void Log::info(const char* format, ...) {
-    //don't write if this is the wrong process rank
-    if (restricted_rank >= 0 && restricted_rank != process_rank) return;
+    //if the buffer is full, wake up the drainer and wait for it to make room
+    while (head - buffer->tail.load(std::memory_order_acquire) >= capacity) {
+        drainer_condition.notify_one();
+        std::this_thread::yield();
+    }
 
-    //not writing this type of message to either std out or a file
-    if (std_message_level < INFO && file_message_level < INFO) return;
+    LogRecord &record = buffer->records[head % capacity];
+    record.to_std = to_std;
+    record.log_file = log_file;
+    record.text.assign(header);
+    record.text.append(message);
 
-    va_list arguments;
-    va_start(arguments, format);
-    write_message(true, INFO, "INFO", format, arguments);
+    buffer->head.store(head + 1, std::memory_order_release);
 }
 
-void Log::debug(const char* format, ...) {
-    //don't write if this is the wrong process rank
-    if (restricted_rank >= 0 && restricted_rank != process_rank) return;
+void Log::drain_buffers() {
+    buffers_mutex.lock();
+    vector<LogBuffer*> current_buffers = buffers;
+    buffers_mutex.unlock();
 
-    //not writing this type of message to either std out or a file
-    if (std_message_level < DEBUG && file_message_level < DEBUG) return;
+    vector<LogFile*> written_files;
+    bool wrote_std = false;
 
-    va_list arguments;
-    va_start(arguments, format);
-    write_message(true, DEBUG, "DEBUG", format, arguments);
-}
+    for (int32_t i = 0; i < (int32_t)current_buffers.size(); i++) {
+        LogBuffer *buffer = current_buffers[i];
+        uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        uint64_t capacity = buffer->records.size();
 
-void Log::trace(const char* format, ...) {
-    //don't write if this is the wrong process rank
-    if (restricted_rank >= 0 && restricted_rank != process_rank) return;
+        for (; tail < head; tail++) {
+            LogRecord &record = buffer->records[tail % capacity];
 
-    //not writing this type of message to either std out or a file
-    if (std_message_level < TRACE && file_message_level < TRACE) return;
+            if (record.to_std) {
+                fwrite(record.text.c_str(), 1, record.text.size(), stdout);
+                wrote_std = true;
+            }
 
-    va_list arguments;
-    va_start(arguments, format);
-    write_message(true, TRACE, "TRACE", format, arguments);
-}
+            if (record.log_file != NULL) {
+                record.log_file->file_mutex.lock();
+                fwrite(record.text.c_str(), 1, record.text.size(), record.log_file->file);
+                record.log_file->file_mutex.unlock();
 
-void Log::fatal_no_header(const char *format, ...) {
-    //don't write if this is the wrong process rank
-    if (restricted_rank >= 0 && restricted_rank != process_rank) return;
+                if (written_files.size() == 0 || written_files.back() != record.log_file) written_files.push_back(record.log_file);
+            }
+        }
 
-    //not writing this type of message to either std out or a file
-    if (std_message_level < FATAL && file_message_level < FATAL) return;
+        buffer->tail.store(tail, std::memory_order_release);
+    }
 
-    va_list arguments;
-    va_start(arguments, format);
-    write_message(false, FATAL, "FATAL", format, arguments);
+    //only flush once per batch instead of once per message
+    if (wrote_std) fflush(stdout);
+    for (int32_t i = 0; i < (int32_t)written_files.size(); i++) {
+        written_files[i]->file_mutex.lock();
+        fflush(written_files[i]->file);
+        written_files[i]->file_mutex.unlock();
+    }
 }
 
-void Log::error_no_header(const char* format, ...) {
-    //don't write if this is the wrong process rank
-    if (restricted_rank >= 0 && restricted_rank != process_rank) return;
-
-    //not writing this type of message to either std out or a file
-    if (std_message_level < ERROR && file_message_level < ERROR) return;
+void Log::drainer_loop() {
+    while (drainer_running) {
+        {
+            std::unique_lock<mutex> wait_lock(drainer_wait_mutex);
+            drainer_condition.wait_for(wait_lock, std::chrono::milliseconds(10));
+        }
 
-    va_list arguments;
-    va_start(arguments, format);
-    write_message(false, ERROR, "ERROR", format, arguments);
+        drain_mutex.lock();
+        drain_buffers();
+        drain_mutex.unlock();
+    }
 }
 
-void Log::warning_no_header(const char* format, ...) {
-    //don't write if this is the wrong process rank
-    if (restricted_rank >= 0 && restricted_rank != process_rank) return;
-
-    //not writing this type of message to either std out or a file
-    if (std_message_level < WARNING && file_message_level < WARNING) return;
+void Log::flush() {
+    if (!async) return;
 
-    va_list arguments;
-    va_start(arguments, format);
-    write_message(false, WARNING, "WARNING", format, arguments);
+    drain_mutex.lock();
+    drain_buffers();
+    drain_mutex.unlock();
 }
 
-void Log::info_no_header(const char* format, ...) {
-    //don't write if this is the wrong process rank
-    if (restricted_rank >= 0 && restricted_rank != process_rank) return;
+void Log::stop_drainer() {
+    if (drainer == NULL) return;
 
-    //not writing this type of message to either std out or a file
-    if (std_message_level < INFO && file_message_level < INFO) return;
+    drainer_running = false;
+    drainer_condition.notify_one();
+    if (drainer->get_id() != std::this_thread::get_id()) drainer->join();
+    else drainer->detach();
+    delete drainer;
+    drainer = NULL;
 
-    va_list arguments;
-    va_start(arguments, format);
-    write_message(false, INFO, "INFO", format, arguments);
+    flush();
+    async = false;
 }
 
-void Log::debug_no_header(const char* format, ...) {
-    //don't write if this is the wrong process rank
-    if (restricted_rank >= 0 && restricted_rank != process_rank) return;
-
-    //not writing this type of message to either std out or a file
-    if (std_message_level < DEBUG && file_message_level < DEBUG) return;
-
-    va_list arguments;
-    va_start(arguments, format);
-    write_message(false, DEBUG, "DEBUG", format, arguments);
+bool Log::at_level(int8_t level) {
+    return level <= std_message_level || level <= file_message_level;
 }
 
-void Log::trace_no_header(const char* format, ...) {
-    //don't write if this is the wrong process rank
-    if (restricted_rank >= 0 && restricted_rank != process_rank) return;
-
-    //not writing this type of message to either std out or a file
-    if (std_message_level < TRACE && file_message_level < TRACE) return;
-
+void Log::log_message(bool print_header, int8_t message_level, const char *message_type, const char *format, ...) {
     va_list arguments;
     va_start(arguments, format);
-    write_message(false, TRACE, "TRACE", format, arguments);
+    write_message(print_header, message_level, message_type, format, arguments);
+    va_end(arguments);
 }
-
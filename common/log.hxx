@@ -1,6 +1,12 @@
 #ifndef EXONA_LOG
 #define EXONA_LOG
 
+#include <atomic>
+using std::atomic;
+
+#include <condition_variable>
+using std::condition_variable;
+
 #include <cstdio>  
 
 #include <iostream>
@@ -12,6 +18,9 @@ using std::map;
 #include <mutex>
 using std::mutex;
 
+#include <set>
+using std::set;
+
 #include <shared_mutex>
 using std::shared_mutex;
 
@@ -21,6 +30,19 @@ using std::string;
 #include <thread>
 using std::thread;
 
+#include <vector>
+using std::vector;
+
+/**
+ * Messages above this level are compiled out, so they are never formatted or
+ * written, e.g., build with -DEXAMM_LOG_MAX_LEVEL=4 to strip all debug and
+ * trace messages from the hot loops. The arguments of a stripped call are
+ * still evaluated at the call site, so they should not be expensive.
+ */
+#ifndef EXAMM_LOG_MAX_LEVEL
+#define EXAMM_LOG_MAX_LEVEL 7
+#endif
+
 class LogFile {
     private:
         FILE* file;
@@ -32,6 +54,32 @@ class LogFile {
     friend class Log;
 };
 
+/**
+ * A single formatted message waiting to be written by the drainer thread.
+ */
+struct LogRecord {
+    bool to_std;
+    LogFile *log_file;
+    string text;
+};
+
+/**
+ * A single producer, single consumer ring of log records. Each thread writing
+ * to the Log owns one of these; only that thread pushes and only the thread
+ * holding Log::drain_mutex pops, so the fast path needs no locks.
+ */
+class LogBuffer {
+    private:
+        vector<LogRecord> records;
+        atomic<uint64_t> head;
+        atomic<uint64_t> tail;
+
+    public:
+        LogBuffer(int32_t capacity);
+
+    friend class Log;
+};
+
 class Log {
     private:
         /**
@@ -92,12 +140,88 @@ class Log {
          */
         static map<string, LogFile*> output_files;
 
+        /**
+         * The human readable ids whose files have been closed by Log::release_id. If one of
+         * these is written to again its file is appended to instead of truncated.
+         */
+        static set<string> released_ids;
+
         /**
          * A std::shared_mutex protecting the Log::thread_ids map.
          * The Log::set_thread_id(int32_t) mehod needs write access so it will use the std::shared_mutex::lock()x and std::shared_mutex()::unlock() mechanism, while the Log::get_thread_id() only needs read access and can used the std::shared_mutex::lock_shared() and std::shared_mutex::unlock_shared() methods.
          */
         static shared_mutex log_ids_mutex;
 
+        /**
+         * Incremented every time a log file is released so threads know to
+         * drop their cached LogFile pointers.
+         */
+        static atomic<int32_t> file_generation;
+
+        /**
+         * Specifies if messages are handed off to a background drainer thread
+         * (set with --log_async) instead of being written by the calling thread.
+         */
+        static bool async;
+
+        /**
+         * The number of records in each per thread LogBuffer.
+         */
+        static int32_t buffer_capacity;
+
+        /**
+         * All LogBuffers ever created, guarded by Log::buffers_mutex (only
+         * taken when a thread writes its first message).
+         */
+        static vector<LogBuffer*> buffers;
+        static mutex buffers_mutex;
+
+        /**
+         * Only one thread can pop from the LogBuffers at a time.
+         */
+        static mutex drain_mutex;
+
+        static thread *drainer;
+        static atomic<bool> drainer_running;
+        static mutex drainer_wait_mutex;
+        static condition_variable drainer_condition;
+
+        /**
+         * \param level is the message level to check
+         *
+         * \return true if a message of this level would be written by this process
+         */
+        static inline bool should_write(int8_t level) {
+            if (restricted_rank >= 0 && restricted_rank != process_rank) return false;
+            return std_message_level >= level || file_message_level >= level;
+        }
+
+        /**
+         * Writes out all records currently in the LogBuffers. The caller must hold Log::drain_mutex.
+         */
+        static void drain_buffers();
+
+        /**
+         * The main loop of the background drainer thread.
+         */
+        static void drainer_loop();
+
+        /**
+         * Hands a formatted message off to either stdout/the log file directly or to
+         * this thread's LogBuffer.
+         */
+        static void emit(bool to_std, LogFile *log_file, const char *header, const char *message);
+
+        /**
+         * \return the LogFile for the calling thread's human readable id, opening it if needed
+         */
+        static LogFile* get_log_file(const string &human_readable_id);
+
+        /**
+         * Variadic entry point used by the public logging templates, which calls Log::write_message.
+         */
+        static void log_message(bool print_header, int8_t message_level, const char *message_type, const char *format, ...);
+
 
         /**
          * Potentially writes the message to either standard output or the log file if the message level is high enough.
@@ -186,6 +310,11 @@ class Log {
          */
         static void release_id(string human_readable_id);
 
+        /**
+         * \return the human readable id set for the calling thread with Log::set_id(string), or an empty string if none has been set
+         */
+        static string get_id();
+
 
         /**
          * Determines if either output level (the file or standard output) level
@@ -197,19 +326,43 @@ class Log {
          */
         static bool at_level(int8_t level);
 
-        static void fatal(const char* format, ...); /**< Logs a fatal message. varargs are the same as in printf. */
-        static void error(const char* format, ...); /**< Logs an error message. varargs are the same as in printf. */
-        static void warning(const char* format, ...); /**< Logs a warning message. varargs are the same as in printf. */
-        static void info(const char* format, ...); /**< Logs an info message. varargs are the same as in printf. */
-        static void debug(const char* format, ...); /**< Logs a debug message. varargs are the same as in printf. */
-        static void trace(const char* format, ...); /**< Logs a trace message. varargs are the same as in printf. */
-
-        static void fatal_no_header(const char* format, ...); /**< Logs a fatal message. Does not print the message header (useful if doing multiple log prints to the same line). varargs are the same as in printf. */
-        static void error_no_header(const char* format, ...); /**< Logs an error message. Does not print the message header (useful if doing multiple log prints to the same line).  varargs are the same as in printf. */
-        static void warning_no_header(const char* format, ...); /**< Logs a warning message. Does not print the message header (useful if doing multiple log prints to the same line).  varargs are the same as in printf. */
-        static void info_no_header(const char* format, ...); /**< Logs an info message. Does not print the message header (useful if doing multiple log prints to the same line).  varargs are the same as in printf. */
-        static void debug_no_header(const char* format, ...); /**< Logs a debug message. Does not print the message header (useful if doing multiple log prints to the same line).  varargs are the same as in printf. */
-        static void trace_no_header(const char* format, ...); /**< Logs a trace message. Does not print the message header (useful if doing multiple log prints to the same line).  varargs are the same as in printf. */
+        /**
+         * Blocks until every message logged so far has been written out. Does nothing
+         * if the Log is not running asynchronously.
+         */
+        static void flush();
+
+        /**
+         * Flushes any pending messages and stops the background drainer thread (if
+         * there is one). Later messages are written synchronously.
+         */
+        static void stop_drainer();
+
+        /**
+         * The logging methods are templates so that the level checks are inlined at
+         * the call site and messages above EXAMM_LOG_MAX_LEVEL compile away.
+         */
+        template <typename... Args> static void fatal(const char* format, Args... arguments) { log_at<FATAL>(true, "FATAL", format, arguments...); } /**< Logs a fatal message. varargs are the same as in printf. */
+        template <typename... Args> static void error(const char* format, Args... arguments) { log_at<ERROR>(true, "ERROR", format, arguments...); } /**< Logs an error message. varargs are the same as in printf. */
+        template <typename... Args> static void warning(const char* format, Args... arguments) { log_at<WARNING>(true, "WARNING", format, arguments...); } /**< Logs a warning message. varargs are the same as in printf. */
+        template <typename... Args> static void info(const char* format, Args... arguments) { log_at<INFO>(true, "INFO", format, arguments...); } /**< Logs an info message. varargs are the same as in printf. */
+        template <typename... Args> static void debug(const char* format, Args... arguments) { log_at<DEBUG>(true, "DEBUG", format, arguments...); } /**< Logs a debug message. varargs are the same as in printf. */
+        template <typename... Args> static void trace(const char* format, Args... arguments) { log_at<TRACE>(true, "TRACE", format, arguments...); } /**< Logs a trace message. varargs are the same as in printf. */
+
+        template <typename... Args> static void fatal_no_header(const char* format, Args... arguments) { log_at<FATAL>(false, "FATAL", format, arguments...); } /**< Logs a fatal message. Does not print the message header (useful if doing multiple log prints to the same line). varargs are the same as in printf. */
+        template <typename... Args> static void error_no_header(const char* format, Args... arguments) { log_at<ERROR>(false, "ERROR", format, arguments...); } /**< Logs an error message. Does not print the message header (useful if doing multiple log prints to the same line).  varargs are the same as in printf. */
+        template <typename... Args> static void warning_no_header(const char* format, Args... arguments) { log_at<WARNING>(false, "WARNING", format, arguments...); } /**< Logs a warning message. Does not print the message header (useful if doing multiple log prints to the same line).  varargs are the same as in printf. */
+        template <typename... Args> static void info_no_header(const char* format, Args... arguments) { log_at<INFO>(false, "INFO", format, arguments...); } /**< Logs an info message. Does not print the message header (useful if doing multiple log prints to the same line).  varargs are the same as in printf. */
+        template <typename... Args> static void debug_no_header(const char* format, Args... arguments) { log_at<DEBUG>(false, "DEBUG", format, arguments...); } /**< Logs a debug message. Does not print the message header (useful if doing multiple log prints to the same line).  varargs are the same as in printf. */
+        template <typename... Args> static void trace_no_header(const char* format, Args... arguments) { log_at<TRACE>(false, "TRACE", format, arguments...); } /**< Logs a trace message. Does not print the message header (useful if doing multiple log prints to the same line).  varargs are the same as in printf. */
+
+    private:
+        template <int8_t level, typename... Args>
+        static inline void log_at(bool print_header, const char *message_type, const char *format, Args... arguments) {
+            if constexpr (level <= EXAMM_LOG_MAX_LEVEL) {
+                if (should_write(level)) log_message(print_header, level, message_type, format, arguments...);
+            }
+        }
 
 };
 
@@ -0,0 +1,167 @@
+#include <cstdio>
+using std::fprintf;
+
+#include <limits>
+using std::numeric_limits;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include "common/arguments.hxx"
+#include "common/log.hxx"
+#include "common/performance_log.hxx"
+
+bool PerformanceLog::enabled = false;
+vector<PerformanceThreadStats*> PerformanceLog::thread_stats;
+mutex PerformanceLog::thread_stats_mutex;
+
+const char* PerformanceLog::CATEGORY_NAMES[] = {
+    "genome_generation",
+    "crossover",
+    "mutation_clone",
+    "mutation_add_edge",
+    "mutation_add_recurrent_edge",
+    "mutation_enable_edge",
+    "mutation_disable_edge",
+    "mutation_split_edge",
+    "mutation_add_node",
+    "mutation_enable_node",
+    "mutation_disable_node",
+    "mutation_split_node",
+    "mutation_merge_node",
+    "get_rnn",
+    "forward_pass",
+    "backward_pass",
+    "weight_update",
+    "validation",
+    "training",
+    "serialization",
+    "deserialization",
+    "mpi_wait",
+    "insertion"
+};
+
+static thread_local PerformanceThreadStats *current_thread_stats = NULL;
+
+PerformanceCategory::PerformanceCategory() : count(0), total_ns(0), min_ns(numeric_limits<int64_t>::max()), max_ns(0) {
+    for (int32_t i = 0; i < 64; i++) buckets[i] = 0;
+}
+
+void PerformanceCategory::record(int64_t nanoseconds) {
+    count++;
+    total_ns += nanoseconds;
+    if (nanoseconds < min_ns) min_ns = nanoseconds;
+    if (nanoseconds > max_ns) max_ns = nanoseconds;
+
+    //bucket i holds durations in [2^(i-1), 2^i)
+    int32_t bucket = nanoseconds <= 0 ? 0 : 64 - __builtin_clzll((uint64_t)nanoseconds);
+    if (bucket > 63) bucket = 63;
+    buckets[bucket]++;
+}
+
+void PerformanceCategory::merge(const PerformanceCategory &other) {
+    count += other.count;
+    total_ns += other.total_ns;
+    if (other.min_ns < min_ns) min_ns = other.min_ns;
+    if (other.max_ns > max_ns) max_ns = other.max_ns;
+    for (int32_t i = 0; i < 64; i++) buckets[i] += other.buckets[i];
+}
+
+int64_t PerformanceCategory::get_percentile(double fraction) const {
+    if (count == 0) return 0;
+
+    int64_t target = (int64_t)(fraction * count);
+    int64_t seen = 0;
+    for (int32_t i = 0; i < 64; i++) {
+        seen += buckets[i];
+        if (seen > target) {
+            int64_t upper = i == 0 ? 0 : ((int64_t)1 << i) - 1;
+            return upper < max_ns ? upper : max_ns;
+        }
+    }
+    return max_ns;
+}
+
+PerformanceThreadStats::PerformanceThreadStats(string _name) : name(_name), categories(PerformanceLog::NUMBER_CATEGORIES) {
+}
+
+void PerformanceLog::initialize(const vector<string> &arguments) {
+    enabled = argument_exists(arguments, "--performance_log");
+    if (enabled) Log::info("Recording performance timings, a summary will be written at the end of the run\n");
+}
+
+void PerformanceLog::set_enabled(bool _enabled) {
+    enabled = _enabled;
+}
+
+PerformanceThreadStats* PerformanceLog::get_thread_stats() {
+    if (current_thread_stats == NULL) {
+        string name = Log::get_id();
+
+        thread_stats_mutex.lock();
+        //named under the lock, so threads registering at the same time get different names
+        if (name == "") name = "thread_" + to_string(thread_stats.size());
+        current_thread_stats = new PerformanceThreadStats(name);
+        thread_stats.push_back(current_thread_stats);
+        thread_stats_mutex.unlock();
+    }
+    return current_thread_stats;
+}
+
+void PerformanceLog::set_thread_name(string name) {
+    get_thread_stats()->name = name;
+}
+
+void PerformanceLog::record(int32_t category, int64_t nanoseconds) {
+    get_thread_stats()->categories[category].record(nanoseconds);
+}
+
+static void write_category(FILE *file, const string &name, const char *category_name, const PerformanceCategory &category, int64_t count, int64_t total_ns, int64_t min_ns, int64_t max_ns) {
+    fprintf(file, "%s,%s,%ld,%.6lf,%.3lf,%.3lf,%.3lf,%.3lf,%.3lf,%.3lf\n",
+            name.c_str(),
+            category_name,
+            (long)count,
+            total_ns / 1.0e9,
+            (total_ns / (double)count) / 1000.0,
+            min_ns / 1000.0,
+            max_ns / 1000.0,
+            category.get_percentile(0.5) / 1000.0,
+            category.get_percentile(0.9) / 1000.0,
+            category.get_percentile(0.99) / 1000.0);
+}
+
+void PerformanceLog::write_summary(string filename) {
+    if (!enabled) return;
+
+    FILE *file = fopen(filename.c_str(), "w");
+    if (file == NULL) {
+        Log::error("could not open performance summary file '%s' for writing\n", filename.c_str());
+        return;
+    }
+
+    fprintf(file, "Thread,Category,Count,Total (s),Mean (us),Min (us),Max (us),P50 (us),P90 (us),P99 (us)\n");
+
+    thread_stats_mutex.lock();
+    vector<PerformanceCategory> totals(NUMBER_CATEGORIES);
+    for (int32_t i = 0; i < (int32_t)thread_stats.size(); i++) {
+        for (int32_t j = 0; j < NUMBER_CATEGORIES; j++) {
+            const PerformanceCategory &category = thread_stats[i]->categories[j];
+            if (category.count == 0) continue;
+
+            write_category(file, thread_stats[i]->name, CATEGORY_NAMES[j], category, category.count, category.total_ns, category.min_ns, category.max_ns);
+            totals[j].merge(category);
+        }
+    }
+    thread_stats_mutex.unlock();
+
+    for (int32_t j = 0; j < NUMBER_CATEGORIES; j++) {
+        if (totals[j].count == 0) continue;
+        write_category(file, "all", CATEGORY_NAMES[j], totals[j], totals[j].count, totals[j].total_ns, totals[j].min_ns, totals[j].max_ns);
+    }
+
+    fclose(file);
+    Log::info("wrote performance summary to '%s'\n", filename.c_str());
+}
@@ -0,0 +1,153 @@
+#ifndef EXAMM_PERFORMANCE_LOG_HXX
+#define EXAMM_PERFORMANCE_LOG_HXX
+
+#include <chrono>
+
+#include <mutex>
+using std::mutex;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+/**
+ * Timing statistics for a single category on a single thread. Durations are
+ * kept in nanoseconds, with a histogram of power of two buckets so percentiles
+ * can be estimated after merging.
+ */
+class PerformanceCategory {
+    private:
+        int64_t count;
+        int64_t total_ns;
+        int64_t min_ns;
+        int64_t max_ns;
+        int64_t buckets[64];
+
+    public:
+        PerformanceCategory();
+
+        void record(int64_t nanoseconds);
+        void merge(const PerformanceCategory &other);
+
+        /**
+         * \param fraction is the percentile to estimate (e.g., 0.9)
+         *
+         * \return the upper bound (in nanoseconds) of the histogram bucket containing that percentile
+         */
+        int64_t get_percentile(double fraction) const;
+
+    friend class PerformanceLog;
+};
+
+/**
+ * All the timing statistics recorded by a single thread.
+ */
+class PerformanceThreadStats {
+    private:
+        string name;
+        vector<PerformanceCategory> categories;
+
+    public:
+        PerformanceThreadStats(string name);
+
+    friend class PerformanceLog;
+};
+
+/**
+ * Collects counts and timings of the main phases of EXAMM (genome generation,
+ * mutation and crossover, training passes, MPI waits, etc.). Each thread records
+ * into its own PerformanceThreadStats so recording needs no locks; these are
+ * merged when the summary is written. Recording is disabled unless the
+ * --performance_log argument is given.
+ */
+class PerformanceLog {
+    private:
+        static bool enabled;
+
+        static vector<PerformanceThreadStats*> thread_stats;
+        static mutex thread_stats_mutex;
+
+        static PerformanceThreadStats* get_thread_stats();
+
+    public:
+        static const int32_t GENOME_GENERATION = 0;
+        static const int32_t CROSSOVER = 1;
+        static const int32_t MUTATION_CLONE = 2;
+        static const int32_t MUTATION_ADD_EDGE = 3;
+        static const int32_t MUTATION_ADD_RECURRENT_EDGE = 4;
+        static const int32_t MUTATION_ENABLE_EDGE = 5;
+        static const int32_t MUTATION_DISABLE_EDGE = 6;
+        static const int32_t MUTATION_SPLIT_EDGE = 7;
+        static const int32_t MUTATION_ADD_NODE = 8;
+        static const int32_t MUTATION_ENABLE_NODE = 9;
+        static const int32_t MUTATION_DISABLE_NODE = 10;
+        static const int32_t MUTATION_SPLIT_NODE = 11;
+        static const int32_t MUTATION_MERGE_NODE = 12;
+        static const int32_t GET_RNN = 13;
+        static const int32_t FORWARD_PASS = 14;
+        static const int32_t BACKWARD_PASS = 15;
+        static const int32_t WEIGHT_UPDATE = 16;
+        static const int32_t VALIDATION = 17;
+        static const int32_t TRAINING = 18;
+        static const int32_t SERIALIZATION = 19;
+        static const int32_t DESERIALIZATION = 20;
+        static const int32_t MPI_WAIT = 21;
+        static const int32_t INSERTION = 22;
+        static const int32_t NUMBER_CATEGORIES = 23;
+
+        static const char* CATEGORY_NAMES[];
+
+        /**
+         * Enables recording if --performance_log is in the arguments.
+         */
+        static void initialize(const vector<string> &arguments);
+
+        static inline bool is_enabled() {
+            return enabled;
+        }
+
+        static void set_enabled(bool _enabled);
+
+        /**
+         * Names the calling thread's statistics. If this is not called, the thread's
+         * Log id at the time of its first recording is used.
+         */
+        static void set_thread_name(string name);
+
+        static void record(int32_t category, int64_t nanoseconds);
+
+        /**
+         * Writes a CSV file with one row per thread and category, followed by the
+         * totals over all threads. Should only be called once the other threads
+         * have finished recording.
+         *
+         * \param filename is the file to write the summary to
+         */
+        static void write_summary(string filename);
+};
+
+/**
+ * Records the time between its construction and destruction to a PerformanceLog category.
+ */
+class ScopedTimer {
+    private:
+        int32_t category;
+        bool active;
+        std::chrono::time_point<std::chrono::steady_clock> start;
+
+    public:
+        inline ScopedTimer(int32_t _category) : category(_category), active(PerformanceLog::is_enabled()) {
+            if (active) start = std::chrono::steady_clock::now();
+        }
+
+        inline ~ScopedTimer() {
+            if (active) {
+                int64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+                PerformanceLog::record(category, nanoseconds);
+            }
+        }
+};
+
+#endif
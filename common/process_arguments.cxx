@@ -19,23 +19,43 @@ EXAMM* generate_examm_from_arguments(const vector<string> &arguments, TimeSeries
     get_argument(arguments, "--output_directory", false, output_directory);
     vector<string> possible_node_types;
     get_argument_vector(arguments, "--possible_node_types", false, possible_node_types);
+    int32_t innovation_number_offset = 0;
+    get_argument(arguments, "--innovation_number_offset", false, innovation_number_offset);
     double learning_rate = 0.0069;
 
     Log::info("Setting up examm with %d islands, island size %d, and max_genome %d\n", number_islands, island_size, max_genomes);
 
-    // random_sequence_length = argument_exists(arguments, "--random_sequence_length");
-    // get_argument(arguments, "--sequence_length_lower_bound", false, sequence_length_lower_bound);
-    // get_argument(arguments, "--sequence_length_upper_bound", false, sequence_length_upper_bound);
-
     GenomeProperty *genome_property = new GenomeProperty();
     genome_property->generate_genome_property_from_arguments(arguments);
     genome_property->get_time_series_parameters(time_series_sets);
 
     SpeciationStrategy *speciation_strategy = generate_speciation_strategy_from_arguments(arguments, seed_genome);
 
-    EXAMM* examm = new EXAMM(island_size, number_islands, max_genomes, learning_rate, speciation_strategy, weight_rules, genome_property, output_directory);
+    EXAMM* examm = new EXAMM(island_size, number_islands, max_genomes, learning_rate, speciation_strategy, weight_rules, genome_property, output_directory, innovation_number_offset);
     if (possible_node_types.size() > 0)  examm->set_possible_node_types(possible_node_types);
 
+    string shared_weights = "none";
+    get_argument(arguments, "--shared_weights", false, shared_weights);
+    if (shared_weights.compare("none") != 0) {
+        Log::info("Sharing weights across the population with the '%s' policy\n", shared_weights.c_str());
+        examm->set_shared_weight_store(new SharedWeightStore(SharedWeightStore::get_policy_from_string(shared_weights)));
+    }
+
+    if (argument_exists(arguments, "--surrogate_filter")) {
+        double surrogate_exploration_rate = 0.1;
+        get_argument(arguments, "--surrogate_exploration_rate", false, surrogate_exploration_rate);
+        int32_t surrogate_candidates = 10;
+        get_argument(arguments, "--surrogate_candidates", false, surrogate_candidates);
+        Log::info("Filtering generated genomes with a fitness surrogate, exploration rate: %lf, candidates per genome: %d\n", surrogate_exploration_rate, surrogate_candidates);
+        examm->set_fitness_model(new GenomeFitnessModel(1.0e-3), surrogate_exploration_rate, surrogate_candidates);
+    }
+
+    int32_t low_fidelity_bp_iterations = 0;
+    if (get_argument(arguments, "--low_fidelity_bp_iterations", false, low_fidelity_bp_iterations) && low_fidelity_bp_iterations > 0) {
+        Log::info("Genomes are first trained at low fidelity for %d epochs\n", low_fidelity_bp_iterations);
+        examm->set_low_fidelity(low_fidelity_bp_iterations);
+    }
+
     return examm;
 }
 
@@ -115,9 +135,11 @@ NeatSpeciationStrategy* generate_neat_speciation_strategy_from_arguments(const v
     get_argument(arguments, "--neat_c2", false, neat_c2);
     double neat_c3 = 1;
     get_argument(arguments, "--neat_c3", false, neat_c3);
+    int32_t neat_minhash_size = 0;
+    get_argument(arguments, "--neat_minhash_size", false, neat_minhash_size);
     double mutation_rate = 0.70, intra_island_co_rate = 0.20, inter_island_co_rate = 0.10;
 
-    NeatSpeciationStrategy *neat_strategy = new NeatSpeciationStrategy(mutation_rate, intra_island_co_rate, inter_island_co_rate, seed_genome, species_threshold, fitness_threshold, neat_c1, neat_c2, neat_c3);
+    NeatSpeciationStrategy *neat_strategy = new NeatSpeciationStrategy(mutation_rate, intra_island_co_rate, inter_island_co_rate, seed_genome, species_threshold, fitness_threshold, neat_c1, neat_c2, neat_c3, neat_minhash_size);
     return neat_strategy;
 }
 
@@ -139,57 +161,62 @@ void write_time_series_to_file(const vector<string> &arguments, TimeSeriesSets *
     }
 }
 
-void get_train_validation_data(const vector<string> &arguments, TimeSeriesSets *time_series_sets, vector< vector< vector<double> > > &train_inputs, vector< vector< vector<double> > > &train_outputs, vector< vector< vector<double> > > &validation_inputs, vector< vector< vector<double> > > &validation_outputs) {
+void get_train_validation_data(const vector<string> &arguments, TimeSeriesSets *time_series_sets, vector<SeriesTensor> &train_inputs, vector<SeriesTensor> &train_outputs, vector<SeriesTensor> &validation_inputs, vector<SeriesTensor> &validation_outputs) {
     int32_t time_offset = 1;
     get_argument(arguments, "--time_offset", true, time_offset);
 
     time_series_sets->export_training_series(time_offset, train_inputs, train_outputs);
     time_series_sets->export_test_series(time_offset, validation_inputs, validation_outputs);
 
+    //random sequence windows are drawn from the whole series during training
+    //(see SequenceWindows), so the series are not sliced up front
     int32_t sequence_length = 0;
-    if (get_argument(arguments, "--sequence_length", false, sequence_length)) {
+    if (argument_exists(arguments, "--random_sequence_length")) {
+        if (argument_exists(arguments, "--sequence_length")) Log::warning("--sequence_length is ignored when --random_sequence_length is used\n");
+    } else if (get_argument(arguments, "--sequence_length", false, sequence_length)) {
         Log::info("Slicing input training data with time sequence length: %d\n", sequence_length);
         slice_input_data(train_inputs, train_outputs, sequence_length); 
     }
     Log::info("Generating time series data finished! \n");
 }
 
-void slice_input_data(vector< vector< vector<double> > > &inputs, vector< vector< vector<double> > > &outputs, int32_t sequence_length) {
-    vector< vector< vector<double> > > sliced_inputs;
-    vector< vector< vector<double> > > sliced_outputs;
+void get_low_fidelity_data(const vector<string> &arguments, const vector<SeriesTensor> &train_inputs, const vector<SeriesTensor> &train_outputs, vector<SeriesTensor> &low_fidelity_inputs, vector<SeriesTensor> &low_fidelity_outputs) {
+    double series_fraction = 0.25;
+    get_argument(arguments, "--low_fidelity_series_fraction", false, series_fraction);
+
+    int32_t number_series = (int32_t)(series_fraction * train_inputs.size() + 0.5);
+    if (number_series < 1) number_series = 1;
+    if (number_series > (int32_t)train_inputs.size()) number_series = (int32_t)train_inputs.size();
+
+    //spread the series out over the training data rather than taking the first ones
+    low_fidelity_inputs.clear();
+    low_fidelity_outputs.clear();
+    for (int32_t i = 0; i < number_series; i++) {
+        int32_t series = (int32_t)(((int64_t)i * train_inputs.size()) / number_series);
+        low_fidelity_inputs.push_back(train_inputs[series]);
+        low_fidelity_outputs.push_back(train_outputs[series]);
+    }
+    Log::info("Low fidelity genomes are trained on %d of the %d training series\n", number_series, (int32_t)train_inputs.size());
+}
+
+void slice_input_data(vector<SeriesTensor> &inputs, vector<SeriesTensor> &outputs, int32_t sequence_length) {
+    vector<SeriesTensor> sliced_inputs;
+    vector<SeriesTensor> sliced_outputs;
     for (int32_t n = 0; n < (int32_t)inputs.size(); n++) {
-        int32_t num_row = (int32_t)inputs[n][0].size();
-        int32_t num_inputs = (int32_t)inputs[n].size();
-        int32_t num_outputs = (int32_t)outputs[n].size();
+        int32_t num_row = inputs[n].get_number_timesteps();
+        int32_t num_inputs = inputs[n].get_number_parameters();
         int32_t current_row = 0;
         while (current_row + sequence_length <= num_row) {
-            vector< vector<double> > current_time_series_input; // <each parameter <time series values>>
-            vector< vector<double> > current_time_series_output; // <each parameter <time series values>>
-            current_time_series_input = slice_time_series(current_row, sequence_length, num_inputs, inputs[n]);
-            current_time_series_output = slice_time_series(current_row, sequence_length, num_outputs, outputs[n]);
-            sliced_inputs.push_back(current_time_series_input);
-            sliced_outputs.push_back(current_time_series_output);
+            //the slices share the original series' storage, so nothing is copied
+            sliced_inputs.push_back(inputs[n].slice_time(current_row, sequence_length));
+            sliced_outputs.push_back(outputs[n].slice_time(current_row, sequence_length));
             current_row = current_row + sequence_length;
         }
         Log::info("Before slicing, original time series %d has %d parameters, and %d length\n", n, num_inputs, num_row);
     }
 
-    inputs.clear();
-    outputs.clear();
-    
-    inputs.assign(sliced_inputs.begin(), sliced_inputs.end()); 
-    outputs.assign(sliced_outputs.begin(), sliced_outputs.end());
-    Log::info("After slicing, sliced training input data has %d sets, and %d parameters and length %d \n", inputs.size(), inputs[0].size(), inputs[0][0].size());
-    Log::info("After slicing, sliced training output data has %d sets, and %d parameters and length %d \n", outputs.size(), outputs[0].size(), outputs[0][0].size());
+    inputs.swap(sliced_inputs);
+    outputs.swap(sliced_outputs);
+    Log::info("After slicing, sliced training input data has %d sets, and %d parameters and length %d \n", inputs.size(), inputs[0].get_number_parameters(), inputs[0].get_number_timesteps());
+    Log::info("After slicing, sliced training output data has %d sets, and %d parameters and length %d \n", outputs.size(), outputs[0].get_number_parameters(), outputs[0].get_number_timesteps());
 }
-
-vector< vector<double> > slice_time_series(int32_t start_index, int32_t sequence_length, int32_t num_parameter, const vector< vector<double> > &time_series) {
-    vector< vector <double> > current_time_series;
-    for (int32_t j = 0; j < num_parameter; j++) {
-        vector<double> current_parameter_slice;
-        current_parameter_slice.assign(time_series[j].begin() + start_index, time_series[j].begin()+ start_index + sequence_length);
-        current_time_series.push_back(current_parameter_slice);
-    }
-    return current_time_series;
-}
-
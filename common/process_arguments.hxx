@@ -15,6 +15,7 @@ using std::vector;
 #include "examm/island_speciation_strategy.hxx"
 #include "examm/neat_speciation_strategy.hxx"
 #include "examm/examm.hxx"
+#include "time_series/series_tensor.hxx"
 #include "time_series/time_series.hxx"
 #include "rnn/rnn_genome.hxx"
 
@@ -28,8 +29,19 @@ bool is_neat_strategy (string strategy_name);
 void set_island_transfer_learning_parameters(const vector<string> &arguments, IslandSpeciationStrategy *island_strategy);
 
 void write_time_series_to_file(const vector<string> &arguments, TimeSeriesSets *time_series_sets);
-void get_train_validation_data(const vector<string> &arguments, TimeSeriesSets *time_series_sets, vector< vector< vector<double> > > &traing_inputs, vector< vector< vector<double> > > &train_outputs, vector< vector< vector<double> > > &test_inputs, vector< vector< vector<double> > > &test_outputs);
-void slice_input_data(vector< vector< vector<double> > > &traing_inputs, vector< vector< vector<double> > > &train_outputs, int32_t sequence_length);
-vector< vector<double> > slice_time_series(int32_t start_index, int32_t sequence_length, int32_t num_parameter, const vector< vector<double> > &time_series);
+void get_train_validation_data(const vector<string> &arguments, TimeSeriesSets *time_series_sets, vector<SeriesTensor> &traing_inputs, vector<SeriesTensor> &train_outputs, vector<SeriesTensor> &test_inputs, vector<SeriesTensor> &test_outputs);
+
+/**
+ * Selects the training series low fidelity genomes are trained on (see
+ * EXAMM::set_low_fidelity): a --low_fidelity_series_fraction (0.25 by default) of them,
+ * spread evenly over the training data.
+ */
+void get_low_fidelity_data(const vector<string> &arguments, const vector<SeriesTensor> &train_inputs, const vector<SeriesTensor> &train_outputs, vector<SeriesTensor> &low_fidelity_inputs, vector<SeriesTensor> &low_fidelity_outputs);
+
+/**
+ * Replaces each series with its consecutive sequence_length long windows, which are
+ * views into the original series rather than copies.
+ */
+void slice_input_data(vector<SeriesTensor> &traing_inputs, vector<SeriesTensor> &train_outputs, int32_t sequence_length);
 
 #endif
\ No newline at end of file
@@ -3,6 +3,13 @@
 #include <limits>
 #include <cstdint>
 
+#include <atomic>
+using std::atomic;
+
+#include <chrono>
+
+#include <mutex>
+
 #include <iomanip>
 using std::setprecision;
 
@@ -13,11 +20,102 @@ using std::istream;
 #include <random>
 using std::minstd_rand0;
 
+#include <string>
+using std::string;
+
 #include <vector>
 using std::vector;
 
+#include "arguments.hxx"
+#include "log.hxx"
 #include "random.hxx"
 
+static atomic<bool> random_seed_set(false);
+static uint64_t random_seed = 0;
+static atomic<uint64_t> random_seed_counter(0);
+
+void set_random_seed(uint64_t seed) {
+    random_seed = seed;
+    random_seed_counter = 0;
+    random_seed_set = true;
+}
+
+bool initialize_random_seed(const vector<string> &arguments) {
+    uint64_t seed;
+    if (get_argument(arguments, "--random_seed", false, seed)) {
+        set_random_seed(seed);
+        Log::info("Random seed is set to %lu\n", seed);
+        return true;
+    }
+    return false;
+}
+
+uint64_t get_random_seed() {
+    static std::once_flag clock_seed_flag;
+    if (!random_seed_set) {
+        std::call_once(clock_seed_flag, []() {
+            if (!random_seed_set) set_random_seed(std::chrono::system_clock::now().time_since_epoch().count());
+        });
+    }
+    return random_seed;
+}
+
+uint64_t get_random_stream_key(int64_t generation_id, int32_t purpose) {
+    uint32_t counter[4] = { (uint32_t)generation_id, (uint32_t)((uint64_t)generation_id >> 32), (uint32_t)purpose, 0x45584d4d };
+    philox_4x32(counter, get_random_seed());
+    return ((uint64_t)counter[1] << 32) | counter[0];
+}
+
+void philox_4x32(uint32_t counter[4], uint64_t key) {
+    uint32_t key0 = (uint32_t)key;
+    uint32_t key1 = (uint32_t)(key >> 32);
+
+    for (int32_t round = 0; round < 10; round++) {
+        uint64_t product0 = (uint64_t)0xD2511F53 * counter[0];
+        uint64_t product1 = (uint64_t)0xCD9E8D57 * counter[2];
+
+        uint32_t c0 = (uint32_t)(product1 >> 32) ^ counter[1] ^ key0;
+        uint32_t c1 = (uint32_t)product1;
+        uint32_t c2 = (uint32_t)(product0 >> 32) ^ counter[3] ^ key1;
+        uint32_t c3 = (uint32_t)product0;
+
+        counter[0] = c0;
+        counter[1] = c1;
+        counter[2] = c2;
+        counter[3] = c3;
+
+        key0 += 0x9E3779B9;
+        key1 += 0xBB67AE85;
+    }
+}
+
+uint32_t counter_random_uint32(uint64_t key, uint64_t counter_high, uint64_t counter_low) {
+    uint32_t counter[4] = { (uint32_t)counter_low, (uint32_t)(counter_low >> 32), (uint32_t)counter_high, (uint32_t)(counter_high >> 32) };
+    philox_4x32(counter, key);
+    return counter[0];
+}
+
+double counter_random_0_1(uint64_t key, uint64_t counter_high, uint64_t counter_low) {
+    uint32_t counter[4] = { (uint32_t)counter_low, (uint32_t)(counter_low >> 32), (uint32_t)counter_high, (uint32_t)(counter_high >> 32) };
+    philox_4x32(counter, key);
+    //53 random bits for a full precision double
+    uint64_t bits = (((uint64_t)counter[0] << 32) | counter[1]) >> 11;
+    return bits * (1.0 / 9007199254740992.0);
+}
+
+uint32_t generate_random_seed() {
+    if (!random_seed_set) {
+        return (uint32_t)std::chrono::system_clock::now().time_since_epoch().count();
+    }
+
+    //splitmix64 so consecutive seeds give uncorrelated generators
+    uint64_t z = random_seed + (++random_seed_counter) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z = z ^ (z >> 31);
+    return (uint32_t)z;
+}
+
 float random_0_1(minstd_rand0 &generator) {
     return ((float)generator() - (float)generator.min()) / ((float)generator.max() - (float)generator.min());
 }
@@ -8,9 +8,69 @@ using std::istream;
 #include <random>
 using std::minstd_rand0;
 
+#include <string>
+using std::string;
+
 #include <vector>
 using std::vector;
 
+/**
+ * Sets the seed for the whole run. Once set, every call to generate_random_seed()
+ * returns a seed derived from it, so runs with the same seed (and the same order of
+ * generator creation) are reproducible.
+ */
+void set_random_seed(uint64_t seed);
+
+/**
+ * Sets the run seed from the --random_seed argument, if it was given.
+ *
+ * \return true if a seed was specified
+ */
+bool initialize_random_seed(const vector<string> &arguments);
+
+/**
+ * \return a seed for a new random number generator, derived from the run seed if one was set and from the system clock otherwise
+ */
+uint32_t generate_random_seed();
+
+/**
+ * \return the seed for this run: the one given with --random_seed, or one chosen from the system clock the first time it is needed
+ */
+uint64_t get_random_seed();
+
+/**
+ * Each use of randomness gets its own independent stream, keyed by the run seed, the
+ * generation id of the genome it belongs to and one of these purposes. Draws from a
+ * stream only depend on that key and a counter, never on which thread (or MPI rank)
+ * made them or in what order.
+ */
+#define RANDOM_PURPOSE_GENOME 0
+#define RANDOM_PURPOSE_TRAINING 1
+#define RANDOM_PURPOSE_DROPOUT 2
+#define RANDOM_PURPOSE_WINDOWS 3
+
+/**
+ * \return the key for the stream of random numbers used for the given purpose by the genome with the given generation id
+ */
+uint64_t get_random_stream_key(int64_t generation_id, int32_t purpose);
+
+/**
+ * The Philox4x32-10 counter based random number generator (Salmon et al., "Parallel random
+ * numbers: as easy as 1, 2, 3"). Maps a 128 bit counter and a 64 bit key to 128 random bits,
+ * which are written back into counter.
+ */
+void philox_4x32(uint32_t counter[4], uint64_t key);
+
+/**
+ * \return a uniformly distributed random number in [0, 1) for the given key and counter
+ */
+double counter_random_0_1(uint64_t key, uint64_t counter_high, uint64_t counter_low);
+
+/**
+ * \return 32 random bits for the given key and counter
+ */
+uint32_t counter_random_uint32(uint64_t key, uint64_t counter_high, uint64_t counter_low);
+
 void fisher_yates_shuffle(minstd_rand0 &generator, vector<int> &v);
 void fisher_yates_shuffle(minstd_rand0 &generator, vector<long> &v);
 
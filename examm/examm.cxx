@@ -1,7 +1,13 @@
 #include <algorithm>
+using std::min;
 using std::sort;
 
 #include <chrono>
+
+#include <cmath>
+using std::log10;
+using std::pow;
+
 #include <cstring>
 
 #include <functional>
@@ -44,11 +50,18 @@ using std::to_string;
 
 #include "common/files.hxx"
 #include "common/log.hxx"
+#include "common/random.hxx"
+#include "common/performance_log.hxx"
 
 
 EXAMM::~EXAMM() {
     delete weight_rules;
     delete genome_property;
+    delete shared_weight_store;
+    delete fitness_model;
+    for (int32_t i = 0; i < (int32_t)promoted_genomes.size(); i++) {
+        delete promoted_genomes[i];
+    }
 }
 
 EXAMM::EXAMM(
@@ -60,7 +73,8 @@ EXAMM::EXAMM(
         SpeciationStrategy *_speciation_strategy,
         WeightRules *_weight_rules,
         GenomeProperty *_genome_property,
-        string _output_directory) :
+        string _output_directory,
+        int32_t _innovation_number_offset) :
                         island_size(_island_size),
                         number_islands(_number_islands),
                         max_genomes(_max_genomes),
@@ -68,6 +82,17 @@ EXAMM::EXAMM(
                         speciation_strategy(_speciation_strategy),
                         weight_rules(_weight_rules),
                         genome_property(_genome_property),
+                        shared_weight_store(NULL),
+                        fitness_model(NULL),
+                        surrogate_exploration_rate(0.0),
+                        surrogate_candidates(1),
+                        surrogate_rejected(0),
+                        last_parent_fitness(EXAMM_MAX_DOUBLE),
+                        low_fidelity_bp_iterations(0),
+                        fidelity_log_ratio_sum(0.0),
+                        fidelity_ratio_samples(0),
+                        low_fidelity_promoted(0),
+                        low_fidelity_rejected(0),
                         output_directory(_output_directory) {
 
     total_bp_epochs = 0;
@@ -75,8 +100,7 @@ EXAMM::EXAMM(
     node_innovation_count = 0;
     generate_op_log = false;
 
-    int32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
-    generator = minstd_rand0(seed);
+    generator = minstd_rand0(generate_random_seed());
     rng_0_1 = uniform_real_distribution<double>(0.0, 1.0);
     rng_crossover_weight = uniform_real_distribution<double>(-0.5, 1.5);
 
@@ -84,6 +108,9 @@ EXAMM::EXAMM(
     set_evolution_hyper_parameters();
     initialize_seed_genome();
     //make sure we don't duplicate node or edge innovation numbers
+    //with other EXAMM instances this one exchanges genomes with
+    edge_innovation_count += _innovation_number_offset;
+    node_innovation_count += _innovation_number_offset;
 
     function<void (int32_t, RNN_Genome*)> mutate_function =
     [=](int32_t max_mutations, RNN_Genome *genome) {
@@ -265,6 +292,92 @@ void EXAMM::set_possible_node_types(vector<string> possible_node_type_strings) {
     }
 }
 
+void EXAMM::set_shared_weight_store(SharedWeightStore *_shared_weight_store) {
+    delete shared_weight_store;
+    shared_weight_store = _shared_weight_store;
+}
+
+void EXAMM::set_fitness_model(GenomeFitnessModel *_fitness_model, double _surrogate_exploration_rate, int32_t _surrogate_candidates) {
+    delete fitness_model;
+    fitness_model = _fitness_model;
+    surrogate_exploration_rate = _surrogate_exploration_rate;
+    surrogate_candidates = _surrogate_candidates;
+    if (surrogate_candidates < 1) surrogate_candidates = 1;
+}
+
+void EXAMM::set_low_fidelity(int32_t _low_fidelity_bp_iterations) {
+    low_fidelity_bp_iterations = _low_fidelity_bp_iterations;
+}
+
+//until this many genomes have been trained at both fidelities there is no projection, so
+//every low fidelity genome is promoted
+#define MIN_FIDELITY_RATIO_SAMPLES 5
+
+bool EXAMM::attempt_promotion(RNN_Genome *genome) {
+    double mse = genome->get_best_validation_mse();
+    double insert_threshold = get_insert_threshold(genome);
+
+    double projected_mse = EXAMM_MAX_DOUBLE;
+    if (mse > 0.0 && mse < EXAMM_MAX_DOUBLE) {
+        projected_mse = mse;
+        if (fidelity_ratio_samples > 0) projected_mse *= pow(10.0, fidelity_log_ratio_sum / fidelity_ratio_samples);
+    }
+
+    if (projected_mse >= EXAMM_MAX_DOUBLE || (fidelity_ratio_samples >= MIN_FIDELITY_RATIO_SAMPLES && projected_mse >= insert_threshold)) {
+        low_fidelity_rejected++;
+        Log::info("not promoting low fidelity genome %d, projected MSE: %lf, needed: %lf (%d promoted, %d rejected)\n", genome->get_generation_id(), projected_mse, insert_threshold, low_fidelity_promoted, low_fidelity_rejected);
+        return false;
+    }
+
+    //the caller deletes the genome, so queue a copy which continues from its trained weights
+    RNN_Genome *promoted = genome->copy();
+    promoted->set_fidelity(RNN_Genome::FULL_FIDELITY);
+    genome_property->set_genome_properties(promoted);
+    if ((int32_t)promoted->best_parameters.size() == promoted->get_number_weights()) {
+        promoted->initial_parameters = promoted->best_parameters;
+        promoted->set_weights(promoted->initial_parameters);
+    }
+    promoted->best_parameters.clear();
+    promoted->best_validation_mse = EXAMM_MAX_DOUBLE;
+    promoted->best_validation_mae = EXAMM_MAX_DOUBLE;
+
+    low_fidelity_mses[genome->get_generation_id()] = mse;
+    promoted_genomes.push_back(promoted);
+    low_fidelity_promoted++;
+    Log::info("promoting low fidelity genome %d to full fidelity, projected MSE: %lf, needed: %lf (%d promoted, %d rejected)\n", genome->get_generation_id(), projected_mse, insert_threshold, low_fidelity_promoted, low_fidelity_rejected);
+    return true;
+}
+
+double EXAMM::get_insert_threshold(RNN_Genome *genome) {
+    if (speciation_strategy->get_islands_size() == 0) {
+        double worst_fitness = speciation_strategy->get_worst_fitness();
+        return worst_fitness > 0.0 ? worst_fitness : EXAMM_MAX_DOUBLE;
+    }
+
+    Island *island = speciation_strategy->get_island_at_index(genome->get_group_id());
+    if (!island->is_full()) return EXAMM_MAX_DOUBLE;
+    return island->get_worst_fitness();
+}
+
+void EXAMM::update_fitness_model(RNN_Genome *genome, bool inserted) {
+    //genomes generated before the model was set (e.g., the initial population) have no features
+    auto features = surrogate_features.find(genome->get_generation_id());
+    if (features == surrogate_features.end()) return;
+
+    auto prediction = surrogate_predictions.find(genome->get_generation_id());
+    if (prediction != surrogate_predictions.end()) {
+        fitness_model->add_outcome(prediction->second.first, prediction->second.second, genome->get_best_validation_mse(), inserted);
+        surrogate_predictions.erase(prediction);
+
+        if (fitness_model->get_number_outcomes() % 100 == 0) {
+            Log::info("fitness surrogate: %s, %d generated genomes rejected without training\n", fitness_model->get_accuracy_string().c_str(), surrogate_rejected);
+        }
+    }
+
+    fitness_model->add_sample(features->second, genome->get_best_validation_mse());
+    surrogate_features.erase(features);
+}
+
 string EXAMM::get_output_directory() const {
     return output_directory;
 }
@@ -287,15 +400,38 @@ RNN_Genome* EXAMM::get_worst_genome() {
 
 //this will insert a COPY, original needs to be deleted
 bool EXAMM::insert_genome(RNN_Genome* genome) {
+    ScopedTimer timer(PerformanceLog::INSERTION);
     total_bp_epochs += genome->get_bp_iterations();
     if (!genome->sanity_check()) {
         Log::error("genome failed sanity check on insert!\n");
         exit(1);
     }
 
+    if (genome->get_fidelity() == RNN_Genome::LOW_FIDELITY) {
+        //a promoted genome keeps its generation id, so the fitness model learns from its
+        //full fidelity result; a rejected one never has one, so forget its features
+        if (!attempt_promotion(genome)) {
+            surrogate_features.erase(genome->get_generation_id());
+            surrogate_predictions.erase(genome->get_generation_id());
+        }
+        return false;
+    }
+
+    auto low_fidelity_mse = low_fidelity_mses.find(genome->get_generation_id());
+    if (low_fidelity_mse != low_fidelity_mses.end()) {
+        double mse = genome->get_best_validation_mse();
+        if (mse > 0.0 && mse < EXAMM_MAX_DOUBLE) {
+            fidelity_log_ratio_sum += log10(mse / low_fidelity_mse->second);
+            fidelity_ratio_samples++;
+        }
+        low_fidelity_mses.erase(low_fidelity_mse);
+    }
+
     //updates EXAMM's mapping of which genomes have been generated by what
     genome->update_generation_map(generated_from_map);
     int32_t insert_position = speciation_strategy->insert_genome(genome);
+    if (shared_weight_store != NULL && insert_position >= 0) genome->publish_shared_weights(shared_weight_store);
+    if (fitness_model != NULL) update_fitness_model(genome, insert_position >= 0);
     //write this genome to disk if it was a new best found genome
     if (insert_position == 0) {
         // genome->normalize_type = normalize_type;
@@ -308,6 +444,23 @@ bool EXAMM::insert_genome(RNN_Genome* genome) {
     return insert_position >= 0;
 }
 
+bool EXAMM::insert_migrated_genome(RNN_Genome* genome) {
+    ScopedTimer timer(PerformanceLog::INSERTION);
+    if (!genome->sanity_check()) {
+        Log::error("migrated genome failed sanity check on insert!\n");
+        exit(1);
+    }
+
+    int32_t insert_position = speciation_strategy->insert_migrated_genome(genome, rng_0_1, generator);
+    if (shared_weight_store != NULL && insert_position >= 0) genome->publish_shared_weights(shared_weight_store);
+    if (insert_position == 0) {
+        genome->write_graphviz(output_directory + "/rnn_genome_" + to_string(genome->get_generation_id()) + ".gv");
+        genome->write_to_file(output_directory + "/rnn_genome_" + to_string(genome->get_generation_id()) + ".bin");
+    }
+    update_log();
+    return insert_position >= 0;
+}
+
 //SHO SY
 void EXAMM::generate_initial_hyperparameters(double &learning_rate)
 {    
@@ -327,7 +480,10 @@ void EXAMM::generate_simplex_hyperparameters(double &learning_rate)
     // rng_0_1 = uniform_real_distribution<double>(0.0, 1.0);
 
     avg_learning_rate = 0;
-    
+
+    //the neat speciation strategy has no islands to sample genomes from,
+    //so keep the learning rate from generate_initial_hyperparameters
+    if (speciation_strategy->get_islands_size() == 0) return;
 
     double best_fitness = EXAMM_MAX_DOUBLE;
     //TODO maybe change simplex count
@@ -338,66 +494,66 @@ void EXAMM::generate_simplex_hyperparameters(double &learning_rate)
     {
         
         // RNN_Genome *current_genome = genomes[rng_0_1(generator) * genomes.size()];
-        Log::error("\n SY: Before current genome");
-        Log::error("\n SY: Island size 1: %d",speciation_strategy->get_islands_size());
+        Log::debug("\n SY: Before current genome");
+        Log::debug("\n SY: Island size 1: %d",speciation_strategy->get_islands_size());
         int32_t x_rnd = rng_0_1(generator) *  speciation_strategy->get_islands_size();
-        Log::error("\n SY: x_rnd = %d",x_rnd);
-        Log::error("\n SY: Island size 2: %d",speciation_strategy->get_island_at_index(x_rnd)->size());
+        Log::debug("\n SY: x_rnd = %d",x_rnd);
+        Log::debug("\n SY: Island size 2: %d",speciation_strategy->get_island_at_index(x_rnd)->size());
 
         if(speciation_strategy->get_island_at_index(x_rnd)->size() > 0) {
             int32_t y_rnd = rng_0_1(generator) * speciation_strategy->get_island_at_index(x_rnd)->size();
-        Log::error("\n SY: y_rnd = %d", y_rnd);
-        Log::error("\n SY: During current genome");
+        Log::debug("\n SY: y_rnd = %d", y_rnd);
+        Log::debug("\n SY: During current genome");
 
         
         RNN_Genome *current_genome = speciation_strategy->get_island_at_index(x_rnd)->get_genome_at(y_rnd);
-        Log::error("\n SY: After current genome");
-        Log::error("\n Best Fitness Before: %lf",best_fitness);
+        Log::debug("\n SY: After current genome");
+        Log::debug("\n Best Fitness Before: %lf",best_fitness);
 
         if( i == 0 || current_genome->get_best_validation_mse() < best_fitness)
         {
             
             best_fitness = current_genome->get_best_validation_mse();
-            Log::error("\n Best Fitness after: %lf",best_fitness);
-            Log::error("\n SY: Inside if statement after rnn genome");
+            Log::debug("\n Best Fitness after: %lf",best_fitness);
+            Log::debug("\n SY: Inside if statement after rnn genome");
             //best_learning_rate = current_genome->get_initial_learning_rate();
             best_learning_rate = current_genome->get_initial_learning_rate();
             
-            Log::error("\n SY:  Best learning rate: %lf",best_learning_rate);
+            Log::debug("\n SY:  Best learning rate: %lf",best_learning_rate);
             // best_learning_rate_delta = current_genome->get_best_learning_rate_delta();
             // best_dropout_probability = current_genome->get_best_dropout_probability();
         }
-        Log::error("\n SY:  Before Average learning rate");
+        Log::debug("\n SY:  Before Average learning rate");
         //avg_learning_rate += current_genome->get_initial_learning_rate();
         avg_learning_rate += current_genome->get_initial_learning_rate();
-        Log::error("\n SY: Avg Learning Rate: %lf",avg_learning_rate);
+        Log::debug("\n SY: Avg Learning Rate: %lf",avg_learning_rate);
         // avg_learning_rate_delta += current_genome->get_initial_learning_rate_delta();
         // avg_dropout_probability += current_genome->get_initial_dropout_probability();
-        Log::error("\n SY:  After Average learning rate");
+        Log::debug("\n SY:  After Average learning rate");
 
         }
         
     }
-    Log::error("\n SY: avg before division: %lf",avg_learning_rate);
+    Log::debug("\n SY: avg before division: %lf",avg_learning_rate);
     avg_learning_rate = avg_learning_rate /  simplex_count;
-    Log::error("\n SY: avg after division: %lf",avg_learning_rate);
+    Log::debug("\n SY: avg after division: %lf",avg_learning_rate);
     // avg_learning_rate_delta /= simplex_count;
     // avg_dropout_probability /= simplex_count;
 
     double scale = (rng_0_1(generator) * 2.0) - 0.5;
-    Log::error("\n SY: avg_learning_rate after adding avg and mul: %lf",avg_learning_rate);
-    Log::error("\n SY: best_learning_rate after adding avg and mul: %lf",best_learning_rate);
-    Log::error("\n SY: scale after adding avg and mul: %lf",scale);
+    Log::debug("\n SY: avg_learning_rate after adding avg and mul: %lf",avg_learning_rate);
+    Log::debug("\n SY: best_learning_rate after adding avg and mul: %lf",best_learning_rate);
+    Log::debug("\n SY: scale after adding avg and mul: %lf",scale);
     learning_rate = avg_learning_rate + ((best_learning_rate - avg_learning_rate) * scale);
 
-    Log::error("\n SY: learning rate after adding avg and mul: %lf",learning_rate);
+    Log::debug("\n SY: learning rate after adding avg and mul: %lf",learning_rate);
     
     // learning_rate_delta = avg_learning_rate_delta + ((best_learning_rate_delta - avg_learning_rate_delta) * scale);
     // dropout_probability = avg_dropout_probability + ((best_dropout_probability - avg_dropout_probability) * scale);
 
     if (learning_rate < learning_rate_min) learning_rate = learning_rate_min;
     if (learning_rate > learning_rate_max) learning_rate = learning_rate_max;
-    Log::error("\n SY: learning rate finally : %lf",learning_rate);
+    Log::debug("\n SY: learning rate finally : %lf",learning_rate);
     // if (learning_rate_delta < learning_rate_delta_min) learning_rate_delta = learning_rate_delta_min;
     // if (learning_rate_delta > learning_rate_delta_max) learning_rate_delta = learning_rate_delta_max;
     // if (dropout_probability < dropout_probability_min) dropout_probability = dropout_probability_min;
@@ -406,7 +562,16 @@ void EXAMM::generate_simplex_hyperparameters(double &learning_rate)
 }
 
 RNN_Genome* EXAMM::generate_genome() {
-    if (speciation_strategy->get_evaluated_genomes() > max_genomes) return NULL;
+    ScopedTimer timer(PerformanceLog::GENOME_GENERATION);
+    //rejected low fidelity genomes are never inserted, so they are counted here or they
+    //would not use up any of the budget
+    if (speciation_strategy->get_evaluated_genomes() + low_fidelity_rejected > max_genomes) return NULL;
+
+    if (promoted_genomes.size() > 0) {
+        RNN_Genome *genome = promoted_genomes.front();
+        promoted_genomes.pop_front();
+        return genome;
+    }
 
     function<void (int32_t, RNN_Genome*)> mutate_function =
         [=](int32_t max_mutations, RNN_Genome *genome) {
@@ -418,32 +583,78 @@ RNN_Genome* EXAMM::generate_genome() {
             return this->crossover(parent1, parent2);
         };
 
-    RNN_Genome *genome = speciation_strategy->generate_genome(rng_0_1, generator, mutate_function, crossover_function);
+    RNN_Genome *genome = NULL;
+    vector<double> features;
+    double predicted_mse = 0.0, insert_threshold = 0.0;
+
+    bool filter = fitness_model != NULL && fitness_model->is_calibrated() && rng_0_1(generator) >= surrogate_exploration_rate;
+    for (int32_t candidate = 0; ; candidate++) {
+        RNN_Genome *candidate_genome = speciation_strategy->generate_genome(rng_0_1, generator, mutate_function, crossover_function);
+        if (fitness_model == NULL) {
+            genome = candidate_genome;
+            break;
+        }
+
+        vector<double> candidate_features;
+        fitness_model->get_features(candidate_genome, last_parent_fitness, candidate_features);
+        double candidate_predicted_mse = fitness_model->predict(candidate_features);
+        double candidate_insert_threshold = get_insert_threshold(candidate_genome);
+
+        //keep whichever candidate is predicted to be best relative to what it needs
+        if (genome == NULL || candidate_predicted_mse / candidate_insert_threshold < predicted_mse / insert_threshold) {
+            delete genome;
+            genome = candidate_genome;
+            features = candidate_features;
+            predicted_mse = candidate_predicted_mse;
+            insert_threshold = candidate_insert_threshold;
+        } else {
+            delete candidate_genome;
+        }
+
+        if (!filter || predicted_mse < insert_threshold || candidate + 1 >= surrogate_candidates) break;
+        surrogate_rejected++;
+    }
+
+    if (fitness_model != NULL) {
+        surrogate_features[genome->get_generation_id()] = features;
+        if (fitness_model->is_calibrated()) surrogate_predictions[genome->get_generation_id()] = pair<double, double>(predicted_mse, insert_threshold);
+    }
 
     //SHO SY
     if(speciation_strategy->islands_full() != true) {
-        Log::error("SY: Island Not Full");
+        Log::debug("SY: Island Not Full");
         genome->set_learning_rate(learning_rate);
-        Log::error("SY:Island not full learning_rate %lf",genome->get_learning_rate());
+        Log::debug("SY:Island not full learning_rate %lf",genome->get_learning_rate());
     }
     else {
-        // Log::error("\n SY: initialising hyperparameters");
+        // Log::debug("\n SY: initialising hyperparameters");
         generate_initial_hyperparameters(learning_rate);
-        // Log::error("\n SY: simplex hyperparameters");
+        // Log::debug("\n SY: simplex hyperparameters");
         generate_simplex_hyperparameters(learning_rate);
-        // Log::error("\n SY: learning rate before updating genome: %lf",learning_rate);
+        // Log::debug("\n SY: learning rate before updating genome: %lf",learning_rate);
         //genome->learning_rate = learning_rate;
         genome->set_learning_rate(learning_rate);
-        Log::error("\n SY: learning rate after updating genome if island full: %lf",genome->get_learning_rate());
+        Log::debug("\n SY: learning rate after updating genome if island full: %lf",genome->get_learning_rate());
     }
 
-    Log::error("SY: Island is Full");
-    Log::error("SY:Island is full learning_rate %lf",genome->get_learning_rate());
+    Log::debug("SY: Island is Full");
+    Log::debug("SY:Island is full learning_rate %lf",genome->get_learning_rate());
 
     genome_property->set_genome_properties(genome);
     genome -> set_learning_rate(learning_rate);
     // if (!epigenetic_weights) genome->initialize_randomly();
 
+    if (shared_weight_store != NULL) {
+        int32_t number_shared = genome->initialize_from_shared_weights(shared_weight_store);
+        Log::debug("initialized %d components of genome %d from the shared weight store\n", number_shared, genome->get_generation_id());
+    }
+
+    //genomes for islands which are not full yet would all be promoted anyway
+    if (low_fidelity_bp_iterations > 0 && get_insert_threshold(genome) < EXAMM_MAX_DOUBLE) {
+        genome->set_fidelity(RNN_Genome::LOW_FIDELITY);
+        genome->set_bp_iterations(low_fidelity_bp_iterations);
+    }
+
     //this is just a sanity check, can most likely comment out (checking to see
     //if all the paramemters are sane)
     Log::debug("getting mu/sigma after random initialization of copy!\n");
@@ -467,6 +678,11 @@ void EXAMM::mutate(int32_t max_mutations, RNN_Genome *g) {
 
     //g->write_graphviz("rnn_genome_premutate_" + to_string(g->get_generation_id()) + ".gv");
 
+    last_parent_fitness = g->best_validation_mse;
+
+    //g will be the next genome generated, so its mutations come from that genome's stream
+    g->set_random_stream(speciation_strategy->get_generated_genomes() + 1);
+
     g->get_mu_sigma(g->best_parameters, mu, sigma);
     g->clear_generated_by();
     //the the weights in the genome to it's best parameters
@@ -495,6 +711,7 @@ void EXAMM::mutate(int32_t max_mutations, RNN_Genome *g) {
         Log::debug( "rng: %lf, total: %lf, new node type: %d (%s)\n", rng, total, new_node_type, node_type_str.c_str());
 
         if (rng < clone_rate) {
+            ScopedTimer timer(PerformanceLog::MUTATION_CLONE);
             Log::debug("\tcloned\n");
             g->set_generated_by("clone");
             modified = true;
@@ -502,6 +719,7 @@ void EXAMM::mutate(int32_t max_mutations, RNN_Genome *g) {
         }
         rng -= clone_rate;
         if (rng < add_edge_rate) {
+            ScopedTimer timer(PerformanceLog::MUTATION_ADD_EDGE);
             modified = g->add_edge(mu, sigma, edge_innovation_count);
             Log::debug("\tadding edge, modified: %d\n", modified);
             if (modified) g->set_generated_by("add_edge");
@@ -510,6 +728,7 @@ void EXAMM::mutate(int32_t max_mutations, RNN_Genome *g) {
         rng -= add_edge_rate;
 
         if (rng < add_recurrent_edge_rate) {
+            ScopedTimer timer(PerformanceLog::MUTATION_ADD_RECURRENT_EDGE);
             uniform_int_distribution<int32_t> dist = genome_property->get_recurrent_depth_dist();
             modified = g->add_recurrent_edge(mu, sigma, dist, edge_innovation_count);
             Log::debug("\tadding recurrent edge, modified: %d\n", modified);
@@ -519,6 +738,7 @@ void EXAMM::mutate(int32_t max_mutations, RNN_Genome *g) {
         rng -= add_recurrent_edge_rate;
 
         if (rng < enable_edge_rate) {
+            ScopedTimer timer(PerformanceLog::MUTATION_ENABLE_EDGE);
             modified = g->enable_edge();
             Log::debug("\tenabling edge, modified: %d\n", modified);
             if (modified) g->set_generated_by("enable_edge");
@@ -527,6 +747,7 @@ void EXAMM::mutate(int32_t max_mutations, RNN_Genome *g) {
         rng -= enable_edge_rate;
 
         if (rng < disable_edge_rate) {
+            ScopedTimer timer(PerformanceLog::MUTATION_DISABLE_EDGE);
             modified = g->disable_edge();
             Log::debug("\tdisabling edge, modified: %d\n", modified);
             if (modified) g->set_generated_by("disable_edge");
@@ -535,6 +756,7 @@ void EXAMM::mutate(int32_t max_mutations, RNN_Genome *g) {
         rng -= disable_edge_rate;
 
         if (rng < split_edge_rate) {
+            ScopedTimer timer(PerformanceLog::MUTATION_SPLIT_EDGE);
             uniform_int_distribution<int32_t> dist = genome_property->get_recurrent_depth_dist();
             modified = g->split_edge(mu, sigma, new_node_type, dist, edge_innovation_count, node_innovation_count);
             Log::debug("\tsplitting edge, modified: %d\n", modified);
@@ -544,6 +766,7 @@ void EXAMM::mutate(int32_t max_mutations, RNN_Genome *g) {
         rng -= split_edge_rate;
 
         if (rng < add_node_rate) {
+            ScopedTimer timer(PerformanceLog::MUTATION_ADD_NODE);
             uniform_int_distribution<int32_t> dist = genome_property->get_recurrent_depth_dist();
             modified = g->add_node(mu, sigma, new_node_type, dist, edge_innovation_count, node_innovation_count);
             Log::debug("\tadding node, modified: %d\n", modified);
@@ -553,6 +776,7 @@ void EXAMM::mutate(int32_t max_mutations, RNN_Genome *g) {
         rng -= add_node_rate;
 
         if (rng < enable_node_rate) {
+            ScopedTimer timer(PerformanceLog::MUTATION_ENABLE_NODE);
             modified = g->enable_node();
             Log::debug("\tenabling node, modified: %d\n", modified);
             if (modified) g->set_generated_by("enable_node");
@@ -561,6 +785,7 @@ void EXAMM::mutate(int32_t max_mutations, RNN_Genome *g) {
         rng -= enable_node_rate;
 
         if (rng < disable_node_rate) {
+            ScopedTimer timer(PerformanceLog::MUTATION_DISABLE_NODE);
             modified = g->disable_node();
             Log::debug("\tdisabling node, modified: %d\n", modified);
             if (modified) g->set_generated_by("disable_node");
@@ -569,6 +794,7 @@ void EXAMM::mutate(int32_t max_mutations, RNN_Genome *g) {
         rng -= disable_node_rate;
 
         if (rng < split_node_rate) {
+            ScopedTimer timer(PerformanceLog::MUTATION_SPLIT_NODE);
             uniform_int_distribution<int32_t> dist = genome_property->get_recurrent_depth_dist();
             modified = g->split_node(mu, sigma, new_node_type, dist, edge_innovation_count, node_innovation_count);
             Log::debug("\tsplitting node, modified: %d\n", modified);
@@ -578,6 +804,7 @@ void EXAMM::mutate(int32_t max_mutations, RNN_Genome *g) {
         rng -= split_node_rate;
 
         if (rng < merge_node_rate) {
+            ScopedTimer timer(PerformanceLog::MUTATION_MERGE_NODE);
             uniform_int_distribution<int32_t> dist = genome_property->get_recurrent_depth_dist();
             modified = g->merge_node(mu, sigma, new_node_type, dist, edge_innovation_count, node_innovation_count);
             Log::debug("\tmerging node, modified: %d\n", modified);
@@ -652,9 +879,9 @@ void EXAMM::attempt_edge_insert(vector<RNN_Edge*> &child_edges, vector<RNN_Node_
     double new_weight = 0.0;
     if (second_edge != NULL) {
         double crossover_value = rng_crossover_weight(generator);
-        new_weight = crossover_value * -(second_edge->weight - edge->weight) + edge->weight;
+        new_weight = crossover_value * -(second_edge->get_weight() - edge->get_weight()) + edge->get_weight();
 
-        Log::trace("EDGE WEIGHT CROSSOVER :: better: %lf, worse: %lf, crossover_value: %lf, new_weight: %lf\n", edge->weight, second_edge->weight, crossover_value, new_weight);
+        Log::trace("EDGE WEIGHT CROSSOVER :: better: %lf, worse: %lf, crossover_value: %lf, new_weight: %lf\n", edge->get_weight(), second_edge->get_weight(), crossover_value, new_weight);
 
         vector<double> input_weights1, input_weights2, output_weights1, output_weights2;
         edge->get_input_node()->get_weights(input_weights1);
@@ -680,7 +907,7 @@ void EXAMM::attempt_edge_insert(vector<RNN_Edge*> &child_edges, vector<RNN_Node_
         }
 
     } else {
-        new_weight = edge->weight;
+        new_weight = edge->get_weight();
         edge->get_input_node()->get_weights(new_input_weights);
         edge->get_output_node()->get_weights(new_output_weights);
     }
@@ -691,7 +918,7 @@ void EXAMM::attempt_edge_insert(vector<RNN_Edge*> &child_edges, vector<RNN_Node_
     RNN_Edge *edge_copy = edge->copy(child_nodes);
 
     edge_copy->enabled = set_enabled;
-    edge_copy->weight = new_weight;
+    edge_copy->set_weight(new_weight);
 
     //edges have already been copied
     child_edges.insert( upper_bound(child_edges.begin(), child_edges.end(), edge_copy, sort_RNN_Edges_by_depth()), edge_copy);
@@ -723,9 +950,9 @@ void EXAMM::attempt_recurrent_edge_insert(vector<RNN_Recurrent_Edge*> &child_rec
     double new_weight = 0.0;
     if (second_edge != NULL) {
         double crossover_value = rng_crossover_weight(generator);
-        new_weight = crossover_value * -(second_edge->weight - recurrent_edge->weight) + recurrent_edge->weight;
+        new_weight = crossover_value * -(second_edge->get_weight() - recurrent_edge->get_weight()) + recurrent_edge->get_weight();
 
-        Log::debug("RECURRENT EDGE WEIGHT CROSSOVER :: better: %lf, worse: %lf, crossover_value: %lf, new_weight: %lf\n", recurrent_edge->weight, second_edge->weight, crossover_value, new_weight);
+        Log::debug("RECURRENT EDGE WEIGHT CROSSOVER :: better: %lf, worse: %lf, crossover_value: %lf, new_weight: %lf\n", recurrent_edge->get_weight(), second_edge->get_weight(), crossover_value, new_weight);
 
         vector<double> input_weights1, input_weights2, output_weights1, output_weights2;
         recurrent_edge->get_input_node()->get_weights(input_weights1);
@@ -748,7 +975,7 @@ void EXAMM::attempt_recurrent_edge_insert(vector<RNN_Recurrent_Edge*> &child_rec
         }
 
     } else {
-        new_weight = recurrent_edge->weight;
+        new_weight = recurrent_edge->get_weight();
         recurrent_edge->get_input_node()->get_weights(new_input_weights);
         recurrent_edge->get_output_node()->get_weights(new_output_weights);
     }
@@ -759,7 +986,7 @@ void EXAMM::attempt_recurrent_edge_insert(vector<RNN_Recurrent_Edge*> &child_rec
     RNN_Recurrent_Edge *recurrent_edge_copy = recurrent_edge->copy(child_nodes);
 
     recurrent_edge_copy->enabled = set_enabled;
-    recurrent_edge_copy->weight = new_weight;
+    recurrent_edge_copy->set_weight(new_weight);
 
 
     //recurrent_edges have already been copied
@@ -768,7 +995,9 @@ void EXAMM::attempt_recurrent_edge_insert(vector<RNN_Recurrent_Edge*> &child_rec
 
 
 RNN_Genome* EXAMM::crossover(RNN_Genome *p1, RNN_Genome *p2) {
+    ScopedTimer timer(PerformanceLog::CROSSOVER);
     Log::debug("generating new genome by crossover!\n");
+    last_parent_fitness = min(p1->best_validation_mse, p2->best_validation_mse);
     Log::debug("p1->island: %d, p2->island: %d\n", p1->get_group_id(), p2->get_group_id());
     Log::debug("p1->number_inputs: %d, p2->number_inputs: %d\n", p1->get_number_inputs(), p2->get_number_inputs());
 
@@ -949,6 +1178,7 @@ RNN_Genome* EXAMM::crossover(RNN_Genome *p1, RNN_Genome *p2) {
     sort(child_recurrent_edges.begin(), child_recurrent_edges.end(), sort_RNN_Recurrent_Edges_by_depth());
 
     RNN_Genome *child = new RNN_Genome(child_nodes, child_edges, child_recurrent_edges, weight_rules);
+    child->set_random_stream(speciation_strategy->get_generated_genomes() + 1);
     genome_property->set_genome_properties(child);
     // child->set_parameter_names(input_parameter_names, output_parameter_names);
     // child->set_normalize_bounds(normalize_type, normalize_mins, normalize_maxs, normalize_avgs, normalize_std_devs);
@@ -972,6 +1202,10 @@ RNN_Genome* EXAMM::crossover(RNN_Genome *p1, RNN_Genome *p2) {
         child->initialize_randomly();
     }
 
+    if (weight_inheritance == WeightType::LAMARCKIAN && weight_rules->get_inherit_optimizer_state()) {
+        child->inherit_optimizer_state(p1, p2);
+    }
+
     child->get_weights(new_parameters);
     Log::debug("getting mu/sigma before assign reachability\n");
     child->get_mu_sigma(new_parameters, mu, sigma);
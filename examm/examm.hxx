@@ -1,6 +1,9 @@
 #ifndef EXAMM_HXX
 #define EXAMM_HXX
 
+#include <deque>
+using std::deque;
+
 #include <fstream>
 using std::ofstream;
 
@@ -14,11 +17,16 @@ using std::ostringstream;
 using std::string;
 using std::to_string;
 
+#include <utility>
+using std::pair;
+
 #include <vector>
 using std::vector;
 
 #include "rnn/rnn_genome.hxx"
+#include "genome_fitness_model.hxx"
 #include "speciation_strategy.hxx"
+#include "weights/shared_weight_store.hxx"
 #include "weights/weight_rules.hxx"
 #include "time_series/time_series.hxx"
 #include "rnn/genome_property.hxx"
@@ -34,6 +42,53 @@ class EXAMM {
         WeightRules *weight_rules;
         GenomeProperty *genome_property;
 
+        /**
+         * If not NULL, genomes which are inserted into the population publish their trained
+         * weights here, and new genomes start from them (see set_shared_weight_store).
+         */
+        SharedWeightStore *shared_weight_store;
+
+        /**
+         * If not NULL, a surrogate of genome fitness used to skip training generated genomes
+         * which are predicted to be too poor to be inserted (see set_fitness_model).
+         */
+        GenomeFitnessModel *fitness_model;
+        double surrogate_exploration_rate;
+        int32_t surrogate_candidates;
+        int32_t surrogate_rejected;
+
+        /**
+         * The features of each generated genome which has not been inserted yet, and (if the
+         * model was calibrated when it was generated) its predicted MSE and the MSE it needed
+         * to be inserted, by generation id.
+         */
+        map<int32_t, vector<double>> surrogate_features;
+        map<int32_t, pair<double, double>> surrogate_predictions;
+
+        /**
+         * The best validation MSE of the parent(s) of the genome most recently made by
+         * mutate or crossover.
+         */
+        double last_parent_fitness;
+
+        /**
+         * If > 0, genomes are first trained at low fidelity for this many epochs (see
+         * set_low_fidelity), and those which look good enough are promoted to a full
+         * fidelity run.
+         */
+        int32_t low_fidelity_bp_iterations;
+        deque<RNN_Genome*> promoted_genomes; /**< promoted genomes waiting to be returned by generate_genome */
+        map<int32_t, double> low_fidelity_mses; /**< the low fidelity MSE of each promoted genome, by generation id */
+
+        /**
+         * Full fidelity MSEs are projected from low fidelity ones by multiplying by
+         * 10^(fidelity_log_ratio_sum / fidelity_ratio_samples), learned from the genomes
+         * which were trained at both.
+         */
+        double fidelity_log_ratio_sum;
+        int32_t fidelity_ratio_samples;
+        int32_t low_fidelity_promoted;
+        int32_t low_fidelity_rejected;
 
         int32_t edge_innovation_count;
         int32_t node_innovation_count;
@@ -97,7 +152,8 @@ class EXAMM {
                 SpeciationStrategy *_speciation_strategy,
                 WeightRules *_weight_rules,
                 GenomeProperty *_genome_property,
-                string _output_directory);
+                string _output_directory,
+                int32_t _innovation_number_offset);
 
         ~EXAMM();
 
@@ -106,6 +162,50 @@ class EXAMM {
 
         void set_possible_node_types(vector<string> possible_node_type_strings);
 
+        /**
+         * Shares weights across the whole population: each genome inserted into the
+         * population (or migrated into it) publishes its best weights to the store, and
+         * each generated genome starts from the store's weights for every node, edge and
+         * recurrent edge the store has, rather than only what it inherited from its parents.
+         * EXAMM takes ownership of the store.
+         */
+        void set_shared_weight_store(SharedWeightStore *_shared_weight_store);
+
+        /**
+         * Filters generated genomes with a surrogate of their fitness. Once the model has
+         * been fit to enough trained genomes, generate_genome generates up to
+         * _surrogate_candidates genomes and returns the first one predicted to be good
+         * enough to be inserted into its island (or the one predicted to be closest),
+         * deleting the rest untrained. A fraction _surrogate_exploration_rate of genomes are
+         * not filtered, so the model keeps seeing the kinds of genomes it rejects. EXAMM
+         * takes ownership of the model.
+         */
+        void set_fitness_model(GenomeFitnessModel *_fitness_model, double _surrogate_exploration_rate, int32_t _surrogate_candidates);
+
+        /**
+         * \return the validation MSE a genome needs to be inserted into its island (or the
+         * population for NEAT), or EXAMM_MAX_DOUBLE if its island is not full
+         */
+        double get_insert_threshold(RNN_Genome *genome);
+        void update_fitness_model(RNN_Genome *genome, bool inserted);
+
+        /**
+         * Evaluates genomes in two stages. Genomes generated for full islands are marked
+         * as RNN_Genome::LOW_FIDELITY and trained for _low_fidelity_bp_iterations epochs
+         * (the drivers train them on a subset of the training series). When one is
+         * inserted, if its projected full fidelity MSE would get it into its island, a copy
+         * starting from its trained weights is queued to be returned by generate_genome at
+         * full fidelity, otherwise it is dropped. Low fidelity genomes are never inserted
+         * into the population themselves, but each dropped one counts as an evaluated
+         * genome towards max_genomes.
+         */
+        void set_low_fidelity(int32_t _low_fidelity_bp_iterations);
+
+        /**
+         * \return true if the low fidelity genome was promoted to a full fidelity run
+         */
+        bool attempt_promotion(RNN_Genome *genome);
+
         uniform_int_distribution<int32_t> get_recurrent_depth_dist();
 
         int32_t get_random_node_type();
@@ -113,6 +213,12 @@ class EXAMM {
         RNN_Genome* generate_genome();
         bool insert_genome(RNN_Genome* genome);
 
+        /**
+         * Inserts a copy of a genome migrated from another EXAMM instance, see
+         * SpeciationStrategy::insert_migrated_genome.
+         */
+        bool insert_migrated_genome(RNN_Genome* genome);
+
         void mutate(int32_t max_mutations, RNN_Genome *p1);
 
         void attempt_node_insert(vector<RNN_Node_Interface*> &child_nodes, const RNN_Node_Interface *node, const vector<double> &new_weights);
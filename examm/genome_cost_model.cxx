@@ -0,0 +1,49 @@
+#include <vector>
+using std::vector;
+
+#include "examm/genome_cost_model.hxx"
+#include "rnn/rnn_genome.hxx"
+#include "rnn/rnn_node_interface.hxx"
+
+//the features other than the per node type counts: a constant, the number of weights,
+//edges, recurrent edges and the sum of the recurrent edge depths
+#define NUMBER_STRUCTURE_FEATURES 5
+
+GenomeCostModel::GenomeCostModel(int64_t _training_timesteps, int64_t _low_fidelity_timesteps, double _regularization) : number_features(NUMBER_STRUCTURE_FEATURES + NUMBER_NODE_TYPES), training_timesteps(_training_timesteps), low_fidelity_timesteps(_low_fidelity_timesteps), regression(number_features, _regularization) {
+}
+
+void GenomeCostModel::get_features(RNN_Genome *genome, vector<double> &features) const {
+    //in millions of time steps trained, to keep the features and coefficients well scaled
+    int64_t genome_timesteps = genome->get_fidelity() == RNN_Genome::LOW_FIDELITY ? low_fidelity_timesteps : training_timesteps;
+    double timesteps = (double)genome->get_bp_iterations() * genome_timesteps / 1.0e6;
+    int32_t recurrent_edges = genome->get_enabled_recurrent_edge_count();
+
+    features.resize(number_features);
+    features[0] = 1.0;
+    features[1] = genome->get_number_weights() * timesteps;
+    features[2] = genome->get_enabled_edge_count() * timesteps;
+    features[3] = recurrent_edges * timesteps;
+    features[4] = (recurrent_edges > 0 ? genome->get_avg_recurrent_depth() * recurrent_edges : 0.0) * timesteps;
+    for (int32_t i = 0; i < NUMBER_NODE_TYPES; i++) {
+        features[NUMBER_STRUCTURE_FEATURES + i] = genome->get_enabled_node_count(i) * timesteps;
+    }
+}
+
+bool GenomeCostModel::is_calibrated() const {
+    return regression.get_number_samples() >= number_features;
+}
+
+double GenomeCostModel::predict(const vector<double> &features) const {
+    if (!is_calibrated()) return features[1];
+
+    double prediction = regression.predict(features);
+
+    //a poorly fit model could predict a negative time for small genomes
+    if (prediction < 1.0e-6) prediction = 1.0e-6;
+    return prediction;
+}
+
+void GenomeCostModel::add_sample(const vector<double> &features, double seconds) {
+    regression.add_sample(features, seconds);
+    if (is_calibrated()) regression.fit();
+}
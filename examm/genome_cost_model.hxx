@@ -0,0 +1,57 @@
+#ifndef EXAMM_GENOME_COST_MODEL_HXX
+#define EXAMM_GENOME_COST_MODEL_HXX
+
+#include <cstdint>
+
+#include <vector>
+using std::vector;
+
+#include "examm/ridge_regression.hxx"
+#include "rnn/rnn_genome.hxx"
+
+/**
+ * Predicts how long a genome will take to train from its structure: the number of
+ * weights, edges and recurrent edges, the sum of its recurrent edge depths and the
+ * number of hidden nodes of each type, each multiplied by the number of backpropagation
+ * iterations and the number of time steps the genome trains on (which is fewer for low
+ * fidelity genomes). The cost of each of these is learned with ridge
+ * regression from the measured training times of previous genomes.
+ */
+class GenomeCostModel {
+    private:
+        int32_t number_features;
+        int64_t training_timesteps;
+        int64_t low_fidelity_timesteps;
+
+        RidgeRegression regression;
+
+    public:
+        /**
+         * \param training_timesteps is the total number of time steps in the training data
+         * \param low_fidelity_timesteps is the total number of time steps in the subset of the
+         *      training data low fidelity genomes are trained on
+         * \param regularization is the ridge regression penalty, relative to the average squared feature value
+         */
+        GenomeCostModel(int64_t training_timesteps, int64_t low_fidelity_timesteps, double regularization);
+
+        void get_features(RNN_Genome *genome, vector<double> &features) const;
+
+        /**
+         * \return true once enough samples have been added for predictions to be in seconds
+         */
+        bool is_calibrated() const;
+
+        /**
+         * \return the predicted training time in seconds if the model is calibrated, otherwise
+         * the genome's number of weights times its training time steps (which is only useful
+         * for comparing genomes to each other)
+         */
+        double predict(const vector<double> &features) const;
+
+        /**
+         * Adds a measured training time and refits the model.
+         */
+        void add_sample(const vector<double> &features, double seconds);
+};
+
+#endif
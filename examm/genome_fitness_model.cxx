@@ -0,0 +1,111 @@
+#include <cmath>
+using std::fabs;
+using std::log10;
+using std::pow;
+
+#include <cstdio>
+
+#include <map>
+using std::map;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include "examm/genome_fitness_model.hxx"
+#include "rnn/rnn_genome.hxx"
+#include "rnn/rnn_node_interface.hxx"
+#include "rnn/rnn_recurrent_edge.hxx"
+
+//the operators EXAMM records in a genome's generated_by map (without the node type of
+//the node operators)
+static const string FITNESS_MODEL_OPERATORS[] = {
+    "clone", "add_edge", "add_recurrent_edge", "enable_edge", "disable_edge", "split_edge",
+    "add_node", "enable_node", "disable_node", "split_node", "merge_node",
+    "crossover", "island_crossover"
+};
+#define NUMBER_FITNESS_MODEL_OPERATORS 13
+
+//recurrent edges are counted in buckets of depth 1, 2-3, 4-7 and 8 or more
+#define NUMBER_DEPTH_BUCKETS 4
+
+//a constant, the number of enabled edges and recurrent edges, the parent's log10 MSE and
+//whether it had one
+#define NUMBER_OTHER_FEATURES 5
+
+GenomeFitnessModel::GenomeFitnessModel(double _regularization) : number_features(NUMBER_OTHER_FEATURES + NUMBER_NODE_TYPES + NUMBER_DEPTH_BUCKETS + NUMBER_FITNESS_MODEL_OPERATORS), regression(number_features, _regularization), number_outcomes(0), sum_absolute_error(0.0), correct_decisions(0) {
+}
+
+void GenomeFitnessModel::get_features(RNN_Genome *genome, double parent_fitness, vector<double> &features) const {
+    features.assign(number_features, 0.0);
+
+    //the edge counts are scaled down to be closer to the node counts
+    features[0] = 1.0;
+    features[1] = genome->get_enabled_edge_count() / 10.0;
+    features[2] = genome->get_enabled_recurrent_edge_count() / 10.0;
+    if (parent_fitness < EXAMM_MAX_DOUBLE) {
+        features[3] = log10(parent_fitness);
+        features[4] = 1.0;
+    }
+
+    int32_t current = NUMBER_OTHER_FEATURES;
+    for (int32_t i = 0; i < NUMBER_NODE_TYPES; i++) {
+        features[current++] = genome->get_enabled_node_count(i);
+    }
+
+    for (int32_t i = 0; i < (int32_t)genome->recurrent_edges.size(); i++) {
+        if (!genome->recurrent_edges[i]->is_enabled()) continue;
+
+        int32_t depth = genome->recurrent_edges[i]->get_recurrent_depth();
+        int32_t bucket = 0;
+        while (bucket < NUMBER_DEPTH_BUCKETS - 1 && depth >= (2 << bucket)) bucket++;
+        features[current + bucket] += 1.0;
+    }
+    current += NUMBER_DEPTH_BUCKETS;
+
+    const map<string, int32_t> *generated_by_map = genome->get_generated_by_map();
+    for (auto it = generated_by_map->begin(); it != generated_by_map->end(); it++) {
+        string op = it->first.substr(0, it->first.find('('));
+        for (int32_t i = 0; i < NUMBER_FITNESS_MODEL_OPERATORS; i++) {
+            if (op.compare(FITNESS_MODEL_OPERATORS[i]) == 0) features[current + i] += it->second;
+        }
+    }
+}
+
+bool GenomeFitnessModel::is_calibrated() const {
+    return regression.get_number_samples() >= number_features;
+}
+
+double GenomeFitnessModel::predict(const vector<double> &features) const {
+    return pow(10.0, regression.predict(features));
+}
+
+void GenomeFitnessModel::add_sample(const vector<double> &features, double mse) {
+    //genomes which failed to train (e.g., whose weights blew up) would skew the model
+    if (!(mse > 0.0) || mse >= EXAMM_MAX_DOUBLE) return;
+
+    regression.add_sample(features, log10(mse));
+    if (is_calibrated()) regression.fit();
+}
+
+void GenomeFitnessModel::add_outcome(double predicted_mse, double insert_threshold, double mse, bool inserted) {
+    if (!(mse > 0.0) || mse >= EXAMM_MAX_DOUBLE) return;
+
+    number_outcomes++;
+    sum_absolute_error += fabs(log10(predicted_mse) - log10(mse));
+    if ((predicted_mse < insert_threshold) == inserted) correct_decisions++;
+}
+
+int32_t GenomeFitnessModel::get_number_outcomes() const {
+    return number_outcomes;
+}
+
+string GenomeFitnessModel::get_accuracy_string() const {
+    if (number_outcomes == 0) return "no predictions checked yet";
+
+    char buffer[256];
+    snprintf(buffer, 256, "%d predictions, mean absolute error of log10 MSE: %lf, correct insert/reject decisions: %.2lf%%", number_outcomes, sum_absolute_error / number_outcomes, 100.0 * correct_decisions / number_outcomes);
+    return string(buffer);
+}
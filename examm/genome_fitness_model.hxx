@@ -0,0 +1,79 @@
+#ifndef EXAMM_GENOME_FITNESS_MODEL_HXX
+#define EXAMM_GENOME_FITNESS_MODEL_HXX
+
+#include <cstdint>
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include "examm/ridge_regression.hxx"
+#include "rnn/rnn_genome.hxx"
+
+/**
+ * A surrogate which predicts the (log10) validation MSE a genome will reach after training
+ * from what is known before it is trained: the number of enabled nodes of each type, its
+ * enabled edges and recurrent edges, a histogram of its recurrent edge depths, the
+ * operators which generated it and the fitness of its parent(s). It is learned with ridge
+ * regression from the genomes which have been trained so far, so EXAMM can skip training
+ * offspring which are predicted to be too poor to be inserted.
+ */
+class GenomeFitnessModel {
+    private:
+        int32_t number_features;
+        RidgeRegression regression;
+
+        int32_t number_outcomes;
+        double sum_absolute_error;
+        int32_t correct_decisions;
+
+    public:
+        /**
+         * \param regularization is the ridge regression penalty, relative to the average squared feature value
+         */
+        GenomeFitnessModel(double regularization);
+
+        /**
+         * \param parent_fitness is the best validation MSE of the genome's (more fit) parent,
+         *      or EXAMM_MAX_DOUBLE if it had no trained parent
+         */
+        void get_features(RNN_Genome *genome, double parent_fitness, vector<double> &features) const;
+
+        /**
+         * \return true once enough genomes have been added for the predictions to be used
+         */
+        bool is_calibrated() const;
+
+        /**
+         * \return the predicted validation MSE
+         */
+        double predict(const vector<double> &features) const;
+
+        /**
+         * Adds the validation MSE a genome reached after training and refits the model.
+         */
+        void add_sample(const vector<double> &features, double mse);
+
+        /**
+         * Tracks how accurate the model is.
+         *
+         * \param predicted_mse is what the model predicted before the genome was trained
+         * \param insert_threshold is the fitness the genome needed to be inserted, which
+         *      is what the predicted_mse was compared against to decide whether to train it
+         * \param mse is the genome's actual validation MSE after training
+         * \param inserted is true if the genome was inserted into the population
+         */
+        void add_outcome(double predicted_mse, double insert_threshold, double mse, bool inserted);
+
+        int32_t get_number_outcomes() const;
+
+        /**
+         * \return the mean absolute error of the log10 MSE predictions, and the percentage of
+         * genomes where predicted_mse < insert_threshold matched whether they were inserted
+         */
+        string get_accuracy_string() const;
+};
+
+#endif
@@ -184,6 +184,22 @@ int32_t IslandSpeciationStrategy::insert_genome(RNN_Genome* genome) {
     }
 }
 
+int32_t IslandSpeciationStrategy::insert_migrated_genome(RNN_Genome* genome, uniform_real_distribution<double> &rng_0_1, minstd_rand0 &generator) {
+    int32_t island = rng_0_1(generator) * number_of_islands;
+
+    generated_genomes++;
+    genome->set_generation_id(generated_genomes);
+    islands[island]->set_latest_generation_id(generated_genomes);
+    genome->set_group_id(island);
+
+    Log::info("Island %d: inserting migrated genome\n", island);
+    int32_t insert_position = insert_genome(genome);
+
+    //migrated genomes were evaluated by another EXAMM instance's workers
+    evaluated_genomes--;
+    return insert_position;
+}
+
 int32_t IslandSpeciationStrategy::get_worst_island_by_best_genome() {
     int32_t worst_island = -1;
     double worst_best_fitness = 0;
@@ -264,6 +280,7 @@ RNN_Genome* IslandSpeciationStrategy::generate_for_initializing_island(uniform_r
     if (current_island->size() == 0) {
         Log::info("Island %d: starting island with minimal genome\n", generation_island);
         new_genome = seed_genome->copy();
+        new_genome->set_random_stream(generated_genomes + 1);
         new_genome->initialize_randomly();
 
         bool stir_seed_genome = false;
@@ -143,6 +143,13 @@ class IslandSpeciationStrategy : public SpeciationStrategy {
          */
         int32_t insert_genome(RNN_Genome* genome);
 
+        /**
+         * Inserts a <b>copy</b> of a genome migrated from another EXAMM instance into a
+         * randomly selected island, the same way inter-island crossover selects the island
+         * it takes a parent from.
+         */
+        int32_t insert_migrated_genome(RNN_Genome* genome, uniform_real_distribution<double> &rng_0_1, minstd_rand0 &generator);
+
         /**
          * find the worst island in the population, the worst island's best genome is the worst among all the islands
          *
@@ -1,3 +1,8 @@
+#include <algorithm>
+using std::find;
+using std::max;
+using std::min;
+
 #include <functional>
 using std::function;
 
@@ -13,6 +18,9 @@ using std::uniform_real_distribution;
 #include <string>
 using std::string;
 
+#include <vector>
+using std::vector;
+
 #include <stdlib.h>
 
 #include "examm.hxx"
@@ -28,7 +36,7 @@ NeatSpeciationStrategy::NeatSpeciationStrategy(
                 double _mutation_rate, double _intra_island_crossover_rate,
                 double _inter_island_crossover_rate, RNN_Genome *_seed_genome,
                 double _species_threshold, double _fitness_threshold,
-                double _neat_c1, double _neat_c2, double _neat_c3) :
+                double _neat_c1, double _neat_c2, double _neat_c3, int32_t _minhash_size) :
                         generation_species(0),
                         species_count(0),
                         population_not_improving_count(0),
@@ -37,6 +45,7 @@ NeatSpeciationStrategy::NeatSpeciationStrategy(
                         neat_c1(_neat_c1),
                         neat_c2(_neat_c2),
                         neat_c3(_neat_c3),
+                        minhash_size(_minhash_size),
                         mutation_rate(_mutation_rate),
                         intra_island_crossover_rate(_intra_island_crossover_rate),
                         inter_island_crossover_rate(_inter_island_crossover_rate),
@@ -137,6 +146,7 @@ double NeatSpeciationStrategy::get_worst_fitness() {
 //returns 0 if a new global best, < 0 if not inserted, > 0 otherwise
 int32_t NeatSpeciationStrategy::insert_genome(RNN_Genome* genome) {
     bool inserted = false;
+    int32_t number_species = (int32_t)Neat_Species.size();
     bool erased_population = check_population();
     if (!erased_population) {
             check_species();
@@ -144,6 +154,9 @@ int32_t NeatSpeciationStrategy::insert_genome(RNN_Genome* genome) {
     else {
         population_not_improving_count = 0;
     }
+    //check_population ranks (reorders) the species before erasing them, which can leave the
+    //same number of species in a different order
+    if (erased_population || (int32_t)Neat_Species.size() != number_species) rebuild_species_index();
     vector<double> best = genome->get_best_parameters();
 
     if(best.size() != 0){
@@ -157,38 +170,17 @@ int32_t NeatSpeciationStrategy::insert_genome(RNN_Genome* genome) {
     if (Neat_Species.size() == 1 && Neat_Species[0]->size() == 0) {
         // insert the first genome in the evolution
         insert_position = Neat_Species[0]->insert_genome(genome);
+        index_species(Neat_Species[0]);
         Log::info("first genome of this species inserted \n");
         inserted = true;
     }
 
     if (!inserted) {
-        vector<int32_t> species_list = get_random_species_list();
-        for (int32_t i = 0; i < (int32_t)species_list.size(); i++){
-            Species* random_species = Neat_Species[species_list[i]];
-            if (random_species == NULL || random_species->size() == 0) {
-                Log::error("random_species is empty\n");
-                continue;
-            }
-
-            RNN_Genome* genome_representation = random_species->get_latested_genome();
-            if (genome_representation == NULL) {
-                Log::error("genome representation is null!\n");
-                break;
-            }
-
-            if (genome_representation == NULL){
-                Log::fatal("the latest genome is null, this should never happen!\n");
-            }
-            double distance = get_distance(genome_representation, genome);
-
-            // Log::error("distance is %f \n", distance);
-
-            if (distance < species_threshold) {
-                Log::info("inserting genome to species: %d\n", species_list[i]);
-                insert_position = random_species->insert_genome(genome);
-                inserted = true;
-                break;
-            }
+        Species *species = find_species(genome);
+        if (species != NULL) {
+            insert_position = species->insert_genome(genome);
+            index_species(species);
+            inserted = true;
         }
     }
 
@@ -201,6 +193,7 @@ int32_t NeatSpeciationStrategy::insert_genome(RNN_Genome* genome) {
             Log::error("num of species: %d, and species count is %d \n", Neat_Species.size(), species_count);
         }
         insert_position = new_species->insert_genome(genome);
+        index_species(new_species);
         inserted = true;
     }
 
@@ -232,9 +225,9 @@ RNN_Genome* NeatSpeciationStrategy::generate_genome(uniform_real_distribution<do
 
     Species *currentSpecies = Neat_Species[generation_species];
 
-    function<double (RNN_Genome*, RNN_Genome*)> distance_function =
-    [=](RNN_Genome *g1, RNN_Genome *g2) {
-        return this->get_distance(g1, g2);
+    function<double (const GenomeSignature&, const GenomeSignature&)> distance_function =
+    [this](const GenomeSignature &s1, const GenomeSignature &s2) {
+        return this->get_distance(s1, s2);
     };
 
     Log::info("generating new genome for species[%d], species_size: %d, mutation_rate: %lf, intra_island_crossover_rate: %lf, inter_island_crossover_rate: %lf\n", generation_species, currentSpecies->size(), mutation_rate, intra_island_crossover_rate, inter_island_crossover_rate);
@@ -265,7 +258,8 @@ RNN_Genome* NeatSpeciationStrategy::generate_genome(uniform_real_distribution<do
     } else {
         //first eliminate genomes who have low fitness sharing in this species
             if (currentSpecies->size() > 10){
-                currentSpecies->fitness_sharing_remove(fitness_threshold, distance_function);
+                currentSpecies->fitness_sharing_remove(fitness_threshold, minhash_size, distance_function);
+                index_species(currentSpecies);
             }
         //generate a genome via crossover or mutation
         Log::info("current species size %d, doing mutaion or crossover\n", currentSpecies->size());
@@ -415,56 +409,122 @@ vector<int32_t> NeatSpeciationStrategy::get_random_species_list() {
 }
 
 double NeatSpeciationStrategy::get_distance(RNN_Genome* g1, RNN_Genome* g2) {
+    return get_distance(g1->get_signature(minhash_size), g2->get_signature(minhash_size));
+}
 
-    double distance;
-    int32_t E;
-    int32_t D;
-    int32_t N;
+double NeatSpeciationStrategy::get_distance(const GenomeSignature &s1, const GenomeSignature &s2) {
     // d = c1*E/N + c2*D/N + c3*w
-    vector<int32_t> innovation1 = g1->get_innovation_list();
-    vector<int32_t> innovation2 = g2->get_innovation_list();
-    double weight1 = g1-> get_avg_edge_weight();
-    double weight2 = g2-> get_avg_edge_weight();
-    double w = abs(weight1 - weight2);
-    Log::debug("weight difference: %f \n", w);
-    if (innovation1.size() >= innovation2.size()){
-        N = innovation1.size();
+    const vector<int32_t> &innovation1 = s1.get_innovations();
+    const vector<int32_t> &innovation2 = s2.get_innovations();
+    double w = abs(s1.get_avg_edge_weight() - s2.get_avg_edge_weight());
 
-    } else {
-        N = innovation2.size();
-    }
-    if (innovation1.back() == innovation2.back()) {
-        E = 0;
-    } else if (innovation1.back() > innovation2.back()) {
-        E = get_exceed_number(innovation1, innovation2);
-    } else {
-        // innovation1.back() < innovation2.back()
-        E = get_exceed_number(innovation2, innovation1);
+    int32_t N = max(innovation1.size(), innovation2.size());
+    if (N == 0) return neat_c3 * w;
+
+    //only the genome with the larger maximum innovation number has excess genes
+    int32_t E = s1.get_excess(s2) + s2.get_excess(s1);
+
+    int32_t shared = s1.get_shared(s2);
+    int32_t D = innovation1.size() + innovation2.size() - 2 * shared - E;
+    //an overestimated number of shared genes (from the minhash sketches) can't make this negative
+    if (D < 0) D = 0;
+
+    return neat_c1 * E / N + neat_c2 * D / N + neat_c3 * w;
+}
+
+int32_t NeatSpeciationStrategy::insert_migrated_genome(RNN_Genome* genome, uniform_real_distribution<double> &rng_0_1, minstd_rand0 &generator) {
+    generated_genomes++;
+    genome->set_generation_id(generated_genomes);
+
+    Log::info("inserting migrated genome\n");
+    int32_t insert_position = insert_genome(genome);
+
+    //migrated genomes were evaluated by another EXAMM instance's workers
+    evaluated_genomes--;
+    return insert_position;
+}
+
+void NeatSpeciationStrategy::index_species(Species *species) {
+    //species are only ever added to the end of Neat_Species, and removing any rebuilds the index
+    if (species_positions.count(species) == 0) species_positions[species] = (int32_t)Neat_Species.size() - 1;
+
+    auto position = species_index_positions.find(species);
+    if (position != species_index_positions.end()) {
+        species_index.erase(position->second);
+        species_index_positions.erase(position);
     }
 
-    std::vector<int32_t> setunion;
-    std::vector<int32_t> intersec;
-    std::set_union(innovation1.begin(), innovation1.end(), innovation2.begin(), innovation2.end(), std::inserter(setunion, setunion.begin()));
-    std::set_intersection(innovation1.begin(), innovation1.end(), innovation2.begin(), innovation2.end(), std::inserter(intersec, intersec.begin()));
+    RNN_Genome *representative = species->get_latested_genome();
+    if (representative == NULL) return;
 
-    D = setunion.size() - intersec.size() - E;
-    distance = neat_c1 * E / N + neat_c2 * D / N + neat_c3 * w ;
-    Log::debug("distance is %f \n", distance);
-    return distance;
+    double avg_edge_weight = representative->get_signature(minhash_size).get_avg_edge_weight();
+    species_index_positions[species] = species_index.insert({avg_edge_weight, species});
+}
 
+void NeatSpeciationStrategy::rebuild_species_index() {
+    species_index.clear();
+    species_index_positions.clear();
+    species_positions.clear();
+    //the order is by position, so it's chosen again for the new positions
+    species_order.clear();
+    for (int32_t i = 0; i < (int32_t)Neat_Species.size(); i++) {
+        species_positions[Neat_Species[i]] = i;
+        index_species(Neat_Species[i]);
+    }
 }
-//v1.max > v2.max
-int32_t NeatSpeciationStrategy::get_exceed_number(vector<int32_t> v1, vector<int32_t> v2) {
-    int32_t exceed = 0;
-
-    for (auto it = v1.rbegin(); it != v1.rend(); ++it)  {
-        if(*it > v2.back()){
-            exceed++;
-        } else {
-            break;
+
+Species* NeatSpeciationStrategy::find_species(RNN_Genome *genome) {
+    const GenomeSignature &signature = genome->get_signature(minhash_size);
+    int32_t genome_size = (int32_t)signature.get_innovations().size();
+
+    //the species are checked in the same order as before the index was added, so the
+    //same species is chosen when the genome is within the threshold of more than one
+    if (species_order.size() != Neat_Species.size()) {
+        vector<int32_t> species_list = get_random_species_list();
+        species_order.resize(species_list.size());
+        for (int32_t i = 0; i < (int32_t)species_list.size(); i++) {
+            species_order[species_list[i]] = i;
+        }
+    }
+
+    //the bounds below are only used to skip species, so they're loosened slightly to
+    //make sure floating point error never skips a species the distance would accept
+    double bound_threshold = species_threshold * (1.0 + 1e-9);
+
+    auto first = species_index.begin();
+    auto last = species_index.end();
+    if (neat_c3 > 0) {
+        double max_weight_difference = bound_threshold / neat_c3;
+        first = species_index.lower_bound(signature.get_avg_edge_weight() - max_weight_difference);
+        last = species_index.upper_bound(signature.get_avg_edge_weight() + max_weight_difference);
+    }
+
+    Species *closest = NULL;
+    int32_t closest_order = (int32_t)species_order.size();
+    for (auto it = first; it != last; it++) {
+        Species *species = it->second;
+        int32_t order = species_order[species_positions[species]];
+        if (order >= closest_order) continue;
+
+        const GenomeSignature &representative = species->get_latested_genome()->get_signature(minhash_size);
+
+        //at least the difference in sizes of the two genomes' genes are either excess or disjoint
+        int32_t representative_size = (int32_t)representative.get_innovations().size();
+        int32_t larger_size = max(genome_size, representative_size);
+        if (larger_size > 0) {
+            double lower_bound = min(neat_c1, neat_c2) * abs(genome_size - representative_size) / larger_size
+                + neat_c3 * abs(signature.get_avg_edge_weight() - representative.get_avg_edge_weight());
+            if (lower_bound >= bound_threshold) continue;
+        }
+
+        if (get_distance(representative, signature) < species_threshold) {
+            closest = species;
+            closest_order = order;
         }
     }
-    return exceed;
+
+    if (closest != NULL) Log::info("inserting genome to species: %d\n", species_positions[closest]);
+    return closest;
 }
 
 void NeatSpeciationStrategy::rank_species() {
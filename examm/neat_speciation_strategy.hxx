@@ -4,6 +4,10 @@
 #include <functional>
 using std::function;
 
+#include <map>
+using std::map;
+using std::multimap;
+
 #include <string>
 using std::string;
 
@@ -25,6 +29,7 @@ class NeatSpeciationStrategy : public SpeciationStrategy {
         double neat_c1;
         double neat_c2;
         double neat_c3;
+        int32_t minhash_size; /**< The size of the MinHash sketches used to estimate the distance between genomes, or 0 to calculate it exactly. */
         double mutation_rate; /**< How frequently to do mutations. Note that mutation_rate + intra_island_crossover_rate + inter_island_crossover_rate should equal 1, if not they will be scaled down such that they do. */
         double intra_island_crossover_rate; /**< How frequently to do intra-island crossovers. Note that mutation_rate + intra_island_crossover_rate + inter_island_crossover_rate should equal 1, if not they will be scaled down such that they do. */
         double inter_island_crossover_rate; /**< How frequently to do inter-island crossovers. Note that mutation_rate + intra_island_crossover_rate + inter_island_crossover_rate should equal 1, if not they will be scaled down such that they do. */
@@ -36,12 +41,45 @@ class NeatSpeciationStrategy : public SpeciationStrategy {
 
         vector<Species*> Neat_Species;
         RNN_Genome* global_best_genome;
+
+        /**
+         * The species with a representative genome, keyed by their representative's average
+         * edge weight. As the distance between two genomes is at least neat_c3 times the
+         * difference of their average edge weights, only species within species_threshold / neat_c3
+         * of a genome need to have their distance to it calculated.
+         */
+        multimap<double, Species*> species_index;
+        map<Species*, multimap<double, Species*>::iterator> species_index_positions;
+
+        /**
+         * The position of each species in Neat_Species, and the rank of each position in the
+         * order given by get_random_species_list. That order only depends on the number of
+         * species, so it is only recalculated when species are added or removed.
+         */
+        map<Species*, int32_t> species_positions;
+        vector<int32_t> species_order;
+
+        /**
+         * (Re)indexes a species by its current representative, should be called whenever
+         * its representative may have changed.
+         */
+        void index_species(Species *species);
+        void rebuild_species_index();
+
+        /**
+         * Finds the species a genome should be inserted into: the first species in the order
+         * given by get_random_species_list whose representative is within species_threshold of
+         * the genome, the same as checking every species in that order would.
+         *
+         * \return the species, or NULL if the genome is not close enough to any of them
+         */
+        Species* find_species(RNN_Genome *genome);
     public:
 
         NeatSpeciationStrategy( double _mutation_rate, double _intra_island_crossover_rate,
                                 double _inter_island_crossover_rate, RNN_Genome *_seed_genome,
                                 double _species_threshold, double _fitness_threshold,
-                                double _neat_c1, double _neat_c2, double _neat_c3);
+                                double _neat_c1, double _neat_c2, double _neat_c3, int32_t _minhash_size);
         /**
          * \return the number of generated genomes.
          */
@@ -88,6 +126,12 @@ class NeatSpeciationStrategy : public SpeciationStrategy {
          */
         int32_t insert_genome(RNN_Genome* genome);
 
+        /**
+         * Inserts a <b>copy</b> of a genome migrated from another EXAMM instance, into whichever
+         * species it is compatible with.
+         */
+        int32_t insert_migrated_genome(RNN_Genome* genome, uniform_real_distribution<double> &rng_0_1, minstd_rand0 &generator);
+
         /**
          * Generates a new genome.
          *
@@ -125,7 +169,12 @@ class NeatSpeciationStrategy : public SpeciationStrategy {
 
         double get_distance(RNN_Genome* g1, RNN_Genome* g2);
 
-        int32_t get_exceed_number(vector<int32_t> v1, vector<int32_t> v2);
+        /**
+         * The NEAT compatibility distance, c1 * E / N + c2 * D / N + c3 * W, where E is the
+         * number of excess genes, D the number of disjoint genes, N the size of the larger
+         * genome and W the difference in average edge weight.
+         */
+        double get_distance(const GenomeSignature &s1, const GenomeSignature &s2);
 
         void rank_species();
 
@@ -0,0 +1,78 @@
+#include <algorithm>
+using std::swap;
+
+#include <cmath>
+using std::fabs;
+
+#include <vector>
+using std::vector;
+
+#include "examm/ridge_regression.hxx"
+
+RidgeRegression::RidgeRegression(int32_t _number_features, double _regularization) : number_features(_number_features), regularization(_regularization), number_samples(0) {
+    xtx.assign(number_features * number_features, 0.0);
+    xty.assign(number_features, 0.0);
+    coefficients.assign(number_features, 0.0);
+}
+
+int32_t RidgeRegression::get_number_features() const {
+    return number_features;
+}
+
+int32_t RidgeRegression::get_number_samples() const {
+    return number_samples;
+}
+
+void RidgeRegression::add_sample(const vector<double> &features, double target) {
+    for (int32_t i = 0; i < number_features; i++) {
+        for (int32_t j = 0; j < number_features; j++) {
+            xtx[(i * number_features) + j] += features[i] * features[j];
+        }
+        xty[i] += features[i] * target;
+    }
+    number_samples++;
+}
+
+double RidgeRegression::predict(const vector<double> &features) const {
+    double prediction = 0.0;
+    for (int32_t i = 0; i < number_features; i++) prediction += coefficients[i] * features[i];
+    return prediction;
+}
+
+void RidgeRegression::fit() {
+    //solves (X^T X + lambda I) c = X^T y with gaussian elimination, features which
+    //have always been zero have all zero rows so the penalty is what keeps this solvable
+    double average_diagonal = 0.0;
+    for (int32_t i = 0; i < number_features; i++) average_diagonal += xtx[(i * number_features) + i];
+    average_diagonal /= number_features;
+    double lambda = regularization * average_diagonal;
+    if (lambda <= 0.0) lambda = 1.0e-12;
+
+    int32_t n = number_features;
+    vector<double> a(xtx);
+    vector<double> b(xty);
+    for (int32_t i = 0; i < n; i++) a[(i * n) + i] += lambda;
+
+    for (int32_t column = 0; column < n; column++) {
+        int32_t pivot = column;
+        for (int32_t row = column + 1; row < n; row++) {
+            if (fabs(a[(row * n) + column]) > fabs(a[(pivot * n) + column])) pivot = row;
+        }
+        if (pivot != column) {
+            for (int32_t k = 0; k < n; k++) swap(a[(column * n) + k], a[(pivot * n) + k]);
+            swap(b[column], b[pivot]);
+        }
+
+        for (int32_t row = column + 1; row < n; row++) {
+            double factor = a[(row * n) + column] / a[(column * n) + column];
+            for (int32_t k = column; k < n; k++) a[(row * n) + k] -= factor * a[(column * n) + k];
+            b[row] -= factor * b[column];
+        }
+    }
+
+    for (int32_t row = n - 1; row >= 0; row--) {
+        double sum = b[row];
+        for (int32_t k = row + 1; k < n; k++) sum -= a[(row * n) + k] * coefficients[k];
+        coefficients[row] = sum / a[(row * n) + row];
+    }
+}
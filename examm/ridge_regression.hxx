@@ -0,0 +1,46 @@
+#ifndef EXAMM_RIDGE_REGRESSION_HXX
+#define EXAMM_RIDGE_REGRESSION_HXX
+
+#include <cstdint>
+
+#include <vector>
+using std::vector;
+
+/**
+ * An online linear least squares model with an L2 (ridge) penalty, which keeps the sums
+ * X^T X and X^T y of the samples added so far instead of the samples themselves, so it
+ * can be refit cheaply after every new sample.
+ */
+class RidgeRegression {
+    private:
+        int32_t number_features;
+        double regularization;
+
+        int32_t number_samples;
+        vector<double> xtx; /**< the sum of the outer products of the samples' features, number_features x number_features */
+        vector<double> xty; /**< the sum of the samples' features times their targets */
+        vector<double> coefficients;
+
+    public:
+        /**
+         * \param regularization is the ridge regression penalty, relative to the average squared feature value
+         */
+        RidgeRegression(int32_t number_features, double regularization);
+
+        int32_t get_number_features() const;
+        int32_t get_number_samples() const;
+
+        void add_sample(const vector<double> &features, double target);
+
+        /**
+         * Recalculates the coefficients from all the samples added so far.
+         */
+        void fit();
+
+        /**
+         * \return the features times the coefficients from the last fit (0 before the first one)
+         */
+        double predict(const vector<double> &features) const;
+};
+
+#endif
@@ -60,6 +60,18 @@ class SpeciationStrategy {
          */
         virtual int32_t insert_genome(RNN_Genome* genome) = 0;
 
+        /**
+         * Inserts a <b>copy</b> of a genome migrated from another EXAMM instance (e.g., another
+         * sub-master in a hierarchical run). The genome is given a new generation id from this
+         * strategy and does not count towards the number of evaluated genomes.
+         *
+         * \param genome is the genome to insert.
+         * \param rng_0_1 is the random number distribution that generates random numbers between 0 (inclusive) and 1 (non=inclusive).
+         * \param generator is the random number generator
+         * \return the same as insert_genome
+         */
+        virtual int32_t insert_migrated_genome(RNN_Genome* genome, uniform_real_distribution<double> &rng_0_1, minstd_rand0 &generator) = 0;
+
         /**
          * Generates a new genome.
          *
@@ -1,4 +1,5 @@
 #include <algorithm>
+using std::min;
 using std::sort;
 using std::upper_bound;
 
@@ -13,10 +14,21 @@ using std::uniform_real_distribution;
 using std::string;
 using std::to_string;
 
+#include <thread>
+using std::thread;
+
+#include <vector>
+using std::vector;
+
 #include "species.hxx"
 #include "rnn/rnn_genome.hxx"
 
 #include "common/log.hxx"
+
+//the minimum number of rows of the distance matrix per thread before
+//fitness sharing calculates the matrix with multiple threads
+#define FITNESS_SHARING_ROWS_PER_THREAD 32
+
         // Species(int32_t id, double fitness_th);
 Species::Species(int32_t _id) : id(_id), species_not_improving_count(0) {
 }
@@ -157,32 +169,50 @@ RNN_Genome* Species::get_latested_genome() {
     return latest;
 }
 
-void Species::fitness_sharing_remove(double fitness_threshold, function<double (RNN_Genome*, RNN_Genome*)> &get_distance) {
+void Species::fitness_sharing_remove(double fitness_threshold, int32_t minhash_size, function<double (const GenomeSignature&, const GenomeSignature&)> &get_distance) {
     int32_t N = (int32_t)genomes.size();
-    double distance_sum[N];
-    double fitness_share[N];
+
+    //the signatures are cached on the genomes, so get them all before
+    //the distances are calculated concurrently
+    vector<const GenomeSignature*> signatures(N);
+    for (int32_t i = 0; i < N; i++) {
+        signatures[i] = &genomes[i]->get_signature(minhash_size);
+    }
+
+    vector<double> distance(N * N, 0.0);
+    auto calculate_rows = [&](int32_t first_row, int32_t row_step) {
+        for (int32_t i = first_row; i < N; i += row_step) {
+            for (int32_t j = i + 1; j < N; j++) {
+                distance[i * N + j] = get_distance(*signatures[i], *signatures[j]);
+            }
+        }
+    };
+
+    //rows are interleaved between the threads as they get shorter
+    //further down the upper triangle of the matrix
+    int32_t number_threads = min((int32_t)thread::hardware_concurrency(), N / FITNESS_SHARING_ROWS_PER_THREAD);
+    if (number_threads > 1) {
+        vector<thread> threads;
+        for (int32_t t = 0; t < number_threads; t++) {
+            threads.push_back(thread(calculate_rows, t, number_threads));
+        }
+        for (int32_t t = 0; t < number_threads; t++) {
+            threads[t].join();
+        }
+    } else {
+        calculate_rows(0, 1);
+    }
+
+    vector<double> fitness_share(N);
     double fitness_share_total = 0;
     double sum_square = 0;
-    double distance [N][N];
     for (int32_t i = 0; i < N; i++) {
-        distance_sum[i] = 0;
+        double distance_sum = 0;
         for (int32_t j = 0; j < N; j++) {
-            if (i < j) {
-                distance[i][j] = get_distance(genomes[i], genomes[j]);
-            }
-            else if (i > j) {
-                distance[i][j] = distance[j][i]; 
-            }
-            else {
-                distance[i][j] = 0;
-            }
-            if (distance[i][j] > fitness_threshold) {
-                distance_sum[i] += 0;
-            } else {
-                distance_sum[i] += 1;
-            }
+            double d = i <= j ? distance[i * N + j] : distance[j * N + i];
+            if (d <= fitness_threshold) distance_sum += 1;
         }
-        fitness_share[i] = (genomes[i] -> get_fitness()) / distance_sum[i];
+        fitness_share[i] = (genomes[i] -> get_fitness()) / distance_sum;
         fitness_share_total += fitness_share[i];
         sum_square += fitness_share[i] * fitness_share[i];
     }
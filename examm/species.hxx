@@ -133,7 +133,16 @@ class Species {
 
         RNN_Genome* get_latested_genome();
 
-        void fitness_sharing_remove(double fitness_threshold, function<double (RNN_Genome*, RNN_Genome*)> &get_distance);
+        /**
+         * Removes the genomes whose shared fitness is more than 3 standard deviations above
+         * the mean. The distances between all pairs of genomes are calculated from their
+         * (cached) signatures, in parallel for larger species.
+         *
+         * \param fitness_threshold is the distance under which two genomes share fitness
+         * \param minhash_size is the size of the MinHash sketches used to estimate distances (0 to calculate them exactly)
+         * \param get_distance calculates the distance between two genome signatures, and must be safe to call from multiple threads
+         */
+        void fitness_sharing_remove(double fitness_threshold, int32_t minhash_size, function<double (const GenomeSignature&, const GenomeSignature&)> &get_distance);
 
         void erase_species();
 
@@ -1,5 +1,14 @@
 #include <chrono>
 
+#include <condition_variable>
+using std::condition_variable;
+
+#include <algorithm>
+using std::sort;
+
+#include <deque>
+using std::deque;
+
 #include <iomanip>
 using std::setw;
 using std::fixed;
@@ -7,6 +16,10 @@ using std::setprecision;
 
 #include <mutex>
 using std::mutex;
+using std::unique_lock;
+
+#include <set>
+using std::set;
 
 #include <string>
 using std::string;
@@ -14,24 +27,40 @@ using std::string;
 #include <thread>
 using std::thread;
 
+#include <utility>
+using std::pair;
+
 #include <vector>
 using std::vector;
 
 #include "mpi.h"
 
+#include "common/arguments.hxx"
 #include "common/log.hxx"
+#include "common/performance_log.hxx"
 #include "common/process_arguments.hxx"
+#include "common/random.hxx"
 #include "weights/weight_rules.hxx"
 #include "weights/weight_update.hxx"
 #include "rnn/generate_nn.hxx"
 #include "examm/examm.hxx"
+#include "examm/genome_cost_model.hxx"
+#include "mpi/shared_series_data.hxx"
 
+#include "time_series/sequence_windows.hxx"
 #include "time_series/time_series.hxx"
 
 #define WORK_REQUEST_TAG 1
 #define GENOME_LENGTH_TAG 2
 #define GENOME_TAG 3
 #define TERMINATE_TAG 4
+#define HEARTBEAT_TAG 5
+
+//the states of each worker rank, as tracked by the master
+#define WORKER_IDLE 0
+#define WORKER_TRAINING 1
+#define WORKER_TERMINATED 2
+#define WORKER_LOST 3
 
 mutex examm_mutex;
 
@@ -42,14 +71,27 @@ WeightUpdate *weight_update_method;
 
 bool finished = false;
 
-vector< vector< vector<double> > > training_inputs;
-vector< vector< vector<double> > > training_outputs;
-vector< vector< vector<double> > > validation_inputs;
-vector< vector< vector<double> > > validation_outputs;
+//if > 0, a worker which the master hasn't heard from (a result or a heartbeat) in this many
+//seconds while training is considered lost, and its genome is sent to another worker
+double worker_timeout = 0;
+//how often (in seconds) workers send the master a heartbeat while training, 0 for never
+double heartbeat_interval = 0;
+
+//if > 0, the master keeps this many generated genomes ready and sends each worker the one
+//whose predicted training time best matches how fast that worker has been
+int32_t schedule_lookahead = 0;
+GenomeCostModel *cost_model = NULL;
+
+vector<SeriesTensor> training_inputs;
+vector<SeriesTensor> training_outputs;
+vector<SeriesTensor> validation_inputs;
+vector<SeriesTensor> validation_outputs;
+
+//the subset of the training series low fidelity genomes are trained on
+vector<SeriesTensor> low_fidelity_inputs;
+vector<SeriesTensor> low_fidelity_outputs;
 
-// bool random_sequence_length;
-// int32_t sequence_length_lower_bound = 30;
-// int32_t sequence_length_upper_bound = 100;
+SequenceWindows *sequence_windows = NULL;
 
 void send_work_request(int32_t target) {
     int32_t work_request_message[1];
@@ -87,7 +129,8 @@ RNN_Genome* receive_genome_from(int32_t source) {
     return genome;
 }
 
-void send_genome_to(int32_t target, RNN_Genome* genome) {
+//returns false if the genome could not be sent (i.e., the target rank has failed)
+bool send_genome_to(int32_t target, RNN_Genome* genome) {
     char *byte_array;
     int32_t length;
 
@@ -97,12 +140,15 @@ void send_genome_to(int32_t target, RNN_Genome* genome) {
 
     int32_t length_message[1];
     length_message[0] = length;
-    MPI_Send(length_message, 1, MPI_INT, target, GENOME_LENGTH_TAG, MPI_COMM_WORLD);
+    int32_t result = MPI_Send(length_message, 1, MPI_INT, target, GENOME_LENGTH_TAG, MPI_COMM_WORLD);
 
-    Log::debug("sending genome to: %d\n", target);
-    MPI_Send(byte_array, length, MPI_CHAR, target, GENOME_TAG, MPI_COMM_WORLD);
+    if (result == MPI_SUCCESS) {
+        Log::debug("sending genome to: %d\n", target);
+        result = MPI_Send(byte_array, length, MPI_CHAR, target, GENOME_TAG, MPI_COMM_WORLD);
+    }
 
     free(byte_array);
+    return result == MPI_SUCCESS;
 }
 
 void send_terminate_message(int32_t target) {
@@ -111,76 +157,304 @@ void send_terminate_message(int32_t target) {
     MPI_Send(terminate_message, 1, MPI_INT, target, TERMINATE_TAG, MPI_COMM_WORLD);
 }
 
+void receive_heartbeat(int32_t source) {
+    MPI_Status status;
+    int32_t heartbeat_message[1];
+    MPI_Recv(heartbeat_message, 1, MPI_INT, source, HEARTBEAT_TAG, MPI_COMM_WORLD, &status);
+}
+
+/**
+ * Sends the master a heartbeat every heartbeat_interval seconds while a worker is training,
+ * so the master can tell a long training run from a dead or hung worker. Only this thread
+ * makes MPI calls while it is running, so MPI_THREAD_SERIALIZED is enough.
+ */
+class Heartbeat {
+    private:
+        mutex heartbeat_mutex;
+        condition_variable stop_condition;
+        bool stopped;
+        thread heartbeat_thread;
+
+    public:
+        Heartbeat() : stopped(false) {
+            heartbeat_thread = thread([this]() {
+                unique_lock<mutex> lock(heartbeat_mutex);
+                while (!stop_condition.wait_for(lock, std::chrono::duration<double>(heartbeat_interval), [this]() { return stopped; })) {
+                    int32_t heartbeat_message[1];
+                    heartbeat_message[0] = 0;
+                    MPI_Send(heartbeat_message, 1, MPI_INT, 0, HEARTBEAT_TAG, MPI_COMM_WORLD);
+                }
+            });
+        }
+
+        ~Heartbeat() {
+            {
+                unique_lock<mutex> lock(heartbeat_mutex);
+                stopped = true;
+            }
+            stop_condition.notify_one();
+            heartbeat_thread.join();
+        }
+};
+
+double seconds_since(std::chrono::time_point<std::chrono::steady_clock> time) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - time).count();
+}
+
+/**
+ * Selects which of the scheduled genomes to send to a worker. The active workers are ranked
+ * by their slowdown (how much longer than predicted their genomes have taken) and the worker
+ * gets the genome at the same rank by predicted cost, so the fastest workers train the
+ * largest genomes and slow workers don't finish the search with a long straggling genome.
+ *
+ * \return the index of the genome in scheduled_genomes
+ */
+int32_t select_scheduled_genome(int32_t worker, const vector<int32_t> &worker_state, const vector<double> &worker_slowdown, const vector< vector<double> > &scheduled_features) {
+    int32_t active_workers = 0;
+    int32_t slower_workers = 0;
+    for (int32_t i = 1; i < (int32_t)worker_state.size(); i++) {
+        if (i != worker && (worker_state[i] == WORKER_TERMINATED || worker_state[i] == WORKER_LOST)) continue;
+        active_workers++;
+        if (worker_slowdown[i] > worker_slowdown[worker]) slower_workers++;
+    }
+    double speed_rank = active_workers > 1 ? (double)slower_workers / (active_workers - 1) : 1.0;
+
+    vector<int32_t> order(scheduled_features.size());
+    vector<double> predicted_costs(scheduled_features.size());
+    for (int32_t i = 0; i < (int32_t)scheduled_features.size(); i++) {
+        order[i] = i;
+        predicted_costs[i] = cost_model->predict(scheduled_features[i]);
+    }
+    sort(order.begin(), order.end(), [&](int32_t a, int32_t b) { return predicted_costs[a] < predicted_costs[b]; });
+
+    return order[(int32_t)(speed_rank * (order.size() - 1) + 0.5)];
+}
+
 void receive_terminate_message(int32_t source) {
     MPI_Status status;
     int32_t terminate_message[1];
     MPI_Recv(terminate_message, 1, MPI_INT, source, TERMINATE_TAG, MPI_COMM_WORLD, &status);
 }
 
-void master(int32_t max_rank) {
+//returns the number of workers which were lost
+int32_t master(int32_t max_rank) {
     //the "main" id will have already been set by the main function so we do not need to re-set it here
     Log::debug("MAX int32_t: %d\n", numeric_limits<int32_t>::max());
 
+    //the genome each worker is training, kept until its result comes back so it
+    //can be sent to another worker if this one is lost
+    vector<int32_t> worker_state(max_rank, WORKER_IDLE);
+    vector<RNN_Genome*> outstanding_genomes(max_rank, NULL);
+    vector< std::chrono::time_point<std::chrono::steady_clock> > last_heard(max_rank, std::chrono::steady_clock::now());
+    deque<RNN_Genome*> redispatch_genomes;
+
+    //the (generation id, fidelity) of genomes which were re-dispatched, and of those which
+    //already had a result inserted, so only the first result for a genome with more than one
+    //copy is used. a promoted genome keeps its generation id, so its full fidelity run is
+    //told apart from its low fidelity one by the fidelity
+    set< pair<int32_t, int32_t> > redispatched_ids;
+    set< pair<int32_t, int32_t> > finished_ids;
+
+    //genomes generated ahead of time for the scheduler, and the cost model's measurements
+    vector<RNN_Genome*> scheduled_genomes;
+    vector< vector<double> > scheduled_features;
+    bool search_finished = false;
+    vector<double> worker_slowdown(max_rank, 1.0);
+    vector< vector<double> > dispatched_features(max_rank);
+    vector< std::chrono::time_point<std::chrono::steady_clock> > dispatch_time(max_rank);
+
     int32_t terminates_sent = 0;
+    int32_t lost_workers = 0;
 
-    while (true) {
-        //wait for a incoming message
+    while (terminates_sent + lost_workers < max_rank - 1) {
+        //wait for a incoming message, checking for timed out workers while waiting
         MPI_Status status;
-        MPI_Probe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
+        {
+            ScopedTimer timer(PerformanceLog::MPI_WAIT);
+            if (worker_timeout > 0) {
+                int32_t message_waiting = 0;
+                while (true) {
+                    MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &message_waiting, &status);
+                    if (message_waiting) break;
+
+                    for (int32_t i = 1; i < max_rank; i++) {
+                        if ((worker_state[i] != WORKER_TRAINING && worker_state[i] != WORKER_IDLE) || seconds_since(last_heard[i]) <= worker_timeout) continue;
+
+                        //idle workers are also timed out, as a worker which dies before asking
+                        //for (more) work would otherwise never be accounted for at shutdown
+                        if (worker_state[i] == WORKER_TRAINING) {
+                            Log::warning("worker %d has not responded in %lf seconds, re-dispatching genome %d\n", i, worker_timeout, outstanding_genomes[i]->get_generation_id());
+                            redispatched_ids.insert(pair<int32_t, int32_t>(outstanding_genomes[i]->get_generation_id(), outstanding_genomes[i]->get_fidelity()));
+                            redispatch_genomes.push_back(outstanding_genomes[i]);
+                            outstanding_genomes[i] = NULL;
+                        } else {
+                            Log::warning("idle worker %d has not asked for work in %lf seconds\n", i, worker_timeout);
+                        }
+                        worker_state[i] = WORKER_LOST;
+                        lost_workers++;
+                    }
+                    if (terminates_sent + lost_workers >= max_rank - 1) break;
+
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                if (!message_waiting) break;
+            } else {
+                MPI_Probe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
+            }
+        }
 
         int32_t source = status.MPI_SOURCE;
         int32_t tag = status.MPI_TAG;
         Log::debug("probe returned message from: %d with tag: %d\n", source, tag);
-
+        last_heard[source] = std::chrono::steady_clock::now();
 
         //if the message is a work request, send a genome
 
         if (tag == WORK_REQUEST_TAG) {
             receive_work_request(source);
 
+            if (worker_state[source] == WORKER_LOST) {
+                Log::info("lost worker %d has returned\n", source);
+                lost_workers--;
+            }
 
             // if (transfer_learning_version.compare("v3") == 0 || transfer_learning_version.compare("v1+v3") == 0) {
             //     seed_stirs = 3;
             // }
-            examm_mutex.lock();
-            RNN_Genome *genome = examm->generate_genome();
-            examm_mutex.unlock();
+            RNN_Genome *genome = NULL;
+            if (redispatch_genomes.size() > 0) {
+                genome = redispatch_genomes.front();
+                redispatch_genomes.pop_front();
+            } else if (schedule_lookahead > 0) {
+                while (!search_finished && (int32_t)scheduled_genomes.size() < schedule_lookahead) {
+                    examm_mutex.lock();
+                    RNN_Genome *scheduled_genome = examm->generate_genome();
+                    examm_mutex.unlock();
+
+                    if (scheduled_genome == NULL) {
+                        //the search has enough genomes, any still scheduled are not needed
+                        search_finished = true;
+                        Log::info("search finished, discarding %d scheduled genomes\n", scheduled_genomes.size());
+                        for (int32_t i = 0; i < (int32_t)scheduled_genomes.size(); i++) delete scheduled_genomes[i];
+                        scheduled_genomes.clear();
+                        scheduled_features.clear();
+                    } else {
+                        scheduled_genomes.push_back(scheduled_genome);
+                        scheduled_features.push_back(vector<double>());
+                        cost_model->get_features(scheduled_genome, scheduled_features.back());
+                    }
+                }
+
+                if (scheduled_genomes.size() > 0) {
+                    int32_t selected = select_scheduled_genome(source, worker_state, worker_slowdown, scheduled_features);
+                    genome = scheduled_genomes[selected];
+                    scheduled_genomes.erase(scheduled_genomes.begin() + selected);
+                    scheduled_features.erase(scheduled_features.begin() + selected);
+                }
+            } else {
+                examm_mutex.lock();
+                genome = examm->generate_genome();
+                examm_mutex.unlock();
+            }
 
             if (genome == NULL) { //search was completed if it returns NULL for an individual
                 //send terminate message
                 Log::info("terminating worker: %d\n", source);
                 send_terminate_message(source);
+                worker_state[source] = WORKER_TERMINATED;
                 terminates_sent++;
 
-                Log::debug("sent: %d terminates of %d\n", terminates_sent, (max_rank - 1));
-                if (terminates_sent >= max_rank - 1) return;
+                Log::debug("sent: %d terminates of %d (%d workers lost)\n", terminates_sent, (max_rank - 1), lost_workers);
 
             } else {
                 //genome->write_to_file( examm->get_output_directory() + "/before_send_gen_" + to_string(genome->get_generation_id()) );
 
                 //send genome
                 Log::debug("sending genome to: %d\n", source);
-                send_genome_to(source, genome);
-
-                //delete this genome as it will not be used again
-                delete genome;
+                if (schedule_lookahead > 0) {
+                    cost_model->get_features(genome, dispatched_features[source]);
+                    dispatch_time[source] = std::chrono::steady_clock::now();
+                }
+
+                if (send_genome_to(source, genome)) {
+                    worker_state[source] = WORKER_TRAINING;
+                    outstanding_genomes[source] = genome;
+                } else {
+                    Log::warning("could not send genome to worker %d, re-dispatching genome %d\n", source, genome->get_generation_id());
+                    redispatch_genomes.push_front(genome);
+                    worker_state[source] = WORKER_LOST;
+                    lost_workers++;
+                }
             }
         } else if (tag == GENOME_LENGTH_TAG) {
             Log::debug("received genome from: %d\n", source);
             RNN_Genome *genome = receive_genome_from(source);
 
-            examm_mutex.lock();
-            examm->insert_genome(genome);
-            examm_mutex.unlock();
+            //a worker which timed out may still finish its genome
+            if (worker_state[source] == WORKER_LOST) {
+                Log::info("lost worker %d has returned\n", source);
+                lost_workers--;
+            } else if (schedule_lookahead > 0) {
+                //calibrate the cost model with how long the genome took, and the worker's
+                //slowdown with how that compares to what the model predicted
+                double seconds = seconds_since(dispatch_time[source]);
+                cost_model->add_sample(dispatched_features[source], seconds / worker_slowdown[source]);
+                if (cost_model->is_calibrated()) {
+                    double predicted = cost_model->predict(dispatched_features[source]);
+                    worker_slowdown[source] = (0.8 * worker_slowdown[source]) + (0.2 * (seconds / predicted));
+                    Log::debug("worker %d took %lf seconds, predicted %lf, slowdown now %lf\n", source, seconds, predicted, worker_slowdown[source]);
+                }
+            }
+            worker_state[source] = WORKER_IDLE;
+            if (outstanding_genomes[source] != NULL) {
+                delete outstanding_genomes[source];
+                outstanding_genomes[source] = NULL;
+            }
+
+            int32_t generation_id = genome->get_generation_id();
+            pair<int32_t, int32_t> result_id(generation_id, genome->get_fidelity());
+            bool duplicate = finished_ids.count(result_id) > 0;
+            if (!duplicate && redispatched_ids.count(result_id) > 0) {
+                //the first result for a re-dispatched genome, any copy which has not been sent
+                //out yet is no longer needed and any which is still training will be discarded
+                finished_ids.insert(result_id);
+                for (auto it = redispatch_genomes.begin(); it != redispatch_genomes.end();) {
+                    if ((*it)->get_generation_id() == generation_id && (*it)->get_fidelity() == result_id.second) {
+                        Log::info("dropping the re-dispatched copy of genome %d, worker %d finished it\n", generation_id, source);
+                        delete *it;
+                        it = redispatch_genomes.erase(it);
+                    } else {
+                        it++;
+                    }
+                }
+            }
+
+            if (duplicate) {
+                Log::info("discarding duplicate result for re-dispatched genome %d from worker %d\n", generation_id, source);
+            } else {
+                examm_mutex.lock();
+                examm->insert_genome(genome);
+                examm_mutex.unlock();
+            }
 
             //delete the genome as it won't be used again, a copy was inserted
             delete genome;
             //this genome will be deleted if/when removed from population
+        } else if (tag == HEARTBEAT_TAG) {
+            receive_heartbeat(source);
+
         } else {
             Log::fatal("ERROR: received message from %d with unknown tag: %d", source, tag);
             MPI_Abort(MPI_COMM_WORLD, 1);
         }
     }
+
+    if (lost_workers > 0) {
+        Log::warning("finished with %d lost workers, %d genomes were not evaluated\n", lost_workers, redispatch_genomes.size());
+    }
+    for (int32_t i = 0; i < (int32_t)redispatch_genomes.size(); i++) delete redispatch_genomes[i];
+    for (int32_t i = 0; i < (int32_t)scheduled_genomes.size(); i++) delete scheduled_genomes[i];
+    return lost_workers;
 }
 
 void worker(int32_t rank) {
@@ -192,7 +466,10 @@ void worker(int32_t rank) {
         Log::debug("sent work request!\n");
 
         MPI_Status status;
-        MPI_Probe(0, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
+        {
+            ScopedTimer timer(PerformanceLog::MPI_WAIT);
+            MPI_Probe(0, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
+        }
         int32_t tag = status.MPI_TAG;
 
         Log::debug("probe received message with tag: %d\n", tag);
@@ -209,7 +486,15 @@ void worker(int32_t rank) {
             //have each worker write the backproagation to a separate log file
             string log_id = "genome_" + to_string(genome->get_generation_id()) + "_worker_" + to_string(rank);
             Log::set_id(log_id);
-            genome->backpropagate_stochastic(training_inputs, training_outputs, validation_inputs, validation_outputs, weight_update_method);
+            bool low_fidelity = genome->get_fidelity() == RNN_Genome::LOW_FIDELITY;
+            const vector<SeriesTensor> &inputs = low_fidelity ? low_fidelity_inputs : training_inputs;
+            const vector<SeriesTensor> &outputs = low_fidelity ? low_fidelity_outputs : training_outputs;
+            if (heartbeat_interval > 0) {
+                Heartbeat heartbeat;
+                genome->backpropagate_stochastic(inputs, outputs, validation_inputs, validation_outputs, weight_update_method, sequence_windows);
+            } else {
+                genome->backpropagate_stochastic(inputs, outputs, validation_inputs, validation_outputs, weight_update_method, sequence_windows);
+            }
             Log::release_id(log_id);
 
             //go back to the worker's log for MPI communication
@@ -230,7 +515,9 @@ void worker(int32_t rank) {
 
 int main(int argc, char** argv) {
     std::cout << "starting up!" << std::endl;
-    MPI_Init(&argc, &argv);
+    //the heartbeat thread makes MPI calls while the worker's main thread is training
+    int32_t thread_support;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &thread_support);
     std::cout << "did mpi init!" << std::endl;
     int32_t rank, max_rank;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
@@ -243,33 +530,106 @@ int main(int argc, char** argv) {
     Log::set_rank(rank);
     Log::set_id("main_" + to_string(rank));
     Log::restrict_to_rank(0);
+    PerformanceLog::initialize(arguments);
+    initialize_random_seed(arguments);
     std::cout << "initailized log!" << std::endl;
 
+    get_argument(arguments, "--worker_timeout", false, worker_timeout);
+    get_argument(arguments, "--heartbeat_interval", false, heartbeat_interval);
+    if (worker_timeout > 0) {
+        if (heartbeat_interval <= 0) heartbeat_interval = worker_timeout / 4.0;
+        if (heartbeat_interval >= worker_timeout) {
+            Log::fatal("ERROR: --heartbeat_interval (%lf) must be less than --worker_timeout (%lf)\n", heartbeat_interval, worker_timeout);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        //report failed sends to the master instead of aborting the whole run
+        MPI_Comm_set_errhandler(MPI_COMM_WORLD, MPI_ERRORS_RETURN);
+    }
+    if (heartbeat_interval > 0 && thread_support < MPI_THREAD_SERIALIZED) {
+        Log::warning("MPI does not support MPI_THREAD_SERIALIZED, workers will not send heartbeats\n");
+        heartbeat_interval = 0;
+    }
+
+    //only one rank on each node (rank 0 is always the first on its node) loads the
+    //time series, the others on the node read them from its shared memory
+    MPI_Comm node_comm;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node_comm);
+    int32_t node_rank;
+    MPI_Comm_rank(node_comm, &node_rank);
+
     TimeSeriesSets *time_series_sets = NULL;
-    time_series_sets = TimeSeriesSets::generate_from_arguments(arguments);
-    get_train_validation_data(arguments, time_series_sets, training_inputs, training_outputs, validation_inputs, validation_outputs);
+    if (node_rank == 0) {
+        time_series_sets = TimeSeriesSets::generate_from_arguments(arguments);
+        get_train_validation_data(arguments, time_series_sets, training_inputs, training_outputs, validation_inputs, validation_outputs);
+    }
+
+    //every rank (including the node leader, freeing its own copy) trains on views
+    //of the shared window
+    SharedSeriesData *shared_series_data = new SharedSeriesData(node_comm, {&training_inputs, &training_outputs, &validation_inputs, &validation_outputs});
+    shared_series_data->get_set(0, training_inputs);
+    shared_series_data->get_set(1, training_outputs);
+    shared_series_data->get_set(2, validation_inputs);
+    shared_series_data->get_set(3, validation_outputs);
+    get_low_fidelity_data(arguments, training_inputs, training_outputs, low_fidelity_inputs, low_fidelity_outputs);
 
     weight_update_method = new WeightUpdate();
     weight_update_method->generate_from_arguments(arguments);
+    sequence_windows = SequenceWindows::generate_from_arguments(arguments);
 
     WeightRules *weight_rules = new WeightRules();
     weight_rules->generate_weight_initialize_from_arguments(arguments);
 
-    RNN_Genome *seed_genome = get_seed_genome(arguments, time_series_sets, weight_rules);
+    //only the master needs the seed genome and time series sets
+    RNN_Genome *seed_genome = NULL;
+    if (rank == 0) {
+        seed_genome = get_seed_genome(arguments, time_series_sets, weight_rules);
+    } else if (time_series_sets != NULL) {
+        delete time_series_sets;
+        time_series_sets = NULL;
+    }
 
     Log::clear_rank_restriction();
 
+    int32_t lost_workers = 0;
     if (rank == 0) {
         write_time_series_to_file(arguments, time_series_sets);
         examm = generate_examm_from_arguments(arguments, time_series_sets, weight_rules, seed_genome);
-        master(max_rank);
+        get_argument(arguments, "--schedule_lookahead", false, schedule_lookahead);
+        if (schedule_lookahead > 0) {
+            int64_t training_timesteps = 0;
+            for (int32_t i = 0; i < (int32_t)training_inputs.size(); i++) {
+                training_timesteps += training_inputs[i].get_number_timesteps();
+            }
+            int64_t low_fidelity_timesteps = 0;
+            for (int32_t i = 0; i < (int32_t)low_fidelity_inputs.size(); i++) {
+                low_fidelity_timesteps += low_fidelity_inputs[i].get_number_timesteps();
+            }
+            cost_model = new GenomeCostModel(training_timesteps, low_fidelity_timesteps, 1.0e-3);
+        }
+
+        lost_workers = master(max_rank);
     } else {
         worker(rank);
     }
     Log::set_id("main_" + to_string(rank));
     finished = true;
-    Log::debug("rank %d completed!\n");
+
+    string output_directory = "";
+    if (get_argument(arguments, "--output_directory", false, output_directory)) {
+        PerformanceLog::write_summary(output_directory + "/performance_summary_rank_" + to_string(rank) + ".csv");
+    }
+    Log::debug("rank %d completed!\n", rank);
     Log::release_id("main_" + to_string(rank));
+
+    if (lost_workers > 0) {
+        //lost workers may be hung rather than dead, in which case they would
+        //never reach MPI_Finalize, so end the run now that the results are written
+        Log::warning("aborting the remaining ranks as %d workers were lost\n", lost_workers);
+        Log::flush();
+        MPI_Abort(MPI_COMM_WORLD, 0);
+    }
+    delete shared_series_data;
+    MPI_Comm_free(&node_comm);
     MPI_Finalize();
 
     delete time_series_sets;
@@ -0,0 +1,486 @@
+#include <chrono>
+
+#include <cstdint>
+
+#include <random>
+using std::minstd_rand0;
+using std::uniform_real_distribution;
+
+#include <string>
+using std::string;
+using std::to_string;
+
+#include <vector>
+using std::vector;
+
+#include "mpi.h"
+
+#include "common/arguments.hxx"
+#include "common/log.hxx"
+#include "common/performance_log.hxx"
+#include "common/process_arguments.hxx"
+#include "common/random.hxx"
+#include "weights/weight_rules.hxx"
+#include "weights/weight_update.hxx"
+#include "rnn/generate_nn.hxx"
+#include "examm/examm.hxx"
+
+#include "time_series/sequence_windows.hxx"
+#include "time_series/time_series.hxx"
+
+#define WORK_REQUEST_TAG 1
+#define GENOME_LENGTH_TAG 2
+#define GENOME_TAG 3
+#define TERMINATE_TAG 4
+#define MIGRATION_TAG 5
+#define MIGRATION_DONE_TAG 6
+
+//each sub-master's EXAMM instance gets its own range of innovation numbers, so
+//genomes migrated between them never reuse an innovation number for a different gene
+#define INNOVATION_NUMBERS_PER_SUB_MASTER (1 << 24)
+
+/**
+ * \return the first innovation number of the sub-master's range, or -1 if its range would
+ * not fit in the (32 bit) innovation numbers
+ */
+int64_t get_innovation_number_offset(int32_t sub_master) {
+    int64_t offset = (int64_t)sub_master * INNOVATION_NUMBERS_PER_SUB_MASTER;
+    if (offset + INNOVATION_NUMBERS_PER_SUB_MASTER - 1 > INT32_MAX) return -1;
+    return offset;
+}
+
+vector<string> arguments;
+
+EXAMM *examm;
+WeightUpdate *weight_update_method;
+
+vector<SeriesTensor> training_inputs;
+vector<SeriesTensor> training_outputs;
+vector<SeriesTensor> validation_inputs;
+vector<SeriesTensor> validation_outputs;
+
+//the subset of the training series low fidelity genomes are trained on
+vector<SeriesTensor> low_fidelity_inputs;
+vector<SeriesTensor> low_fidelity_outputs;
+
+SequenceWindows *sequence_windows = NULL;
+
+/**
+ * Ranks 0 to number_sub_masters - 1 are the sub-masters, the remaining ranks are
+ * workers which are dealt out to the sub-masters in turn.
+ */
+int32_t get_sub_master(int32_t rank, int32_t number_sub_masters) {
+    if (rank < number_sub_masters) return rank;
+    return (rank - number_sub_masters) % number_sub_masters;
+}
+
+int32_t get_number_workers(int32_t sub_master, int32_t number_sub_masters, int32_t max_rank) {
+    int32_t number_workers = 0;
+    for (int32_t rank = number_sub_masters; rank < max_rank; rank++) {
+        if (get_sub_master(rank, number_sub_masters) == sub_master) number_workers++;
+    }
+    return number_workers;
+}
+
+/**
+ * \return the share of total given to the sub-master, spreading any remainder over the first sub-masters
+ */
+int32_t get_share(int32_t total, int32_t sub_master, int32_t number_sub_masters) {
+    return (total / number_sub_masters) + (sub_master < (total % number_sub_masters) ? 1 : 0);
+}
+
+void set_argument(vector<string> &args, string argument, string value) {
+    for (int32_t i = 0; i < (int32_t)args.size() - 1; i++) {
+        if (args[i] == argument) {
+            args[i + 1] = value;
+            return;
+        }
+    }
+    args.push_back(argument);
+    args.push_back(value);
+}
+
+void send_work_request(int32_t target) {
+    int32_t work_request_message[1];
+    work_request_message[0] = 0;
+    MPI_Send(work_request_message, 1, MPI_INT, target, WORK_REQUEST_TAG, MPI_COMM_WORLD);
+}
+
+void receive_work_request(int32_t source) {
+    MPI_Status status;
+    int32_t work_request_message[1];
+    MPI_Recv(work_request_message, 1, MPI_INT, source, WORK_REQUEST_TAG, MPI_COMM_WORLD, &status);
+}
+
+RNN_Genome* receive_genome_from(int32_t source) {
+    MPI_Status status;
+    int32_t length_message[1];
+    MPI_Recv(length_message, 1, MPI_INT, source, GENOME_LENGTH_TAG, MPI_COMM_WORLD, &status);
+
+    int32_t length = length_message[0];
+
+    Log::debug("receiving genome of length: %d from: %d\n", length, source);
+
+    char* genome_str = new char[length + 1];
+
+    Log::debug("receiving genome from: %d\n", source);
+    MPI_Recv(genome_str, length, MPI_CHAR, source, GENOME_TAG, MPI_COMM_WORLD, &status);
+
+    genome_str[length] = '\0';
+
+    Log::trace("genome_str:\n%s\n", genome_str);
+
+    RNN_Genome* genome = new RNN_Genome(genome_str, length);
+
+    delete [] genome_str;
+    return genome;
+}
+
+void send_genome_to(int32_t target, RNN_Genome* genome) {
+    char *byte_array;
+    int32_t length;
+
+    genome->write_to_array(&byte_array, length);
+
+    Log::debug("sending genome of length: %d to: %d\n", length, target);
+
+    int32_t length_message[1];
+    length_message[0] = length;
+    MPI_Send(length_message, 1, MPI_INT, target, GENOME_LENGTH_TAG, MPI_COMM_WORLD);
+
+    Log::debug("sending genome to: %d\n", target);
+    MPI_Send(byte_array, length, MPI_CHAR, target, GENOME_TAG, MPI_COMM_WORLD);
+
+    free(byte_array);
+}
+
+void send_terminate_message(int32_t target) {
+    int32_t terminate_message[1];
+    terminate_message[0] = 0;
+    MPI_Send(terminate_message, 1, MPI_INT, target, TERMINATE_TAG, MPI_COMM_WORLD);
+}
+
+void receive_terminate_message(int32_t source) {
+    MPI_Status status;
+    int32_t terminate_message[1];
+    MPI_Recv(terminate_message, 1, MPI_INT, source, TERMINATE_TAG, MPI_COMM_WORLD, &status);
+}
+
+/**
+ * Migrations between sub-masters are sent without blocking, as two sub-masters may be
+ * sending to each other at the same time. Each keeps its buffer until the send completes.
+ */
+class PendingMigrations {
+    private:
+        vector<MPI_Request> requests;
+        vector<char*> buffers;
+
+    public:
+        void send_genome_to(int32_t target, RNN_Genome *genome) {
+            char *byte_array;
+            int32_t length;
+            genome->write_to_array(&byte_array, length);
+
+            Log::debug("migrating genome of length: %d to sub-master: %d\n", length, target);
+
+            MPI_Request request;
+            MPI_Isend(byte_array, length, MPI_CHAR, target, MIGRATION_TAG, MPI_COMM_WORLD, &request);
+            requests.push_back(request);
+            buffers.push_back(byte_array);
+        }
+
+        void send_done_to(int32_t target) {
+            MPI_Request request;
+            MPI_Isend(NULL, 0, MPI_CHAR, target, MIGRATION_DONE_TAG, MPI_COMM_WORLD, &request);
+            requests.push_back(request);
+            buffers.push_back(NULL);
+        }
+
+        /**
+         * Frees the buffers of the sends which have completed.
+         */
+        void test() {
+            for (int32_t i = (int32_t)requests.size() - 1; i >= 0; i--) {
+                int32_t completed = 0;
+                MPI_Test(&requests[i], &completed, MPI_STATUS_IGNORE);
+                if (completed) {
+                    if (buffers[i] != NULL) free(buffers[i]);
+                    requests.erase(requests.begin() + i);
+                    buffers.erase(buffers.begin() + i);
+                }
+            }
+        }
+
+        void wait_all() {
+            MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+            for (int32_t i = 0; i < (int32_t)buffers.size(); i++) {
+                if (buffers[i] != NULL) free(buffers[i]);
+            }
+            requests.clear();
+            buffers.clear();
+        }
+};
+
+RNN_Genome* receive_migrated_genome(int32_t source, MPI_Status &status) {
+    int32_t length;
+    MPI_Get_count(&status, MPI_CHAR, &length);
+
+    char* genome_str = new char[length + 1];
+    MPI_Recv(genome_str, length, MPI_CHAR, source, MIGRATION_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    genome_str[length] = '\0';
+
+    RNN_Genome* genome = new RNN_Genome(genome_str, length);
+
+    delete [] genome_str;
+    return genome;
+}
+
+/**
+ * A sub-master runs its own EXAMM instance (with its share of the islands) for its group
+ * of workers, using the same protocol as the single master in examm_mpi. Every
+ * migration_interval inserted genomes it sends its best genome (if it has improved since
+ * the last migration) to another randomly selected sub-master, the same way inter-island
+ * crossover selects another island to take the best genome from.
+ */
+void sub_master(int32_t rank, int32_t number_sub_masters, int32_t number_workers, int32_t migration_interval) {
+    //the "main" id will have already been set by the main function so we do not need to re-set it here
+    minstd_rand0 generator(generate_random_seed());
+    uniform_real_distribution<double> rng_0_1(0.0, 1.0);
+
+    PendingMigrations pending_migrations;
+    double migrated_fitness = EXAMM_MAX_DOUBLE;
+    int32_t inserted_genomes = 0;
+
+    int32_t terminates_sent = 0;
+    int32_t done_received = 0;
+    bool done = (number_workers == 0);
+
+    if (done) {
+        for (int32_t i = 0; i < number_sub_masters; i++) {
+            if (i != rank) pending_migrations.send_done_to(i);
+        }
+    }
+
+    //after its own workers have finished, a sub-master still receives (and discards) migrations
+    //until every other sub-master has finished, so no migration is left unreceived
+    while (!done || done_received < number_sub_masters - 1) {
+        MPI_Status status;
+        {
+            ScopedTimer timer(PerformanceLog::MPI_WAIT);
+            MPI_Probe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
+        }
+
+        int32_t source = status.MPI_SOURCE;
+        int32_t tag = status.MPI_TAG;
+        Log::debug("probe returned message from: %d with tag: %d\n", source, tag);
+
+        if (tag == WORK_REQUEST_TAG) {
+            receive_work_request(source);
+
+            RNN_Genome *genome = examm->generate_genome();
+
+            if (genome == NULL) { //search was completed if it returns NULL for an individual
+                Log::info("terminating worker: %d\n", source);
+                send_terminate_message(source);
+                terminates_sent++;
+
+                if (terminates_sent >= number_workers) {
+                    done = true;
+                    for (int32_t i = 0; i < number_sub_masters; i++) {
+                        if (i != rank) pending_migrations.send_done_to(i);
+                    }
+                }
+            } else {
+                Log::debug("sending genome to: %d\n", source);
+                send_genome_to(source, genome);
+
+                //delete this genome as it will not be used again
+                delete genome;
+            }
+
+        } else if (tag == GENOME_LENGTH_TAG) {
+            Log::debug("received genome from: %d\n", source);
+            RNN_Genome *genome = receive_genome_from(source);
+
+            examm->insert_genome(genome);
+            inserted_genomes++;
+
+            //delete the genome as it won't be used again, a copy was inserted
+            delete genome;
+
+            if (number_sub_masters > 1 && inserted_genomes % migration_interval == 0) {
+                RNN_Genome *best_genome = examm->get_best_genome();
+                if (best_genome != NULL && best_genome->get_fitness() < migrated_fitness) {
+                    int32_t target = rng_0_1(generator) * (number_sub_masters - 1);
+                    if (target >= rank) target++;
+
+                    Log::info("migrating best genome (fitness: %lf) to sub-master: %d\n", best_genome->get_fitness(), target);
+                    pending_migrations.send_genome_to(target, best_genome);
+                    migrated_fitness = best_genome->get_fitness();
+                }
+            }
+            pending_migrations.test();
+
+        } else if (tag == MIGRATION_TAG) {
+            RNN_Genome *genome = receive_migrated_genome(source, status);
+
+            if (!done) {
+                Log::info("received migrated genome (fitness: %lf) from sub-master: %d\n", genome->get_fitness(), source);
+                examm->insert_migrated_genome(genome);
+            }
+            delete genome;
+
+        } else if (tag == MIGRATION_DONE_TAG) {
+            MPI_Recv(NULL, 0, MPI_CHAR, source, MIGRATION_DONE_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            done_received++;
+            Log::debug("sub-master %d finished, %d of %d other sub-masters done\n", source, done_received, number_sub_masters - 1);
+
+        } else {
+            Log::fatal("ERROR: received message from %d with unknown tag: %d", source, tag);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+
+    pending_migrations.wait_all();
+}
+
+void worker(int32_t rank, int32_t sub_master) {
+    Log::set_id("worker_" + to_string(rank));
+
+    while (true) {
+        Log::debug("sending work request!\n");
+        send_work_request(sub_master);
+        Log::debug("sent work request!\n");
+
+        MPI_Status status;
+        {
+            ScopedTimer timer(PerformanceLog::MPI_WAIT);
+            MPI_Probe(sub_master, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
+        }
+        int32_t tag = status.MPI_TAG;
+
+        Log::debug("probe received message with tag: %d\n", tag);
+
+        if (tag == TERMINATE_TAG) {
+            Log::debug("received terminate tag!\n");
+            receive_terminate_message(sub_master);
+            break;
+
+        } else if (tag == GENOME_LENGTH_TAG) {
+            Log::debug("received genome!\n");
+            RNN_Genome* genome = receive_genome_from(sub_master);
+
+            //have each worker write the backproagation to a separate log file
+            string log_id = "genome_" + to_string(genome->get_generation_id()) + "_worker_" + to_string(rank);
+            Log::set_id(log_id);
+            bool low_fidelity = genome->get_fidelity() == RNN_Genome::LOW_FIDELITY;
+            genome->backpropagate_stochastic(low_fidelity ? low_fidelity_inputs : training_inputs, low_fidelity ? low_fidelity_outputs : training_outputs, validation_inputs, validation_outputs, weight_update_method, sequence_windows);
+            Log::release_id(log_id);
+
+            //go back to the worker's log for MPI communication
+            Log::set_id("worker_" + to_string(rank));
+
+            send_genome_to(sub_master, genome);
+
+            delete genome;
+        } else {
+            Log::fatal("ERROR: received message with unknown tag: %d\n", tag);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+
+    //release the log file for the worker communication
+    Log::release_id("worker_" + to_string(rank));
+}
+
+int main(int argc, char** argv) {
+    MPI_Init(&argc, &argv);
+    int32_t rank, max_rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &max_rank);
+    arguments = vector<string>(argv, argv + argc);
+
+    Log::initialize(arguments);
+    Log::set_rank(rank);
+    Log::set_id("main_" + to_string(rank));
+    Log::restrict_to_rank(0);
+    PerformanceLog::initialize(arguments);
+
+    int32_t number_sub_masters = 1;
+    get_argument(arguments, "--number_sub_masters", false, number_sub_masters);
+    int32_t migration_interval = 100;
+    get_argument(arguments, "--migration_interval", false, migration_interval);
+
+    int32_t number_islands;
+    get_argument(arguments, "--number_islands", true, number_islands);
+    int32_t max_genomes;
+    get_argument(arguments, "--max_genomes", true, max_genomes);
+    string output_directory = "";
+    get_argument(arguments, "--output_directory", false, output_directory);
+
+    if (number_sub_masters > 1 && get_innovation_number_offset(number_sub_masters - 1) < 0) {
+        Log::fatal("ERROR: --number_sub_masters was %d but can be at most %d, as each sub-master needs its own range of %d innovation numbers\n", number_sub_masters, (int32_t)(((int64_t)INT32_MAX + 1) / INNOVATION_NUMBERS_PER_SUB_MASTER), INNOVATION_NUMBERS_PER_SUB_MASTER);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    if (number_sub_masters < 1 || max_rank < number_sub_masters * 2) {
+        Log::fatal("ERROR: --number_sub_masters was %d but needs to be at least 1, with at least one worker for each (%d processes)\n", number_sub_masters, max_rank);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    if (number_islands < number_sub_masters) {
+        Log::fatal("ERROR: --number_islands (%d) needs to be at least --number_sub_masters (%d), so each sub-master has an island\n", number_islands, number_sub_masters);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    if (migration_interval < 1) {
+        Log::fatal("ERROR: --migration_interval was %d but needs to be at least 1\n", migration_interval);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    int32_t group = get_sub_master(rank, number_sub_masters);
+
+    //each group gets a different (but reproducible) run seed, so the sub-masters don't all evolve the same genomes
+    if (initialize_random_seed(arguments)) set_random_seed(get_random_seed() + group);
+
+    TimeSeriesSets *time_series_sets = NULL;
+    time_series_sets = TimeSeriesSets::generate_from_arguments(arguments);
+    get_train_validation_data(arguments, time_series_sets, training_inputs, training_outputs, validation_inputs, validation_outputs);
+    get_low_fidelity_data(arguments, training_inputs, training_outputs, low_fidelity_inputs, low_fidelity_outputs);
+
+    weight_update_method = new WeightUpdate();
+    weight_update_method->generate_from_arguments(arguments);
+    sequence_windows = SequenceWindows::generate_from_arguments(arguments);
+
+    WeightRules *weight_rules = new WeightRules();
+    weight_rules->generate_weight_initialize_from_arguments(arguments);
+
+    RNN_Genome *seed_genome = get_seed_genome(arguments, time_series_sets, weight_rules);
+
+    Log::clear_rank_restriction();
+
+    if (rank < number_sub_masters) {
+        //each sub-master runs EXAMM over its share of the islands and genomes
+        vector<string> sub_master_arguments = arguments;
+        set_argument(sub_master_arguments, "--number_islands", to_string(get_share(number_islands, rank, number_sub_masters)));
+        set_argument(sub_master_arguments, "--max_genomes", to_string(get_share(max_genomes, rank, number_sub_masters)));
+        set_argument(sub_master_arguments, "--innovation_number_offset", to_string(get_innovation_number_offset(rank)));
+        if (output_directory != "") {
+            set_argument(sub_master_arguments, "--output_directory", output_directory + "/sub_master_" + to_string(rank));
+        }
+
+        if (rank == 0) write_time_series_to_file(arguments, time_series_sets);
+        examm = generate_examm_from_arguments(sub_master_arguments, time_series_sets, weight_rules, seed_genome);
+        sub_master(rank, number_sub_masters, get_number_workers(rank, number_sub_masters, max_rank), migration_interval);
+    } else {
+        worker(rank, group);
+    }
+    Log::set_id("main_" + to_string(rank));
+
+    if (output_directory != "") {
+        PerformanceLog::write_summary(output_directory + "/performance_summary_rank_" + to_string(rank) + ".csv");
+    }
+    Log::debug("rank %d completed!\n", rank);
+    Log::release_id("main_" + to_string(rank));
+    MPI_Finalize();
+
+    delete time_series_sets;
+    return 0;
+}
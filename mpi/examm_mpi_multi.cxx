@@ -43,10 +43,10 @@ EXAMM *examm;
 
 WeightUpdate *weight_update_method;
 
-vector< vector< vector<double> > > training_inputs;
-vector< vector< vector<double> > > training_outputs;
-vector< vector< vector<double> > > validation_inputs;
-vector< vector< vector<double> > > validation_outputs;
+vector<SeriesTensor> training_inputs;
+vector<SeriesTensor> training_outputs;
+vector<SeriesTensor> validation_inputs;
+vector<SeriesTensor> validation_outputs;
 
 int32_t global_slice;
 int32_t global_repeat;
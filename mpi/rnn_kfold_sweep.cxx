@@ -360,10 +360,10 @@ ResultSet handle_job(int32_t rank, int32_t current_job) {
     time_series_sets->set_training_indexes(training_indexes);
     time_series_sets->set_test_indexes(test_indexes);
 
-    vector< vector< vector<double> > > training_inputs;
-    vector< vector< vector<double> > > training_outputs;
-    vector< vector< vector<double> > > validation_inputs;
-    vector< vector< vector<double> > > validation_outputs;
+    vector<SeriesTensor> training_inputs;
+    vector<SeriesTensor> training_outputs;
+    vector<SeriesTensor> validation_inputs;
+    vector<SeriesTensor> validation_outputs;
 
     time_series_sets->export_training_series(time_offset, training_inputs, training_outputs);
     time_series_sets->export_test_series(time_offset, validation_inputs, validation_outputs);
@@ -0,0 +1,111 @@
+#include <vector>
+using std::vector;
+
+#include "mpi.h"
+
+#include "common/log.hxx"
+#include "mpi/shared_series_data.hxx"
+
+SharedSeriesData::SharedSeriesData(MPI_Comm node_comm, const vector< const vector<SeriesTensor>* > &sets) {
+    int32_t node_rank;
+    MPI_Comm_rank(node_comm, &node_rank);
+
+    //the node leader sends the shape of every series to the other ranks on the node, as
+    //the number of series in each set followed by each series' parameters, time steps
+    //and layout
+    vector<int32_t> shape;
+    if (node_rank == 0) {
+        for (int32_t i = 0; i < (int32_t)sets.size(); i++) {
+            const vector<SeriesTensor> &set = *sets[i];
+            shape.push_back(set.size());
+            for (int32_t j = 0; j < (int32_t)set.size(); j++) {
+                shape.push_back(set[j].get_number_parameters());
+                shape.push_back(set[j].get_number_timesteps());
+                shape.push_back(set[j].get_time_stride() == 1 ? SeriesTensor::PARAMETER_MAJOR : SeriesTensor::TIME_MAJOR);
+            }
+        }
+    }
+
+    int32_t shape_size = shape.size();
+    MPI_Bcast(&shape_size, 1, MPI_INT, 0, node_comm);
+    shape.resize(shape_size);
+    MPI_Bcast(shape.data(), shape_size, MPI_INT, 0, node_comm);
+
+    int64_t total_size = 0;
+    int32_t position = 0;
+    for (int32_t i = 0; i < (int32_t)sets.size(); i++) {
+        int32_t number_series = shape[position++];
+        number_parameters.push_back(vector<int32_t>(number_series));
+        number_timesteps.push_back(vector<int32_t>(number_series));
+        layouts.push_back(vector<int32_t>(number_series));
+        series_offsets.push_back(vector<int64_t>(number_series));
+
+        for (int32_t j = 0; j < number_series; j++) {
+            number_parameters[i][j] = shape[position++];
+            number_timesteps[i][j] = shape[position++];
+            layouts[i][j] = shape[position++];
+            series_offsets[i][j] = total_size;
+            total_size += (int64_t)number_parameters[i][j] * number_timesteps[i][j];
+        }
+    }
+
+    //only the node leader allocates memory for the window, the other ranks get a pointer to it
+    double *local_data;
+    MPI_Win_allocate_shared(node_rank == 0 ? total_size * sizeof(double) : 0, sizeof(double), MPI_INFO_NULL, node_comm, &local_data, &window);
+
+    MPI_Aint leader_size;
+    int32_t displacement_unit;
+    MPI_Win_shared_query(window, 0, &leader_size, &displacement_unit, &data);
+
+    MPI_Win_fence(0, window);
+    if (node_rank == 0) {
+        Log::info("copying %ld time series values (%.2lf MB) into the node's shared memory\n", (long)total_size, (total_size * sizeof(double)) / (1024.0 * 1024.0));
+
+        for (int32_t i = 0; i < (int32_t)sets.size(); i++) {
+            const vector<SeriesTensor> &set = *sets[i];
+            for (int32_t j = 0; j < (int32_t)set.size(); j++) {
+                SeriesTensor series = get_series(i, j);
+                for (int32_t k = 0; k < number_parameters[i][j]; k++) {
+                    for (int32_t l = 0; l < number_timesteps[i][j]; l++) {
+                        series.at(k, l) = set[j](k, l);
+                    }
+                }
+            }
+        }
+    }
+    MPI_Win_fence(0, window);
+}
+
+SharedSeriesData::~SharedSeriesData() {
+    MPI_Win_free(&window);
+}
+
+int32_t SharedSeriesData::get_number_series(int32_t set) const {
+    return number_parameters[set].size();
+}
+
+int32_t SharedSeriesData::get_number_parameters(int32_t set, int32_t series) const {
+    return number_parameters[set][series];
+}
+
+int32_t SharedSeriesData::get_number_timesteps(int32_t set, int32_t series) const {
+    return number_timesteps[set][series];
+}
+
+SeriesTensor SharedSeriesData::get_series(int32_t set, int32_t series) const {
+    int32_t parameters = number_parameters[set][series];
+    int32_t timesteps = number_timesteps[set][series];
+
+    if (layouts[set][series] == SeriesTensor::TIME_MAJOR) {
+        return SeriesTensor::view(data + series_offsets[set][series], parameters, timesteps, 1, parameters);
+    } else {
+        return SeriesTensor::view(data + series_offsets[set][series], parameters, timesteps, timesteps, 1);
+    }
+}
+
+void SharedSeriesData::get_set(int32_t set, vector<SeriesTensor> &series) const {
+    series.resize(get_number_series(set));
+    for (int32_t j = 0; j < (int32_t)series.size(); j++) {
+        series[j] = get_series(set, j);
+    }
+}
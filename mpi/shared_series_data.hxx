@@ -0,0 +1,56 @@
+#ifndef EXAMM_SHARED_SERIES_DATA_HXX
+#define EXAMM_SHARED_SERIES_DATA_HXX
+
+#include <cstdint>
+
+#include <vector>
+using std::vector;
+
+#include "mpi.h"
+
+#include "time_series/series_tensor.hxx"
+
+/**
+ * One read-only copy of a set of time series data sets (e.g., the training and validation
+ * inputs and outputs) shared by all the ranks on a node through an MPI-3 shared memory
+ * window. The data is stored flat, each series following the previous one in the same
+ * layout (parameter or time major) as the tensor it was copied from.
+ */
+class SharedSeriesData {
+    private:
+        MPI_Win window;
+        double *data;
+
+        vector< vector<int32_t> > number_parameters;
+        vector< vector<int32_t> > number_timesteps;
+        vector< vector<int32_t> > layouts;
+        vector< vector<int64_t> > series_offsets;
+
+    public:
+        /**
+         * Collective over node_comm. Rank 0 of node_comm copies the data sets into the shared
+         * window, the other ranks only need to pass the same number of (empty) data sets.
+         *
+         * \param node_comm is a communicator of the ranks on this node, e.g., from
+         *      MPI_Comm_split_type with MPI_COMM_TYPE_SHARED
+         * \param sets are the data sets, each a vector of series
+         */
+        SharedSeriesData(MPI_Comm node_comm, const vector< const vector<SeriesTensor>* > &sets);
+        ~SharedSeriesData();
+
+        int32_t get_number_series(int32_t set) const;
+        int32_t get_number_parameters(int32_t set, int32_t series) const;
+        int32_t get_number_timesteps(int32_t set, int32_t series) const;
+
+        /**
+         * \return a view of the series in the shared window, which is valid until this is deleted
+         */
+        SeriesTensor get_series(int32_t set, int32_t series) const;
+
+        /**
+         * Replaces series with views of every series of a data set in the shared window.
+         */
+        void get_set(int32_t set, vector<SeriesTensor> &series) const;
+};
+
+#endif
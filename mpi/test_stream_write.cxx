@@ -42,10 +42,10 @@ EXAMM *examm;
 
 bool finished = false;
 
-vector< vector< vector<double> > > training_inputs;
-vector< vector< vector<double> > > training_outputs;
-vector< vector< vector<double> > > validation_inputs;
-vector< vector< vector<double> > > validation_outputs;
+vector<SeriesTensor> training_inputs;
+vector<SeriesTensor> training_outputs;
+vector<SeriesTensor> validation_inputs;
+vector<SeriesTensor> validation_outputs;
 
 int main(int argc, char** argv) {
     std::cout << "starting up!" << std::endl;
@@ -2,6 +2,9 @@
 #include <condition_variable>
 using std::condition_variable;
 
+#include <cstdio>
+using std::fprintf;
+
 #include <iomanip>
 using std::setw;
 
@@ -17,10 +20,15 @@ using std::thread;
 #include <vector>
 using std::vector;
 
+#include <sys/resource.h>
+
 #include "common/log.hxx"
+#include "common/performance_log.hxx"
 #include "common/process_arguments.hxx"
+#include "common/random.hxx"
 #include "examm/examm.hxx"
 #include "rnn/generate_nn.hxx"
+#include "time_series/sequence_windows.hxx"
 #include "time_series/time_series.hxx"
 #include "weights/weight_rules.hxx"
 #include "weights/weight_update.hxx"
@@ -35,16 +43,35 @@ WeightUpdate* weight_update_method;
 
 bool finished = false;
 
-vector<vector<vector<double> > > training_inputs;
-vector<vector<vector<double> > > training_outputs;
-vector<vector<vector<double> > > validation_inputs;
-vector<vector<vector<double> > > validation_outputs;
+vector<SeriesTensor> training_inputs;
+vector<SeriesTensor> training_outputs;
+vector<SeriesTensor> validation_inputs;
+vector<SeriesTensor> validation_outputs;
+
+//the subset of the training series low fidelity genomes are trained on
+vector<SeriesTensor> low_fidelity_inputs;
+vector<SeriesTensor> low_fidelity_outputs;
+
+SequenceWindows* sequence_windows = NULL;
+
+//time each thread spends generating/inserting genomes (the master's work) vs training them
+vector<double> master_seconds;
+vector<double> worker_seconds;
+vector<int32_t> genomes_evaluated;
+
+double seconds_since(std::chrono::time_point<std::chrono::steady_clock> start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
 
 void examm_thread(int32_t id) {
+    PerformanceLog::set_thread_name("thread_" + to_string(id));
+
     while (true) {
         examm_mutex.lock();
+        auto start = std::chrono::steady_clock::now();
         Log::set_id("main");
         RNN_Genome* genome = examm->generate_genome();
+        master_seconds[id] += seconds_since(start);
         examm_mutex.unlock();
 
         if (genome == NULL) {
@@ -53,15 +80,22 @@ void examm_thread(int32_t id) {
 
         string log_id = "genome_" + to_string(genome->get_generation_id()) + "_thread_" + to_string(id);
         Log::set_id(log_id);
+        start = std::chrono::steady_clock::now();
         // genome->backpropagate(training_inputs, training_outputs, validation_inputs, validation_outputs);
+        bool low_fidelity = genome->get_fidelity() == RNN_Genome::LOW_FIDELITY;
         genome->backpropagate_stochastic(
-            training_inputs, training_outputs, validation_inputs, validation_outputs, weight_update_method
+            low_fidelity ? low_fidelity_inputs : training_inputs, low_fidelity ? low_fidelity_outputs : training_outputs,
+            validation_inputs, validation_outputs, weight_update_method, sequence_windows
         );
+        worker_seconds[id] += seconds_since(start);
         Log::release_id(log_id);
 
         examm_mutex.lock();
+        start = std::chrono::steady_clock::now();
         Log::set_id("main");
         examm->insert_genome(genome);
+        master_seconds[id] += seconds_since(start);
+        genomes_evaluated[id]++;
         examm_mutex.unlock();
 
         delete genome;
@@ -86,26 +120,39 @@ int main(int argc, char** argv) {
 
     Log::initialize(arguments);
     Log::set_id("main");
+    PerformanceLog::initialize(arguments);
 
     int32_t number_threads;
     get_argument(arguments, "--number_threads", true, number_threads);
 
+    initialize_random_seed(arguments);
+
+    string benchmark_filename = "";
+    get_argument(arguments, "--benchmark_file", false, benchmark_filename);
+
     TimeSeriesSets* time_series_sets = NULL;
     time_series_sets = TimeSeriesSets::generate_from_arguments(arguments);
     get_train_validation_data(
         arguments, time_series_sets, training_inputs, training_outputs, validation_inputs, validation_outputs
     );
+    get_low_fidelity_data(arguments, training_inputs, training_outputs, low_fidelity_inputs, low_fidelity_outputs);
 
     weight_update_method = new WeightUpdate();
     weight_update_method->generate_from_arguments(arguments);
+    sequence_windows = SequenceWindows::generate_from_arguments(arguments);
 
     WeightRules* weight_rules = new WeightRules();
-    weight_rules->initialize_from_args(arguments);
+    weight_rules->generate_weight_initialize_from_arguments(arguments);
 
     RNN_Genome* seed_genome = get_seed_genome(arguments, time_series_sets, weight_rules);
 
     examm = generate_examm_from_arguments(arguments, time_series_sets, weight_rules, seed_genome);
 
+    master_seconds.assign(number_threads, 0.0);
+    worker_seconds.assign(number_threads, 0.0);
+    genomes_evaluated.assign(number_threads, 0);
+    auto search_start = std::chrono::steady_clock::now();
+
     vector<thread> threads;
     for (int32_t i = 0; i < number_threads; i++) {
         threads.push_back(thread(examm_thread, i));
@@ -117,6 +164,36 @@ int main(int argc, char** argv) {
 
     finished = true;
 
+    double total_seconds = seconds_since(search_start);
+    double total_master_seconds = 0.0, total_worker_seconds = 0.0;
+    int32_t total_genomes = 0;
+    for (int32_t i = 0; i < number_threads; i++) {
+        total_master_seconds += master_seconds[i];
+        total_worker_seconds += worker_seconds[i];
+        total_genomes += genomes_evaluated[i];
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    //ru_maxrss is in kilobytes on linux
+    double peak_rss_mb = usage.ru_maxrss / 1024.0;
+
+    Log::info("evaluated %d genomes in %lf seconds (%lf genomes/sec), master time: %lf s, worker time: %lf s, peak RSS: %lf MB, best fitness: %lf\n",
+            total_genomes, total_seconds, total_genomes / total_seconds, total_master_seconds, total_worker_seconds, peak_rss_mb, examm->get_best_fitness());
+
+    if (benchmark_filename != "") {
+        FILE *benchmark_file = fopen(benchmark_filename.c_str(), "w");
+        if (benchmark_file == NULL) {
+            Log::error("could not open benchmark file '%s' for writing\n", benchmark_filename.c_str());
+        } else {
+            fprintf(benchmark_file, "{\"number_threads\": %d, \"genomes\": %d, \"seconds\": %lf, \"genomes_per_second\": %lf, \"master_seconds\": %lf, \"worker_seconds\": %lf, \"peak_rss_mb\": %lf, \"best_fitness\": %.10lf}\n",
+                    number_threads, total_genomes, total_seconds, total_genomes / total_seconds, total_master_seconds, total_worker_seconds, peak_rss_mb, examm->get_best_fitness());
+            fclose(benchmark_file);
+        }
+    }
+
+    PerformanceLog::write_summary(examm->get_output_directory() + "/performance_summary.csv");
+
     Log::info("completed!\n");
     Log::release_id("main");
 
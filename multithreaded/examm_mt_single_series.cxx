@@ -44,10 +44,10 @@ bool finished = false;
 
 string output_directory = "";
 
-vector<vector<vector<double> > > training_inputs;
-vector<vector<vector<double> > > training_outputs;
-vector<vector<vector<double> > > validation_inputs;
-vector<vector<vector<double> > > validation_outputs;
+vector<SeriesTensor> training_inputs;
+vector<SeriesTensor> training_outputs;
+vector<SeriesTensor> validation_inputs;
+vector<SeriesTensor> validation_outputs;
 
 void examm_thread(int32_t id) {
     while (true) {
@@ -118,7 +118,7 @@ int main(int argc, char** argv) {
     weight_update_method->generate_from_arguments(arguments);
 
     WeightRules* weight_rules = new WeightRules();
-    weight_rules->initialize_from_args(arguments);
+    weight_rules->generate_weight_initialize_from_arguments(arguments);
 
     RNN_Genome* seed_genome = get_seed_genome(arguments, time_series_sets, weight_rules);
 
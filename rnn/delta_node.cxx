@@ -25,9 +25,16 @@ using std::vector;
 
 
 #define NUMBER_DELTA_WEIGHTS 6
+#define DELTA_ALPHA 0
+#define DELTA_BETA1 1
+#define DELTA_BETA2 2
+#define DELTA_V 3
+#define DELTA_R_BIAS 4
+#define DELTA_Z_HAT_BIAS 5
 
 Delta_Node::Delta_Node(int32_t _innovation_number, int32_t _type, double _depth) : RNN_Node_Interface(_innovation_number, _type, _depth) {
     node_type = DELTA_NODE;
+    initialize_weight_storage(NUMBER_DELTA_WEIGHTS);
 }
 
 Delta_Node::~Delta_Node() {
@@ -35,65 +42,59 @@ Delta_Node::~Delta_Node() {
 
 void Delta_Node::initialize_lamarckian(minstd_rand0 &generator, NormalDistribution &normal_distribution, double mu, double sigma) {
 
-    alpha = bound(normal_distribution.random(generator, mu, sigma));
-    beta1 = bound(normal_distribution.random(generator, mu, sigma));
-    beta2 = bound(normal_distribution.random(generator, mu, sigma));
-    v = bound(normal_distribution.random(generator, mu, sigma));
-    r_bias = bound(normal_distribution.random(generator, mu, sigma));
-    z_hat_bias = bound(normal_distribution.random(generator, mu, sigma));
+    weights[DELTA_ALPHA] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[DELTA_BETA1] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[DELTA_BETA2] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[DELTA_V] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[DELTA_R_BIAS] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[DELTA_Z_HAT_BIAS] = bound(normal_distribution.random(generator, mu, sigma));
 }
 
 void Delta_Node::initialize_xavier(minstd_rand0 &generator, uniform_real_distribution<double> &rng_1_1, double range) {
 
-    alpha = range * (rng_1_1(generator));
-    beta1 = range * (rng_1_1(generator));
-    beta2 = range * (rng_1_1(generator));
-    v = range * (rng_1_1(generator));
-    r_bias = range * (rng_1_1(generator));
-    z_hat_bias = range * (rng_1_1(generator));
+    weights[DELTA_ALPHA] = range * (rng_1_1(generator));
+    weights[DELTA_BETA1] = range * (rng_1_1(generator));
+    weights[DELTA_BETA2] = range * (rng_1_1(generator));
+    weights[DELTA_V] = range * (rng_1_1(generator));
+    weights[DELTA_R_BIAS] = range * (rng_1_1(generator));
+    weights[DELTA_Z_HAT_BIAS] = range * (rng_1_1(generator));
 }
 
 void Delta_Node::initialize_kaiming(minstd_rand0 &generator, NormalDistribution &normal_distribution, double range){
-    alpha = range * normal_distribution.random(generator, 0, 1);
-    beta1 = range * normal_distribution.random(generator, 0, 1);
-    beta2 = range * normal_distribution.random(generator, 0, 1);
-    v = range * normal_distribution.random(generator, 0, 1);
-    r_bias = range * normal_distribution.random(generator, 0, 1);
-    z_hat_bias = range * normal_distribution.random(generator, 0, 1);
+    weights[DELTA_ALPHA] = range * normal_distribution.random(generator, 0, 1);
+    weights[DELTA_BETA1] = range * normal_distribution.random(generator, 0, 1);
+    weights[DELTA_BETA2] = range * normal_distribution.random(generator, 0, 1);
+    weights[DELTA_V] = range * normal_distribution.random(generator, 0, 1);
+    weights[DELTA_R_BIAS] = range * normal_distribution.random(generator, 0, 1);
+    weights[DELTA_Z_HAT_BIAS] = range * normal_distribution.random(generator, 0, 1);
 }
 
 void Delta_Node::initialize_uniform_random(minstd_rand0 &generator, uniform_real_distribution<double> &rng) {
-    alpha = rng(generator);
-    beta1 = rng(generator);
-    beta2 = rng(generator);
-    v = rng(generator);
-    r_bias = rng(generator);
-    z_hat_bias = rng(generator);
+    weights[DELTA_ALPHA] = rng(generator);
+    weights[DELTA_BETA1] = rng(generator);
+    weights[DELTA_BETA2] = rng(generator);
+    weights[DELTA_V] = rng(generator);
+    weights[DELTA_R_BIAS] = rng(generator);
+    weights[DELTA_Z_HAT_BIAS] = rng(generator);
 }
 
 double Delta_Node::get_gradient(string gradient_name) {
-    double gradient_sum = 0.0;
-
-    for (int32_t i = 0; i < series_length; i++ ) {
-        if (gradient_name == "alpha") {
-            gradient_sum += d_alpha[i];
-        } else if (gradient_name == "beta1") {
-            gradient_sum += d_beta1[i];
-        } else if (gradient_name == "beta2") {
-            gradient_sum += d_beta2[i];
-        } else if (gradient_name == "v") {
-            gradient_sum += d_v[i];
-        } else if (gradient_name == "r_bias") {
-            gradient_sum += d_r_bias[i];
-        } else if (gradient_name == "z_hat_bias") {
-            gradient_sum += d_z_hat_bias[i];
-        } else {
-            Log::fatal("ERROR: tried to get unknown gradient: '%s'\n", gradient_name.c_str());
-            exit(1);
-        }
+    if (gradient_name == "alpha") {
+        return d_weights[DELTA_ALPHA];
+    } else if (gradient_name == "beta1") {
+        return d_weights[DELTA_BETA1];
+    } else if (gradient_name == "beta2") {
+        return d_weights[DELTA_BETA2];
+    } else if (gradient_name == "v") {
+        return d_weights[DELTA_V];
+    } else if (gradient_name == "r_bias") {
+        return d_weights[DELTA_R_BIAS];
+    } else if (gradient_name == "z_hat_bias") {
+        return d_weights[DELTA_Z_HAT_BIAS];
+    } else {
+        Log::fatal("ERROR: tried to get unknown gradient: '%s'\n", gradient_name.c_str());
+        exit(1);
     }
-
-    return gradient_sum;
 }
 
 void Delta_Node::print_gradient(string gradient_name) {
@@ -112,26 +113,26 @@ void Delta_Node::input_fired(int32_t time, double incoming_output) {
     }
 
     //update alpha, beta1, beta2 so they're centered around 2, 1 and 1
-    alpha += 2;
-    beta1 += 1;
-    beta2 += 1;
+    weights[DELTA_ALPHA] += 2;
+    weights[DELTA_BETA1] += 1;
+    weights[DELTA_BETA2] += 1;
 
     double d2 = input_values[time];
 
     double z_prev = 0.0;
     if (time > 0) z_prev = output_values[time - 1];
 
-    double d1 = v * z_prev;
+    double d1 = weights[DELTA_V] * z_prev;
 
-    double z_hat_1 = d1 * d2 * alpha;
-    double z_hat_2 = d1 * beta1;
+    double z_hat_1 = d1 * d2 * weights[DELTA_ALPHA];
+    double z_hat_2 = d1 * weights[DELTA_BETA1];
 
-    double z_hat_3 = d2 * beta2;
-    double z_hat_sum = z_hat_1 + z_hat_2 + z_hat_3 + z_hat_bias;
+    double z_hat_3 = d2 * weights[DELTA_BETA2];
+    double z_hat_sum = z_hat_1 + z_hat_2 + z_hat_3 + weights[DELTA_Z_HAT_BIAS];
     z_cap[time] = tanh(z_hat_sum);
     ld_z_cap[time] = tanh_derivative(z_cap[time]);
 
-    double input_r_bias = d2 + r_bias;
+    double input_r_bias = d2 + weights[DELTA_R_BIAS];
     r[time] = sigmoid(input_r_bias);
     ld_r[time] = sigmoid_derivative(r[time]);
 
@@ -146,9 +147,9 @@ void Delta_Node::input_fired(int32_t time, double incoming_output) {
 
     //reset alpha, beta1, beta2 so they don't mess with mean/stddev calculations for
     //parameter generation
-    alpha -= 2.0;
-    beta1 -= 1.0;
-    beta2 -= 1.0;
+    weights[DELTA_ALPHA] -= 2.0;
+    weights[DELTA_BETA1] -= 1.0;
+    weights[DELTA_BETA2] -= 1.0;
 }
 
 void Delta_Node::try_update_deltas(int32_t time) {
@@ -159,9 +160,9 @@ void Delta_Node::try_update_deltas(int32_t time) {
     }
 
     //update the alpha and betas to be their actual value
-    alpha += 2.0;
-    beta1 += 1.0;
-    beta2 += 1.0;
+    weights[DELTA_ALPHA] += 2.0;
+    weights[DELTA_BETA1] += 1.0;
+    weights[DELTA_BETA2] += 1.0;
 
     double error = error_values[time];
     double d2 = input_values[time];
@@ -181,32 +182,32 @@ void Delta_Node::try_update_deltas(int32_t time) {
     d_z_prev[time] = d_z * r[time];
 
     double d_r = ((d_z * z_cap[time] * -1) + (d_z * z_prev)) * ld_r[time];
-    d_r_bias[time] = d_r;
+    d_weights[DELTA_R_BIAS] += d_r;
     d_input[time] = d_r;
 
     double d_z_cap = d_z * ld_z_cap[time] * (1 - r[time]);
     //d_z_hat_bias route
-    d_z_hat_bias[time] = d_z_cap;
+    d_weights[DELTA_Z_HAT_BIAS] += d_z_cap;
 
     //z_hat_3 route
-    d_input[time] += d_z_cap * beta2;
-    d_beta2[time] = d_z_cap * d2;
+    d_input[time] += d_z_cap * weights[DELTA_BETA2];
+    d_weights[DELTA_BETA2] += d_z_cap * d2;
 
     //z_hat_1 route
-    double d1 = v * z_prev;
-    d_input[time] += d_z_cap * alpha * d1;
-    d_alpha[time] = d_z_cap * d2 * d1;
+    double d1 = weights[DELTA_V] * z_prev;
+    d_input[time] += d_z_cap * weights[DELTA_ALPHA] * d1;
+    d_weights[DELTA_ALPHA] += d_z_cap * d2 * d1;
 
     //z_hat_2 route
-    d_beta1[time] = d_z_cap * d1;
-    double d_d1 = (d_z_cap * beta1) + (d2 * alpha * d_z_cap);
-    d_v[time] = d_d1 * z_prev;
-    d_z_prev[time] += d_d1 * v;
+    d_weights[DELTA_BETA1] += d_z_cap * d1;
+    double d_d1 = (d_z_cap * weights[DELTA_BETA1]) + (d2 * weights[DELTA_ALPHA] * d_z_cap);
+    d_weights[DELTA_V] += d_d1 * z_prev;
+    d_z_prev[time] += d_d1 * weights[DELTA_V];
 
     //reset the alpha/betas to be around 0
-    alpha -= 2.0;
-    beta1 -= 1.0;
-    beta2 -= 1.0;
+    weights[DELTA_ALPHA] -= 2.0;
+    weights[DELTA_BETA1] -= 1.0;
+    weights[DELTA_BETA2] -= 1.0;
 }
 
 void Delta_Node::error_fired(int32_t time, double error) {
@@ -230,76 +231,10 @@ int32_t Delta_Node::get_number_weights() const {
     return NUMBER_DELTA_WEIGHTS;
 }
 
-void Delta_Node::get_weights(vector<double> &parameters) const {
-    parameters.resize(get_number_weights());
-    int32_t offset = 0;
-    get_weights(offset, parameters);
-}
-
-void Delta_Node::set_weights(const vector<double> &parameters) {
-    int32_t offset = 0;
-    set_weights(offset, parameters);
-}
-
-
-void Delta_Node::set_weights(int32_t &offset, const vector<double> &parameters) {
-    //int32_t start_offset = offset;
-
-    alpha = bound(parameters[offset++]);
-    beta1 = bound(parameters[offset++]);
-    beta2 = bound(parameters[offset++]);
-    v = bound(parameters[offset++]);
-
-    r_bias = bound(parameters[offset++]);
-    z_hat_bias = bound(parameters[offset++]);
-
-    //int32_t end_offset = offset;
-    //Log::trace("set weights from offset %d to %d on Delta_node %d\n", start_offset, end_offset, innovation_number);
-}
-
-void Delta_Node::get_weights(int32_t &offset, vector<double> &parameters) const {
-    //int32_t start_offset = offset;
-
-    parameters[offset++] = alpha;
-    parameters[offset++] = beta1;
-    parameters[offset++] = beta2;
-    parameters[offset++] = v;
-
-    parameters[offset++] = r_bias;
-    parameters[offset++] = z_hat_bias;
-
-    //int32_t end_offset = offset;
-    //Log::trace("got weights from offset %d to %d on Delta_node %d\n", start_offset, end_offset, innovation_number);
-}
-
-
-void Delta_Node::get_gradients(vector<double> &gradients) {
-    gradients.assign(NUMBER_DELTA_WEIGHTS, 0.0);
-
-    for (int32_t i = 0; i < NUMBER_DELTA_WEIGHTS; i++) {
-        gradients[i] = 0.0;
-    }
-
-    for (int32_t i = 0; i < series_length; i++) {
-        gradients[0] += d_alpha[i];
-        gradients[1] += d_beta1[i];
-        gradients[2] += d_beta2[i];
-        gradients[3] += d_v[i];
-
-        gradients[4] += d_r_bias[i];
-        gradients[5] += d_z_hat_bias[i];
-    }
-}
-
 void Delta_Node::reset(int32_t _series_length) {
     series_length = _series_length;
 
-    d_alpha.assign(series_length, 0.0);
-    d_beta1.assign(series_length, 0.0);
-    d_beta2.assign(series_length, 0.0);
-    d_v.assign(series_length, 0.0);
-    d_r_bias.assign(series_length, 0.0);
-    d_z_hat_bias.assign(series_length, 0.0);
+    for (int32_t i = 0; i < NUMBER_DELTA_WEIGHTS; i++) d_weights[i] = 0.0;
     d_z_prev.assign(series_length, 0.0);
 
     r.assign(series_length, 0.0);
@@ -322,12 +257,7 @@ RNN_Node_Interface* Delta_Node::copy() const {
     Delta_Node* n = new Delta_Node(innovation_number, layer_type, depth);
 
     //copy Delta_Node values
-    n->d_alpha = d_alpha;
-    n->d_beta1 = d_beta1;
-    n->d_beta2 = d_beta2;
-    n->d_v = d_v;
-    n->d_r_bias = d_r_bias;
-    n->d_z_hat_bias = d_z_hat_bias;
+    copy_weights_to(n);
     n->d_z_prev = d_z_prev;
 
     n->r = r;
@@ -13,11 +13,9 @@ DNASNode::DNASNode(
 )
     : RNN_Node_Interface(_innovation_number, _type, _depth),
       nodes(_nodes),
-      pi(vector<double>(nodes.size(), 1.0)),
       z(vector<double>(nodes.size())),
       x(vector<double>(nodes.size())),
       g(vector<double>(nodes.size())),
-      d_pi(vector<double>(nodes.size())),
       noise(vector<double>(nodes.size())),
       counter(counter) {
     node_type = DNAS_NODE;
@@ -26,6 +24,13 @@ DNASNode::DNASNode(
         node->total_inputs = 1;
         node->total_outputs = 1;
     }
+
+    initialize_weight_storage(get_number_weights());
+    for (int i = 0; i < nodes.size(); i++) {
+        weights[i] = 1.0;
+    }
+    set_node_weight_buffers();
+
     sample_gumbel_softmax(generator);
 }
 
@@ -38,8 +43,10 @@ DNASNode::DNASNode(const DNASNode& src) : RNN_Node_Interface(src.innovation_numb
 
     node_type = DNAS_NODE;
 
-    pi = src.pi;
-    d_pi = src.d_pi;
+    initialize_weight_storage(get_number_weights());
+    set_node_weight_buffers();
+    src.copy_weights_to(this);
+
     z = src.z;
     g = src.g;
     x = src.x;
@@ -79,8 +86,8 @@ void DNASNode::gumbel_noise(Rng& rng, vector<double>& output) {
 
 template <uniform_random_bit_generator Rng>
 void DNASNode::sample_gumbel_softmax(Rng& rng) {
-    z.assign(pi.size(), 0.0);
-    x.assign(pi.size(), 0.0);
+    z.assign(nodes.size(), 0.0);
+    x.assign(nodes.size(), 0.0);
 
     gumbel_noise(rng, g);
 
@@ -93,7 +100,7 @@ void DNASNode::calculate_z() {
     xtotal = 0.0;
     double emax = -10000000;
     for (int i = 0; i < z.size(); i++) {
-        x[i] = g[i] + log(pi[i]);
+        x[i] = g[i] + log(weights[i]);
         x[i] /= tao;
         emax = max(emax, x[i]);
     }
@@ -107,9 +114,15 @@ void DNASNode::calculate_z() {
 }
 
 void DNASNode::reset(int32_t series_length) {
-    d_pi = vector<double>(pi.size(), 0.0);
+    // this also clears the gradients of the sub-nodes, which only the chosen one sets
+    // once the node is crystallized
+    int32_t number_weights = get_number_weights();
+    for (int32_t i = 0; i < number_weights; i++) {
+        d_weights[i] = 0.0;
+    }
+
     d_input = vector<double>(series_length, 0.0);
-    node_outputs = vector<vector<double>>(series_length, vector<double>(pi.size(), 0.0));
+    node_outputs = vector<vector<double>>(series_length, vector<double>(nodes.size(), 0.0));
     output_values = vector<double>(series_length, 0.0);
     error_values = vector<double>(series_length, 0.0);
     inputs_fired = vector<int>(series_length, 0);
@@ -121,6 +134,9 @@ void DNASNode::reset(int32_t series_length) {
     } else {
         if (stochastic) {
             sample_gumbel_softmax(generator);
+        } else {
+            // pi is trained in place, so z has to follow it
+            calculate_z();
         }
 
         for (auto node : nodes) {
@@ -192,17 +208,23 @@ void DNASNode::try_update_deltas(int32_t time) {
     } else {
         for (int i = 0; i < z.size(); i++) {
             nodes[i]->output_fired(time, delta * z[i]);
-            double p = (x[i] / pi[i]);
+            double p = (x[i] / weights[i]);
             p *= ((delta * node_outputs[time][i]) / xtotal);
             p *= (1 - (x[i] / xtotal));
             p *= 1 / tao;
-            d_pi[i] += p;
+            d_weights[i] += p;
         }
         d_input[time] = 0.0;
         for (auto node : nodes) {
             d_input[time] += node->d_input[time];
         }
     }
+
+    if (time == 0) {
+        // We want this to count weight updates, finishing the backward pass implies an impending weight update
+        counter += 1;
+        calculate_maxi();
+    }
 }
 
 void DNASNode::initialize_lamarckian(
@@ -232,7 +254,7 @@ void DNASNode::initialize_uniform_random(minstd_rand0& generator, uniform_real_d
 }
 
 int32_t DNASNode::get_number_weights() const {
-    int n_weights = pi.size();
+    int n_weights = nodes.size();
 
     for (auto node : nodes) {
         n_weights += node->get_number_weights();
@@ -241,49 +263,28 @@ int32_t DNASNode::get_number_weights() const {
     return n_weights;
 }
 
-void DNASNode::get_weights(vector<double>& parameters) const {
-    parameters.resize(get_number_weights());
-    int32_t offset = 0;
-    get_weights(offset, parameters);
-}
-
-void DNASNode::set_weights(const vector<double>& parameters) {
-    int32_t offset = 0;
-    set_weights(offset, parameters);
-}
-
-void DNASNode::get_weights(int32_t& offset, vector<double>& parameters) const {
-    // Log::info("pi start %d; ", offset);
-    for (int i = 0; i < pi.size(); i++) {
-        parameters[offset++] = pi[i];
-    }
-    // Log::info_no_header("pi end %d \n", offset);
+void DNASNode::set_weight_buffers(double* _weights, double* _d_weights) {
+    // the sub-nodes are moved first, as they are kept in this node's current buffers
+    int32_t offset = nodes.size();
     for (auto node : nodes) {
-        node->get_weights(offset, parameters);
+        node->set_weight_buffers(_weights + offset, _d_weights + offset);
+        offset += node->get_number_weights();
     }
+
+    RNN_Node_Interface::set_weight_buffers(_weights, _d_weights);
 }
 
-void DNASNode::set_weights(int32_t& offset, const vector<double>& parameters) {
-    // int start = offset;
-    for (int i = 0; i < pi.size(); i++) {
-        pi[i] = parameters[offset++];
-    }
-    // Log::info("Pi indices: %d-%d\n", start, offset);
+void DNASNode::set_node_weight_buffers() {
+    int32_t offset = nodes.size();
     for (auto node : nodes) {
-        node->set_weights(offset, parameters);
-    }
-    Log::info("Just set weights\n");
-    calculate_z();
-    string s = "Pi = { ";
-    for (auto p : pi) {
-        s += std::to_string(p) + ", ";
+        node->set_weight_buffers(weights + offset, d_weights + offset);
+        offset += node->get_number_weights();
     }
-    Log::info("%s }\n", s.c_str());
 }
 
 void DNASNode::set_pi(const vector<double>& new_pi) {
-    for (int i = 0; i < pi.size(); i++) {
-        pi[i] = new_pi[i];
+    for (int i = 0; i < nodes.size(); i++) {
+        weights[i] = new_pi[i];
     }
     calculate_maxi();
 }
@@ -291,63 +292,24 @@ void DNASNode::set_pi(const vector<double>& new_pi) {
 void DNASNode::calculate_maxi() {
     if (counter >= CRYSTALLIZATION_THRESHOLD && maxi < 0) {
         maxi = 0;
-        double max_pi = pi[0];
+        double max_pi = weights[0];
 
         for (int i = 1; i < nodes.size(); i++) {
-            if (pi[i] > max_pi) {
-                max_pi = pi[i];
+            if (weights[i] > max_pi) {
+                max_pi = weights[i];
                 maxi = i;
             }
         }
     }
 }
 
-void DNASNode::get_gradients(vector<double>& gradients) {
-    gradients.assign(get_number_weights(), 0.0);
-
-    // We want this to count weight updates, fetching gradients implies an impending weight update
-    counter += 1;
-    calculate_maxi();
-
-    vector<double> temp;
-    int offset = 0;
-
-    if (counter >= CRYSTALLIZATION_THRESHOLD) {
-        offset += pi.size();
-        for (int i = 0; i < nodes.size(); i++) {
-            RNN_Node_Interface* node = nodes[i];
-            if (i == maxi) {
-                node->get_gradients(temp);
-                for (int j = 0; j < temp.size(); j++) {
-                    gradients[offset++] = temp[j];
-                }
-            } else {
-                offset += node->get_number_weights();
-            }
-        }
-    } else {
-        gradients.assign(get_number_weights(), 0.0);
-        int offset = 0;
-        for (int i = 0; i < pi.size(); i++) {
-            gradients[offset++] = d_pi[i];
-        }
-
-        for (auto node : nodes) {
-            node->get_gradients(temp);
-            for (int i = 0; i < temp.size(); i++) {
-                gradients[offset++] = temp[i];
-            }
-        }
-    }
-}
-
 void DNASNode::write_to_stream(ostream& out) {
     RNN_Node_Interface::write_to_stream(out);
 
     int32_t n = nodes.size();
     out.write((char*) &n, sizeof(int32_t));
     out.write((char*) &counter, sizeof(int32_t));
-    out.write((char*) &pi[0], sizeof(double) * n);
+    out.write((char*) weights, sizeof(double) * n);
     for (auto node : nodes) {
         node->write_to_stream(out);
     }
@@ -31,14 +31,17 @@ class DNASNode : public RNN_Node_Interface {
     static void gumbel_noise(R& rng, vector<double>& output);
     void calculate_maxi();
 
+    // Points the nodes at their weights, which follow pi in this node's weights
+    void set_node_weight_buffers();
+
     std::mt19937_64 generator;
 
     // These components are used to create a sub-network within this node, basically
     // to reduce the hackiness of things.
     vector<RNN_Node_Interface*> nodes;
 
-    // Describes the probability distribution we are learning
-    vector<double> pi;
+    // The probability distribution we are learning, pi, is the first nodes.size() weights
+    // of this node, followed by the weights of each of the nodes.
 
     // A sample from the probability distribution described by pi
     vector<double> z;
@@ -68,7 +71,6 @@ class DNASNode : public RNN_Node_Interface {
     // Can be set externally using DNASNode::set_stochastic
     bool stochastic = true;
 
-    vector<double> d_pi;
     vector<vector<double>> node_outputs;
 
    public:
@@ -97,15 +99,10 @@ class DNASNode : public RNN_Node_Interface {
 
     virtual int32_t get_number_weights() const;
 
-    virtual void get_weights(vector<double>& parameters) const;
-    virtual void set_weights(const vector<double>& parameters);
-
-    virtual void get_weights(int32_t& offset, vector<double>& parameters) const;
-    virtual void set_weights(int32_t& offset, const vector<double>& parameters);
+    virtual void set_weight_buffers(double* _weights, double* _d_weights);
 
     void set_pi(const vector<double>& new_pi);
 
-    virtual void get_gradients(vector<double>& gradients);
     virtual void reset(int32_t _series_length);
     virtual void write_to_stream(ostream& out);
 
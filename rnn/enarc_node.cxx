@@ -24,9 +24,20 @@ using std::vector;
 #include "enarc_node.hxx"
 
 #define NUMBER_ENARC_WEIGHTS 10
+#define ENARC_ZW 0
+#define ENARC_RW 1
+#define ENARC_W1 2
+#define ENARC_W2 3
+#define ENARC_W3 4
+#define ENARC_W6 5
+#define ENARC_W4 6
+#define ENARC_W5 7
+#define ENARC_W7 8
+#define ENARC_W8 9
 
 ENARC_Node::ENARC_Node(int32_t _innovation_number, int32_t _type, double _depth) : RNN_Node_Interface(_innovation_number, _type, _depth) {
   node_type = ENARC_NODE;
+  initialize_weight_storage(NUMBER_ENARC_WEIGHTS);
 }
 
 ENARC_Node::~ENARC_Node() {
@@ -35,107 +46,98 @@ ENARC_Node::~ENARC_Node() {
 
 void ENARC_Node::initialize_lamarckian(minstd_rand0 &generator, NormalDistribution &normal_distribution, double mu, double sigma) {
 
-    zw = bound(normal_distribution.random(generator, mu, sigma));
-    rw = bound(normal_distribution.random(generator, mu, sigma));
+    weights[ENARC_ZW] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[ENARC_RW] = bound(normal_distribution.random(generator, mu, sigma));
 
-    w1 = bound(normal_distribution.random(generator, mu, sigma));
+    weights[ENARC_W1] = bound(normal_distribution.random(generator, mu, sigma));
 
-    w2 = bound(normal_distribution.random(generator, mu, sigma));
-    w3 = bound(normal_distribution.random(generator, mu, sigma));
-    w6 = bound(normal_distribution.random(generator, mu, sigma));
+    weights[ENARC_W2] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[ENARC_W3] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[ENARC_W6] = bound(normal_distribution.random(generator, mu, sigma));
 
-    w4 = bound(normal_distribution.random(generator, mu, sigma));
-    w5 = bound(normal_distribution.random(generator, mu, sigma));
-    w7 = bound(normal_distribution.random(generator, mu, sigma));
-    w8 = bound(normal_distribution.random(generator, mu, sigma));
+    weights[ENARC_W4] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[ENARC_W5] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[ENARC_W7] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[ENARC_W8] = bound(normal_distribution.random(generator, mu, sigma));
 }
 
 void ENARC_Node::initialize_xavier(minstd_rand0 &generator, uniform_real_distribution<double> &rng_1_1, double range) {
 
-    zw = range * (rng_1_1(generator));
-    rw = range * (rng_1_1(generator));
+    weights[ENARC_ZW] = range * (rng_1_1(generator));
+    weights[ENARC_RW] = range * (rng_1_1(generator));
 
-    w1 = range * (rng_1_1(generator));
+    weights[ENARC_W1] = range * (rng_1_1(generator));
 
-    w2 = range * (rng_1_1(generator));
-    w3 = range * (rng_1_1(generator));
-    w6 = range * (rng_1_1(generator));
+    weights[ENARC_W2] = range * (rng_1_1(generator));
+    weights[ENARC_W3] = range * (rng_1_1(generator));
+    weights[ENARC_W6] = range * (rng_1_1(generator));
 
-    w4 = range * (rng_1_1(generator));
-    w5 = range * (rng_1_1(generator));
-    w7 = range * (rng_1_1(generator));
-    w8 = range * (rng_1_1(generator));
+    weights[ENARC_W4] = range * (rng_1_1(generator));
+    weights[ENARC_W5] = range * (rng_1_1(generator));
+    weights[ENARC_W7] = range * (rng_1_1(generator));
+    weights[ENARC_W8] = range * (rng_1_1(generator));
 }
 
 void ENARC_Node::initialize_kaiming(minstd_rand0 &generator, NormalDistribution &normal_distribution, double range) {
-    zw = range * normal_distribution.random(generator, 0, 1);
-    rw = range * normal_distribution.random(generator, 0, 1);
+    weights[ENARC_ZW] = range * normal_distribution.random(generator, 0, 1);
+    weights[ENARC_RW] = range * normal_distribution.random(generator, 0, 1);
 
-    w1 = range * normal_distribution.random(generator, 0, 1);
+    weights[ENARC_W1] = range * normal_distribution.random(generator, 0, 1);
 
-    w2 = range * normal_distribution.random(generator, 0, 1);
-    w3 = range * normal_distribution.random(generator, 0, 1);
-    w6 = range * normal_distribution.random(generator, 0, 1);
+    weights[ENARC_W2] = range * normal_distribution.random(generator, 0, 1);
+    weights[ENARC_W3] = range * normal_distribution.random(generator, 0, 1);
+    weights[ENARC_W6] = range * normal_distribution.random(generator, 0, 1);
 
-    w4 = range * normal_distribution.random(generator, 0, 1);
-    w5 = range * normal_distribution.random(generator, 0, 1);
-    w7 = range * normal_distribution.random(generator, 0, 1);
-    w8 = range * normal_distribution.random(generator, 0, 1);
+    weights[ENARC_W4] = range * normal_distribution.random(generator, 0, 1);
+    weights[ENARC_W5] = range * normal_distribution.random(generator, 0, 1);
+    weights[ENARC_W7] = range * normal_distribution.random(generator, 0, 1);
+    weights[ENARC_W8] = range * normal_distribution.random(generator, 0, 1);
 }
 
 void ENARC_Node::initialize_uniform_random(minstd_rand0 &generator, uniform_real_distribution<double> &rng) {
-    zw = rng(generator);
-    rw = rng(generator);
+    weights[ENARC_ZW] = rng(generator);
+    weights[ENARC_RW] = rng(generator);
 
-    w1 = rng(generator);
+    weights[ENARC_W1] = rng(generator);
 
-    w2 = rng(generator);
-    w3 = rng(generator);
-    w6 = rng(generator);
+    weights[ENARC_W2] = rng(generator);
+    weights[ENARC_W3] = rng(generator);
+    weights[ENARC_W6] = rng(generator);
 
-    w4 = rng(generator);
-    w5 = rng(generator);
-    w7 = rng(generator);
-    w8 = rng(generator);
+    weights[ENARC_W4] = rng(generator);
+    weights[ENARC_W5] = rng(generator);
+    weights[ENARC_W7] = rng(generator);
+    weights[ENARC_W8] = rng(generator);
 }
 
 
 
 
 double ENARC_Node::get_gradient(string gradient_name) {
-    double gradient_sum = 0.0;
-    for (int32_t i = 0; i < series_length; i++ ) {
-        if (gradient_name == "zw") {
-            gradient_sum += d_zw[i];
-        } else if (gradient_name == "rw") {
-            gradient_sum += d_rw[i];
-        } else if (gradient_name == "w1") {
-            gradient_sum += d_w1[i];
-
-        } else if (gradient_name == "w2") {
-            gradient_sum += d_w2[i];
-        } else if (gradient_name == "w3") {
-            gradient_sum += d_w3[i];
-        } else if (gradient_name == "w6") {
-            gradient_sum += d_w6[i];
-
-        } else if (gradient_name == "w4") {
-            gradient_sum += d_w4[i];
-
-
-
-        } else if (gradient_name == "w5") {
-            gradient_sum += d_w5[i];
-        } else if (gradient_name == "w7") {
-            gradient_sum += d_w7[i];
-        } else if (gradient_name == "w8") {
-            gradient_sum += d_w8[i];
-        } else {
-            Log::fatal("ERROR: tried to get unknown gradient: '%s'\n", gradient_name.c_str()); 
-            exit(1);
-        }
+    if (gradient_name == "zw") {
+        return d_weights[ENARC_ZW];
+    } else if (gradient_name == "rw") {
+        return d_weights[ENARC_RW];
+    } else if (gradient_name == "w1") {
+        return d_weights[ENARC_W1];
+    } else if (gradient_name == "w2") {
+        return d_weights[ENARC_W2];
+    } else if (gradient_name == "w3") {
+        return d_weights[ENARC_W3];
+    } else if (gradient_name == "w6") {
+        return d_weights[ENARC_W6];
+    } else if (gradient_name == "w4") {
+        return d_weights[ENARC_W4];
+    } else if (gradient_name == "w5") {
+        return d_weights[ENARC_W5];
+    } else if (gradient_name == "w7") {
+        return d_weights[ENARC_W7];
+    } else if (gradient_name == "w8") {
+        return d_weights[ENARC_W8];
+    } else {
+        Log::fatal("ERROR: tried to get unknown gradient: '%s'\n", gradient_name.c_str());
+        exit(1);
     }
-    return gradient_sum;
 }
 
 void ENARC_Node::print_gradient(string gradient_name) {
@@ -161,8 +163,8 @@ void ENARC_Node::input_fired(int32_t time, double incoming_output) {
     double h_prev = 0.0;
     if (time > 0) h_prev = output_values[time - 1];
 
-    double xzw = x*zw;
-    double hrw = h_prev*rw;
+    double xzw = x*weights[ENARC_ZW];
+    double hrw = h_prev*weights[ENARC_RW];
     double z_sum = hrw+xzw;
 
      z[time] = tanh(z_sum);
@@ -170,40 +172,40 @@ void ENARC_Node::input_fired(int32_t time, double incoming_output) {
 
   /**************1st layer ***************/    
 
-     double w1_z_mul = w1 * z[time];
+     double w1_z_mul = weights[ENARC_W1] * z[time];
      w1_z[time] = tanh(w1_z_mul);
      l_w1_z[time] = tanh_derivative(w1_z[time]);
 
  //     /**************2nd layer ***************/
 
-    double w6_w1_mul = w6*w1_z[time];
+    double w6_w1_mul = weights[ENARC_W6]*w1_z[time];
     w6_w1[time] = swish(w6_w1_mul);
     l_w6_w1[time] = swish_derivative(w6_w1_mul,w6_w1[time]);
 
-     double w2_w1_mul = w2*w1_z[time];
+     double w2_w1_mul = weights[ENARC_W2]*w1_z[time];
      w2_w1[time] = tanh(w2_w1_mul);
      l_w2_w1[time] = tanh_derivative(w2_w1[time]);
 
-     double w3_w1_mul = w3*w1_z[time];
+     double w3_w1_mul = weights[ENARC_W3]*w1_z[time];
      w3_w1[time] = leakyReLU(w3_w1_mul);
      l_w3_w1[time] = leakyReLU_derivative(w3_w1[time]);
 
 
   // *************3rd layer **************    
 
-     double w4_w2_mul = w4*w2_w1[time];
+     double w4_w2_mul = weights[ENARC_W4]*w2_w1[time];
      w4_w2[time] = leakyReLU(w4_w2_mul);
      l_w4_w2[time] = leakyReLU_derivative(w4_w2[time]);
 
-     double w5_w3_mul = w5*w3_w1[time];
+     double w5_w3_mul = weights[ENARC_W5]*w3_w1[time];
      w5_w3[time] = swish(w5_w3_mul);
      l_w5_w3[time] = swish_derivative(w5_w3_mul,w5_w3[time]);
 
-    double w7_w3_mul = w7*w3_w1[time];
+    double w7_w3_mul = weights[ENARC_W7]*w3_w1[time];
      w7_w3[time] = tanh(w7_w3_mul);
      l_w7_w3[time] = tanh_derivative(w7_w3[time]);
 
-     double w8_w3_mul = w8*w3_w1[time];
+     double w8_w3_mul = weights[ENARC_W8]*w3_w1[time];
      w8_w3[time] = swish(w8_w3_mul);
      l_w8_w3[time] = swish_derivative(w8_w3_mul,w8_w3[time]);    
 
@@ -235,32 +237,32 @@ void ENARC_Node::try_update_deltas(int32_t time){
 
     //d_h *= 0.2;
 
-    d_w6[time] = d_h*l_w6_w1[time]*w1_z[time];
+    d_weights[ENARC_W6] += d_h*l_w6_w1[time]*w1_z[time];
 
-    d_w8[time] = d_h*l_w8_w3[time]*w3_w1[time];
-    d_w7[time] = d_h*l_w7_w3[time]*w3_w1[time];
-    d_w5[time] = d_h*l_w5_w3[time]*w3_w1[time];
+    d_weights[ENARC_W8] += d_h*l_w8_w3[time]*w3_w1[time];
+    d_weights[ENARC_W7] += d_h*l_w7_w3[time]*w3_w1[time];
+    d_weights[ENARC_W5] += d_h*l_w5_w3[time]*w3_w1[time];
 
-    d_w4[time] = d_h*l_w4_w2[time]*w2_w1[time];
+    d_weights[ENARC_W4] += d_h*l_w4_w2[time]*w2_w1[time];
 
-    double d_h_tanh2 = d_h*l_w4_w2[time]*w4;
-    double d_h_leaky2 = d_h*l_w8_w3[time]*w8 +d_h*l_w7_w3[time]*w7+ d_h*l_w5_w3[time]*w5;
+    double d_h_tanh2 = d_h*l_w4_w2[time]*weights[ENARC_W4];
+    double d_h_leaky2 = d_h*l_w8_w3[time]*weights[ENARC_W8] +d_h*l_w7_w3[time]*weights[ENARC_W7]+ d_h*l_w5_w3[time]*weights[ENARC_W5];
     
     
-    d_w2[time] = d_h_tanh2*l_w2_w1[time]*w1_z[time];
-    d_w3[time] = d_h_leaky2*l_w3_w1[time]*w1_z[time];
+    d_weights[ENARC_W2] += d_h_tanh2*l_w2_w1[time]*w1_z[time];
+    d_weights[ENARC_W3] += d_h_leaky2*l_w3_w1[time]*w1_z[time];
     
-    double d_h_tanh1 =  d_h*l_w6_w1[time]*w6 + d_h_tanh2*l_w2_w1[time]*w2 + d_h_leaky2*l_w3_w1[time]*w3;
+    double d_h_tanh1 =  d_h*l_w6_w1[time]*weights[ENARC_W6] + d_h_tanh2*l_w2_w1[time]*weights[ENARC_W2] + d_h_leaky2*l_w3_w1[time]*weights[ENARC_W3];
 
-    d_w1[time] = d_h_tanh1*l_w1_z[time]*z[time];
+    d_weights[ENARC_W1] += d_h_tanh1*l_w1_z[time]*z[time];
 
-    double d_h_tanh = d_h_tanh1*l_w1_z[time]*w1;
+    double d_h_tanh = d_h_tanh1*l_w1_z[time]*weights[ENARC_W1];
 
-    d_h_prev[time] += d_h_tanh*l_d_z[time]*rw;
-    d_rw[time] = d_h_tanh*l_d_z[time]*h_prev;
+    d_h_prev[time] += d_h_tanh*l_d_z[time]*weights[ENARC_RW];
+    d_weights[ENARC_RW] += d_h_tanh*l_d_z[time]*h_prev;
 
-    d_input[time] += d_h_tanh*l_d_z[time]*zw;
-    d_zw[time] = d_h_tanh*l_d_z[time]*x;
+    d_input[time] += d_h_tanh*l_d_z[time]*weights[ENARC_ZW];
+    d_weights[ENARC_ZW] += d_h_tanh*l_d_z[time]*x;
 }
 
 void ENARC_Node::error_fired(int32_t time, double error) {
@@ -284,105 +286,11 @@ int32_t ENARC_Node::get_number_weights() const {
     return NUMBER_ENARC_WEIGHTS;
 }
 
-void ENARC_Node::get_weights(vector<double> &parameters) const {
-    parameters.resize(get_number_weights());
-    int32_t offset = 0;
-    get_weights(offset, parameters);
-}
-
-void ENARC_Node::set_weights(const vector<double> &parameters) {
-    int32_t offset = 0;
-    set_weights(offset, parameters);
-}
-
-void ENARC_Node::set_weights(int32_t &offset, const vector<double> &parameters) {
-    //int32_t start_offset = offset;
-
-  zw = bound(parameters[offset++]);
-  rw = bound(parameters[offset++]);
-
-  w1 = bound(parameters[offset++]);
-
-  w2 = bound(parameters[offset++]);
-  w3 = bound(parameters[offset++]);
-  w6 = bound(parameters[offset++]);
-
-  w4 = bound(parameters[offset++]);
-  w5 = bound(parameters[offset++]);
-  w7 = bound(parameters[offset++]);
-  w8 = bound(parameters[offset++]);
-
-
-    //int32_t end_offset = offset;
-    //Log::trace("set weights from offset %d to %d on ENARC_Node %d\n", start_offset, end_offset, innovation_number);
-}
-
-void ENARC_Node::get_weights(int32_t &offset, vector<double> &parameters) const {
-    //int32_t start_offset = offset;
-
-
-
-    parameters[offset++] = zw;
-    parameters[offset++] = rw;
-
-    parameters[offset++] = w1; 
-
-    parameters[offset++] = w2;
-    parameters[offset++] = w3;
-    parameters[offset++] = w6;
-
-    parameters[offset++] = w4;
-    parameters[offset++] = w5;
-    parameters[offset++] = w7;
-    parameters[offset++] = w8;
-
-
-    //int32_t end_offset = offset;
-    //Log::trace("got weights from offset %d to %d on ENARC_Node %d\n", start_offset, end_offset, innovation_number);
-}
-
-void ENARC_Node::get_gradients(vector<double> &gradients) {
-    gradients.assign(NUMBER_ENARC_WEIGHTS, 0.0);
-
-    for (int32_t i = 0; i < NUMBER_ENARC_WEIGHTS; i++) {
-        gradients[i] = 0.0;
-    }
-
-    for (int32_t i = 0; i < series_length; i++) {
-        gradients[0] += d_zw[i];
-        gradients[1] += d_rw[i];
-
-        gradients[2] += d_w1[i];
-
-        gradients[3] += d_w2[i];
-        gradients[4] += d_w3[i];
-        gradients[5] += d_w6[i];
-
-        gradients[6] += d_w4[i];
-        gradients[7] += d_w5[i];
-        gradients[8] += d_w7[i];
-        gradients[9] += d_w8[i];
-
-    }
-}
-
 void ENARC_Node::reset(int32_t _series_length) {
     series_length = _series_length;
 
-    d_zw.assign(series_length, 0.0);
-    d_rw.assign(series_length, 0.0);
-
-    d_w1.assign(series_length, 0.0);
+    for (int32_t i = 0; i < NUMBER_ENARC_WEIGHTS; i++) d_weights[i] = 0.0;
 
-    d_w2.assign(series_length, 0.0); 
-    d_w3.assign(series_length, 0.0); 
-    d_w6.assign(series_length, 0.0); 
-
-    d_w4.assign(series_length, 0.0); 
-    d_w5.assign(series_length, 0.0); 
-    d_w7.assign(series_length, 0.0);
-    d_w8.assign(series_length, 0.0); 
-  
     d_h_prev.assign(series_length, 0.0);
 
     z.assign(series_length, 0.0);
@@ -429,33 +337,8 @@ RNN_Node_Interface* ENARC_Node::copy() const {
     ENARC_Node* n = new ENARC_Node(innovation_number, layer_type, depth);
 
     //copy ENARC_Node values
-    n->rw = rw;
-    n->zw = zw;
-    n->w1 = w1;
-
-    n->w2 = w2;
-    n->w3 = w3;
-    n->w6 = w6;
+    copy_weights_to(n);
 
-    n->w4 = w4;
-    n->w5 = w5;
-    n->w7 = w7;
-    n->w8 = w8;
-
-    n->d_zw = d_zw;
-    n->d_rw = d_rw;
-
-    n->d_w1 = d_w1;
-
-    n->d_w2 = d_w2;
-    n->d_w3 = d_w3;
-    n->d_w6 = d_w6;
-
-    n->d_w4 = d_w4;
-    n->d_w5 = d_w5;
-    
-    n->d_w7 = d_w7;
-    n->d_w8 = d_w8;
     n->d_h_prev = d_h_prev;
 
     n->z = z;
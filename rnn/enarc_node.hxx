@@ -17,33 +17,6 @@ using std::vector;
 
 class ENARC_Node : public RNN_Node_Interface{
 	private:
-		
-		double rw;
-		double zw;
-
-		double w1;
-		double w2;
-		double w3;
-		double w6;
-		double w4;
-		double w5;
-		double w7;
-		double w8;
-
-		vector<double> d_zw;
-		vector<double> d_rw;
-
-		vector<double> d_w1;
-
-		vector<double> d_w2; 
-		vector<double> d_w3; 
-		vector<double> d_w6; 
-
-		vector<double> d_w4; 
-		vector<double> d_w5; 
-		vector<double> d_w7;
-		vector<double> d_w8; 
-	
 		vector<double> d_h_prev;
 
 		vector<double> z;
@@ -95,14 +68,6 @@ class ENARC_Node : public RNN_Node_Interface{
 
         int32_t get_number_weights() const;
 
-        void get_weights(vector<double> &parameters) const;
-        void set_weights(const vector<double> &parameters);
-
-        void get_weights(int32_t &offset, vector<double> &parameters) const;
-        void set_weights(int32_t &offset, const vector<double> &parameters);
-
-        void get_gradients(vector<double> &gradients);
-
         void reset(int32_t _series_length);
 
         void write_to_stream(ostream &out);
@@ -34,10 +34,15 @@ using std::vector;
 #include "enas_dag_node.hxx"
 
 #define NUMBER_ENAS_DAG_WEIGHTS 10
+#define ENAS_DAG_ZW 0
+#define ENAS_DAG_RW 1
+//the weights of the other nodes follow zw and rw
+#define ENAS_DAG_NODE_WEIGHTS 2
 
 
 ENAS_DAG_Node::ENAS_DAG_Node(int32_t _innovation_number, int32_t _type, double _depth) : RNN_Node_Interface(_innovation_number, _type, _depth) {
   node_type = ENAS_DAG_NODE;
+  initialize_weight_storage(NUMBER_ENAS_DAG_WEIGHTS);
 }
 
 ENAS_DAG_Node::~ENAS_DAG_Node(){
@@ -46,83 +51,78 @@ ENAS_DAG_Node::~ENAS_DAG_Node(){
 
 void ENAS_DAG_Node::initialize_lamarckian(minstd_rand0 &generator, NormalDistribution &normal_distribution, double mu, double sigma) {
 
-    zw = bound(normal_distribution.random(generator, mu, sigma));
-    rw = bound(normal_distribution.random(generator, mu, sigma));
+    weights[ENAS_DAG_ZW] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[ENAS_DAG_RW] = bound(normal_distribution.random(generator, mu, sigma));
 
     int32_t assigned_node_weights = 2; // 2 weights for the starting node assigned above
 
     for (int32_t new_node_weight = 0; new_node_weight < NUMBER_ENAS_DAG_WEIGHTS - assigned_node_weights; ++new_node_weight){
-        weights.at(new_node_weight)= bound(normal_distribution.random(generator, mu, sigma));
+        weights[ENAS_DAG_NODE_WEIGHTS + new_node_weight]= bound(normal_distribution.random(generator, mu, sigma));
     }
 
 }
 
 void ENAS_DAG_Node::initialize_xavier(minstd_rand0 &generator, uniform_real_distribution<double> &rng_1_1, double range) {
-    zw = range * (rng_1_1(generator));
-    rw = range * (rng_1_1(generator));
+    weights[ENAS_DAG_ZW] = range * (rng_1_1(generator));
+    weights[ENAS_DAG_RW] = range * (rng_1_1(generator));
 
     int32_t assigned_node_weights = 2; // 2 weights for the starting node assigned above
 
     for (int32_t new_node_weight = 0; new_node_weight < NUMBER_ENAS_DAG_WEIGHTS - assigned_node_weights; ++new_node_weight){
-        weights.at(new_node_weight) = range * (rng_1_1(generator));
+        weights[ENAS_DAG_NODE_WEIGHTS + new_node_weight] = range * (rng_1_1(generator));
     }
 
 }
 
 void ENAS_DAG_Node::initialize_kaiming(minstd_rand0 &generator, NormalDistribution &normal_distribution, double range) {
-    zw = range * normal_distribution.random(generator, 0, 1);
-    rw = range * normal_distribution.random(generator, 0, 1);
+    weights[ENAS_DAG_ZW] = range * normal_distribution.random(generator, 0, 1);
+    weights[ENAS_DAG_RW] = range * normal_distribution.random(generator, 0, 1);
 
     int32_t assigned_node_weights = 2; // 2 weights for the starting node assigned above
 
     for (int32_t new_node_weight = 0; new_node_weight < NUMBER_ENAS_DAG_WEIGHTS - assigned_node_weights; ++new_node_weight){
-        weights.at(new_node_weight) = range * normal_distribution.random(generator, 0, 1);
+        weights[ENAS_DAG_NODE_WEIGHTS + new_node_weight] = range * normal_distribution.random(generator, 0, 1);
     }
 
 }
 
 void ENAS_DAG_Node::initialize_uniform_random(minstd_rand0 &generator, uniform_real_distribution<double> &rng) {
-    zw = rng(generator);
-    rw = rng(generator);
+    weights[ENAS_DAG_ZW] = rng(generator);
+    weights[ENAS_DAG_RW] = rng(generator);
 
     int32_t assigned_node_weights = 2; // 2 weights for the starting node assigned above
 
     for (int32_t new_node_weight = 0; new_node_weight < NUMBER_ENAS_DAG_WEIGHTS - assigned_node_weights; ++new_node_weight){
-        weights.at(new_node_weight) = rng(generator);
+        weights[ENAS_DAG_NODE_WEIGHTS + new_node_weight] = rng(generator);
     }
 }
 
 
 double ENAS_DAG_Node::get_gradient(string gradient_name) {
-    double gradient_sum = 0.0;
-    for (int32_t i = 0; i < series_length; i++ ) {
-        if (gradient_name == "zw") {
-            gradient_sum += d_zw[i];
-        } else if (gradient_name == "rw") {
-            gradient_sum += d_rw[i];
-        } else if (gradient_name == "w1") {
-            gradient_sum += d_weights[0][i];
-
-        } else if (gradient_name == "w2") {
-            gradient_sum += d_weights[1][i];
-        } else if (gradient_name == "w3") {
-            gradient_sum += d_weights[2][i];
-        } else if (gradient_name == "w4") {
-            gradient_sum += d_weights[3][i];
-        } else if (gradient_name == "w5") {
-            gradient_sum +=  d_weights[4][i];
-        } else if (gradient_name == "w6") {
-            gradient_sum += d_weights[5][i];
-        } else if (gradient_name == "w7") {
-            gradient_sum +=  d_weights[6][i];
-        } else if (gradient_name == "w8") {
-            gradient_sum +=  d_weights[7][i];
-        } else {
-            Log::fatal("ERROR: tried to get unknown gradient: '%s'\n", gradient_name.c_str()); 
-            exit(1);
-        }
+    if (gradient_name == "zw") {
+        return d_weights[ENAS_DAG_ZW];
+    } else if (gradient_name == "rw") {
+        return d_weights[ENAS_DAG_RW];
+    } else if (gradient_name == "w1") {
+        return d_weights[ENAS_DAG_NODE_WEIGHTS + 0];
+    } else if (gradient_name == "w2") {
+        return d_weights[ENAS_DAG_NODE_WEIGHTS + 1];
+    } else if (gradient_name == "w3") {
+        return d_weights[ENAS_DAG_NODE_WEIGHTS + 2];
+    } else if (gradient_name == "w4") {
+        return d_weights[ENAS_DAG_NODE_WEIGHTS + 3];
+    } else if (gradient_name == "w5") {
+        return d_weights[ENAS_DAG_NODE_WEIGHTS + 4];
+    } else if (gradient_name == "w6") {
+        return d_weights[ENAS_DAG_NODE_WEIGHTS + 5];
+    } else if (gradient_name == "w7") {
+        return d_weights[ENAS_DAG_NODE_WEIGHTS + 6];
+    } else if (gradient_name == "w8") {
+        return d_weights[ENAS_DAG_NODE_WEIGHTS + 7];
+    } else {
+        Log::fatal("ERROR: tried to get unknown gradient: '%s'\n", gradient_name.c_str());
+        exit(1);
     }
-    return gradient_sum;
 }
 
 void ENAS_DAG_Node::print_gradient(string gradient_name) {
@@ -175,8 +175,8 @@ void ENAS_DAG_Node::input_fired(int32_t time, double incoming_output) {
     double h_prev = 0.0;
     if (time > 0) h_prev = output_values[time - 1];
 
-    double xzw = x*zw;
-    double hrw = h_prev*rw;
+    double xzw = x*weights[ENAS_DAG_ZW];
+    double hrw = h_prev*weights[ENAS_DAG_RW];
     double node0_sum = hrw+xzw;
 
     Nodes[0][time] = activation(node0_sum,operations[0]);
@@ -184,7 +184,7 @@ void ENAS_DAG_Node::input_fired(int32_t time, double incoming_output) {
     node_output[0] = 0;
     for(int32_t i = 1; i < (int32_t)connections.size(); i++){
         int32_t incoming_node = connections[i] - 1;
-        double node_mul = weights[i-1]*Nodes[incoming_node][time];
+        double node_mul = weights[ENAS_DAG_NODE_WEIGHTS + i - 1]*Nodes[incoming_node][time];
         Nodes[i][time] = activation(node_mul,operations[i]);
         l_Nodes[i][time] = activation_derivative(node_mul,Nodes[i][time],operations[i]);
         node_output[incoming_node] = 0;
@@ -245,15 +245,15 @@ void ENAS_DAG_Node::try_update_deltas(int32_t time){
     for (int32_t i = no_of_nodes - 1; i >=  1; i--)
     {
         int32_t incoming_node = connections[i] - 1;
-        d_weights[i-1][time] = d_node_h[i]*l_Nodes[i][time]*Nodes[incoming_node][time];
-        d_node_h[incoming_node] += d_node_h[i]*l_Nodes[i][time]*weights[i-1];
+        d_weights[ENAS_DAG_NODE_WEIGHTS + i - 1] += d_node_h[i]*l_Nodes[i][time]*Nodes[incoming_node][time];
+        d_node_h[incoming_node] += d_node_h[i]*l_Nodes[i][time]*weights[ENAS_DAG_NODE_WEIGHTS + i - 1];
     }
 
-    d_h_prev[time] += d_node_h[0]*l_Nodes[0][time]*rw;
-    d_rw[time] =  d_node_h[0]*l_Nodes[0][time]*h_prev;
+    d_h_prev[time] += d_node_h[0]*l_Nodes[0][time]*weights[ENAS_DAG_RW];
+    d_weights[ENAS_DAG_RW] += d_node_h[0]*l_Nodes[0][time]*h_prev;
 
-    d_input[time] +=  d_node_h[0]*l_Nodes[0][time]*zw;
-    d_zw[time] = d_node_h[0]*l_Nodes[0][time]*x;
+    d_input[time] +=  d_node_h[0]*l_Nodes[0][time]*weights[ENAS_DAG_ZW];
+    d_weights[ENAS_DAG_ZW] += d_node_h[0]*l_Nodes[0][time]*x;
 
     // d_h_prev[time] += d_h*l_Nodes[0][time]*rw;
     // d_rw[time] =  d_h*l_Nodes[0][time]*h_prev;
@@ -288,84 +288,11 @@ int32_t ENAS_DAG_Node::get_number_weights() const {
     return NUMBER_ENAS_DAG_WEIGHTS;
 }
 
-void ENAS_DAG_Node::get_weights(vector<double> &parameters) const {
-    parameters.resize(get_number_weights());
-    int32_t offset = 0;
-    get_weights(offset, parameters);
-}
-
-void ENAS_DAG_Node::set_weights(const vector<double> &parameters) {
-    int32_t offset = 0;
-    set_weights(offset, parameters);
-}
-
-void ENAS_DAG_Node::set_weights(int32_t &offset, const vector<double> &parameters) {
-    //int32_t start_offset = offset;
-
-    int32_t assigned_node_weights = 2; // 2 weights for the starting node assigned above
-
-    zw = bound(parameters[offset++]);
-    rw = bound(parameters[offset++]);
-
-    for (int32_t new_node_weight = 0; new_node_weight < NUMBER_ENAS_DAG_WEIGHTS - assigned_node_weights; ++new_node_weight){
-        if((int32_t)weights.size() < NUMBER_ENAS_DAG_WEIGHTS - assigned_node_weights){
-            weights.push_back(bound(parameters[offset++]));            
-        }
-        else
-            weights.at(new_node_weight) = bound(parameters[offset++]);
-    }
-    Log::debug("DEBUG: no of  weights  on ENAS_DAG_Node %d at time %d is %d \n", innovation_number, time, weights.size());
-
-
-}
-
-void ENAS_DAG_Node::get_weights(int32_t &offset, vector<double> &parameters) const {
-    //int32_t start_offset = offset;
-
-
-
-    int32_t assigned_node_weights = 2; // 2 weights for the starting node assigned above
-
-    parameters[offset++] = zw;
-    parameters[offset++] = rw;
-
-    for (int32_t new_node_weight = 0; new_node_weight < NUMBER_ENAS_DAG_WEIGHTS - assigned_node_weights; ++new_node_weight)
-      parameters[offset++] = weights.at(new_node_weight); 
-
-}
-
-void ENAS_DAG_Node::get_gradients(vector<double> &gradients) {
-    gradients.assign(NUMBER_ENAS_DAG_WEIGHTS, 0.0);
-
-    for (int32_t i = 0; i < NUMBER_ENAS_DAG_WEIGHTS; i++) {
-        gradients[i] = 0.0;
-    }
-
-    for (int32_t i = 0; i < series_length; i++) {
-        gradients[0] += d_zw[i];
-        gradients[1] += d_rw[i];
-
-        gradients[2] += d_weights[0][i];
-
-        gradients[3] += d_weights[1][i];
-        gradients[4] += d_weights[2][i];
-        gradients[5] += d_weights[3][i];
-
-        gradients[6] += d_weights[4][i];
-        gradients[7] += d_weights[5][i];
-        gradients[8] += d_weights[6][i];
-        gradients[9] += d_weights[7][i];
-
-    }
-}
-
 void ENAS_DAG_Node::reset(int32_t _series_length) {
     series_length = _series_length;
 
-    d_zw.assign(series_length, 0.0);
-    d_rw.assign(series_length, 0.0);
+    for (int32_t i = 0; i < NUMBER_ENAS_DAG_WEIGHTS; i++) d_weights[i] = 0.0;
 
-    d_weights.assign(NUMBER_ENAS_DAG_WEIGHTS, vector<double>(series_length,0.0)); 
     d_h_prev.assign(series_length, 0.0);
     Nodes.assign(NUMBER_ENAS_DAG_WEIGHTS, vector<double>(series_length,0.0));
     l_Nodes.assign(NUMBER_ENAS_DAG_WEIGHTS, vector<double>(series_length,0.0));
@@ -387,21 +314,8 @@ RNN_Node_Interface* ENAS_DAG_Node::copy() const {
     ENAS_DAG_Node* n = new ENAS_DAG_Node(innovation_number, layer_type, depth);
 
     //copy ENAS_DAG_Node values
-    n->rw = rw;
-    n->zw = zw;
-
-    n->d_zw = d_zw;
-    n->d_rw = d_rw;
-
-
-     for (int32_t i = 0; i < (int32_t)weights.size(); ++i)
-    {
-        n->weights[i] = weights[i];
-        n->d_weights[i] = d_weights[i];
-    }
-
+    copy_weights_to(n);
 
-   
     n->d_h_prev = d_h_prev;
 
     for (int32_t i = 0; i < (int32_t)Nodes.size(); ++i)
@@ -0,0 +1,88 @@
+#include <algorithm>
+using std::min;
+using std::upper_bound;
+
+#include <cmath>
+
+#include <limits>
+using std::numeric_limits;
+
+#include <vector>
+using std::vector;
+
+#include "rnn/genome_signature.hxx"
+
+//a 64 bit mixing function (the splitmix64 finalizer), used to make one hash
+//function per position of the minhash sketch
+static inline uint32_t minhash_hash(int32_t innovation, int32_t function) {
+    uint64_t z = ((uint64_t)(uint32_t)innovation << 32) | (uint32_t)function;
+    z += 0x9E3779B97F4A7C15;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+    z = z ^ (z >> 31);
+    return (uint32_t)z;
+}
+
+GenomeSignature::GenomeSignature() : avg_edge_weight(0.0) {
+}
+
+GenomeSignature::GenomeSignature(const vector<int32_t> &_innovations, double _avg_edge_weight, int32_t minhash_size) : innovations(_innovations), avg_edge_weight(_avg_edge_weight) {
+    if (minhash_size <= 0) return;
+
+    minhash.assign(minhash_size, numeric_limits<uint32_t>::max());
+    for (int32_t i = 0; i < (int32_t)innovations.size(); i++) {
+        for (int32_t j = 0; j < minhash_size; j++) {
+            uint32_t hash = minhash_hash(innovations[i], j);
+            if (hash < minhash[j]) minhash[j] = hash;
+        }
+    }
+}
+
+const vector<int32_t>& GenomeSignature::get_innovations() const {
+    return innovations;
+}
+
+double GenomeSignature::get_avg_edge_weight() const {
+    return avg_edge_weight;
+}
+
+int32_t GenomeSignature::get_minhash_size() const {
+    return (int32_t)minhash.size();
+}
+
+int32_t GenomeSignature::get_excess(const GenomeSignature &other) const {
+    if (innovations.size() == 0) return 0;
+    if (other.innovations.size() == 0) return (int32_t)innovations.size();
+
+    return (int32_t)(innovations.end() - upper_bound(innovations.begin(), innovations.end(), other.innovations.back()));
+}
+
+int32_t GenomeSignature::get_shared(const GenomeSignature &other) const {
+    if (minhash.size() > 0 && minhash.size() == other.minhash.size()) {
+        int32_t matches = 0;
+        for (int32_t i = 0; i < (int32_t)minhash.size(); i++) {
+            if (minhash[i] == other.minhash[i]) matches++;
+        }
+
+        //the fraction of matches estimates the jaccard index |A & B| / |A | B|,
+        //and |A | B| = |A| + |B| - |A & B|
+        double jaccard = (double)matches / minhash.size();
+        int32_t shared = (int32_t)round(jaccard * (innovations.size() + other.innovations.size()) / (1.0 + jaccard));
+        return min(shared, (int32_t)min(innovations.size(), other.innovations.size()));
+    }
+
+    int32_t shared = 0;
+    int32_t i = 0, j = 0;
+    while (i < (int32_t)innovations.size() && j < (int32_t)other.innovations.size()) {
+        if (innovations[i] < other.innovations[j]) {
+            i++;
+        } else if (innovations[i] > other.innovations[j]) {
+            j++;
+        } else {
+            shared++;
+            i++;
+            j++;
+        }
+    }
+    return shared;
+}
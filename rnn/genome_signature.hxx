@@ -0,0 +1,48 @@
+#ifndef EXAMM_GENOME_SIGNATURE_HXX
+#define EXAMM_GENOME_SIGNATURE_HXX
+
+#include <cstdint>
+
+#include <vector>
+using std::vector;
+
+/**
+ * The parts of a genome used to calculate the NEAT compatibility distance between
+ * two genomes: its edge innovation numbers (sorted), its average enabled edge weight
+ * and, optionally, a MinHash sketch of the innovation numbers which allows the number
+ * of shared innovations to be estimated in time independent of the genome's size.
+ */
+class GenomeSignature {
+    private:
+        vector<int32_t> innovations;
+        double avg_edge_weight;
+        vector<uint32_t> minhash;
+
+    public:
+        GenomeSignature();
+
+        /**
+         * \param innovations are the genome's edge innovation numbers, in sorted order
+         * \param avg_edge_weight is the genome's average enabled edge weight
+         * \param minhash_size is the number of hash functions in the MinHash sketch, 0 for no sketch
+         */
+        GenomeSignature(const vector<int32_t> &innovations, double avg_edge_weight, int32_t minhash_size);
+
+        const vector<int32_t>& get_innovations() const;
+        double get_avg_edge_weight() const;
+        int32_t get_minhash_size() const;
+
+        /**
+         * \return the number of innovations in this signature which are greater than
+         * the largest in other (the excess genes)
+         */
+        int32_t get_excess(const GenomeSignature &other) const;
+
+        /**
+         * \return the number of innovations in both signatures, estimated from the MinHash
+         * sketches if both have one of the same size, or counted exactly otherwise
+         */
+        int32_t get_shared(const GenomeSignature &other) const;
+};
+
+#endif
@@ -25,9 +25,19 @@ using std::vector;
 
 
 #define NUMBER_GRU_WEIGHTS 9
+#define GRU_ZW 0
+#define GRU_ZU 1
+#define GRU_Z_BIAS 2
+#define GRU_RW 3
+#define GRU_RU 4
+#define GRU_R_BIAS 5
+#define GRU_HW 6
+#define GRU_HU 7
+#define GRU_H_BIAS 8
 
 GRU_Node::GRU_Node(int32_t _innovation_number, int32_t _type, double _depth) : RNN_Node_Interface(_innovation_number, _type, _depth) {
     node_type = GRU_NODE;
+    initialize_weight_storage(NUMBER_GRU_WEIGHTS);
 }
 
 GRU_Node::~GRU_Node() {
@@ -35,93 +45,87 @@ GRU_Node::~GRU_Node() {
 
 void GRU_Node::initialize_lamarckian(minstd_rand0 &generator, NormalDistribution &normal_distribution, double mu, double sigma) {
 
-    zw = bound(normal_distribution.random(generator, mu, sigma));
-    zu = bound(normal_distribution.random(generator, mu, sigma));
-    z_bias = bound(normal_distribution.random(generator, mu, sigma));
+    weights[GRU_ZW] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[GRU_ZU] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[GRU_Z_BIAS] = bound(normal_distribution.random(generator, mu, sigma));
 
-    rw = bound(normal_distribution.random(generator, mu, sigma));
-    ru = bound(normal_distribution.random(generator, mu, sigma));
-    r_bias = bound(normal_distribution.random(generator, mu, sigma));
+    weights[GRU_RW] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[GRU_RU] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[GRU_R_BIAS] = bound(normal_distribution.random(generator, mu, sigma));
 
-    hw = bound(normal_distribution.random(generator, mu, sigma));
-    hu = bound(normal_distribution.random(generator, mu, sigma));
-    h_bias = bound(normal_distribution.random(generator, mu, sigma));
+    weights[GRU_HW] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[GRU_HU] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[GRU_H_BIAS] = bound(normal_distribution.random(generator, mu, sigma));
 }
 
 void GRU_Node::initialize_xavier(minstd_rand0 &generator, uniform_real_distribution<double> &rng_1_1, double range) {
     
-    zw = range * (rng_1_1(generator));
-    zu = range * (rng_1_1(generator));
-    z_bias = range * (rng_1_1(generator));
+    weights[GRU_ZW] = range * (rng_1_1(generator));
+    weights[GRU_ZU] = range * (rng_1_1(generator));
+    weights[GRU_Z_BIAS] = range * (rng_1_1(generator));
 
-    rw = range * (rng_1_1(generator));
-    ru = range * (rng_1_1(generator));
-    r_bias = range * (rng_1_1(generator));
+    weights[GRU_RW] = range * (rng_1_1(generator));
+    weights[GRU_RU] = range * (rng_1_1(generator));
+    weights[GRU_R_BIAS] = range * (rng_1_1(generator));
 
-    hw = range * (rng_1_1(generator));
-    hu = range * (rng_1_1(generator));
-    h_bias = range * (rng_1_1(generator));
+    weights[GRU_HW] = range * (rng_1_1(generator));
+    weights[GRU_HU] = range * (rng_1_1(generator));
+    weights[GRU_H_BIAS] = range * (rng_1_1(generator));
 
 }
 
 void GRU_Node::initialize_kaiming(minstd_rand0 &generator, NormalDistribution &normal_distribution, double range){
-    zw = range * normal_distribution.random(generator, 0, 1);
-    zu = range * normal_distribution.random(generator, 0, 1);
-    z_bias = range * normal_distribution.random(generator, 0, 1);
+    weights[GRU_ZW] = range * normal_distribution.random(generator, 0, 1);
+    weights[GRU_ZU] = range * normal_distribution.random(generator, 0, 1);
+    weights[GRU_Z_BIAS] = range * normal_distribution.random(generator, 0, 1);
 
-    rw = range * normal_distribution.random(generator, 0, 1);
-    ru = range * normal_distribution.random(generator, 0, 1);
-    r_bias = range * normal_distribution.random(generator, 0, 1);
+    weights[GRU_RW] = range * normal_distribution.random(generator, 0, 1);
+    weights[GRU_RU] = range * normal_distribution.random(generator, 0, 1);
+    weights[GRU_R_BIAS] = range * normal_distribution.random(generator, 0, 1);
 
-    hw = range * normal_distribution.random(generator, 0, 1);
-    hu = range * normal_distribution.random(generator, 0, 1);
-    h_bias = range * normal_distribution.random(generator, 0, 1);
+    weights[GRU_HW] = range * normal_distribution.random(generator, 0, 1);
+    weights[GRU_HU] = range * normal_distribution.random(generator, 0, 1);
+    weights[GRU_H_BIAS] = range * normal_distribution.random(generator, 0, 1);
 }
 
 void GRU_Node::initialize_uniform_random(minstd_rand0 &generator, uniform_real_distribution<double> &rng) {
-    zw = rng(generator);
-    zu = rng(generator);
-    z_bias = rng(generator);
+    weights[GRU_ZW] = rng(generator);
+    weights[GRU_ZU] = rng(generator);
+    weights[GRU_Z_BIAS] = rng(generator);
 
-    rw = rng(generator);
-    ru = rng(generator);
-    r_bias = rng(generator);
+    weights[GRU_RW] = rng(generator);
+    weights[GRU_RU] = rng(generator);
+    weights[GRU_R_BIAS] = rng(generator);
 
-    hw = rng(generator);
-    hu = rng(generator);
-    h_bias = rng(generator);
+    weights[GRU_HW] = rng(generator);
+    weights[GRU_HU] = rng(generator);
+    weights[GRU_H_BIAS] = rng(generator);
     
 }
 
 double GRU_Node::get_gradient(string gradient_name) {
-    double gradient_sum = 0.0;
-
-    for (int32_t i = 0; i < series_length; i++ ) {
-        if (gradient_name == "zw") {
-            gradient_sum += d_zw[i];
-        } else if (gradient_name == "zu") {
-            gradient_sum += d_zu[i];
-        } else if (gradient_name == "z_bias") {
-            gradient_sum += d_z_bias[i];
-        } else if (gradient_name == "rw") {
-            gradient_sum += d_rw[i];
-        } else if (gradient_name == "ru") {
-            gradient_sum += d_ru[i];
-        } else if (gradient_name == "r_bias") {
-            gradient_sum += d_r_bias[i];
-        } else if (gradient_name == "hw") {
-            gradient_sum += d_hw[i];
-        } else if (gradient_name == "hu") {
-            gradient_sum += d_hu[i];
-        } else if (gradient_name == "h_bias") {
-            gradient_sum += d_h_bias[i];
-        } else {
-            Log::fatal("ERROR: tried to get unknown gradient: '%s'\n", gradient_name.c_str()); 
-            exit(1);
-        }
+    if (gradient_name == "zw") {
+        return d_weights[GRU_ZW];
+    } else if (gradient_name == "zu") {
+        return d_weights[GRU_ZU];
+    } else if (gradient_name == "z_bias") {
+        return d_weights[GRU_Z_BIAS];
+    } else if (gradient_name == "rw") {
+        return d_weights[GRU_RW];
+    } else if (gradient_name == "ru") {
+        return d_weights[GRU_RU];
+    } else if (gradient_name == "r_bias") {
+        return d_weights[GRU_R_BIAS];
+    } else if (gradient_name == "hw") {
+        return d_weights[GRU_HW];
+    } else if (gradient_name == "hu") {
+        return d_weights[GRU_HU];
+    } else if (gradient_name == "h_bias") {
+        return d_weights[GRU_H_BIAS];
+    } else {
+        Log::fatal("ERROR: tried to get unknown gradient: '%s'\n", gradient_name.c_str());
+        exit(1);
     }
-
-    return gradient_sum;
 }
 
 void GRU_Node::print_gradient(string gradient_name) {
@@ -147,27 +151,27 @@ void GRU_Node::input_fired(int32_t time, double incoming_output) {
     double h_prev = 0.0;
     if (time > 0) h_prev = output_values[time - 1];
 
-    double hzu = h_prev * zu;
-    double xzw = x * zw;
-    double z_sum = z_bias + hzu + xzw;
+    double hzu = h_prev * weights[GRU_ZU];
+    double xzw = x * weights[GRU_ZW];
+    double z_sum = weights[GRU_Z_BIAS] + hzu + xzw;
 
     z[time] = sigmoid(z_sum);
     ld_z[time] = sigmoid_derivative(z[time]);
 
     double z_h_prev = h_prev * z[time];
 
-    double xhw = x * hw;
-    double xrw = x * rw;
-    double hru = h_prev * ru;
+    double xhw = x * weights[GRU_HW];
+    double xrw = x * weights[GRU_RW];
+    double hru = h_prev * weights[GRU_RU];
 
-    double r_sum = r_bias + xrw + hru;
+    double r_sum = weights[GRU_R_BIAS] + xrw + hru;
 
     r[time] = sigmoid(r_sum);
     ld_r[time] = sigmoid_derivative(r[time]);
 
-    double hu_r_h_prev = hu * r[time] * h_prev;
+    double hu_r_h_prev = weights[GRU_HU] * r[time] * h_prev;
 
-    double h_sum = h_bias + xhw + hu_r_h_prev;
+    double h_sum = weights[GRU_H_BIAS] + xhw + hu_r_h_prev;
 
     h_tanh[time] = tanh(h_sum);
     ld_h_tanh[time] = tanh_derivative(h_tanh[time]);
@@ -204,30 +208,30 @@ void GRU_Node::try_update_deltas(int32_t time) {
     d_h_prev[time] = d_h * z[time];
 
     double d_z = ((d_h * h_prev) - (d_h * h_tanh[time])) * ld_z[time];
-    d_z_bias[time] = d_z;
-    d_zu[time] = d_z * h_prev;
-    d_h_prev[time] += d_z * zu;
-    d_zw[time] = d_z * x;
-    d_input[time] = d_z * zw;
+    d_weights[GRU_Z_BIAS] += d_z;
+    d_weights[GRU_ZU] += d_z * h_prev;
+    d_h_prev[time] += d_z * weights[GRU_ZU];
+    d_weights[GRU_ZW] += d_z * x;
+    d_input[time] = d_z * weights[GRU_ZW];
 
     double d_h_tanh = (1 - z[time]) * d_h * ld_h_tanh[time];
 
-    d_input[time] += d_h_tanh * hw;
-    d_hw[time] = d_h_tanh * x;
+    d_input[time] += d_h_tanh * weights[GRU_HW];
+    d_weights[GRU_HW] += d_h_tanh * x;
 
-    d_h_bias[time] = d_h_tanh;
+    d_weights[GRU_H_BIAS] += d_h_tanh;
 
-    d_hu[time] = d_h_tanh * r[time] * h_prev;
-    double d_r = d_h_tanh * hu * h_prev * ld_r[time];
+    d_weights[GRU_HU] += d_h_tanh * r[time] * h_prev;
+    double d_r = d_h_tanh * weights[GRU_HU] * h_prev * ld_r[time];
 
-    d_h_prev[time] += d_h_tanh * hu * r[time];
+    d_h_prev[time] += d_h_tanh * weights[GRU_HU] * r[time];
 
-    d_r_bias[time] = d_r;
-    d_ru[time] = d_r * h_prev;
-    d_h_prev[time] += d_r * ru;
+    d_weights[GRU_R_BIAS] += d_r;
+    d_weights[GRU_RU] += d_r * h_prev;
+    d_h_prev[time] += d_r * weights[GRU_RU];
 
-    d_rw[time] = d_r * x;
-    d_input[time] += d_r * rw;
+    d_weights[GRU_RW] += d_r * x;
+    d_input[time] += d_r * weights[GRU_RW];
 
     //reset the reset gate bias to be around 0
     //r_bias -= 1.0;
@@ -254,94 +258,10 @@ int32_t GRU_Node::get_number_weights() const {
     return NUMBER_GRU_WEIGHTS;
 }
 
-void GRU_Node::get_weights(vector<double> &parameters) const {
-    parameters.resize(get_number_weights());
-    int32_t offset = 0;
-    get_weights(offset, parameters);
-}
-
-void GRU_Node::set_weights(const vector<double> &parameters) {
-    int32_t offset = 0;
-    set_weights(offset, parameters);
-}
-
-
-void GRU_Node::set_weights(int32_t &offset, const vector<double> &parameters) {
-    //int32_t start_offset = offset;
-
-    zw = bound(parameters[offset++]);
-    zu = bound(parameters[offset++]);
-    z_bias = bound(parameters[offset++]);
-
-    rw = bound(parameters[offset++]);
-    ru = bound(parameters[offset++]);
-    r_bias = bound(parameters[offset++]);
-
-    hw = bound(parameters[offset++]);
-    hu = bound(parameters[offset++]);
-    h_bias = bound(parameters[offset++]);
-
-
-    //int32_t end_offset = offset;
-    //Log::trace("set weights from offset %d to %d on GRU_Node %d\n", start_offset, end_offset, innovation_number);
-}
-
-void GRU_Node::get_weights(int32_t &offset, vector<double> &parameters) const {
-    //int32_t start_offset = offset;
-
-    parameters[offset++] = zw;
-    parameters[offset++] = zu;
-    parameters[offset++] = z_bias;
-
-    parameters[offset++] = rw;
-    parameters[offset++] = ru;
-    parameters[offset++] = r_bias;
-
-    parameters[offset++] = hw;
-    parameters[offset++] = hu;
-    parameters[offset++] = h_bias;
-
-    //int32_t end_offset = offset;
-    //Log::trace("got weights from offset %d to %d on GRU_Node %d\n", start_offset, end_offset, innovation_number);
-}
-
-
-void GRU_Node::get_gradients(vector<double> &gradients) {
-    gradients.assign(NUMBER_GRU_WEIGHTS, 0.0);
-
-    for (int32_t i = 0; i < NUMBER_GRU_WEIGHTS; i++) {
-        gradients[i] = 0.0;
-    }
-
-    for (int32_t i = 0; i < series_length; i++) {
-        gradients[0] += d_zw[i];
-        gradients[1] += d_zu[i];
-        gradients[2] += d_z_bias[i];
-
-        gradients[3] += d_rw[i];
-        gradients[4] += d_ru[i];
-        gradients[5] += d_r_bias[i];
-
-        gradients[6] += d_hw[i];
-        gradients[7] += d_hu[i];
-        gradients[8] += d_h_bias[i];
-    }
-}
-
 void GRU_Node::reset(int32_t _series_length) {
     series_length = _series_length;
 
-    d_zw.assign(series_length, 0.0);
-    d_zu.assign(series_length, 0.0);
-    d_z_bias.assign(series_length, 0.0);
-
-    d_rw.assign(series_length, 0.0);
-    d_ru.assign(series_length, 0.0);
-    d_r_bias.assign(series_length, 0.0);
-
-    d_hw.assign(series_length, 0.0);
-    d_hu.assign(series_length, 0.0);
-    d_h_bias.assign(series_length, 0.0);
+    for (int32_t i = 0; i < NUMBER_GRU_WEIGHTS; i++) d_weights[i] = 0.0;
 
     d_h_prev.assign(series_length, 0.0);
 
@@ -367,25 +287,7 @@ RNN_Node_Interface* GRU_Node::copy() const {
     GRU_Node* n = new GRU_Node(innovation_number, layer_type, depth);
 
     //copy GRU_Node values
-    n->zw = zw;
-    n->zu = zu;
-    n->z_bias = z_bias;
-    n->rw = rw;
-    n->ru = ru;
-    n->r_bias = r_bias;
-    n->hw = hw;
-    n->hu = hu;
-    n->h_bias = h_bias;
-
-    n->d_zw = d_zw;
-    n->d_zu = d_zu;
-    n->d_z_bias = d_z_bias;
-    n->d_rw = d_rw;
-    n->d_ru = d_ru;
-    n->d_r_bias = d_r_bias;
-    n->d_hw = d_hw;
-    n->d_hu = d_hu;
-    n->d_h_bias = d_h_bias;
+    copy_weights_to(n);
 
     n->d_h_prev = d_h_prev;
 
@@ -17,28 +17,6 @@ using std::vector;
 
 class GRU_Node : public RNN_Node_Interface {
     private:
-        double zw;
-        double zu;
-        double z_bias;
-
-        double rw;
-        double ru;
-        double r_bias;
-
-        double hw;
-        double hu;
-        double h_bias;
-
-        vector<double> d_zw;
-        vector<double> d_zu;
-        vector<double> d_z_bias;
-        vector<double> d_rw;
-        vector<double> d_ru;
-        vector<double> d_r_bias;
-        vector<double> d_hw;
-        vector<double> d_hu;
-        vector<double> d_h_bias;
-
         vector<double> d_h_prev;
 
         vector<double> z;
@@ -69,14 +47,6 @@ class GRU_Node : public RNN_Node_Interface {
 
         int32_t get_number_weights() const;
 
-        void get_weights(vector<double> &parameters) const;
-        void set_weights(const vector<double> &parameters);
-
-        void get_weights(int32_t &offset, vector<double> &parameters) const;
-        void set_weights(int32_t &offset, const vector<double> &parameters);
-
-        void get_gradients(vector<double> &gradients);
-
         void reset(int32_t _series_length);
 
         void write_to_stream(ostream &out);
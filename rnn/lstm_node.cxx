@@ -24,8 +24,22 @@ using std::vector;
 #include "lstm_node.hxx"
 
 
+#define NUMBER_LSTM_WEIGHTS 11
+#define LSTM_OUTPUT_GATE_UPDATE_WEIGHT 0
+#define LSTM_OUTPUT_GATE_WEIGHT 1
+#define LSTM_OUTPUT_GATE_BIAS 2
+#define LSTM_INPUT_GATE_UPDATE_WEIGHT 3
+#define LSTM_INPUT_GATE_WEIGHT 4
+#define LSTM_INPUT_GATE_BIAS 5
+#define LSTM_FORGET_GATE_UPDATE_WEIGHT 6
+#define LSTM_FORGET_GATE_WEIGHT 7
+#define LSTM_FORGET_GATE_BIAS 8
+#define LSTM_CELL_WEIGHT 9
+#define LSTM_CELL_BIAS 10
+
 LSTM_Node::LSTM_Node(int32_t _innovation_number, int32_t _type, double _depth) : RNN_Node_Interface(_innovation_number, _type, _depth) {
     node_type = LSTM_NODE;
+    initialize_weight_storage(NUMBER_LSTM_WEIGHTS);
 }
 
 LSTM_Node::~LSTM_Node() {
@@ -33,120 +47,114 @@ LSTM_Node::~LSTM_Node() {
 
 void LSTM_Node::initialize_lamarckian(minstd_rand0 &generator, NormalDistribution &normal_distribution, double mu, double sigma) {
 
-    output_gate_update_weight = bound(normal_distribution.random(generator, mu, sigma));
-    output_gate_weight = bound(normal_distribution.random(generator, mu, sigma));
-    output_gate_bias = bound(normal_distribution.random(generator, mu, sigma));
+    weights[LSTM_OUTPUT_GATE_UPDATE_WEIGHT] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[LSTM_OUTPUT_GATE_WEIGHT] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[LSTM_OUTPUT_GATE_BIAS] = bound(normal_distribution.random(generator, mu, sigma));
     //output_gate_bias = 0.0;
 
-    input_gate_update_weight = bound(normal_distribution.random(generator, mu, sigma));
-    input_gate_weight = bound(normal_distribution.random(generator, mu, sigma));
-    input_gate_bias = bound(normal_distribution.random(generator, mu, sigma));
+    weights[LSTM_INPUT_GATE_UPDATE_WEIGHT] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[LSTM_INPUT_GATE_WEIGHT] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[LSTM_INPUT_GATE_BIAS] = bound(normal_distribution.random(generator, mu, sigma));
     //input_gate_bias = 0.0;
 
-    forget_gate_update_weight = bound(normal_distribution.random(generator, mu, sigma));
-    forget_gate_weight = bound(normal_distribution.random(generator, mu, sigma));
-    forget_gate_bias = bound(normal_distribution.random(generator, mu, sigma));
+    weights[LSTM_FORGET_GATE_UPDATE_WEIGHT] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[LSTM_FORGET_GATE_WEIGHT] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[LSTM_FORGET_GATE_BIAS] = bound(normal_distribution.random(generator, mu, sigma));
     //forget_gate_bias = 1.0 + bound(normal_distribution.random(generator, mu, sigma));
 
-    cell_weight = bound(normal_distribution.random(generator, mu, sigma));
-    cell_bias = bound(normal_distribution.random(generator, mu, sigma));
+    weights[LSTM_CELL_WEIGHT] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[LSTM_CELL_BIAS] = bound(normal_distribution.random(generator, mu, sigma));
     //cell_bias = 0.0;
 }
 
 void LSTM_Node::initialize_xavier(minstd_rand0 &generator, uniform_real_distribution<double> &rng_1_1, double range) {
 
-    output_gate_update_weight = range * (rng_1_1(generator));
-    output_gate_weight = range * (rng_1_1(generator));
-    output_gate_bias = range * (rng_1_1(generator));
+    weights[LSTM_OUTPUT_GATE_UPDATE_WEIGHT] = range * (rng_1_1(generator));
+    weights[LSTM_OUTPUT_GATE_WEIGHT] = range * (rng_1_1(generator));
+    weights[LSTM_OUTPUT_GATE_BIAS] = range * (rng_1_1(generator));
     //output_gate_bias = 0.0;
 
-    input_gate_update_weight = range * (rng_1_1(generator));
-    input_gate_weight = range * (rng_1_1(generator));
-    input_gate_bias = range * (rng_1_1(generator));
+    weights[LSTM_INPUT_GATE_UPDATE_WEIGHT] = range * (rng_1_1(generator));
+    weights[LSTM_INPUT_GATE_WEIGHT] = range * (rng_1_1(generator));
+    weights[LSTM_INPUT_GATE_BIAS] = range * (rng_1_1(generator));
     //input_gate_bias = 0.0;
 
-    forget_gate_update_weight = range * (rng_1_1(generator));
-    forget_gate_weight = range * (rng_1_1(generator));
-    forget_gate_bias = range * (rng_1_1(generator));
+    weights[LSTM_FORGET_GATE_UPDATE_WEIGHT] = range * (rng_1_1(generator));
+    weights[LSTM_FORGET_GATE_WEIGHT] = range * (rng_1_1(generator));
+    weights[LSTM_FORGET_GATE_BIAS] = range * (rng_1_1(generator));
     //forget_gate_bias = 1.0 + bound(normal_distribution.random(generator, mu, sigma));
 
-    cell_weight = range * (rng_1_1(generator));
-    cell_bias = range * (rng_1_1(generator));
+    weights[LSTM_CELL_WEIGHT] = range * (rng_1_1(generator));
+    weights[LSTM_CELL_BIAS] = range * (rng_1_1(generator));
 }
 
 void LSTM_Node::initialize_kaiming(minstd_rand0 &generator, NormalDistribution &normal_distribution, double range) {
-    output_gate_update_weight = range * normal_distribution.random(generator, 0, 1);
-    output_gate_weight = range * normal_distribution.random(generator, 0, 1);
-    output_gate_bias = range * normal_distribution.random(generator, 0, 1);
+    weights[LSTM_OUTPUT_GATE_UPDATE_WEIGHT] = range * normal_distribution.random(generator, 0, 1);
+    weights[LSTM_OUTPUT_GATE_WEIGHT] = range * normal_distribution.random(generator, 0, 1);
+    weights[LSTM_OUTPUT_GATE_BIAS] = range * normal_distribution.random(generator, 0, 1);
     //output_gate_bias = 0.0;
 
-    input_gate_update_weight = range * normal_distribution.random(generator, 0, 1);
-    input_gate_weight = range * normal_distribution.random(generator, 0, 1);
-    input_gate_bias = range * normal_distribution.random(generator, 0, 1);
+    weights[LSTM_INPUT_GATE_UPDATE_WEIGHT] = range * normal_distribution.random(generator, 0, 1);
+    weights[LSTM_INPUT_GATE_WEIGHT] = range * normal_distribution.random(generator, 0, 1);
+    weights[LSTM_INPUT_GATE_BIAS] = range * normal_distribution.random(generator, 0, 1);
     //input_gate_bias = 0.0;
 
-    forget_gate_update_weight = range * normal_distribution.random(generator, 0, 1);
-    forget_gate_weight = range * normal_distribution.random(generator, 0, 1);
-    forget_gate_bias = range * normal_distribution.random(generator, 0, 1);
+    weights[LSTM_FORGET_GATE_UPDATE_WEIGHT] = range * normal_distribution.random(generator, 0, 1);
+    weights[LSTM_FORGET_GATE_WEIGHT] = range * normal_distribution.random(generator, 0, 1);
+    weights[LSTM_FORGET_GATE_BIAS] = range * normal_distribution.random(generator, 0, 1);
     //forget_gate_bias = 1.0 + bound(normal_distribution.random(generator, mu, sigma));
 
-    cell_weight = range * normal_distribution.random(generator, 0, 1);
-    cell_bias = range * normal_distribution.random(generator, 0, 1);
+    weights[LSTM_CELL_WEIGHT] = range * normal_distribution.random(generator, 0, 1);
+    weights[LSTM_CELL_BIAS] = range * normal_distribution.random(generator, 0, 1);
 }
 
 void LSTM_Node::initialize_uniform_random(minstd_rand0 &generator, uniform_real_distribution<double> &rng) {
-    output_gate_update_weight = rng(generator);
-    output_gate_weight = rng(generator);
-    output_gate_bias = rng(generator);
+    weights[LSTM_OUTPUT_GATE_UPDATE_WEIGHT] = rng(generator);
+    weights[LSTM_OUTPUT_GATE_WEIGHT] = rng(generator);
+    weights[LSTM_OUTPUT_GATE_BIAS] = rng(generator);
     //output_gate_bias = 0.0;
 
-    input_gate_update_weight = rng(generator);
-    input_gate_weight = rng(generator);
-    input_gate_bias = rng(generator);
+    weights[LSTM_INPUT_GATE_UPDATE_WEIGHT] = rng(generator);
+    weights[LSTM_INPUT_GATE_WEIGHT] = rng(generator);
+    weights[LSTM_INPUT_GATE_BIAS] = rng(generator);
     //input_gate_bias = 0.0;
 
-    forget_gate_update_weight = rng(generator);
-    forget_gate_weight = rng(generator);
-    forget_gate_bias = rng(generator);
+    weights[LSTM_FORGET_GATE_UPDATE_WEIGHT] = rng(generator);
+    weights[LSTM_FORGET_GATE_WEIGHT] = rng(generator);
+    weights[LSTM_FORGET_GATE_BIAS] = rng(generator);
     //forget_gate_bias = 1.0 + bound(normal_distribution.random(generator, mu, sigma));
 
-    cell_weight = rng(generator);
-    cell_bias = rng(generator);
+    weights[LSTM_CELL_WEIGHT] = rng(generator);
+    weights[LSTM_CELL_BIAS] = rng(generator);
 }
 
 double LSTM_Node::get_gradient(string gradient_name) {
-    double gradient_sum = 0.0;
-
-    for (int32_t i = 0; i < series_length; i++ ) {
-        if (gradient_name == "output_gate_update_weight") {
-            gradient_sum += d_output_gate_update_weight[i];
-        } else if (gradient_name == "output_gate_weight") {
-            gradient_sum += d_output_gate_weight[i];
-        } else if (gradient_name == "output_gate_bias") {
-            gradient_sum += d_output_gate_bias[i];
-        } else if (gradient_name == "input_gate_update_weight") {
-            gradient_sum += d_input_gate_update_weight[i];
-        } else if (gradient_name == "input_gate_weight") {
-            gradient_sum += d_input_gate_weight[i];
-        } else if (gradient_name == "input_gate_bias") {
-            gradient_sum += d_input_gate_bias[i];
-        } else if (gradient_name == "forget_gate_update_weight") {
-            gradient_sum += d_forget_gate_update_weight[i];
-        } else if (gradient_name == "forget_gate_weight") {
-            gradient_sum += d_forget_gate_weight[i];
-        } else if (gradient_name == "forget_gate_bias") {
-            gradient_sum += d_forget_gate_bias[i];
-        } else if (gradient_name == "cell_weight") {
-            gradient_sum += d_cell_weight[i];
-        } else if (gradient_name == "cell_bias") {
-            gradient_sum += d_cell_bias[i];
-        } else {
-            Log::fatal("ERROR: tried to get unknown gradient: '%s'\n", gradient_name.c_str());
-            exit(1);
-        }
+    if (gradient_name == "output_gate_update_weight") {
+        return d_weights[LSTM_OUTPUT_GATE_UPDATE_WEIGHT];
+    } else if (gradient_name == "output_gate_weight") {
+        return d_weights[LSTM_OUTPUT_GATE_WEIGHT];
+    } else if (gradient_name == "output_gate_bias") {
+        return d_weights[LSTM_OUTPUT_GATE_BIAS];
+    } else if (gradient_name == "input_gate_update_weight") {
+        return d_weights[LSTM_INPUT_GATE_UPDATE_WEIGHT];
+    } else if (gradient_name == "input_gate_weight") {
+        return d_weights[LSTM_INPUT_GATE_WEIGHT];
+    } else if (gradient_name == "input_gate_bias") {
+        return d_weights[LSTM_INPUT_GATE_BIAS];
+    } else if (gradient_name == "forget_gate_update_weight") {
+        return d_weights[LSTM_FORGET_GATE_UPDATE_WEIGHT];
+    } else if (gradient_name == "forget_gate_weight") {
+        return d_weights[LSTM_FORGET_GATE_WEIGHT];
+    } else if (gradient_name == "forget_gate_bias") {
+        return d_weights[LSTM_FORGET_GATE_BIAS];
+    } else if (gradient_name == "cell_weight") {
+        return d_weights[LSTM_CELL_WEIGHT];
+    } else if (gradient_name == "cell_bias") {
+        return d_weights[LSTM_CELL_BIAS];
+    } else {
+        Log::fatal("ERROR: tried to get unknown gradient: '%s'\n", gradient_name.c_str());
+        exit(1);
     }
-
-    return gradient_sum;
 }
 
 void LSTM_Node::print_gradient(string gradient_name) {
@@ -171,27 +179,27 @@ void LSTM_Node::input_fired(int32_t time, double incoming_output) {
 
     //forget gate bias should be around 1.0 intead of 0, but we do it here to not throw
     //off the mu/sigma of the parameters
-    forget_gate_bias = forget_gate_bias + 1.0;
+    weights[LSTM_FORGET_GATE_BIAS] = weights[LSTM_FORGET_GATE_BIAS] + 1.0;
 
-    output_gate_values[time] = sigmoid(output_gate_weight * input_value + output_gate_update_weight * previous_cell_value + output_gate_bias);
-    input_gate_values[time] = sigmoid(input_gate_weight * input_value + input_gate_update_weight * previous_cell_value + input_gate_bias);
-    forget_gate_values[time] = sigmoid(forget_gate_weight * input_value + forget_gate_update_weight * previous_cell_value + forget_gate_bias);
+    output_gate_values[time] = sigmoid(weights[LSTM_OUTPUT_GATE_WEIGHT] * input_value + weights[LSTM_OUTPUT_GATE_UPDATE_WEIGHT] * previous_cell_value + weights[LSTM_OUTPUT_GATE_BIAS]);
+    input_gate_values[time] = sigmoid(weights[LSTM_INPUT_GATE_WEIGHT] * input_value + weights[LSTM_INPUT_GATE_UPDATE_WEIGHT] * previous_cell_value + weights[LSTM_INPUT_GATE_BIAS]);
+    forget_gate_values[time] = sigmoid(weights[LSTM_FORGET_GATE_WEIGHT] * input_value + weights[LSTM_FORGET_GATE_UPDATE_WEIGHT] * previous_cell_value + weights[LSTM_FORGET_GATE_BIAS]);
 
     ld_output_gate[time] = sigmoid_derivative(output_gate_values[time]);
     ld_input_gate[time] = sigmoid_derivative(input_gate_values[time]);
     ld_forget_gate[time] = sigmoid_derivative(forget_gate_values[time]);
 
     /*
-       output_gate_values[time] = output_gate_weight * input_value + output_gate_update_weight * previous_cell_value + output_gate_bias;
-       input_gate_values[time] = input_gate_weight * input_value + input_gate_update_weight * previous_cell_value + input_gate_bias;
-       forget_gate_values[time] = forget_gate_weight * input_value + forget_gate_update_weight * previous_cell_value + forget_gate_bias;
+       output_gate_values[time] = weights[LSTM_OUTPUT_GATE_WEIGHT] * input_value + weights[LSTM_OUTPUT_GATE_UPDATE_WEIGHT] * previous_cell_value + weights[LSTM_OUTPUT_GATE_BIAS];
+       input_gate_values[time] = weights[LSTM_INPUT_GATE_WEIGHT] * input_value + weights[LSTM_INPUT_GATE_UPDATE_WEIGHT] * previous_cell_value + weights[LSTM_INPUT_GATE_BIAS];
+       forget_gate_values[time] = weights[LSTM_FORGET_GATE_WEIGHT] * input_value + weights[LSTM_FORGET_GATE_UPDATE_WEIGHT] * previous_cell_value + weights[LSTM_FORGET_GATE_BIAS];
 
        ld_output_gate[time] = 1.0;
        ld_input_gate[time] = 1.0;
        ld_forget_gate[time] = 1.0;
        */
 
-    cell_in_tanh[time] = tanh(cell_weight * input_value + cell_bias);
+    cell_in_tanh[time] = tanh(weights[LSTM_CELL_WEIGHT] * input_value + weights[LSTM_CELL_BIAS]);
     ld_cell_in[time] = tanh_derivative(cell_in_tanh[time]);
 
     cell_values[time] = (forget_gate_values[time] * previous_cell_value) + (input_gate_values[time] * cell_in_tanh[time]);
@@ -204,7 +212,7 @@ void LSTM_Node::input_fired(int32_t time, double incoming_output) {
 
     output_values[time] = output_gate_values[time] * cell_out_tanh[time];
 
-    forget_gate_bias -= 1.0;
+    weights[LSTM_FORGET_GATE_BIAS] -= 1.0;
 }
 
 void LSTM_Node::try_update_deltas(int32_t time) {
@@ -222,11 +230,11 @@ void LSTM_Node::try_update_deltas(int32_t time) {
 
     //backprop output gate
     double d_output_gate = error * cell_out_tanh[time] * ld_output_gate[time];
-    d_output_gate_bias[time] = d_output_gate;
-    d_output_gate_update_weight[time] = d_output_gate * previous_cell_value;
-    d_output_gate_weight[time] = d_output_gate * input_value;
-    d_prev_cell[time] += d_output_gate * output_gate_update_weight;
-    d_input[time] += d_output_gate * output_gate_weight;
+    d_weights[LSTM_OUTPUT_GATE_BIAS] += d_output_gate;
+    d_weights[LSTM_OUTPUT_GATE_UPDATE_WEIGHT] += d_output_gate * previous_cell_value;
+    d_weights[LSTM_OUTPUT_GATE_WEIGHT] += d_output_gate * input_value;
+    d_prev_cell[time] += d_output_gate * weights[LSTM_OUTPUT_GATE_UPDATE_WEIGHT];
+    d_input[time] += d_output_gate * weights[LSTM_OUTPUT_GATE_WEIGHT];
 
     //backprop the cell path
 
@@ -238,25 +246,25 @@ void LSTM_Node::try_update_deltas(int32_t time) {
     d_prev_cell[time] += d_cell_out * forget_gate_values[time];
 
     double d_forget_gate = d_cell_out * previous_cell_value * ld_forget_gate[time];
-    d_forget_gate_bias[time] = d_forget_gate;
-    d_forget_gate_update_weight[time] = d_forget_gate * previous_cell_value;
-    d_forget_gate_weight[time] = d_forget_gate * input_value;
-    d_prev_cell[time] += d_forget_gate * forget_gate_update_weight;
-    d_input[time] += d_forget_gate * forget_gate_weight;
+    d_weights[LSTM_FORGET_GATE_BIAS] += d_forget_gate;
+    d_weights[LSTM_FORGET_GATE_UPDATE_WEIGHT] += d_forget_gate * previous_cell_value;
+    d_weights[LSTM_FORGET_GATE_WEIGHT] += d_forget_gate * input_value;
+    d_prev_cell[time] += d_forget_gate * weights[LSTM_FORGET_GATE_UPDATE_WEIGHT];
+    d_input[time] += d_forget_gate * weights[LSTM_FORGET_GATE_WEIGHT];
 
     //backprob input gate
     double d_input_gate = d_cell_out * cell_in_tanh[time] * ld_input_gate[time];
-    d_input_gate_bias[time] = d_input_gate;
-    d_input_gate_update_weight[time] = d_input_gate * previous_cell_value;
-    d_input_gate_weight[time] = d_input_gate * input_value;
-    d_prev_cell[time] += d_input_gate * input_gate_update_weight;
-    d_input[time] += d_input_gate * input_gate_weight;
+    d_weights[LSTM_INPUT_GATE_BIAS] += d_input_gate;
+    d_weights[LSTM_INPUT_GATE_UPDATE_WEIGHT] += d_input_gate * previous_cell_value;
+    d_weights[LSTM_INPUT_GATE_WEIGHT] += d_input_gate * input_value;
+    d_prev_cell[time] += d_input_gate * weights[LSTM_INPUT_GATE_UPDATE_WEIGHT];
+    d_input[time] += d_input_gate * weights[LSTM_INPUT_GATE_WEIGHT];
 
     //backprop cell input
     double d_cell_in = d_cell_out * input_gate_values[time] * ld_cell_in[time];
-    d_cell_bias[time] = d_cell_in;
-    d_cell_weight[time] = d_cell_in * input_value;
-    d_input[time] += d_cell_in * cell_weight;
+    d_weights[LSTM_CELL_BIAS] += d_cell_in;
+    d_weights[LSTM_CELL_WEIGHT] += d_cell_in * input_value;
+    d_input[time] += d_cell_in * weights[LSTM_CELL_WEIGHT];
 }
 
 void LSTM_Node::error_fired(int32_t time, double error) {
@@ -276,89 +284,13 @@ void LSTM_Node::output_fired(int32_t time, double delta) {
 }
 
 int32_t LSTM_Node::get_number_weights() const {
-    return 11;
+    return NUMBER_LSTM_WEIGHTS;
 }
 
-void LSTM_Node::get_weights(vector<double> &parameters) const {
-    parameters.resize(get_number_weights());
-    int32_t offset = 0;
-    get_weights(offset, parameters);
-}
-
-void LSTM_Node::set_weights(const vector<double> &parameters) {
-    int32_t offset = 0;
-    set_weights(offset, parameters);
-}
-
-
-void LSTM_Node::set_weights(int32_t &offset, const vector<double> &parameters) {
-    //int32_t start_offset = offset;
-
-    output_gate_update_weight = bound(parameters[offset++]);
-    output_gate_weight = bound(parameters[offset++]);
-    output_gate_bias = bound(parameters[offset++]);
-
-    input_gate_update_weight = bound(parameters[offset++]);
-    input_gate_weight = bound(parameters[offset++]);
-    input_gate_bias = bound(parameters[offset++]);
-
-    forget_gate_update_weight = bound(parameters[offset++]);
-    forget_gate_weight = bound(parameters[offset++]);
-    forget_gate_bias = bound(parameters[offset++]);
-
-    cell_weight = bound(parameters[offset++]);
-    cell_bias = bound(parameters[offset++]);
-
-    //int32_t end_offset = offset;
-    //Log::trace("set weights from offset %d to %d on LSTM_Node %d\n", start_offset, end_offset, innovation_number);
-}
-
-void LSTM_Node::get_weights(int32_t &offset, vector<double> &parameters) const {
-    //int32_t start_offset = offset;
-
-    parameters[offset++] = output_gate_update_weight;
-    parameters[offset++] = output_gate_weight;
-    parameters[offset++] = output_gate_bias;
-
-    parameters[offset++] = input_gate_update_weight;
-    parameters[offset++] = input_gate_weight;
-    parameters[offset++] = input_gate_bias;
-
-    parameters[offset++] = forget_gate_update_weight;
-    parameters[offset++] = forget_gate_weight;
-    parameters[offset++] = forget_gate_bias;
-
-    parameters[offset++] = cell_weight;
-    parameters[offset++] = cell_bias;
-
-    //int32_t end_offset = offset;
-    //Log::trace("got weights from offset %d to %d on LSTM_Node %d\n", start_offset, end_offset, innovation_number);
-}
-
-
-void LSTM_Node::get_gradients(vector<double> &gradients) {
-    gradients.assign(11, 0.0);
-
-    for (int32_t i = 0; i < 11; i++) {
-        gradients[i] = 0.0;
-    }
-
-    for (int32_t i = 0; i < series_length; i++) {
-        gradients[0] += d_output_gate_update_weight[i];
-        gradients[1] += d_output_gate_weight[i];
-        gradients[2] += d_output_gate_bias[i];
-
-        gradients[3] += d_input_gate_update_weight[i];
-        gradients[4] += d_input_gate_weight[i];
-        gradients[5] += d_input_gate_bias[i];
-
-        gradients[6] += d_forget_gate_update_weight[i];
-        gradients[7] += d_forget_gate_weight[i];
-        gradients[8] += d_forget_gate_bias[i];
-
-        gradients[9] += d_cell_weight[i];
-        gradients[10] += d_cell_bias[i];
-    }
+void LSTM_Node::carry_state(int32_t from_time, int32_t to_time) {
+    //the cell value is the LSTM's recurrent state, as well as its output
+    cell_values[to_time] = cell_values[from_time];
+    RNN_Node_Interface::carry_state(from_time, to_time);
 }
 
 void LSTM_Node::reset(int32_t _series_length) {
@@ -376,20 +308,7 @@ void LSTM_Node::reset(int32_t _series_length) {
     d_input.assign(series_length, 0.0);
     d_prev_cell.assign(series_length, 0.0);
 
-    d_output_gate_update_weight.assign(series_length, 0.0);
-    d_output_gate_weight.assign(series_length, 0.0);
-    d_output_gate_bias.assign(series_length, 0.0);
-
-    d_input_gate_update_weight.assign(series_length, 0.0);
-    d_input_gate_weight.assign(series_length, 0.0);
-    d_input_gate_bias.assign(series_length, 0.0);
-
-    d_forget_gate_update_weight.assign(series_length, 0.0);
-    d_forget_gate_weight.assign(series_length, 0.0);
-    d_forget_gate_bias.assign(series_length, 0.0);
-
-    d_cell_weight.assign(series_length, 0.0);
-    d_cell_bias.assign(series_length, 0.0);
+    for (int32_t i = 0; i < NUMBER_LSTM_WEIGHTS; i++) d_weights[i] = 0.0;
 
     output_gate_values.assign(series_length, 0.0);
     input_gate_values.assign(series_length, 0.0);
@@ -409,20 +328,7 @@ RNN_Node_Interface* LSTM_Node::copy() const {
     LSTM_Node* n = new LSTM_Node(innovation_number, layer_type, depth);
 
     //copy LSTM_Node values
-    n->output_gate_update_weight = output_gate_update_weight;
-    n->output_gate_weight = output_gate_weight;
-    n->output_gate_bias = output_gate_bias;
-
-    n->input_gate_update_weight = input_gate_update_weight;
-    n->input_gate_weight = input_gate_weight;
-    n->input_gate_bias = input_gate_bias;
-
-    n->forget_gate_update_weight = forget_gate_update_weight;
-    n->forget_gate_weight = forget_gate_weight;
-    n->forget_gate_bias = forget_gate_bias;
-
-    n->cell_weight = cell_weight;
-    n->cell_bias = cell_bias;
+    copy_weights_to(n);
 
     n->output_gate_values = output_gate_values;
     n->input_gate_values = input_gate_values;
@@ -440,22 +346,6 @@ RNN_Node_Interface* LSTM_Node::copy() const {
 
     n->d_prev_cell = d_prev_cell;
 
-    n->d_output_gate_update_weight = d_output_gate_update_weight;
-    n->d_output_gate_weight = d_output_gate_weight;
-    n->d_output_gate_bias = d_output_gate_bias;
-
-    n->d_input_gate_update_weight = d_input_gate_update_weight;
-    n->d_input_gate_weight = d_input_gate_weight;
-    n->d_input_gate_bias = d_input_gate_bias;
-
-    n->d_forget_gate_update_weight = d_forget_gate_update_weight;
-    n->d_forget_gate_weight = d_forget_gate_weight;
-    n->d_forget_gate_bias = d_forget_gate_bias;
-
-    n->d_cell_weight = d_cell_weight;
-    n->d_cell_bias = d_cell_bias;
-
-
     //copy RNN_Node_Interface values
     n->series_length = series_length;
     n->input_values = input_values;
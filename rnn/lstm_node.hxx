@@ -17,21 +17,6 @@ using std::vector;
 
 class LSTM_Node : public RNN_Node_Interface {
     private:
-        double output_gate_update_weight;
-        double output_gate_weight;
-        double output_gate_bias;
-
-        double input_gate_update_weight;
-        double input_gate_weight;
-        double input_gate_bias;
-
-        double forget_gate_update_weight;
-        double forget_gate_weight;
-        double forget_gate_bias;
-
-        double cell_weight;
-        double cell_bias;
-
         vector<double> output_gate_values;
         vector<double> input_gate_values;
         vector<double> forget_gate_values;
@@ -48,21 +33,6 @@ class LSTM_Node : public RNN_Node_Interface {
 
         vector<double> d_prev_cell;
 
-        vector<double> d_output_gate_update_weight;
-        vector<double> d_output_gate_weight;
-        vector<double> d_output_gate_bias;
-
-        vector<double> d_input_gate_update_weight;
-        vector<double> d_input_gate_weight;
-        vector<double> d_input_gate_bias;
-
-        vector<double> d_forget_gate_update_weight;
-        vector<double> d_forget_gate_weight;
-        vector<double> d_forget_gate_bias;
-
-        vector<double> d_cell_weight;
-        vector<double> d_cell_bias;
-
     public:
 
         LSTM_Node(int32_t _innovation_number, int32_t _type, double _depth);
@@ -84,15 +54,8 @@ class LSTM_Node : public RNN_Node_Interface {
 
         int32_t get_number_weights() const;
 
-        void get_weights(vector<double> &parameters) const;
-        void set_weights(const vector<double> &parameters);
-
-        void get_weights(int32_t &offset, vector<double> &parameters) const;
-        void set_weights(int32_t &offset, const vector<double> &parameters);
-
-        void get_gradients(vector<double> &gradients);
-
         void reset(int32_t _series_length);
+        void carry_state(int32_t from_time, int32_t to_time);
 
         void write_to_stream(ostream &out);
 
@@ -25,9 +25,16 @@ using std::vector;
 
 
 #define NUMBER_MGU_WEIGHTS 6
+#define MGU_FW 0
+#define MGU_FU 1
+#define MGU_F_BIAS 2
+#define MGU_HW 3
+#define MGU_HU 4
+#define MGU_H_BIAS 5
 
 MGU_Node::MGU_Node(int32_t _innovation_number, int32_t _layer_type, double _depth) : RNN_Node_Interface(_innovation_number, _layer_type, _depth) {
     node_type = MGU_NODE;
+    initialize_weight_storage(NUMBER_MGU_WEIGHTS);
 }
 
 MGU_Node::~MGU_Node() {
@@ -35,70 +42,64 @@ MGU_Node::~MGU_Node() {
 
 void MGU_Node::initialize_lamarckian(minstd_rand0 &generator, NormalDistribution &normal_distribution, double mu, double sigma) {
 
-    fw = bound(normal_distribution.random(generator, mu, sigma));
-    fu = bound(normal_distribution.random(generator, mu, sigma));
-    f_bias = bound(normal_distribution.random(generator, mu, sigma));
+    weights[MGU_FW] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[MGU_FU] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[MGU_F_BIAS] = bound(normal_distribution.random(generator, mu, sigma));
 
-    hw = bound(normal_distribution.random(generator, mu, sigma));
-    hu = bound(normal_distribution.random(generator, mu, sigma));
-    h_bias = bound(normal_distribution.random(generator, mu, sigma));
+    weights[MGU_HW] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[MGU_HU] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[MGU_H_BIAS] = bound(normal_distribution.random(generator, mu, sigma));
 }
 
 void MGU_Node::initialize_xavier(minstd_rand0 &generator, uniform_real_distribution<double> &rng_1_1, double range) {
 
-    fw = range * (rng_1_1(generator));
-    fu = range * (rng_1_1(generator));
-    f_bias = range * (rng_1_1(generator));
+    weights[MGU_FW] = range * (rng_1_1(generator));
+    weights[MGU_FU] = range * (rng_1_1(generator));
+    weights[MGU_F_BIAS] = range * (rng_1_1(generator));
 
-    hw = range * (rng_1_1(generator));
-    hu = range * (rng_1_1(generator));
-    h_bias = range * (rng_1_1(generator));
+    weights[MGU_HW] = range * (rng_1_1(generator));
+    weights[MGU_HU] = range * (rng_1_1(generator));
+    weights[MGU_H_BIAS] = range * (rng_1_1(generator));
     
 }
 
 void MGU_Node::initialize_kaiming(minstd_rand0 &generator, NormalDistribution &normal_distribution, double range){
-    fw = range * normal_distribution.random(generator, 0, 1);
-    fu = range * normal_distribution.random(generator, 0, 1);
-    f_bias = range * normal_distribution.random(generator, 0, 1);
+    weights[MGU_FW] = range * normal_distribution.random(generator, 0, 1);
+    weights[MGU_FU] = range * normal_distribution.random(generator, 0, 1);
+    weights[MGU_F_BIAS] = range * normal_distribution.random(generator, 0, 1);
 
-    hw = range * normal_distribution.random(generator, 0, 1);
-    hu = range * normal_distribution.random(generator, 0, 1);
-    h_bias = range * normal_distribution.random(generator, 0, 1);
+    weights[MGU_HW] = range * normal_distribution.random(generator, 0, 1);
+    weights[MGU_HU] = range * normal_distribution.random(generator, 0, 1);
+    weights[MGU_H_BIAS] = range * normal_distribution.random(generator, 0, 1);
 }
 
 void MGU_Node::initialize_uniform_random(minstd_rand0 &generator, uniform_real_distribution<double> &rng) {
-    fw = rng(generator);
-    fu = rng(generator);
-    f_bias = rng(generator);
+    weights[MGU_FW] = rng(generator);
+    weights[MGU_FU] = rng(generator);
+    weights[MGU_F_BIAS] = rng(generator);
 
-    hw = rng(generator);
-    hu = rng(generator);
-    h_bias = rng(generator);
+    weights[MGU_HW] = rng(generator);
+    weights[MGU_HU] = rng(generator);
+    weights[MGU_H_BIAS] = rng(generator);
 }
 
 double MGU_Node::get_gradient(string gradient_name) {
-    double gradient_sum = 0.0;
-
-    for (int32_t i = 0; i < series_length; i++ ) {
-        if (gradient_name == "fw") {
-            gradient_sum += d_fw[i];
-        } else if (gradient_name == "fu") {
-            gradient_sum += d_fu[i];
-        } else if (gradient_name == "f_bias") {
-            gradient_sum += d_f_bias[i];
-        } else if (gradient_name == "hw") {
-            gradient_sum += d_hw[i];
-        } else if (gradient_name == "hu") {
-            gradient_sum += d_hu[i];
-        } else if (gradient_name == "h_bias") {
-            gradient_sum += d_h_bias[i];
-        } else {
-            Log::fatal("ERROR: tried to get unknown gradient: '%s'\n", gradient_name.c_str());
-            exit(1);
-        }
+    if (gradient_name == "fw") {
+        return d_weights[MGU_FW];
+    } else if (gradient_name == "fu") {
+        return d_weights[MGU_FU];
+    } else if (gradient_name == "f_bias") {
+        return d_weights[MGU_F_BIAS];
+    } else if (gradient_name == "hw") {
+        return d_weights[MGU_HW];
+    } else if (gradient_name == "hu") {
+        return d_weights[MGU_HU];
+    } else if (gradient_name == "h_bias") {
+        return d_weights[MGU_H_BIAS];
+    } else {
+        Log::fatal("ERROR: tried to get unknown gradient: '%s'\n", gradient_name.c_str());
+        exit(1);
     }
-
-    return gradient_sum;
 }
 
 void MGU_Node::print_gradient(string gradient_name) {
@@ -124,15 +125,15 @@ void MGU_Node::input_fired(int32_t time, double incoming_output) {
     double h_prev = 0.0;
     if (time > 0) h_prev = output_values[time - 1];
 
-    double hfu = h_prev * fu;
-    double xfw = x * fw;
-    double f_sum = f_bias + hfu + xfw;
+    double hfu = h_prev * weights[MGU_FU];
+    double xfw = x * weights[MGU_FW];
+    double f_sum = weights[MGU_F_BIAS] + hfu + xfw;
     f[time] = sigmoid(f_sum);
     ld_f[time] = sigmoid_derivative(f[time]);
 
-    double xhw = x * hw;
-    double hu_f_h_prev = hu * f[time] * h_prev;
-    double h_sum = h_bias + xhw + hu_f_h_prev;
+    double xhw = x * weights[MGU_HW];
+    double hu_f_h_prev = weights[MGU_HU] * f[time] * h_prev;
+    double h_sum = weights[MGU_H_BIAS] + xhw + hu_f_h_prev;
 
     h_tanh[time] = tanh(h_sum);
     ld_h_tanh[time] = tanh_derivative(h_tanh[time]);
@@ -162,22 +163,22 @@ void MGU_Node::try_update_deltas(int32_t time) {
     d_h_prev[time] = d_out * (1-f[time]);
 
     double d_h_tanh  = d_out * f[time] * ld_h_tanh[time];
-    d_h_bias[time]   = d_h_tanh;
-    d_hw[time]       = d_h_tanh * x;
-    d_hu[time]       = d_h_tanh * f[time] * h_prev;
-    d_input[time]    += d_h_tanh * hw;
-    d_h_prev[time]   += d_h_tanh * hu * f[time];
+    d_weights[MGU_H_BIAS] += d_h_tanh;
+    d_weights[MGU_HW] += d_h_tanh * x;
+    d_weights[MGU_HU] += d_h_tanh * f[time] * h_prev;
+    d_input[time]    += d_h_tanh * weights[MGU_HW];
+    d_h_prev[time]   += d_h_tanh * weights[MGU_HU] * f[time];
 
     double d_f_sigmoid  = ((d_out * h_tanh[time]) - (d_out * h_prev));
-    d_f_sigmoid         += d_h_tanh * hu * h_prev;
+    d_f_sigmoid         += d_h_tanh * weights[MGU_HU] * h_prev;
 
     double d_f = d_f_sigmoid * ld_f[time];
 
-    d_f_bias[time]  = d_f;
-    d_fu[time]      = d_f * h_prev;
-    d_fw[time]      = d_f * x;
-    d_input[time]   += d_f * fw;
-    d_h_prev[time]  += d_f * fu;
+    d_weights[MGU_F_BIAS] += d_f;
+    d_weights[MGU_FU] += d_f * h_prev;
+    d_weights[MGU_FW] += d_f * x;
+    d_input[time]   += d_f * weights[MGU_FW];
+    d_h_prev[time]  += d_f * weights[MGU_FU];
 
 }
 
@@ -202,77 +203,10 @@ int32_t MGU_Node::get_number_weights() const {
     return NUMBER_MGU_WEIGHTS;
 }
 
-void MGU_Node::get_weights(vector<double> &parameters) const {
-    parameters.resize(get_number_weights());
-    int32_t offset = 0;
-    get_weights(offset, parameters);
-}
-
-void MGU_Node::set_weights(const vector<double> &parameters) {
-    int32_t offset = 0;
-    set_weights(offset, parameters);
-}
-
-
-void MGU_Node::set_weights(int32_t &offset, const vector<double> &parameters) {
-    //int32_t start_offset = offset;
-
-    fw = bound(parameters[offset++]);
-    fu = bound(parameters[offset++]);
-    f_bias = bound(parameters[offset++]);
-
-    hw = bound(parameters[offset++]);
-    hu = bound(parameters[offset++]);
-    h_bias = bound(parameters[offset++]);
-
-
-    //int32_t end_offset = offset;
-    //Log::trace("set weights from offset %d to %d on MGU_Node %d\n", start_offset, end_offset, innovation_number);
-}
-
-void MGU_Node::get_weights(int32_t &offset, vector<double> &parameters) const {
-    //int32_t start_offset = offset;
-
-    parameters[offset++] = fw;
-    parameters[offset++] = fu;
-    parameters[offset++] = f_bias;
-
-    parameters[offset++] = hw;
-    parameters[offset++] = hu;
-    parameters[offset++] = h_bias;
-
-    //int32_t end_offset = offset;
-    //Log::trace("got weights from offset %d to %d on MGU_Node %d\n", start_offset, end_offset, innovation_number);
-}
-
-
-void MGU_Node::get_gradients(vector<double> &gradients) {
-    gradients.assign(NUMBER_MGU_WEIGHTS, 0.0);
-
-    for (int32_t i = 0; i < NUMBER_MGU_WEIGHTS; i++) {
-        gradients[i] = 0.0;
-    }
-
-    for (int32_t i = 0; i < series_length; i++) {
-        gradients[0] += d_fw[i];
-        gradients[1] += d_fu[i];
-        gradients[2] += d_f_bias[i];
-        gradients[3] += d_hw[i];
-        gradients[4] += d_hu[i];
-        gradients[5] += d_h_bias[i];
-    }
-}
-
 void MGU_Node::reset(int32_t _series_length) {
     series_length = _series_length;
 
-    d_fw.assign(series_length, 0.0);
-    d_fu.assign(series_length, 0.0);
-    d_f_bias.assign(series_length, 0.0);
-
-    d_hw.assign(series_length, 0.0);
-    d_hu.assign(series_length, 0.0);
-    d_h_bias.assign(series_length, 0.0);
+    for (int32_t i = 0; i < NUMBER_MGU_WEIGHTS; i++) d_weights[i] = 0.0;
 
     d_h_prev.assign(series_length, 0.0);
 
@@ -296,19 +230,7 @@ RNN_Node_Interface* MGU_Node::copy() const {
     MGU_Node* n = new MGU_Node(innovation_number, layer_type, depth);
 
     //copy MGU_Node values
-    n->fw = fw;
-    n->fu = fu;
-    n->f_bias = f_bias;
-    n->hw = hw;
-    n->hu = hu;
-    n->h_bias = h_bias;
-
-    n->d_fw = d_fw;
-    n->d_fu = d_fu;
-    n->d_f_bias = d_f_bias;
-    n->d_hw = d_hw;
-    n->d_hu = d_hu;
-    n->d_h_bias = d_h_bias;
+    copy_weights_to(n);
 
     n->d_h_prev = d_h_prev;
 
@@ -17,21 +17,6 @@ using std::vector;
 
 class MGU_Node : public RNN_Node_Interface {
     private:
-        double fw;
-        double fu;
-        double f_bias;
-
-        double hw;
-        double hu;
-        double h_bias;
-
-        vector<double> d_fw;
-        vector<double> d_fu;
-        vector<double> d_f_bias;
-        vector<double> d_hw;
-        vector<double> d_hu;
-        vector<double> d_h_bias;
-
         vector<double> d_h_prev;
 
         vector<double> f;
@@ -60,14 +45,6 @@ class MGU_Node : public RNN_Node_Interface {
 
         int32_t get_number_weights() const;
 
-        void get_weights(vector<double> &parameters) const;
-        void set_weights(const vector<double> &parameters);
-
-        void get_weights(int32_t &offset, vector<double> &parameters) const;
-        void set_weights(int32_t &offset, const vector<double> &parameters);
-
-        void get_gradients(vector<double> &gradients);
-
         void reset(int32_t _series_length);
 
         void write_to_stream(ostream &out);
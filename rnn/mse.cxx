@@ -26,8 +26,8 @@ void get_mse(const vector<double> &output_values, const vector<double> &expected
     }
 }
 
-void get_mse(RNN *genome, const vector< vector<double> > &expected, double &mse_sum, vector< vector<double> > &deltas) {
-    deltas.assign(genome->output_nodes.size(), vector<double>(expected[0].size(), 0.0));
+void get_mse(RNN *genome, const SeriesTensor &expected, double &mse_sum, vector< vector<double> > &deltas) {
+    deltas.assign(genome->output_nodes.size(), vector<double>(expected.get_number_timesteps(), 0.0));
 
     mse_sum = 0.0;
     double mse;
@@ -35,20 +35,20 @@ void get_mse(RNN *genome, const vector< vector<double> > &expected, double &mse_
 
     for (int32_t i = 0; i < (int32_t)genome->output_nodes.size(); i++) {
         mse = 0.0;
-        for (int32_t j = 0; j < (int32_t)expected[i].size(); j++) {
-            error = genome->output_nodes[i]->output_values[j] - expected[i][j];
+        for (int32_t j = 0; j < expected.get_number_timesteps(); j++) {
+            error = genome->output_nodes[i]->output_values[j] - expected(i, j);
             deltas[i][j] = error;
 
             mse += error * error;
         }
 
-        mse /= expected[i].size();
+        mse /= expected.get_number_timesteps();
         mse_sum += mse;
     }
 
-    double d_mse = mse_sum * (1.0 / expected[0].size()) * 2.0;
+    double d_mse = mse_sum * (1.0 / expected.get_number_timesteps()) * 2.0;
     for (int32_t i = 0; i < (int32_t)genome->output_nodes.size(); i++) {
-        for (int32_t j = 0; j < (int32_t)expected[i].size(); j++) {
+        for (int32_t j = 0; j < expected.get_number_timesteps(); j++) {
             deltas[i][j] *= d_mse;
         }
     }
@@ -79,8 +79,8 @@ void get_mae(const vector<double> &output_values, const vector<double> &expected
     }
 }
 
-void get_mae(RNN *genome, const vector< vector<double> > &expected, double &mae_sum, vector< vector<double> > &deltas) {
-    deltas.assign(genome->output_nodes.size(), vector<double>(expected[0].size(), 0.0));
+void get_mae(RNN *genome, const SeriesTensor &expected, double &mae_sum, vector< vector<double> > &deltas) {
+    deltas.assign(genome->output_nodes.size(), vector<double>(expected.get_number_timesteps(), 0.0));
 
     mae_sum = 0.0;
     double mae;
@@ -88,24 +88,24 @@ void get_mae(RNN *genome, const vector< vector<double> > &expected, double &mae_
 
     for (int32_t i = 0; i < (int32_t)genome->output_nodes.size(); i++) {
         mae = 0.0;
-        for (int32_t j = 0; j <(int32_t) expected[i].size(); j++) {
-            error = fabs(genome->output_nodes[i]->output_values[j] - expected[i][j]);
+        for (int32_t j = 0; j < expected.get_number_timesteps(); j++) {
+            error = fabs(genome->output_nodes[i]->output_values[j] - expected(i, j));
             if (error == 0) {
                 deltas[i][j] = 0;
             } else {
-                deltas[i][j] = (genome->output_nodes[i]->output_values[j] - expected[i][j]) / error;
+                deltas[i][j] = (genome->output_nodes[i]->output_values[j] - expected(i, j)) / error;
             }
 
             mae += error;
         }
 
-        mae /= expected[i].size();
+        mae /= expected.get_number_timesteps();
         mae_sum += mae;
     }
 
-    double d_mae = mae_sum * (1.0 / expected[0].size());
+    double d_mae = mae_sum * (1.0 / expected.get_number_timesteps());
     for (int32_t i = 0; i < (int32_t)genome->output_nodes.size(); i++) {
-        for (int32_t j = 0; j < (int32_t)expected[i].size(); j++) {
+        for (int32_t j = 0; j < expected.get_number_timesteps(); j++) {
             deltas[i][j] *= d_mae;
         }
     }
@@ -0,0 +1,95 @@
+#include <charconv>
+using std::chars_format;
+using std::to_chars;
+
+#include <cstring>
+using std::memcpy;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include "common/log.hxx"
+#include "prediction_writer.hxx"
+
+#define PREDICTION_WRITER_BUFFER_SIZE (1 << 20)
+
+//enough for any double with 6 significant digits, and its separator
+#define MAX_VALUE_CHARACTERS 32
+
+PredictionWriter::PredictionWriter(string _filename, bool _binary) : filename(_filename), binary(_binary), buffer(PREDICTION_WRITER_BUFFER_SIZE), buffer_used(0) {
+    file = fopen(filename.c_str(), binary ? "wb" : "w");
+    if (file == NULL) {
+        Log::fatal("ERROR: could not open predictions file '%s' for writing\n", filename.c_str());
+        exit(1);
+    }
+}
+
+PredictionWriter::~PredictionWriter() {
+    flush();
+    fclose(file);
+}
+
+void PredictionWriter::flush() {
+    if (buffer_used > 0 && fwrite(buffer.data(), 1, buffer_used, file) != buffer_used) {
+        Log::fatal("ERROR: could not write to predictions file '%s'\n", filename.c_str());
+        exit(1);
+    }
+    buffer_used = 0;
+}
+
+void PredictionWriter::write_bytes(const void *bytes, size_t number_bytes) {
+    if (buffer_used + number_bytes > buffer.size()) {
+        flush();
+        if (number_bytes > buffer.size()) buffer.resize(number_bytes);
+    }
+
+    memcpy(buffer.data() + buffer_used, bytes, number_bytes);
+    buffer_used += number_bytes;
+}
+
+void PredictionWriter::write_header(const vector<string> &column_names, int32_t number_rows) {
+    if (binary) {
+        int32_t counts[2] = { (int32_t)column_names.size(), number_rows };
+        write_bytes("EXAMMBIN", 8);
+        write_bytes(counts, sizeof(counts));
+
+        for (int32_t i = 0; i < (int32_t)column_names.size(); i++) {
+            int32_t length = (int32_t)column_names[i].size();
+            write_bytes(&length, sizeof(length));
+            write_bytes(column_names[i].data(), length);
+        }
+    } else {
+        string header = "#";
+        for (int32_t i = 0; i < (int32_t)column_names.size(); i++) {
+            if (i > 0) header += ",";
+            header += column_names[i];
+        }
+        header += "\n";
+        write_bytes(header.data(), header.size());
+    }
+}
+
+void PredictionWriter::write_row(const vector<double> &values) {
+    if (binary) {
+        write_bytes(values.data(), values.size() * sizeof(double));
+        return;
+    }
+
+    if (buffer_used + values.size() * MAX_VALUE_CHARACTERS + 1 > buffer.size()) {
+        flush();
+        if (values.size() * MAX_VALUE_CHARACTERS + 1 > buffer.size()) buffer.resize(values.size() * MAX_VALUE_CHARACTERS + 1);
+    }
+
+    //formatted in place, the same as the default (6 significant digit) stream output
+    char *current = buffer.data() + buffer_used;
+    for (int32_t i = 0; i < (int32_t)values.size(); i++) {
+        if (i > 0) *current++ = ',';
+        current = to_chars(current, current + MAX_VALUE_CHARACTERS - 1, values[i], chars_format::general, 6).ptr;
+    }
+    *current++ = '\n';
+
+    buffer_used = current - buffer.data();
+}
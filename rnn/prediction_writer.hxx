@@ -0,0 +1,52 @@
+#ifndef EXAMM_PREDICTION_WRITER_HXX
+#define EXAMM_PREDICTION_WRITER_HXX
+
+#include <cstdint>
+#include <cstdio>
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+/**
+ * Writes a table of predictions (column names, then rows of values) through one large
+ * buffer instead of a stream operator and endl per value.
+ *
+ * The text format is the comma separated values the predictions have always been written
+ * as: a header line starting with '#', then each value to 6 significant digits.
+ *
+ * The binary format is the 8 characters "EXAMMBIN", the number of columns and of rows
+ * (int32), each column name (its length as an int32, then its characters), and then the
+ * values (double) row by row.
+ */
+class PredictionWriter {
+    private:
+        string filename;
+        FILE *file;
+        bool binary;
+
+        vector<char> buffer;
+        size_t buffer_used;
+
+        void write_bytes(const void *bytes, size_t number_bytes);
+        void flush();
+
+    public:
+        PredictionWriter(string _filename, bool _binary);
+
+        /**
+         * Flushes anything left in the buffer and closes the file.
+         */
+        ~PredictionWriter();
+
+        /**
+         * \param number_rows is the number of rows which will follow (only written in the
+         *      binary format)
+         */
+        void write_header(const vector<string> &column_names, int32_t number_rows);
+        void write_row(const vector<double> &values);
+};
+
+#endif
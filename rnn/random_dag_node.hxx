@@ -24,20 +24,6 @@ class RANDOM_DAG_Node : public RNN_Node_Interface{
 	private:
 		
 		vector<int32_t> node_output;
-		// starting node 0
-		double rw;
-		double zw;
-		
-		// weights for other nodes
-		vector<double> weights;
-
-
-		// gradients of starting node 0
-		vector<double> d_zw;
-		vector<double> d_rw;
-
-		// gradients of other nodes 
-		vector<vector<double>> d_weights;
 		
 		// gradient of prev output
 		vector<double> d_h_prev;
@@ -74,14 +60,6 @@ class RANDOM_DAG_Node : public RNN_Node_Interface{
 
         int32_t get_number_weights() const;
 
-        void get_weights(vector<double> &parameters) const;
-        void set_weights(const vector<double> &parameters);
-
-        void get_weights(int32_t &offset, vector<double> &parameters) const;
-        void set_weights(int32_t &offset, const vector<double> &parameters);
-
-        void get_gradients(vector<double> &gradients);
-
         void reset(int32_t _series_length);
 
         void write_to_stream(ostream &out);
@@ -4,6 +4,10 @@ using std::upper_bound;
 
 #include <chrono>
 
+#include <cstdlib>
+using std::aligned_alloc;
+using std::free;
+
 #include <limits>
 using std::numeric_limits;
 
@@ -15,9 +19,6 @@ using std::setw;
 using std::endl;
 using std::cout;
 
-#include <fstream>
-using std::ofstream;
-
 #include <random>
 using std::minstd_rand0;
 using std::uniform_real_distribution;
@@ -38,8 +39,11 @@ using std::vector;
 #include "random_dag_node.hxx"
 #include "mgu_node.hxx"
 #include "mse.hxx"
+#include "prediction_writer.hxx"
 
 #include "common/log.hxx"
+#include "common/random.hxx"
+#include "common/performance_log.hxx"
 
 #include "time_series/time_series.hxx"
 // #include "word_series/word_series.hxx"
@@ -159,6 +163,8 @@ void RNN::fix_parameter_orders(const vector<string> &input_parameter_names, cons
 RNN::RNN(vector<RNN_Node_Interface*> &_nodes, vector<RNN_Edge*> &_edges, const vector<string> &input_parameter_names, const vector<string> &output_parameter_names) {
     nodes = _nodes;
     edges = _edges;
+    dropout_key = 0;
+    dropout_pass = 0;
 
     //sort edges by depth
     sort(edges.begin(), edges.end(), sort_RNN_Edges_by_depth());
@@ -173,11 +179,15 @@ RNN::RNN(vector<RNN_Node_Interface*> &_nodes, vector<RNN_Edge*> &_edges, const v
 
     fix_parameter_orders(input_parameter_names, output_parameter_names);
     validate_parameters(input_parameter_names, output_parameter_names);
+
+    initialize_buffers();
 }
 
 RNN::RNN(vector<RNN_Node_Interface*> &_nodes, vector<RNN_Edge*> &_edges, vector<RNN_Recurrent_Edge*> &_recurrent_edges, const vector<string> &input_parameter_names, const vector<string> &output_parameter_names) {
     nodes = _nodes;
     edges = _edges;
+    dropout_key = 0;
+    dropout_pass = 0;
     recurrent_edges = _recurrent_edges;
 
     //sort nodes by depth
@@ -199,9 +209,52 @@ RNN::RNN(vector<RNN_Node_Interface*> &_nodes, vector<RNN_Edge*> &_edges, vector<
     Log::debug("validating parameters, input_node.size: %d\n", input_nodes.size());
     validate_parameters(input_parameter_names, output_parameter_names);
 
+    initialize_buffers();
+
     Log::trace("got RNN with %d nodes, %d edges, %d recurrent edges\n", nodes.size(), edges.size(), recurrent_edges.size());
 }
 
+void RNN::initialize_buffers() {
+    number_weights = 0;
+
+    for (int32_t i = 0; i < (int32_t)nodes.size(); i++) {
+        number_weights += nodes[i]->get_number_weights();
+        //if (nodes[i]->is_reachable()) number_weights += nodes[i]->get_number_weights();
+    }
+
+    //every edge and recurrent edge has one weight
+    number_weights += (int32_t)edges.size() + (int32_t)recurrent_edges.size();
+
+    //the gradient starts on the cache line after the parameters, and aligned_alloc
+    //needs the size to be a multiple of the alignment
+    int32_t doubles_per_line = 64 / sizeof(double);
+    int32_t gradient_offset = ((number_weights + doubles_per_line - 1) / doubles_per_line) * doubles_per_line;
+    size_t buffer_size = sizeof(double) * (2 * gradient_offset + doubles_per_line);
+
+    parameters = (double*)aligned_alloc(64, buffer_size);
+    if (parameters == NULL) {
+        Log::fatal("ERROR: could not allocate the parameter and gradient buffers for %d weights\n", number_weights);
+        exit(1);
+    }
+    gradient = parameters + gradient_offset;
+
+    int32_t current = 0;
+    for (int32_t i = 0; i < (int32_t)nodes.size(); i++) {
+        nodes[i]->set_weight_buffers(parameters + current, gradient + current);
+        current += nodes[i]->get_number_weights();
+    }
+
+    for (int32_t i = 0; i < (int32_t)edges.size(); i++) {
+        edges[i]->set_weight_buffers(parameters + current, gradient + current);
+        current++;
+    }
+
+    for (int32_t i = 0; i < (int32_t)recurrent_edges.size(); i++) {
+        recurrent_edges[i]->set_weight_buffers(parameters + current, gradient + current);
+        current++;
+    }
+}
+
 RNN::~RNN() {
     RNN_Node_Interface *node;
 
@@ -229,6 +282,8 @@ RNN::~RNN() {
 
     while (input_nodes.size() > 0) input_nodes.pop_back();
     while (output_nodes.size() > 0) output_nodes.pop_back();
+
+    free(parameters);
 }
 
 
@@ -248,88 +303,52 @@ RNN_Edge* RNN::get_edge(int32_t i) {
     return edges[i];
 }
 
+void RNN::set_dropout_key(uint64_t _dropout_key) {
+    dropout_key = _dropout_key;
+    dropout_pass = 0;
+}
 
 
-void RNN::get_weights(vector<double> &parameters) {
-    parameters.resize(get_number_weights());
-
-    int32_t current = 0;
-
-    for (int32_t i = 0; i < (int32_t)nodes.size(); i++) {
-        nodes[i]->get_weights(current, parameters);
-        //if (nodes[i]->is_reachable()) nodes[i]->get_weights(current, parameters);
-    }
-
-    for (int32_t i = 0; i < (int32_t)edges.size(); i++) {
-        parameters[current++] = edges[i]->weight;
-        //if (edges[i]->is_reachable()) parameters[current++] = edges[i]->weight;
-    }
 
-    for (int32_t i = 0; i < (int32_t)recurrent_edges.size(); i++) {
-        parameters[current++] = recurrent_edges[i]->weight;
-        //if (recurrent_edges[i]->is_reachable()) parameters[current++] = recurrent_edges[i]->weight;
-    }
+void RNN::get_weights(vector<double> &_parameters) {
+    _parameters.assign(parameters, parameters + number_weights);
 }
 
-void RNN::set_weights(const vector<double> &parameters) {
-    if ((int32_t)parameters.size() != get_number_weights()) {
-        Log::fatal("ERROR! Trying to set weights where the RNN has %d weights, and the parameters vector has %d weights!\n", get_number_weights(), parameters.size());
+void RNN::set_weights(const vector<double> &_parameters) {
+    if ((int32_t)_parameters.size() != number_weights) {
+        Log::fatal("ERROR! Trying to set weights where the RNN has %d weights, and the parameters vector has %d weights!\n", number_weights, _parameters.size());
         exit(1);
     }
 
-    int32_t current = 0;
-
-    for (int32_t i = 0; i < (int32_t)nodes.size(); i++) {
-        nodes[i]->set_weights(current, parameters);
-        //if (nodes[i]->is_reachable()) nodes[i]->set_weights(current, parameters);
-    }
-
-    for (int32_t i = 0; i < (int32_t)edges.size(); i++) {
-        edges[i]->weight = parameters[current++];
-        //if (edges[i]->is_reachable()) edges[i]->weight = parameters[current++];
-    }
-
-    for (int32_t i = 0; i < (int32_t)recurrent_edges.size(); i++) {
-        recurrent_edges[i]->weight = parameters[current++];
-        //if (recurrent_edges[i]->is_reachable()) recurrent_edges[i]->weight = parameters[current++];
+    for (int32_t i = 0; i < number_weights; i++) {
+        parameters[i] = _parameters[i];
     }
-
 }
 
 int32_t RNN::get_number_weights() {
-    int32_t number_weights = 0;
-
-    for (int32_t i = 0; i < (int32_t)nodes.size(); i++) {
-        number_weights += nodes[i]->get_number_weights();
-        //if (nodes[i]->is_reachable()) number_weights += nodes[i]->get_number_weights();
-    }
-
-    for (int32_t i = 0; i < (int32_t)edges.size(); i++) {
-        number_weights++;
-        //if (edges[i]->is_reachable()) number_weights++;
-    }
+    return number_weights;
+}
 
-    for (int32_t i = 0; i < (int32_t)recurrent_edges.size(); i++) {
-        number_weights++;
-        //if (recurrent_edges[i]->is_reachable()) number_weights++;
-    }
+double* RNN::get_parameters() {
+    return parameters;
+}
 
-    return number_weights;
+const double* RNN::get_gradient() const {
+    return gradient;
 }
 
-void RNN::forward_pass(const vector< vector<double> > &series_data, bool using_dropout, bool training, double dropout_probability) {
-    series_length = series_data[0].size();
+void RNN::forward_pass(const SeriesTensor &series_data, bool using_dropout, bool training, double dropout_probability) {
+    ScopedTimer timer(PerformanceLog::FORWARD_PASS);
+    series_length = series_data.get_number_timesteps();
 
-    if (input_nodes.size() != series_data.size()) {
-        Log::fatal("ERROR: number of input nodes (%d) != number of time series data input fields (%d)\n", input_nodes.size(), series_data.size());
+    if ((int32_t)input_nodes.size() != series_data.get_number_parameters()) {
+        Log::fatal("ERROR: number of input nodes (%d) != number of time series data input fields (%d)\n", input_nodes.size(), series_data.get_number_parameters());
         for (int32_t i = 0; i < (int32_t)nodes.size(); i++) {
             Log::fatal("node[%d], in: %d, depth: %lf, layer_type: %d, node_type: %d\n", i, nodes[i]->get_innovation_number(), nodes[i]->get_depth(), nodes[i]->get_layer_type(), nodes[i]->get_node_type());
         }
         exit(1);
     }
 
-    //TODO: want to check that all vectors in series_data are of same length
-
 
     for (int32_t i = 0; i < (int32_t)nodes.size(); i++) {
         nodes[i]->reset(series_length);
@@ -343,6 +362,16 @@ void RNN::forward_pass(const vector< vector<double> > &series_data, bool using_d
         recurrent_edges[i]->reset(series_length);
     }
 
+    //each training pass with dropout gets its own key, so every edge and
+    //time step in every pass draws a different (but reproducible) value
+    uint64_t pass_key = 0;
+    if (using_dropout && training) {
+        uint32_t counter[4] = { (uint32_t)dropout_pass, (uint32_t)(dropout_pass >> 32), 0, 0 };
+        philox_4x32(counter, dropout_key);
+        pass_key = ((uint64_t)counter[1] << 32) | counter[0];
+        dropout_pass++;
+    }
+
     //do a propagate forward for time == -1 so that the the input
     //fired count on each node will be correct for the first pass
     //through the RNN
@@ -352,13 +381,13 @@ void RNN::forward_pass(const vector< vector<double> > &series_data, bool using_d
 
     for (int32_t time = 0; time < series_length; time++) {
         for (int32_t i = 0; i < (int32_t)input_nodes.size(); i++) {
-            if(input_nodes[i]->is_reachable()) input_nodes[i]->input_fired(time, series_data[i][time]);
+            if(input_nodes[i]->is_reachable()) input_nodes[i]->input_fired(time, series_data(i, time));
         }
 
         //feed forward
         if (using_dropout) {
             for (int32_t i = 0; i < (int32_t)edges.size(); i++) {
-                if (edges[i]->is_reachable()) edges[i]->propagate_forward(time, training, dropout_probability);
+                if (edges[i]->is_reachable()) edges[i]->propagate_forward(time, training, dropout_probability, pass_key);
             }
         } else {
             for (int32_t i = 0; i < (int32_t)edges.size(); i++) {
@@ -373,6 +402,7 @@ void RNN::forward_pass(const vector< vector<double> > &series_data, bool using_d
 }
 
 void RNN::backward_pass(double error, bool using_dropout, bool training, double dropout_probability) {
+    ScopedTimer timer(PerformanceLog::BACKWARD_PASS);
     //do a propagate forward for time == (series_length - 1) so that the
     // output fired count on each node will be correct for the first pass
     //through the RNN
@@ -402,7 +432,7 @@ void RNN::backward_pass(double error, bool using_dropout, bool training, double
     }
 }
 
-double RNN::calculate_error_softmax(const vector< vector<double> > &expected_outputs) {
+double RNN::calculate_error_softmax(const SeriesTensor &expected_outputs) {
     
     
     double cross_entropy_sum = 0.0;
@@ -410,11 +440,11 @@ double RNN::calculate_error_softmax(const vector< vector<double> > &expected_out
     double softmax = 0.0;
 
     for (int32_t i = 0; i < (int32_t)output_nodes.size(); i++) {
-        output_nodes[i]->error_values.resize(expected_outputs[i].size());
+        output_nodes[i]->error_values.resize(expected_outputs.get_number_timesteps());
     }
 
     // for each time step j 
-    for (int32_t j = 0; j < (int32_t)expected_outputs[0].size(); j++) {
+    for (int32_t j = 0; j < (int32_t)expected_outputs.get_number_timesteps(); j++) {
         double softmax_sum = 0.0;
         double cross_entropy = 0.0;
         // get sum of all the outputs of the timestep j from all output node i
@@ -426,11 +456,11 @@ double RNN::calculate_error_softmax(const vector< vector<double> > &expected_out
 
         for (int32_t i = 0; i < (int32_t)output_nodes.size(); i++) {
             softmax = exp(output_nodes[i]->output_values[j]) / softmax_sum;
-            error = softmax - expected_outputs[i][j];
+            error = softmax - expected_outputs(i, j);
             output_nodes[i]->error_values[j] = error;
 
             // std::cout<<"softmax ::::: "<<error<<" "<<output_nodes[i]->output_values[j]<<" "<<expected_outputs[i][j]<<"\n"<<std::endl;
-            cross_entropy = -expected_outputs[i][j] * log(softmax);
+            cross_entropy = -expected_outputs(i, j) * log(softmax);
             // if(cross_entropy)std::cout<<"cross_entropy ::::: "<<cross_entropy<<"\n"<<std::endl;
 
             cross_entropy_sum += cross_entropy;
@@ -441,74 +471,74 @@ double RNN::calculate_error_softmax(const vector< vector<double> > &expected_out
   return cross_entropy_sum;
 }
 
-double RNN::calculate_error_mse(const vector< vector<double> > &expected_outputs) {
+double RNN::calculate_error_mse(const SeriesTensor &expected_outputs) {
     double mse_sum = 0.0;
     double mse;
     double error;
   
     for (int32_t i = 0; i < (int32_t)output_nodes.size(); i++) {
-        output_nodes[i]->error_values.resize(expected_outputs[i].size());
+        output_nodes[i]->error_values.resize(expected_outputs.get_number_timesteps());
 
         mse = 0.0;
-        for (int32_t j = 0; j < (int32_t)expected_outputs[i].size(); j++) {
-            error = output_nodes[i]->output_values[j] - expected_outputs[i][j];
+        for (int32_t j = 0; j < (int32_t)expected_outputs.get_number_timesteps(); j++) {
+            error = output_nodes[i]->output_values[j] - expected_outputs(i, j);
 
           // std::cout<<"why this  ???? mse ::::: "<<error<<" "<<output_nodes[i]->output_values[j]<<" "<<expected_outputs[i][j]<<std::endl;
 
             output_nodes[i]->error_values[j] = error;
             mse += error * error;
         }
-        mse_sum += mse / expected_outputs[i].size();
+        mse_sum += mse / expected_outputs.get_number_timesteps();
     }
 
     return mse_sum;
 }
 
-double RNN::calculate_error_mae(const vector< vector<double> > &expected_outputs) {
+double RNN::calculate_error_mae(const SeriesTensor &expected_outputs) {
     double mae_sum = 0.0;
     double mae;
     double error;
 
     for (int32_t i = 0; i < (int32_t)output_nodes.size(); i++) {
-        output_nodes[i]->error_values.resize(expected_outputs[i].size());
+        output_nodes[i]->error_values.resize(expected_outputs.get_number_timesteps());
 
         mae = 0.0;
-        for (int32_t j = 0; j < (int32_t)expected_outputs[i].size(); j++) {
-            error = fabs(output_nodes[i]->output_values[j] - expected_outputs[i][j]);
+        for (int32_t j = 0; j < (int32_t)expected_outputs.get_number_timesteps(); j++) {
+            error = fabs(output_nodes[i]->output_values[j] - expected_outputs(i, j));
 
             mae += error;
 
             if (error == 0) {
                 error = 0;
             } else {
-                error = (output_nodes[i]->output_values[j] - expected_outputs[i][j]) / error;
+                error = (output_nodes[i]->output_values[j] - expected_outputs(i, j)) / error;
             }
             output_nodes[i]->error_values[j] = error;
 
         }
-        mae_sum += mae / expected_outputs[i].size();
+        mae_sum += mae / expected_outputs.get_number_timesteps();
     }
 
     return mae_sum;
 }
 
 
-double RNN::prediction_softmax(const vector< vector<double> > &series_data, const vector< vector<double> > &expected_outputs, bool using_dropout, bool training, double dropout_probability) {
+double RNN::prediction_softmax(const SeriesTensor &series_data, const SeriesTensor &expected_outputs, bool using_dropout, bool training, double dropout_probability) {
     forward_pass(series_data, using_dropout, training, dropout_probability);
     return calculate_error_softmax(expected_outputs);
 }
 
-double RNN::prediction_mse(const vector< vector<double> > &series_data, const vector< vector<double> > &expected_outputs, bool using_dropout, bool training, double dropout_probability) {
+double RNN::prediction_mse(const SeriesTensor &series_data, const SeriesTensor &expected_outputs, bool using_dropout, bool training, double dropout_probability) {
     forward_pass(series_data, using_dropout, training, dropout_probability);
     return calculate_error_mse(expected_outputs);
 }
 
-double RNN::prediction_mae(const vector< vector<double> > &series_data, const vector< vector<double> > &expected_outputs, bool using_dropout, bool training, double dropout_probability) {
+double RNN::prediction_mae(const SeriesTensor &series_data, const SeriesTensor &expected_outputs, bool using_dropout, bool training, double dropout_probability) {
     forward_pass(series_data, using_dropout, training, dropout_probability);
     return calculate_error_mae(expected_outputs);
 }
 
-vector<double> RNN::get_predictions(const vector< vector<double> > &series_data, const vector< vector<double> > &expected_outputs, bool using_dropout, double dropout_probability) {
+vector<double> RNN::get_predictions(const SeriesTensor &series_data, const SeriesTensor &expected_outputs, bool using_dropout, double dropout_probability) {
     forward_pass(series_data, using_dropout, false, dropout_probability);
 
     vector<double> result;
@@ -525,99 +555,78 @@ vector<double> RNN::get_predictions(const vector< vector<double> > &series_data,
     return result;
 }
 
-void RNN::write_predictions(string output_filename, const vector<string> &input_parameter_names, const vector<string> &output_parameter_names, const vector< vector<double> > &series_data, const vector< vector<double> > &expected_outputs, TimeSeriesSets *time_series_sets, bool using_dropout, double dropout_probability) {
+void RNN::write_predictions(string output_filename, const vector<string> &input_parameter_names, const vector<string> &output_parameter_names, const SeriesTensor &series_data, const SeriesTensor &expected_outputs, TimeSeriesSets *time_series_sets, bool using_dropout, double dropout_probability, bool binary) {
     forward_pass(series_data, using_dropout, false, dropout_probability);
 
-    Log::debug("series_length: %d, series_data.size(): %d, series_data[0].size(): %d\n", series_length, series_data.size(), series_data[0].size());
+    Log::debug("series_length: %d, series_data parameters: %d, series_data timesteps: %d\n", series_length, series_data.get_number_parameters(), series_data.get_number_timesteps());
     Log::debug("input_nodes.size(): %d, output_nodes.size(): %d\n", input_nodes.size(), output_nodes.size());
-    ofstream outfile(output_filename);
-
-    outfile << "#";
 
-    for (int32_t i = 0; i < (int32_t)input_nodes.size(); i++) {
-        if (i > 0) outfile << ",";
-        outfile << input_parameter_names[i];
+    int32_t number_inputs = (int32_t)input_nodes.size();
+    int32_t number_outputs = (int32_t)output_nodes.size();
 
-        Log::debug("input_parameter_names[%d]: '%s'\n", i, input_parameter_names[i].c_str());
+    //the inputs, then the expected outputs, then the predicted outputs
+    vector<string> column_names;
+    vector<string> column_parameters;
+    for (int32_t i = 0; i < number_inputs; i++) {
+        column_names.push_back(input_parameter_names[i]);
+        column_parameters.push_back(input_parameter_names[i]);
     }
 
-    for (int32_t i = 0; i < (int32_t)output_nodes.size(); i++) {
-        outfile << ",";
-        outfile << "expected_" << output_parameter_names[i];
-
-        Log::debug("output_parameter_names[%d]: '%s'\n", i, output_parameter_names[i].c_str());
+    for (int32_t i = 0; i < number_outputs; i++) {
+        column_names.push_back("expected_" + output_parameter_names[i]);
+        column_parameters.push_back(output_parameter_names[i]);
     }
 
-    for (int32_t i = 0; i < (int32_t)output_nodes.size(); i++) {
-        outfile << ",";
-        outfile << "predicted_" << output_parameter_names[i];
+    for (int32_t i = 0; i < number_outputs; i++) {
+        column_names.push_back("predicted_" + output_parameter_names[i]);
+        column_parameters.push_back(output_parameter_names[i]);
+    }
 
-        Log::debug("output_parameter_names[%d]: '%s'\n", i, output_parameter_names[i].c_str());
+    //look up how each column is denormalized once, rather than for every value
+    vector<double> scales(column_names.size());
+    vector<double> offsets(column_names.size());
+    for (int32_t i = 0; i < (int32_t)column_names.size(); i++) {
+        time_series_sets->get_denormalize_coefficients(column_parameters[i], scales[i], offsets[i]);
     }
-    outfile << endl;
 
+    PredictionWriter writer(output_filename, binary);
+    writer.write_header(column_names, series_length);
+
+    vector<double> row(column_names.size());
     for (int32_t j = 0; j < series_length; j++) {
-        for (int32_t i = 0; i < (int32_t)input_nodes.size(); i++) {
-            if (i > 0) outfile << ",";
-            //outfile << series_data[i][j];
-            outfile << time_series_sets->denormalize(input_parameter_names[i], series_data[i][j]);
+        for (int32_t i = 0; i < number_inputs; i++) {
+            row[i] = series_data(i, j);
         }
 
-        for (int32_t i = 0; i < (int32_t)output_nodes.size(); i++) {
-            outfile << ",";
-            //outfile << expected_outputs[i][j];
-            outfile << time_series_sets->denormalize(output_parameter_names[i], expected_outputs[i][j]);
+        for (int32_t i = 0; i < number_outputs; i++) {
+            row[number_inputs + i] = expected_outputs(i, j);
+            row[number_inputs + number_outputs + i] = output_nodes[i]->output_values[j];
         }
 
-        for (int32_t i = 0; i < (int32_t)output_nodes.size(); i++) {
-            outfile << ",";
-            //outfile << output_nodes[i]->output_values[j];
-            outfile << time_series_sets->denormalize(output_parameter_names[i], output_nodes[i]->output_values[j]);
+        for (int32_t i = 0; i < (int32_t)row.size(); i++) {
+            row[i] = (row[i] * scales[i]) + offsets[i];
         }
-        outfile << endl;
+
+        writer.write_row(row);
     }
-    outfile.close();
 }
 
-void RNN::get_analytic_gradient(const vector<double> &test_parameters, const vector< vector<double> > &inputs, const vector< vector<double> > &outputs, double &mse, vector<double> &analytic_gradient, bool using_dropout, bool training, double dropout_probability) {
-    analytic_gradient.assign(test_parameters.size(), 0.0);
-
+void RNN::get_analytic_gradient(const vector<double> &test_parameters, const SeriesTensor &inputs, const SeriesTensor &outputs, double &mse, vector<double> &analytic_gradient, bool using_dropout, bool training, double dropout_probability) {
     set_weights(test_parameters);
+    calculate_gradient(inputs, outputs, mse, using_dropout, training, dropout_probability);
+    analytic_gradient.assign(gradient, gradient + number_weights);
+}
+
+void RNN::calculate_gradient(const SeriesTensor &inputs, const SeriesTensor &outputs, double &mse, bool using_dropout, bool training, double dropout_probability) {
+    //resetting the nodes and edges in the forward pass clears the gradient, and the
+    //backward pass accumulates into it
     forward_pass(inputs, using_dropout, training, dropout_probability);
 
     mse = calculate_error_mse(outputs);
-    backward_pass(mse * (1.0 / outputs[0].size())*2.0, using_dropout, training, dropout_probability);
-    
-    vector<double> current_gradients;
-
-    int32_t current = 0;
-    for (int32_t i = 0; i < (int32_t)nodes.size(); i++) {
-        if (nodes[i]->is_reachable()) {
-            nodes[i]->get_gradients(current_gradients);
-
-            for (int32_t j = 0; j < (int32_t)current_gradients.size(); j++) {
-                analytic_gradient[current] = current_gradients[j];
-                current++;
-            }
-        }
-    }
-
-    for (int32_t i = 0; i < (int32_t)edges.size(); i++) {
-        if (edges[i]->is_reachable()) {
-            analytic_gradient[current] = edges[i]->get_gradient();
-            current++;
-        }
-    }
-
-    for (int32_t i = 0; i < (int32_t)recurrent_edges.size(); i++) {
-        if (recurrent_edges[i]->is_reachable()) {
-            analytic_gradient[current] = recurrent_edges[i]->get_gradient();
-            current++;
-        }
-    }
+    backward_pass(mse * (1.0 / outputs.get_number_timesteps())*2.0, using_dropout, training, dropout_probability);
 }
 
-void RNN::get_empirical_gradient(const vector<double> &test_parameters, const vector< vector<double> > &inputs, const vector< vector<double> > &outputs, double &mse, vector<double> &empirical_gradient, bool using_dropout, bool training, double dropout_probability) {
+void RNN::get_empirical_gradient(const vector<double> &test_parameters, const SeriesTensor &inputs, const SeriesTensor &outputs, double &mse, vector<double> &empirical_gradient, bool using_dropout, bool training, double dropout_probability) {
     empirical_gradient.assign(test_parameters.size(), 0.0);
 
     vector< vector<double> > deltas;
@@ -654,12 +663,11 @@ void RNN::get_empirical_gradient(const vector<double> &test_parameters, const ve
     mse = original_mse;
 }
 
-void RNN::initialize_randomly() {
+void RNN::initialize_randomly(int32_t generation_id) {
     int32_t number_of_weights = get_number_weights();
     vector<double> parameters(number_of_weights, 0.0);
 
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    minstd_rand0 generator(seed);
+    minstd_rand0 generator(counter_random_uint32(get_random_stream_key(generation_id, RANDOM_PURPOSE_GENOME), 0, 0));
     uniform_real_distribution<double> rng(-0.5, 0.5);
     for (int32_t i = 0; i < (int32_t)parameters.size(); i++) {
         parameters[i] = rng(generator);
@@ -12,6 +12,7 @@ using std::vector;
 #include "rnn_edge.hxx"
 #include "rnn_recurrent_edge.hxx"
 
+#include "time_series/series_tensor.hxx"
 #include "time_series/time_series.hxx"
 // #include "word_series/word_series.hxx"
 
@@ -26,6 +27,26 @@ class RNN {
         vector<RNN_Edge*> edges;
         vector<RNN_Recurrent_Edge*> recurrent_edges;
 
+        uint64_t dropout_key;
+        uint64_t dropout_pass;
+
+        /**
+         * The RNN's parameters and the gradient of the last backward pass, in the order
+         * given by get_weights/set_weights (nodes, then edges, then recurrent edges). Both
+         * are in one 64 byte aligned block, allocated once when the RNN is created, with the
+         * gradient starting on its own cache line.
+         *
+         * The nodes and edges keep their weights and gradients in these buffers (see
+         * set_weight_buffers), so the forward and backward passes read and write them
+         * directly and the optimizer updates the parameters in place, with nothing copied
+         * in between.
+         */
+        int32_t number_weights;
+        double *parameters;
+        double *gradient;
+
+        void initialize_buffers();
+
     public:
         RNN(vector<RNN_Node_Interface*> &_nodes, vector<RNN_Edge*> &_edges, const vector<string> &input_parameter_names, const vector<string> &output_parameter_names);
         RNN(vector<RNN_Node_Interface*> &_nodes, vector<RNN_Edge*> &_edges, vector<RNN_Recurrent_Edge*> &_recurrent_edges, const vector<string> &input_parameter_names, const vector<string> &output_parameter_names);
@@ -40,35 +61,67 @@ class RNN {
         RNN_Node_Interface* get_node(int32_t i);
         RNN_Edge* get_edge(int32_t i);
 
-        void forward_pass(const vector< vector<double> > &series_data, bool using_dropout, bool training, double dropout_probability);
+        /**
+         * Sets the key of the random stream dropout masks are drawn from. Each training
+         * forward pass after this uses the next counter in that stream, so the masks only
+         * depend on the key and how many passes have been made.
+         */
+        void set_dropout_key(uint64_t _dropout_key);
+
+        void forward_pass(const SeriesTensor &series_data, bool using_dropout, bool training, double dropout_probability);
         void backward_pass(double error, bool using_dropout, bool training, double dropout_probability);
 
-        double calculate_error_softmax(const vector< vector<double> > &expected_outputs);
-        double calculate_error_mse(const vector< vector<double> > &expected_outputs);
-        double calculate_error_mae(const vector< vector<double> > &expected_outputs);
+        double calculate_error_softmax(const SeriesTensor &expected_outputs);
+        double calculate_error_mse(const SeriesTensor &expected_outputs);
+        double calculate_error_mae(const SeriesTensor &expected_outputs);
 
-        double prediction_softmax(const vector< vector<double> > &series_data, const vector< vector<double> > &expected_outputs, bool using_dropout, bool training, double dropout_probability);
-        double prediction_mse(const vector< vector<double> > &series_data, const vector< vector<double> > &expected_outputs, bool using_dropout, bool training, double dropout_probability);
-        double prediction_mae(const vector< vector<double> > &series_data, const vector< vector<double> > &expected_outputs, bool using_dropout, bool training, double dropout_probability);
+        double prediction_softmax(const SeriesTensor &series_data, const SeriesTensor &expected_outputs, bool using_dropout, bool training, double dropout_probability);
+        double prediction_mse(const SeriesTensor &series_data, const SeriesTensor &expected_outputs, bool using_dropout, bool training, double dropout_probability);
+        double prediction_mae(const SeriesTensor &series_data, const SeriesTensor &expected_outputs, bool using_dropout, bool training, double dropout_probability);
 
 
-        vector<double> get_predictions(const vector< vector<double> > &series_data, const vector< vector<double> > &expected_outputs, bool usng_dropout, double dropout_probability);
+        vector<double> get_predictions(const SeriesTensor &series_data, const SeriesTensor &expected_outputs, bool usng_dropout, double dropout_probability);
 
-        void write_predictions(string output_filename, const vector<string> &input_parameter_names, const vector<string> &output_parameter_names, const vector< vector<double> > &series_data, const vector< vector<double> > &expected_outputs, TimeSeriesSets *time_series_sets, bool using_dropout, double dropout_probability);
+        void write_predictions(string output_filename, const vector<string> &input_parameter_names, const vector<string> &output_parameter_names, const SeriesTensor &series_data, const SeriesTensor &expected_outputs, TimeSeriesSets *time_series_sets, bool using_dropout, double dropout_probability, bool binary);
 
-        void initialize_randomly();
+        /**
+         * Sets the weights to uniform random values in [-0.5, 0.5) drawn from the
+         * RANDOM_PURPOSE_GENOME stream of the given generation id.
+         */
+        void initialize_randomly(int32_t generation_id);
         void get_weights(vector<double> &parameters);
         void set_weights(const vector<double> &parameters);
 
         int32_t get_number_weights();
 
-        void get_analytic_gradient(const vector<double> &test_parameters, const vector< vector<double> > &inputs, const vector< vector<double> > &outputs, double &mse, vector<double> &analytic_gradient, bool using_dropout, bool training, double dropout_probability);
-        void get_empirical_gradient(const vector<double> &test_parameters, const vector< vector<double> > &inputs, const vector< vector<double> > &outputs, double &mae, vector<double> &empirical_gradient, bool using_dropout, bool training, double dropout_probability);
+        /**
+         * \return the RNN's parameter buffer, get_number_weights() long, which the nodes and
+         *      edges use directly, so updating it in place updates the RNN.
+         */
+        double* get_parameters();
+
+        /**
+         * \return the gradient calculated by the last backward pass, get_number_weights()
+         *      long
+         */
+        const double* get_gradient() const;
+
+        /**
+         * Does the same as get_analytic_gradient, but for the weights in the parameter buffer,
+         * leaving the result in the gradient buffer.
+         */
+        void calculate_gradient(const SeriesTensor &inputs, const SeriesTensor &outputs, double &mse, bool using_dropout, bool training, double dropout_probability);
+
+        void get_analytic_gradient(const vector<double> &test_parameters, const SeriesTensor &inputs, const SeriesTensor &outputs, double &mse, vector<double> &analytic_gradient, bool using_dropout, bool training, double dropout_probability);
+        void get_empirical_gradient(const vector<double> &test_parameters, const SeriesTensor &inputs, const SeriesTensor &outputs, double &mae, vector<double> &empirical_gradient, bool using_dropout, bool training, double dropout_probability);
 
         //RNN* copy();
 
-        friend void get_mse(RNN* genome, const vector< vector<double> > &expected, double &mse, vector< vector<double> > &deltas);
-        friend void get_mae(RNN* genome, const vector< vector<double> > &expected, double &mae, vector< vector<double> > &deltas);
+        friend class RNN_Stream;
+        friend class RNN_Code_Generator;
+        friend class RNN_Quantized;
+        friend void get_mse(RNN* genome, const SeriesTensor &expected, double &mse, vector< vector<double> > &deltas);
+        friend void get_mae(RNN* genome, const SeriesTensor &expected, double &mae, vector< vector<double> > &deltas);
 };
 
 #endif
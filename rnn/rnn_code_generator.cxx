@@ -0,0 +1,404 @@
+#include <algorithm>
+using std::stable_sort;
+
+#include <cctype>
+
+#include <cmath>
+using std::fmax;
+
+#include <cstdio>
+
+#include <map>
+using std::map;
+
+#include <ostream>
+using std::endl;
+using std::ostream;
+
+#include <string>
+using std::string;
+using std::to_string;
+
+#include <vector>
+using std::vector;
+
+#include "common/log.hxx"
+#include "rnn_code_generator.hxx"
+#include "rnn_edge.hxx"
+
+//a literal which reads back as exactly the same double
+static string double_literal(double value) {
+    char buffer[64];
+    snprintf(buffer, 64, "%.17g", value);
+
+    string literal(buffer);
+    if (literal.find_first_of(".en") == string::npos) literal += ".0";
+    return literal;
+}
+
+RNN_Code_Generator::RNN_Code_Generator(RNN_Genome *_genome) : genome(_genome), number_node_values(0), number_recurrent_values(0) {
+    rnn = genome->get_rnn();
+    rnn->set_weights(genome->get_best_parameters());
+
+    for (int32_t i = 0; i < (int32_t)rnn->nodes.size(); i++) {
+        RNN_Node_Interface *node = rnn->nodes[i];
+        if (!node->is_reachable()) continue;
+
+        switch (node->get_node_type()) {
+            case SIMPLE_NODE:
+            case JORDAN_NODE:
+            case ELMAN_NODE:
+                break;
+            case UGRNN_NODE:
+            case MGU_NODE:
+            case GRU_NODE:
+            case DELTA_NODE:
+            case LSTM_NODE:
+                node_state_index[node] = number_node_values++;
+                break;
+            default:
+                Log::fatal("ERROR: cannot generate code for node %d, code generation is not supported for %s nodes\n", node->get_innovation_number(), NODE_TYPES[node->get_node_type()].c_str());
+                exit(1);
+        }
+    }
+
+    for (int32_t i = 0; i < (int32_t)rnn->recurrent_edges.size(); i++) {
+        if (rnn->recurrent_edges[i]->is_reachable()) recurrent_edges.push_back(rnn->recurrent_edges[i]);
+    }
+
+    //the same order RNN_Stream delivers the recurrent edges' values in, so the nodes'
+    //inputs are summed in the same order as RNN::forward_pass
+    stable_sort(recurrent_edges.begin(), recurrent_edges.end(), [](RNN_Recurrent_Edge *a, RNN_Recurrent_Edge *b) {
+        return a->recurrent_depth > b->recurrent_depth;
+    });
+
+    for (int32_t i = 0; i < (int32_t)recurrent_edges.size(); i++) {
+        recurrent_value_index.push_back(number_recurrent_values);
+        number_recurrent_values += recurrent_edges[i]->recurrent_depth;
+    }
+}
+
+RNN_Code_Generator::~RNN_Code_Generator() {
+    delete rnn;
+}
+
+string RNN_Code_Generator::add_weight(double weight) {
+    weights.push_back(weight);
+    return "weights[" + to_string(weights.size() - 1) + "]";
+}
+
+string RNN_Code_Generator::normalize(const string &parameter_name, const string &value) const {
+    string normalize_type = genome->get_normalize_type();
+
+    if (normalize_type.compare("min_max") == 0) {
+        string min = double_literal(genome->get_normalize_mins().at(parameter_name));
+        string max = double_literal(genome->get_normalize_maxs().at(parameter_name));
+
+        return "(" + value + " - " + min + ") / (" + max + " - " + min + ")";
+
+    } else if (normalize_type.compare("avg_std_dev") == 0) {
+        double min = genome->get_normalize_mins().at(parameter_name);
+        double max = genome->get_normalize_maxs().at(parameter_name);
+        double avg = genome->get_normalize_avgs().at(parameter_name);
+        double std_dev = genome->get_normalize_std_devs().at(parameter_name);
+        double norm_max = fmax((min - avg) / std_dev, (max - avg) / std_dev);
+
+        return "((" + value + " - " + double_literal(avg) + ") / " + double_literal(std_dev) + ") / " + double_literal(norm_max);
+
+    } else {
+        return value;
+    }
+}
+
+string RNN_Code_Generator::denormalize(const string &parameter_name, const string &value) const {
+    string normalize_type = genome->get_normalize_type();
+
+    if (normalize_type.compare("min_max") == 0) {
+        string min = double_literal(genome->get_normalize_mins().at(parameter_name));
+        string max = double_literal(genome->get_normalize_maxs().at(parameter_name));
+
+        return "(" + value + " * (" + max + " - " + min + ")) + " + min;
+
+    } else if (normalize_type.compare("avg_std_dev") == 0) {
+        double min = genome->get_normalize_mins().at(parameter_name);
+        double max = genome->get_normalize_maxs().at(parameter_name);
+        double avg = genome->get_normalize_avgs().at(parameter_name);
+        double std_dev = genome->get_normalize_std_devs().at(parameter_name);
+        double norm_max = fmax((min - avg) / std_dev, (max - avg) / std_dev);
+
+        return "(" + value + " * " + double_literal(norm_max) + " * " + double_literal(std_dev) + ") + " + double_literal(avg);
+
+    } else {
+        return value;
+    }
+}
+
+void RNN_Code_Generator::input_fired(RNN_Node_Interface *node, const string &value) {
+    string innovation = to_string(node->get_innovation_number());
+    step_code << "    in_" << innovation << " += " << value << ";" << endl;
+
+    //like the nodes themselves, only calculate the output once all the inputs are in
+    inputs_fired[node]++;
+    if (inputs_fired[node] == node->get_total_inputs()) write_node(node);
+}
+
+void RNN_Code_Generator::write_node(RNN_Node_Interface *node) {
+    string x = "in_" + to_string(node->get_innovation_number());
+    string out = "out_" + to_string(node->get_innovation_number());
+
+    vector<double> parameters;
+    node->get_weights(parameters);
+
+    string state;
+    if (node_state_index.count(node) > 0) state = "state.node_values[" + to_string(node_state_index[node]) + "]";
+
+    //each of these is written out the same way as the node's input_fired, so the
+    //operations are done in the same order
+    switch (node->get_node_type()) {
+        case SIMPLE_NODE:
+        case JORDAN_NODE:
+        case ELMAN_NODE: {
+            string bias = add_weight(parameters[0]);
+
+            step_code << "    " << out << " = std::tanh(" << x << " + " << bias << ");" << endl;
+            break;
+        }
+
+        case UGRNN_NODE: {
+            string cw = add_weight(parameters[0]);
+            string ch = add_weight(parameters[1]);
+            string c_bias = add_weight(parameters[2]);
+            string gw = add_weight(parameters[3]);
+            string gh = add_weight(parameters[4]);
+            string g_bias = add_weight(parameters[5]);
+
+            step_code << "    {" << endl
+                      << "        double h_prev = " << state << ";" << endl
+                      << "        double c = std::tanh(" << x << " * " << cw << " + h_prev * " << ch << " + " << c_bias << ");" << endl
+                      << "        double g = sigmoid(" << x << " * " << gw << " + h_prev * " << gh << " + " << g_bias << ");" << endl
+                      << "        " << out << " = (g * h_prev) + ((1 - g) * c);" << endl
+                      << "        " << state << " = " << out << ";" << endl
+                      << "    }" << endl;
+            break;
+        }
+
+        case MGU_NODE: {
+            string fw = add_weight(parameters[0]);
+            string fu = add_weight(parameters[1]);
+            string f_bias = add_weight(parameters[2]);
+            string hw = add_weight(parameters[3]);
+            string hu = add_weight(parameters[4]);
+            string h_bias = add_weight(parameters[5]);
+
+            step_code << "    {" << endl
+                      << "        double h_prev = " << state << ";" << endl
+                      << "        double f = sigmoid(" << f_bias << " + h_prev * " << fu << " + " << x << " * " << fw << ");" << endl
+                      << "        double h_tanh = std::tanh(" << h_bias << " + " << x << " * " << hw << " + " << hu << " * f * h_prev);" << endl
+                      << "        " << out << " = (1 - f) * h_prev + f * h_tanh;" << endl
+                      << "        " << state << " = " << out << ";" << endl
+                      << "    }" << endl;
+            break;
+        }
+
+        case GRU_NODE: {
+            string zw = add_weight(parameters[0]);
+            string zu = add_weight(parameters[1]);
+            string z_bias = add_weight(parameters[2]);
+            string rw = add_weight(parameters[3]);
+            string ru = add_weight(parameters[4]);
+            string r_bias = add_weight(parameters[5]);
+            string hw = add_weight(parameters[6]);
+            string hu = add_weight(parameters[7]);
+            string h_bias = add_weight(parameters[8]);
+
+            step_code << "    {" << endl
+                      << "        double h_prev = " << state << ";" << endl
+                      << "        double z = sigmoid(" << z_bias << " + h_prev * " << zu << " + " << x << " * " << zw << ");" << endl
+                      << "        double r = sigmoid(" << r_bias << " + " << x << " * " << rw << " + h_prev * " << ru << ");" << endl
+                      << "        double h_tanh = std::tanh(" << h_bias << " + " << x << " * " << hw << " + " << hu << " * r * h_prev);" << endl
+                      << "        " << out << " = h_prev * z + (1 - z) * h_tanh;" << endl
+                      << "        " << state << " = " << out << ";" << endl
+                      << "    }" << endl;
+            break;
+        }
+
+        case DELTA_NODE: {
+            //the node centers alpha, beta1 and beta2 around 2, 1 and 1 before using them
+            string alpha = add_weight(parameters[0] + 2.0);
+            string beta1 = add_weight(parameters[1] + 1.0);
+            string beta2 = add_weight(parameters[2] + 1.0);
+            string v = add_weight(parameters[3]);
+            string r_bias = add_weight(parameters[4]);
+            string z_hat_bias = add_weight(parameters[5]);
+
+            step_code << "    {" << endl
+                      << "        double z_prev = " << state << ";" << endl
+                      << "        double d1 = " << v << " * z_prev;" << endl
+                      << "        double z_cap = std::tanh(d1 * " << x << " * " << alpha << " + d1 * " << beta1 << " + " << x << " * " << beta2 << " + " << z_hat_bias << ");" << endl
+                      << "        double r = sigmoid(" << x << " + " << r_bias << ");" << endl
+                      << "        " << out << " = std::tanh(z_cap * (1 - r) + r * z_prev);" << endl
+                      << "        " << state << " = " << out << ";" << endl
+                      << "    }" << endl;
+            break;
+        }
+
+        case LSTM_NODE: {
+            string output_gate_update_weight = add_weight(parameters[0]);
+            string output_gate_weight = add_weight(parameters[1]);
+            string output_gate_bias = add_weight(parameters[2]);
+            string input_gate_update_weight = add_weight(parameters[3]);
+            string input_gate_weight = add_weight(parameters[4]);
+            string input_gate_bias = add_weight(parameters[5]);
+            string forget_gate_update_weight = add_weight(parameters[6]);
+            string forget_gate_weight = add_weight(parameters[7]);
+            //the node centers the forget gate bias around 1 before using it
+            string forget_gate_bias = add_weight(parameters[8] + 1.0);
+            string cell_weight = add_weight(parameters[9]);
+            string cell_bias = add_weight(parameters[10]);
+
+            step_code << "    {" << endl
+                      << "        double previous_cell_value = " << state << ";" << endl
+                      << "        double output_gate = sigmoid(" << output_gate_weight << " * " << x << " + " << output_gate_update_weight << " * previous_cell_value + " << output_gate_bias << ");" << endl
+                      << "        double input_gate = sigmoid(" << input_gate_weight << " * " << x << " + " << input_gate_update_weight << " * previous_cell_value + " << input_gate_bias << ");" << endl
+                      << "        double forget_gate = sigmoid(" << forget_gate_weight << " * " << x << " + " << forget_gate_update_weight << " * previous_cell_value + " << forget_gate_bias << ");" << endl
+                      << "        double cell_in = std::tanh(" << cell_weight << " * " << x << " + " << cell_bias << ");" << endl
+                      << "        double cell_value = (forget_gate * previous_cell_value) + (input_gate * cell_in);" << endl
+                      << "        " << out << " = output_gate * cell_value;" << endl
+                      << "        " << state << " = cell_value;" << endl
+                      << "    }" << endl;
+            break;
+        }
+    }
+}
+
+void RNN_Code_Generator::write(ostream &out, const string &name_space, const string &genome_filename) {
+    vector<string> input_parameter_names = genome->get_input_parameter_names();
+    vector<string> output_parameter_names = genome->get_output_parameter_names();
+
+    //write the step function first, as this determines which weights are used
+    weights.clear();
+    inputs_fired.clear();
+    step_code.str("");
+
+    for (int32_t i = 0; i < (int32_t)rnn->nodes.size(); i++) {
+        if (rnn->nodes[i]->is_reachable()) {
+            string innovation = to_string(rnn->nodes[i]->get_innovation_number());
+            step_code << "    double in_" << innovation << " = 0.0, out_" << innovation << ";" << endl;
+        }
+    }
+    step_code << endl;
+
+    //the values the recurrent edges sent recurrent_depth time steps ago
+    for (int32_t i = 0; i < (int32_t)recurrent_edges.size(); i++) {
+        input_fired(recurrent_edges[i]->output_node, "state.recurrent_values[" + to_string(recurrent_value_index[i]) + "]");
+    }
+
+    for (int32_t i = 0; i < (int32_t)rnn->input_nodes.size(); i++) {
+        if (rnn->input_nodes[i]->is_reachable()) input_fired(rnn->input_nodes[i], normalize(input_parameter_names[i], "inputs[" + to_string(i) + "]"));
+    }
+
+    //when predicting, genomes trained with dropout scale what the feed forward edges send
+    //by (1 - dropout_probability); this is done after the weight, as in RNN_Edge, so the
+    //result is rounded the same way
+    string dropout_scale = "";
+    if (genome->get_use_dropout()) dropout_scale = " * " + add_weight(1.0 - genome->get_dropout_probability());
+
+    for (int32_t i = 0; i < (int32_t)rnn->edges.size(); i++) {
+        RNN_Edge *edge = rnn->edges[i];
+        if (!edge->is_reachable()) continue;
+
+        input_fired(edge->output_node, "out_" + to_string(edge->input_node->get_innovation_number()) + " * " + add_weight(edge->get_weight()) + dropout_scale);
+    }
+    step_code << endl;
+
+    //shift each recurrent edge's values along by one time step and add the value it sends now
+    for (int32_t i = 0; i < (int32_t)recurrent_edges.size(); i++) {
+        RNN_Recurrent_Edge *edge = recurrent_edges[i];
+        int32_t index = recurrent_value_index[i];
+
+        for (int32_t j = 0; j < edge->recurrent_depth - 1; j++) {
+            step_code << "    state.recurrent_values[" << (index + j) << "] = state.recurrent_values[" << (index + j + 1) << "];" << endl;
+        }
+        step_code << "    state.recurrent_values[" << (index + edge->recurrent_depth - 1) << "] = out_" << edge->input_node->get_innovation_number() << " * " << add_weight(edge->get_weight()) << ";" << endl;
+    }
+    step_code << endl;
+
+    for (int32_t i = 0; i < (int32_t)rnn->output_nodes.size(); i++) {
+        RNN_Node_Interface *node = rnn->output_nodes[i];
+        string value = node->is_reachable() ? "out_" + to_string(node->get_innovation_number()) : "0.0";
+        step_code << "    outputs[" << i << "] = " << denormalize(output_parameter_names[i], value) << ";" << endl;
+    }
+
+    string guard = name_space;
+    for (int32_t i = 0; i < (int32_t)guard.size(); i++) guard[i] = toupper(guard[i]);
+    guard += "_HXX";
+
+    out << "//generated by rnn_to_cpp from " << genome_filename << ", do not edit" << endl;
+    out << "#ifndef " << guard << endl;
+    out << "#define " << guard << endl;
+    out << endl;
+    out << "#include <cmath>" << endl;
+    out << endl;
+    out << "namespace " << name_space << " {" << endl;
+    out << endl;
+
+    out << "constexpr int number_inputs = " << input_parameter_names.size() << ";" << endl;
+    out << "constexpr int number_outputs = " << output_parameter_names.size() << ";" << endl;
+    out << endl;
+
+    out << "constexpr const char* input_parameter_names[number_inputs] = {";
+    for (int32_t i = 0; i < (int32_t)input_parameter_names.size(); i++) {
+        out << (i == 0 ? "" : ",") << endl << "    \"" << input_parameter_names[i] << "\"";
+    }
+    out << endl << "};" << endl;
+    out << endl;
+
+    out << "constexpr const char* output_parameter_names[number_outputs] = {";
+    for (int32_t i = 0; i < (int32_t)output_parameter_names.size(); i++) {
+        out << (i == 0 ? "" : ",") << endl << "    \"" << output_parameter_names[i] << "\"";
+    }
+    out << endl << "};" << endl;
+    out << endl;
+
+    out << "constexpr double weights[" << weights.size() << "] = {";
+    for (int32_t i = 0; i < (int32_t)weights.size(); i++) {
+        out << (i == 0 ? "" : ",") << endl << "    " << double_literal(weights[i]);
+    }
+    out << endl << "};" << endl;
+    out << endl;
+
+    //zero length arrays are not allowed, so always have at least one value
+    out << "/**" << endl;
+    out << " * The recurrent state carried between time steps; zero initialize it (or call reset)" << endl;
+    out << " * before the first time step of a series." << endl;
+    out << " */" << endl;
+    out << "struct State {" << endl;
+    out << "    double node_values[" << (number_node_values > 0 ? number_node_values : 1) << "];" << endl;
+    out << "    double recurrent_values[" << (number_recurrent_values > 0 ? number_recurrent_values : 1) << "];" << endl;
+    out << "};" << endl;
+    out << endl;
+
+    out << "inline void reset(State &state) {" << endl;
+    out << "    state = State{};" << endl;
+    out << "}" << endl;
+    out << endl;
+
+    out << "inline double sigmoid(double value) {" << endl;
+    out << "    return 1.0 / (1.0 + std::exp(-value));" << endl;
+    out << "}" << endl;
+    out << endl;
+
+    out << "/**" << endl;
+    out << " * Does the next time step of the series; inputs (number_inputs raw values, in the" << endl;
+    out << " * order of input_parameter_names) are normalized the same way the genome's training" << endl;
+    out << " * data was, and outputs (number_outputs values) are set to the denormalized predictions." << endl;
+    out << " */" << endl;
+    out << "inline void step(State &state, const double *inputs, double *outputs) {" << endl;
+    out << step_code.str();
+    out << "}" << endl;
+    out << endl;
+
+    out << "}" << endl;
+    out << endl;
+    out << "#endif" << endl;
+}
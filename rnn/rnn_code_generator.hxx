@@ -0,0 +1,85 @@
+#ifndef EXAMM_RNN_CODE_GENERATOR_HXX
+#define EXAMM_RNN_CODE_GENERATOR_HXX
+
+#include <cstdint>
+
+#include <map>
+using std::map;
+
+#include <ostream>
+using std::ostream;
+
+#include <sstream>
+using std::ostringstream;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include "rnn.hxx"
+#include "rnn_genome.hxx"
+#include "rnn_node_interface.hxx"
+#include "rnn_recurrent_edge.hxx"
+
+/**
+ * Writes a genome (with its best parameters) out as a self contained C++ header, for
+ * deploying it without the rest of EXAMM. The header has the weights as a constexpr
+ * array, a State struct holding the recurrent state, and an inline step function doing
+ * one time step of inference as straight line code: the math of each node type is
+ * written out in place and unreachable nodes and edges are left out. The genome's
+ * normalization is folded in, so step takes the raw input values and returns
+ * denormalized predictions.
+ *
+ * The generated code does the same operations in the same order as RNN_Stream (with the
+ * genome's dropout settings), so (as long as it is not compiled with options which allow
+ * floating point operations to be reordered or contracted, e.g. -ffast-math) its
+ * predictions are the same.
+ */
+class RNN_Code_Generator {
+    private:
+        RNN_Genome *genome;
+        RNN *rnn;
+
+        //the weights the generated code uses, in the order they are first used
+        vector<double> weights;
+
+        //the index in State::node_values of each stateful node's recurrent state
+        map<RNN_Node_Interface*, int32_t> node_state_index;
+        int32_t number_node_values;
+
+        //the reachable recurrent edges (ordered the same as in RNN_Stream), and the index
+        //of the first of each edge's recurrent_depth values in State::recurrent_values
+        vector<RNN_Recurrent_Edge*> recurrent_edges;
+        vector<int32_t> recurrent_value_index;
+        int32_t number_recurrent_values;
+
+        //how many inputs each node has been sent so far while writing the step function
+        map<RNN_Node_Interface*, int32_t> inputs_fired;
+
+        ostringstream step_code;
+
+        string add_weight(double weight);
+        string normalize(const string &parameter_name, const string &value) const;
+        string denormalize(const string &parameter_name, const string &value) const;
+
+        void input_fired(RNN_Node_Interface *node, const string &value);
+        void write_node(RNN_Node_Interface *node);
+
+    public:
+        /**
+         * \param genome is the genome to generate code for, which is not owned by the
+         *      generator; its best parameters are used as the weights
+         */
+        RNN_Code_Generator(RNN_Genome *genome);
+        ~RNN_Code_Generator();
+
+        /**
+         * Writes the header, with everything in it in the namespace name_space (which is
+         * also used for the include guard).
+         */
+        void write(ostream &out, const string &name_space, const string &genome_filename);
+};
+
+#endif
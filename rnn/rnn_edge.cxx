@@ -1,9 +1,16 @@
 #include "rnn_edge.hxx"
 
 #include "common/log.hxx"
+#include "common/random.hxx"
 
 RNN_Edge::RNN_Edge(int32_t _innovation_number, RNN_Node_Interface *_input_node, RNN_Node_Interface *_output_node) {
     innovation_number = _innovation_number;
+
+    weight = &weight_storage[0];
+    d_weight = &weight_storage[1];
+    *weight = 0.0;
+    *d_weight = 0.0;
+
     input_node = _input_node;
     output_node = _output_node;
 
@@ -23,6 +30,11 @@ RNN_Edge::RNN_Edge(int32_t _innovation_number, RNN_Node_Interface *_input_node,
 RNN_Edge::RNN_Edge(int32_t _innovation_number, int32_t _input_innovation_number, int32_t _output_innovation_number, const vector<RNN_Node_Interface*> &nodes) {
     innovation_number = _innovation_number;
 
+    weight = &weight_storage[0];
+    d_weight = &weight_storage[1];
+    *weight = 0.0;
+    *d_weight = 0.0;
+
     input_innovation_number = _input_innovation_number;
     output_innovation_number = _output_innovation_number;
 
@@ -62,11 +74,9 @@ RNN_Edge::RNN_Edge(int32_t _innovation_number, int32_t _input_innovation_number,
 RNN_Edge* RNN_Edge::copy(const vector<RNN_Node_Interface*> new_nodes) {
     RNN_Edge* e = new RNN_Edge(innovation_number, input_innovation_number, output_innovation_number, new_nodes);
 
-    e->weight = weight;
-    e->d_weight = d_weight;
+    *e->weight = *weight;
+    *e->d_weight = *d_weight;
 
-    e->outputs = outputs;
-    e->deltas = deltas;
     e->enabled = enabled;
     e->forward_reachable = forward_reachable;
     e->backward_reachable = backward_reachable;
@@ -84,27 +94,28 @@ void RNN_Edge::propagate_forward(int32_t time) {
         exit(1);
     }
 
-    double output = input_node->output_values[time] * weight;
+    double output = input_node->output_values[time] * (*weight);
 
     //Log::trace("propagating forward at time %d from %d to %d, value: %lf, input: %lf, weight: %lf\n", time, input_node->innovation_number, output_node->innovation_number, output, input_node->output_values[time], weight);
 
-    outputs[time] = output;
     output_node->input_fired(time, output);
 }
 
 
-void RNN_Edge::propagate_forward(int32_t time, bool training, double dropout_probability) {
+void RNN_Edge::propagate_forward(int32_t time, bool training, double dropout_probability, uint64_t dropout_key) {
     if (input_node->inputs_fired[time] != input_node->total_inputs) {
         Log::fatal("ERROR! propagate forward called on edge %d where input_node->inputs_fired[%d] (%d) != total_inputs (%d)\n", innovation_number, time, input_node->inputs_fired[time], input_node->total_inputs);
         exit(1);
     }
 
-    double output = input_node->output_values[time] * weight;
+    double output = input_node->output_values[time] * (*weight);
 
     //Log::trace("propagating forward at time %d from %d to %d, value: %lf, input: %lf, weight: %lf\n", time, input_node->innovation_number, output_node->innovation_number, output, input_node->output_values[time], weight);
 
     if (training) {
-        if (drand48() < dropout_probability) {
+        if (time >= (int32_t)dropped_out.size()) dropped_out.resize(input_node->series_length);
+
+        if (counter_random_0_1(dropout_key, innovation_number, time) < dropout_probability) {
             dropped_out[time] = true;
             output = 0.0;
         } else {
@@ -114,7 +125,6 @@ void RNN_Edge::propagate_forward(int32_t time, bool training, double dropout_pro
         output *= (1.0 - dropout_probability);
     }
 
-    outputs[time] = output;
     output_node->input_fired(time, output);
 }
 
@@ -130,9 +140,8 @@ void RNN_Edge::propagate_backward(int32_t time) {
 
     double delta = output_node->d_input[time];
 
-    d_weight += delta * input_node->output_values[time];
-    deltas[time] = delta * weight;
-    input_node->output_fired(time, deltas[time]);
+    *d_weight += delta * input_node->output_values[time];
+    input_node->output_fired(time, delta * (*weight));
 }
 
 void RNN_Edge::propagate_backward(int32_t time, bool training, double dropout_probability) {
@@ -151,20 +160,31 @@ void RNN_Edge::propagate_backward(int32_t time, bool training, double dropout_pr
         if (dropped_out[time]) delta = 0.0;
     }
 
-    d_weight += delta * input_node->output_values[time];
-    deltas[time] = delta * weight;
-    input_node->output_fired(time, deltas[time]);
+    *d_weight += delta * input_node->output_values[time];
+    input_node->output_fired(time, delta * (*weight));
 }
 
 void RNN_Edge::reset(int32_t series_length) {
-    d_weight = 0.0;
-    outputs.resize(series_length);
-    deltas.resize(series_length);
-    dropped_out.resize(series_length);
+    *d_weight = 0.0;
 }
 
 double RNN_Edge::get_gradient() const {
-    return d_weight;
+    return *d_weight;
+}
+
+double RNN_Edge::get_weight() const {
+    return *weight;
+}
+
+void RNN_Edge::set_weight(double _weight) {
+    *weight = _weight;
+}
+
+void RNN_Edge::set_weight_buffers(double *_weight, double *_d_weight) {
+    *_weight = *weight;
+    *_d_weight = *d_weight;
+    weight = _weight;
+    d_weight = _d_weight;
 }
 
 int32_t RNN_Edge::get_innovation_number() const {
@@ -7,12 +7,17 @@ class RNN_Edge {
     private:
         int32_t innovation_number;
 
-        vector<double> outputs;
-        vector<double> deltas;
+        //edges pass their values straight on to their nodes, so they only keep per time
+        //step state when it is needed by the backward pass: whether they were dropped out
+        //(only sized when training with dropout)
         vector<bool> dropped_out;
 
-        double weight;
-        double d_weight;
+        //the weight and its gradient, which the backward pass adds to and reset clears. When
+        //the edge is part of an RNN these point into the RNN's parameter and gradient buffers
+        //(see set_weight_buffers), otherwise into weight_storage
+        double *weight;
+        double *d_weight;
+        double weight_storage[2];
 
         bool enabled;
         bool forward_reachable;
@@ -36,7 +41,12 @@ class RNN_Edge {
         void propagate_forward(int32_t time);
         void propagate_backward(int32_t time);
 
-        void propagate_forward(int32_t time, bool training, double dropout_probability);
+        /**
+         * Propagates forward with dropout. Whether this edge is dropped out at a time step
+         * is drawn from the counter based stream for dropout_key, so it does not depend on
+         * any shared random number generator state.
+         */
+        void propagate_forward(int32_t time, bool training, double dropout_probability, uint64_t dropout_key);
         void propagate_backward(int32_t time, bool training, double dropout_probability);
 
         double get_gradient() const;
@@ -47,6 +57,16 @@ class RNN_Edge {
         const RNN_Node_Interface* get_input_node() const;
         const RNN_Node_Interface* get_output_node() const;
 
+        double get_weight() const;
+        void set_weight(double _weight);
+
+        /**
+         * Moves the weight and its gradient to the given locations, keeping their current
+         * values. RNN uses this to keep the weights of all its edges in its parameter and
+         * gradient buffers.
+         */
+        void set_weight_buffers(double *_weight, double *_d_weight);
+
         bool is_enabled() const;
         bool is_reachable() const;
 
@@ -56,6 +76,8 @@ class RNN_Edge {
 
         friend class RNN_Genome;
         friend class RNN;
+        friend class RNN_Code_Generator;
+        friend class RNN_Quantized;
         friend class EXAMM;
 };
 
@@ -47,6 +47,7 @@ using std::vector;
 #include "common/random.hxx"
 #include "common/color_table.hxx"
 #include "common/log.hxx"
+#include "common/performance_log.hxx"
 
 #include "time_series/time_series.hxx"
 
@@ -91,8 +92,8 @@ RNN_Genome::RNN_Genome(vector<RNN_Node_Interface*> &_nodes,
     generation_id = -1;
     group_id = -1;
 
-    int16_t seed = std::chrono::system_clock::now().time_since_epoch().count();
-    generator = minstd_rand0(seed);
+    generator = minstd_rand0(generate_random_seed());
+    random_stream_id = -1;
 
     best_validation_mse = EXAMM_MAX_DOUBLE;
     best_validation_mae = EXAMM_MAX_DOUBLE;
@@ -110,6 +111,7 @@ RNN_Genome::RNN_Genome(vector<RNN_Node_Interface*> &_nodes,
 
     //set default values
     bp_iterations = 20000;
+    fidelity = FULL_FIDELITY;
 
     //SHO SY
     //learning_rate = 0.001;
@@ -177,6 +179,7 @@ RNN_Genome* RNN_Genome::copy() {
 
     other->group_id = group_id;
     other->bp_iterations = bp_iterations;
+    other->fidelity = fidelity;
     other->generation_id = generation_id;
     //SHO SY TODO: should we also update the initial learning rate for the copies??
     other->learning_rate = learning_rate;
@@ -201,6 +204,10 @@ RNN_Genome* RNN_Genome::copy() {
     other->best_validation_mae = best_validation_mae;
     other->best_parameters = best_parameters;
 
+    other->node_optimizer_state = node_optimizer_state;
+    other->edge_optimizer_state = edge_optimizer_state;
+    other->recurrent_edge_optimizer_state = recurrent_edge_optimizer_state;
+
     other->input_parameter_names = input_parameter_names;
     other->output_parameter_names = output_parameter_names;
 
@@ -495,6 +502,14 @@ int32_t RNN_Genome::get_bp_iterations() {
     return bp_iterations;
 }
 
+int32_t RNN_Genome::get_fidelity() const {
+    return fidelity;
+}
+
+void RNN_Genome::set_fidelity(int32_t _fidelity) {
+    fidelity = _fidelity;
+}
+
 // void RNN_Genome::set_learning_rate(double _learning_rate) {
 //     learning_rate = _learning_rate;
 // }
@@ -523,9 +538,18 @@ void RNN_Genome::disable_dropout() {
 }
 
 void RNN_Genome::enable_dropout(double _dropout_probability) {
+    use_dropout = true;
     dropout_probability = _dropout_probability;
 }
 
+bool RNN_Genome::get_use_dropout() const {
+    return use_dropout;
+}
+
+double RNN_Genome::get_dropout_probability() const {
+    return dropout_probability;
+}
+
 void RNN_Genome::set_log_filename(string _log_filename) {
     log_filename = _log_filename;
 }
@@ -541,12 +565,12 @@ void RNN_Genome::get_weights(vector<double> &parameters) {
     }
 
     for (int32_t i = 0; i < (int32_t)edges.size(); i++) {
-        parameters[current++] = edges[i]->weight;
+        parameters[current++] = edges[i]->get_weight();
         //if (edges[i]->is_reachable()) parameters[current++] = edges[i]->weight;
     }
 
     for (int32_t i = 0; i < (int32_t)recurrent_edges.size(); i++) {
-        parameters[current++] = recurrent_edges[i]->weight;
+        parameters[current++] = recurrent_edges[i]->get_weight();
         //if (recurrent_edges[i]->is_reachable()) parameters[current++] = recurrent_edges[i]->weight;
     }
 }
@@ -557,6 +581,8 @@ void RNN_Genome::set_weights(const vector<double> &parameters) {
         exit(1);
     }
 
+    signature_valid = false;
+
     int32_t current = 0;
 
     for (int32_t i = 0; i < (int32_t)nodes.size(); i++) {
@@ -565,17 +591,173 @@ void RNN_Genome::set_weights(const vector<double> &parameters) {
     }
 
     for (int32_t i = 0; i < (int32_t)edges.size(); i++) {
-        edges[i]->weight = bound(parameters[current++]);
+        edges[i]->set_weight(bound(parameters[current++]));
         //if (edges[i]->is_reachable()) edges[i]->weight = parameters[current++];
     }
 
     for (int32_t i = 0; i < (int32_t)recurrent_edges.size(); i++) {
-        recurrent_edges[i]->weight = bound(parameters[current++]);
+        recurrent_edges[i]->set_weight(bound(parameters[current++]));
         //if (recurrent_edges[i]->is_reachable()) recurrent_edges[i]->weight = parameters[current++];
     }
 
 }
 
+bool RNN_Genome::has_optimizer_state() const {
+    return node_optimizer_state.size() > 0 || edge_optimizer_state.size() > 0 || recurrent_edge_optimizer_state.size() > 0;
+}
+
+static void get_component_optimizer_state(const map<int32_t, vector<double>> &state, int32_t innovation_number, int32_t n_weights, int32_t current, vector<double> &velocity, vector<double> &prev_velocity) {
+    auto it = state.find(innovation_number);
+    //the component may have changed size (or be new), in which case it starts from scratch
+    if (it == state.end() || (int32_t)it->second.size() != 2 * n_weights) return;
+
+    for (int32_t j = 0; j < n_weights; j++) {
+        velocity[current + j] = it->second[j];
+        prev_velocity[current + j] = it->second[n_weights + j];
+    }
+}
+
+static void set_component_optimizer_state(map<int32_t, vector<double>> &state, int32_t innovation_number, int32_t n_weights, int32_t current, const vector<double> &velocity, const vector<double> &prev_velocity) {
+    vector<double> &values = state[innovation_number];
+    values.resize(2 * n_weights);
+
+    for (int32_t j = 0; j < n_weights; j++) {
+        values[j] = velocity[current + j];
+        values[n_weights + j] = prev_velocity[current + j];
+    }
+}
+
+void RNN_Genome::get_optimizer_state(vector<double> &velocity, vector<double> &prev_velocity) {
+    int32_t number_weights = get_number_weights();
+    velocity.assign(number_weights, 0.0);
+    prev_velocity.assign(number_weights, 0.0);
+
+    int32_t current = 0;
+    for (int32_t i = 0; i < (int32_t)nodes.size(); i++) {
+        int32_t n_weights = nodes[i]->get_number_weights();
+        get_component_optimizer_state(node_optimizer_state, nodes[i]->innovation_number, n_weights, current, velocity, prev_velocity);
+        current += n_weights;
+    }
+
+    for (int32_t i = 0; i < (int32_t)edges.size(); i++) {
+        get_component_optimizer_state(edge_optimizer_state, edges[i]->innovation_number, 1, current++, velocity, prev_velocity);
+    }
+
+    for (int32_t i = 0; i < (int32_t)recurrent_edges.size(); i++) {
+        get_component_optimizer_state(recurrent_edge_optimizer_state, recurrent_edges[i]->innovation_number, 1, current++, velocity, prev_velocity);
+    }
+}
+
+void RNN_Genome::set_optimizer_state(const vector<double> &velocity, const vector<double> &prev_velocity) {
+    if ((int32_t)velocity.size() != get_number_weights() || (int32_t)prev_velocity.size() != get_number_weights()) {
+        Log::fatal("ERROR! Trying to set optimizer state where the RNN has %d weights, and the velocity and prev_velocity vectors have %d and %d values!\n", get_number_weights(), velocity.size(), prev_velocity.size());
+        exit(1);
+    }
+
+    clear_optimizer_state();
+
+    int32_t current = 0;
+    for (int32_t i = 0; i < (int32_t)nodes.size(); i++) {
+        int32_t n_weights = nodes[i]->get_number_weights();
+        if (n_weights > 0) set_component_optimizer_state(node_optimizer_state, nodes[i]->innovation_number, n_weights, current, velocity, prev_velocity);
+        current += n_weights;
+    }
+
+    for (int32_t i = 0; i < (int32_t)edges.size(); i++) {
+        set_component_optimizer_state(edge_optimizer_state, edges[i]->innovation_number, 1, current++, velocity, prev_velocity);
+    }
+
+    for (int32_t i = 0; i < (int32_t)recurrent_edges.size(); i++) {
+        set_component_optimizer_state(recurrent_edge_optimizer_state, recurrent_edges[i]->innovation_number, 1, current++, velocity, prev_velocity);
+    }
+}
+
+void RNN_Genome::clear_optimizer_state() {
+    node_optimizer_state.clear();
+    edge_optimizer_state.clear();
+    recurrent_edge_optimizer_state.clear();
+}
+
+void RNN_Genome::inherit_optimizer_state(const RNN_Genome *more_fit_parent, const RNN_Genome *less_fit_parent) {
+    //only keep state for the components this genome actually has
+    clear_optimizer_state();
+
+    for (int32_t i = 0; i < (int32_t)nodes.size(); i++) {
+        int32_t innovation_number = nodes[i]->innovation_number;
+        auto it = more_fit_parent->node_optimizer_state.find(innovation_number);
+        if (it != more_fit_parent->node_optimizer_state.end()) {
+            node_optimizer_state[innovation_number] = it->second;
+        } else if ((it = less_fit_parent->node_optimizer_state.find(innovation_number)) != less_fit_parent->node_optimizer_state.end()) {
+            node_optimizer_state[innovation_number] = it->second;
+        }
+    }
+
+    for (int32_t i = 0; i < (int32_t)edges.size(); i++) {
+        int32_t innovation_number = edges[i]->innovation_number;
+        auto it = more_fit_parent->edge_optimizer_state.find(innovation_number);
+        if (it != more_fit_parent->edge_optimizer_state.end()) {
+            edge_optimizer_state[innovation_number] = it->second;
+        } else if ((it = less_fit_parent->edge_optimizer_state.find(innovation_number)) != less_fit_parent->edge_optimizer_state.end()) {
+            edge_optimizer_state[innovation_number] = it->second;
+        }
+    }
+
+    for (int32_t i = 0; i < (int32_t)recurrent_edges.size(); i++) {
+        int32_t innovation_number = recurrent_edges[i]->innovation_number;
+        auto it = more_fit_parent->recurrent_edge_optimizer_state.find(innovation_number);
+        if (it != more_fit_parent->recurrent_edge_optimizer_state.end()) {
+            recurrent_edge_optimizer_state[innovation_number] = it->second;
+        } else if ((it = less_fit_parent->recurrent_edge_optimizer_state.find(innovation_number)) != less_fit_parent->recurrent_edge_optimizer_state.end()) {
+            recurrent_edge_optimizer_state[innovation_number] = it->second;
+        }
+    }
+}
+
+void RNN_Genome::publish_shared_weights(SharedWeightStore *store) {
+    if ((int32_t)best_parameters.size() != get_number_weights()) {
+        Log::fatal("ERROR! Trying to publish shared weights where the RNN has %d weights, and the best parameters vector has %d weights!\n", get_number_weights(), best_parameters.size());
+        exit(1);
+    }
+
+    int32_t current = 0;
+    for (int32_t i = 0; i < (int32_t)nodes.size(); i++) {
+        int32_t n_weights = nodes[i]->get_number_weights();
+        if (n_weights > 0) store->update(SHARED_NODE, nodes[i]->innovation_number, n_weights, current, best_parameters);
+        current += n_weights;
+    }
+
+    for (int32_t i = 0; i < (int32_t)edges.size(); i++) {
+        store->update(SHARED_EDGE, edges[i]->innovation_number, 1, current++, best_parameters);
+    }
+
+    for (int32_t i = 0; i < (int32_t)recurrent_edges.size(); i++) {
+        store->update(SHARED_RECURRENT_EDGE, recurrent_edges[i]->innovation_number, 1, current++, best_parameters);
+    }
+}
+
+int32_t RNN_Genome::initialize_from_shared_weights(const SharedWeightStore *store) {
+    if ((int32_t)initial_parameters.size() != get_number_weights()) get_weights(initial_parameters);
+
+    int32_t number_shared = 0;
+    int32_t current = 0;
+    for (int32_t i = 0; i < (int32_t)nodes.size(); i++) {
+        int32_t n_weights = nodes[i]->get_number_weights();
+        if (n_weights > 0 && store->get(SHARED_NODE, nodes[i]->innovation_number, n_weights, current, initial_parameters)) number_shared++;
+        current += n_weights;
+    }
+
+    for (int32_t i = 0; i < (int32_t)edges.size(); i++) {
+        if (store->get(SHARED_EDGE, edges[i]->innovation_number, 1, current++, initial_parameters)) number_shared++;
+    }
+
+    for (int32_t i = 0; i < (int32_t)recurrent_edges.size(); i++) {
+        if (store->get(SHARED_RECURRENT_EDGE, recurrent_edges[i]->innovation_number, 1, current++, initial_parameters)) number_shared++;
+    }
+
+    set_weights(initial_parameters);
+    return number_shared;
+}
+
 int32_t RNN_Genome::get_number_inputs() {
     int32_t number_inputs = 0;
 
@@ -628,19 +810,19 @@ double RNN_Genome::get_avg_edge_weight() {
     double weights = 0;
     for (int32_t i = 0; i < (int32_t)edges.size(); i++) {
         if (edges[i] -> enabled) {
-            if(edges[i] -> weight > 10) {
-                Log::error("ERROR: edge %d has weight %f \n", i, edges[i]-> weight);
+            if(edges[i]->get_weight() > 10) {
+                Log::error("ERROR: edge %d has weight %f \n", i, edges[i]->get_weight());
             }
-            weights += edges[i] -> weight;
+            weights += edges[i]->get_weight();
         }
 
     }
     for (int32_t i = 0; i < (int32_t)recurrent_edges.size(); i++) {
         if (recurrent_edges[i] -> enabled) {
-            if(recurrent_edges[i] -> weight > 10) {
-                Log::error("ERROR: recurrent edge %d has weight %f \n", i, recurrent_edges[i]-> weight);
+            if(recurrent_edges[i]->get_weight() > 10) {
+                Log::error("ERROR: recurrent edge %d has weight %f \n", i, recurrent_edges[i]->get_weight());
             }
-            weights += recurrent_edges[i] -> weight;
+            weights += recurrent_edges[i]->get_weight();
         }
     }
     int32_t N = edges.size() + recurrent_edges.size();
@@ -652,6 +834,8 @@ void RNN_Genome::initialize_randomly() {
     Log::trace("initializing genome %d of group %d randomly!\n", generation_id, group_id);
     int32_t number_of_weights = get_number_weights();
     initial_parameters.assign(number_of_weights, 0.0);
+    //state from any previous weights no longer applies
+    clear_optimizer_state();
     WeightType weight_initialize = weight_rules->get_weight_initialize_method();
 
     if (weight_initialize == WeightType::RANDOM) {
@@ -690,11 +874,11 @@ void RNN_Genome::initialize_xavier(RNN_Node_Interface* n) {
     double range = sqrt(6)/sqrt(sum);
     for(int32_t j = 0; j < (int32_t)input_edges.size(); j++) {
         double edge_weight = range * rng_1_1(generator);
-        input_edges[j]->weight = edge_weight;
+        input_edges[j]->set_weight(edge_weight);
     }
     for(int32_t j = 0; j < (int32_t)input_recurrent_edges.size(); j++) {
         double edge_weight = range * rng_1_1(generator);
-        input_recurrent_edges[j]->weight = edge_weight;
+        input_recurrent_edges[j]->set_weight(edge_weight);
     }
     n->initialize_xavier(generator, rng_1_1, range);
 }
@@ -709,11 +893,11 @@ void RNN_Genome::initialize_kaiming(RNN_Node_Interface* n) {
     double range = sqrt(2) / sqrt(fan_in);
     for(int32_t j = 0; j < (int32_t)input_edges.size(); j++) {
         double edge_weight = range * normal_distribution.random(generator, 0, 1);
-        input_edges[j]->weight = edge_weight;
+        input_edges[j]->set_weight(edge_weight);
     }
     for(int32_t j = 0; j < (int32_t)input_recurrent_edges.size(); j++) {
         double edge_weight = range * normal_distribution.random(generator, 0, 1);
-        input_recurrent_edges[j]->weight = edge_weight;
+        input_recurrent_edges[j]->set_weight(edge_weight);
     }
     n->initialize_kaiming(generator, normal_distribution, range);
 }
@@ -824,6 +1008,7 @@ int32_t RNN_Genome::get_fan_out(int32_t node_innovation) {
 }
 
 RNN* RNN_Genome::get_rnn() {
+    ScopedTimer timer(PerformanceLog::GET_RNN);
     vector<RNN_Node_Interface*> node_copies;
     vector<RNN_Edge*> edge_copies;
     vector<RNN_Recurrent_Edge*> recurrent_edge_copies;
@@ -843,7 +1028,9 @@ RNN* RNN_Genome::get_rnn() {
         //if (recurrent_edges[i]->is_reachable()) recurrent_edge_copies.push_back( recurrent_edges[i]->copy(node_copies) );
     }
 
-    return new RNN(node_copies, edge_copies, recurrent_edge_copies, input_parameter_names, output_parameter_names);
+    RNN *rnn = new RNN(node_copies, edge_copies, recurrent_edge_copies, input_parameter_names, output_parameter_names);
+    rnn->set_dropout_key(get_random_stream_key(generation_id, RANDOM_PURPOSE_DROPOUT));
+    return rnn;
 }
 
 vector<double> RNN_Genome::get_best_parameters() const {
@@ -868,6 +1055,13 @@ void RNN_Genome::set_generation_id(int32_t _generation_id) {
     generation_id = _generation_id;
 }
 
+void RNN_Genome::set_random_stream(int32_t _generation_id) {
+    if (random_stream_id == _generation_id) return;
+
+    generator = minstd_rand0(counter_random_uint32(get_random_stream_key(_generation_id, RANDOM_PURPOSE_GENOME), 0, 0));
+    random_stream_id = _generation_id;
+}
+
 double RNN_Genome::get_fitness() const {
 
     return best_validation_mse;
@@ -896,7 +1090,7 @@ bool RNN_Genome::sanity_check() {
 }
 
 
-void forward_pass_thread_regression(RNN* rnn, const vector<double> &parameters, const vector< vector<double> > &inputs, const vector< vector<double> > &outputs, int32_t i, double *mses, bool use_dropout, bool training, double dropout_probability) {
+void forward_pass_thread_regression(RNN* rnn, const vector<double> &parameters, const SeriesTensor &inputs, const SeriesTensor &outputs, int32_t i, double *mses, bool use_dropout, bool training, double dropout_probability) {
     rnn->set_weights(parameters);
     rnn->forward_pass(inputs, use_dropout, training, dropout_probability);
     mses[i] = rnn->calculate_error_mse(outputs);
@@ -905,7 +1099,7 @@ void forward_pass_thread_regression(RNN* rnn, const vector<double> &parameters,
     Log::trace("mse[%d]: %lf\n", i, mses[i]);
 }
 
-void forward_pass_thread_classification(RNN* rnn, const vector<double> &parameters, const vector< vector<double> > &inputs, const vector< vector<double> > &outputs, int32_t i, double *mses, bool use_dropout, bool training, double dropout_probability) {
+void forward_pass_thread_classification(RNN* rnn, const vector<double> &parameters, const SeriesTensor &inputs, const SeriesTensor &outputs, int32_t i, double *mses, bool use_dropout, bool training, double dropout_probability) {
     rnn->set_weights(parameters);
     rnn->forward_pass(inputs, use_dropout, training, dropout_probability);
     mses[i] = rnn->calculate_error_softmax(outputs);
@@ -914,7 +1108,7 @@ void forward_pass_thread_classification(RNN* rnn, const vector<double> &paramete
     Log::trace("mse[%d]: %lf\n", i, mses[i]);
 }
 
-void RNN_Genome::get_analytic_gradient(vector<RNN*> &rnns, const vector<double> &parameters, const vector< vector< vector<double> > > &inputs, const vector< vector< vector<double> > > &outputs, double &mse, vector<double> &analytic_gradient, bool training) {
+void RNN_Genome::get_analytic_gradient(vector<RNN*> &rnns, const vector<double> &parameters, const vector<SeriesTensor> &inputs, const vector<SeriesTensor> &outputs, double &mse, vector<double> &analytic_gradient, bool training) {
 
     double *mses = new double[rnns.size()];
     double mse_sum = 0.0;
@@ -931,37 +1125,25 @@ void RNN_Genome::get_analytic_gradient(vector<RNN*> &rnns, const vector<double>
 
     for (int32_t i = 0; i < (int32_t)rnns.size(); i++) {
         double d_mse = 0.0;
-        d_mse = mse_sum * (1.0 / outputs[i][0].size()) * 2.0;
+        d_mse = mse_sum * (1.0 / outputs[i].get_number_timesteps()) * 2.0;
         rnns[i]->backward_pass(d_mse, use_dropout, training, dropout_probability);
     }
 
     mse = mse_sum;
 
-    vector<double> current_gradients;
     analytic_gradient.assign(parameters.size(), 0.0);
     for (int32_t k = 0; k < (int32_t)rnns.size(); k++) {
-
-        int32_t current = 0;
-        for (int32_t i = 0; i < rnns[k]->get_number_nodes(); i++) {
-            rnns[k]->get_node(i)->get_gradients(current_gradients);
-
-            for (int32_t j = 0; j < (int32_t)current_gradients.size(); j++) {
-                analytic_gradient[current] += current_gradients[j];
-                current++;
-            }
-        }
-
-        for (int32_t i = 0; i < rnns[k]->get_number_edges(); i++) {
-            analytic_gradient[current] += rnns[k]->get_edge(i)->get_gradient();
-            current++;
+        const double *gradient = rnns[k]->get_gradient();
+        for (int32_t j = 0; j < rnns[k]->get_number_weights(); j++) {
+            analytic_gradient[j] += gradient[j];
         }
     }
 }
 
 
-void RNN_Genome::backpropagate(const vector< vector< vector<double> > > &inputs, const vector< vector< vector<double> > > &outputs, const vector< vector< vector<double> > > &validation_inputs, const vector< vector< vector<double> > > &validation_outputs, WeightUpdate *weight_update_method) {
+void RNN_Genome::backpropagate(const vector<SeriesTensor> &inputs, const vector<SeriesTensor> &outputs, const vector<SeriesTensor> &validation_inputs, const vector<SeriesTensor> &validation_outputs, WeightUpdate *weight_update_method) {
 
-    Log::error("SY: learning rate backprop before: %lf",this->learning_rate);
+    Log::debug("SY: learning rate backprop before: %lf",this->learning_rate);
     // double learning_rate = weight_update_method->get_learning_rate() / inputs.size();
     // double low_threshold = sqrt(weight_update_method->get_low_threshold() * inputs.size());
     // double high_threshold = sqrt(weight_update_method->get_high_threshold() * inputs.size());
@@ -975,8 +1157,12 @@ void RNN_Genome::backpropagate(const vector< vector< vector<double> > > &inputs,
     vector<double> parameters = initial_parameters;
     vector<double> velocity(n_parameters, 0.0);
     vector<double> prev_velocity(n_parameters, 0.0);
+    //warm start the optimizer from the state inherited from this genome's parents
+    if (weight_rules->get_inherit_optimizer_state()) get_optimizer_state(velocity, prev_velocity);
+    //the optimizer state matching best_parameters, which is what children inherit
+    vector<double> best_velocity = velocity;
+    vector<double> best_prev_velocity = prev_velocity;
     vector<double> analytic_gradient;
-    vector<double> prev_gradient(n_parameters, 0.0);
 
     double mse;
     double norm = 0.0;
@@ -993,7 +1179,6 @@ void RNN_Genome::backpropagate(const vector< vector< vector<double> > > &inputs,
     ofstream *output_log = create_log_file();
 
     for (int32_t iteration = 0; iteration < bp_iterations; iteration++) {
-        prev_gradient = analytic_gradient;
         get_analytic_gradient(rnns, parameters, inputs, outputs, mse, analytic_gradient, true);
         this->set_weights(parameters);
         validation_mse = get_mse(parameters, validation_inputs, validation_outputs);
@@ -1001,16 +1186,16 @@ void RNN_Genome::backpropagate(const vector< vector< vector<double> > > &inputs,
             best_validation_mse = validation_mse;
             best_validation_mae = get_mae(parameters, validation_inputs, validation_outputs);
             best_parameters = parameters;
+            best_velocity = velocity;
+            best_prev_velocity = prev_velocity;
         }
-        norm = weight_update_method->get_norm(analytic_gradient);
         if (output_log != NULL) {
             (*output_log) << iteration
                 << " " << mse
                 << " " << validation_mse
                 << " " << best_validation_mse << endl;
         }
-        weight_update_method->norm_gradients(analytic_gradient, norm);
-        weight_update_method->update_weights(parameters, velocity, prev_velocity, analytic_gradient, iteration, this->learning_rate);
+        norm = weight_update_method->normalize_and_update_weights(parameters, velocity, prev_velocity, analytic_gradient, iteration, this->learning_rate);
         Log::info("iteration %10d, mse: %10lf, v_mse: %10lf, bv_mse: %10lf, norm: %lf", iteration, mse, validation_mse, best_validation_mse, norm);
         Log::info_no_header("\n");
         //TODO: In other implementation, here there was a use_nesterov_momentum if-else block which used learning rate to set
@@ -1023,74 +1208,111 @@ void RNN_Genome::backpropagate(const vector< vector< vector<double> > > &inputs,
         rnns.pop_back();
         delete g;
     }
+    if (weight_rules->get_inherit_optimizer_state()) set_optimizer_state(best_velocity, best_prev_velocity);
     this->set_weights(best_parameters);
 }
 
-void RNN_Genome::backpropagate_stochastic(const vector< vector< vector<double> > > &inputs, const vector< vector< vector<double> > > &outputs, const vector< vector< vector<double> > > &validation_inputs, const vector< vector< vector<double> > > &validation_outputs, WeightUpdate *weight_update_method) {
+void RNN_Genome::backpropagate_stochastic(const vector<SeriesTensor> &inputs, const vector<SeriesTensor> &outputs, const vector<SeriesTensor> &validation_inputs, const vector<SeriesTensor> &validation_outputs, WeightUpdate *weight_update_method, const SequenceWindows *sequence_windows) {
+    ScopedTimer timer(PerformanceLog::TRAINING);
     int32_t n_parameters = this->get_number_weights();
-    int32_t n_series = (int32_t)inputs.size();
 
-    vector<double> parameters = initial_parameters;
     vector<double> velocity(n_parameters, 0.0);
     vector<double> prev_velocity(n_parameters, 0.0);
-    vector<double> analytic_gradient;
-    vector<double> prev_gradient(n_parameters, 0.0);
+    //warm start the optimizer from the state inherited from this genome's parents
+    if (weight_rules->get_inherit_optimizer_state()) get_optimizer_state(velocity, prev_velocity);
+    //the optimizer state matching best_parameters, which is what children inherit
+    vector<double> best_velocity = velocity;
+    vector<double> best_prev_velocity = prev_velocity;
 
     double mse;
     double norm = 0.0;
     RNN* rnn = get_rnn();
-    rnn->set_weights(parameters);
-    
+    rnn->set_weights(initial_parameters);
+
+    //the weights are trained in place in the RNN's parameter buffer, using the
+    //gradient it leaves in its gradient buffer
+    double *parameters = rnn->get_parameters();
+    const double *analytic_gradient = rnn->get_gradient();
+
+    //the order the training series are visited in only depends on the run seed
+    //and this genome's generation id, not on which worker trains it
+    minstd_rand0 shuffle_generator(counter_random_uint32(get_random_stream_key(generation_id, RANDOM_PURPOSE_TRAINING), 0, 0));
+
+    //with sequence windows every epoch trains on new views of the training series,
+    //otherwise on the series themselves
+    minstd_rand0 window_generator(counter_random_uint32(get_random_stream_key(generation_id, RANDOM_PURPOSE_WINDOWS), 0, 0));
+    vector<SeriesTensor> window_inputs;
+    vector<SeriesTensor> window_outputs;
+    const vector<SeriesTensor> *epoch_inputs = &inputs;
+    const vector<SeriesTensor> *epoch_outputs = &outputs;
+    if (sequence_windows != NULL) {
+        sequence_windows->sample(window_generator, inputs, outputs, window_inputs, window_outputs);
+        epoch_inputs = &window_inputs;
+        epoch_outputs = &window_outputs;
+    }
+    int32_t n_series = (int32_t)epoch_inputs->size();
+
     std::chrono::time_point<std::chrono::system_clock> startClock = std::chrono::system_clock::now();
 
     //initialize the initial previous values
     for (int32_t i = 0; i < n_series; i++) {
-        Log::trace("getting analytic gradient for input/output: %d, n_series: %d, parameters.size: %d, inputs.size(): %d, outputs.size(): %d, log filename: '%s'\n", i, n_series, parameters.size(), inputs.size(), outputs.size(), log_filename.c_str());
-        rnn->get_analytic_gradient(parameters, inputs[i], outputs[i], mse, analytic_gradient, use_dropout, true, dropout_probability);
+        Log::trace("getting analytic gradient for input/output: %d, n_series: %d, parameters.size: %d, inputs.size(): %d, outputs.size(): %d, log filename: '%s'\n", i, n_series, n_parameters, epoch_inputs->size(), epoch_outputs->size(), log_filename.c_str());
+        rnn->calculate_gradient((*epoch_inputs)[i], (*epoch_outputs)[i], mse, use_dropout, true, dropout_probability);
         Log::trace("got analytic gradient.\n");
-        norm = weight_update_method->get_norm(analytic_gradient);
+        norm = weight_update_method->get_norm(analytic_gradient, n_parameters);
     }
     Log::trace("initialized previous values.\n");
 
     //TODO: need to get validation mse on the RNN not the genome
-    double validation_mse = get_mse(parameters, validation_inputs, validation_outputs);
-    best_validation_mse = validation_mse;
-    best_validation_mae = get_mae(parameters, validation_inputs, validation_outputs);
-    best_parameters = parameters;
+    double validation_mse;
+    {
+        ScopedTimer validation_timer(PerformanceLog::VALIDATION);
+        validation_mse = get_mse(rnn, validation_inputs, validation_outputs);
+        best_validation_mse = validation_mse;
+        best_validation_mae = get_mae(rnn, validation_inputs, validation_outputs);
+    }
+    rnn->get_weights(best_parameters);
 
     Log::trace("got initial mses.\n");
     Log::info("initial validation_mse: %lf, best validation mse: %lf\n", validation_mse, best_validation_mse);
 
-    for (int32_t i = 0; i < (int32_t)parameters.size(); i++) {
+    for (int32_t i = 0; i < n_parameters; i++) {
         Log::trace("parameters[%d]: %lf\n", i, parameters[i]);
     }
 
     ofstream *output_log = create_log_file();
 
     for (int32_t iteration = 0; iteration < bp_iterations; iteration++) {
+        if (sequence_windows != NULL && iteration > 0) {
+            sequence_windows->sample(window_generator, inputs, outputs, window_inputs, window_outputs);
+            n_series = (int32_t)window_inputs.size();
+        }
+
         vector<int32_t> shuffle_order;
         for (int32_t i = 0; i < n_series; i++) {
             shuffle_order.push_back(i);
         }
-        fisher_yates_shuffle(generator, shuffle_order);
+        fisher_yates_shuffle(shuffle_generator, shuffle_order);
         double avg_norm = 0.0;
         for (int32_t k = 0; k < (int32_t)shuffle_order.size(); k++) {
             int32_t random_selection = shuffle_order[k];
-            prev_gradient = analytic_gradient;
-            rnn->get_analytic_gradient(parameters, inputs[random_selection], outputs[random_selection], mse, analytic_gradient, use_dropout, true, dropout_probability);
-            norm = weight_update_method->get_norm(analytic_gradient);
+            rnn->calculate_gradient((*epoch_inputs)[random_selection], (*epoch_outputs)[random_selection], mse, use_dropout, true, dropout_probability);
+            norm = weight_update_method->normalize_and_update_weights(parameters, velocity, prev_velocity, analytic_gradient, n_parameters, iteration, this->learning_rate);
             avg_norm += norm;
-            weight_update_method->norm_gradients(analytic_gradient, norm);
-            weight_update_method->update_weights(parameters, velocity, prev_velocity, analytic_gradient, iteration, this->learning_rate);
         }
-        this->set_weights(parameters);
-        double training_mse = get_mse(parameters, inputs, outputs);
-        validation_mse = get_mse(parameters, validation_inputs, validation_outputs);
-
-        if (validation_mse < best_validation_mse) {
-            best_validation_mse = validation_mse;
-            best_validation_mae = get_mae(parameters, validation_inputs, validation_outputs);
-            best_parameters = parameters;
+        double training_mse;
+        {
+            ScopedTimer validation_timer(PerformanceLog::VALIDATION);
+            training_mse = get_mse(rnn, *epoch_inputs, *epoch_outputs);
+            validation_mse = get_mse(rnn, validation_inputs, validation_outputs);
+
+            if (validation_mse < best_validation_mse) {
+                best_validation_mse = validation_mse;
+                best_validation_mae = get_mae(rnn, validation_inputs, validation_outputs);
+                rnn->get_weights(best_parameters);
+                best_velocity = velocity;
+                best_prev_velocity = prev_velocity;
+            }
         }
         if (output_log != NULL) {
             std::chrono::time_point<std::chrono::system_clock> currentClock = std::chrono::system_clock::now();
@@ -1100,6 +1322,7 @@ void RNN_Genome::backpropagate_stochastic(const vector< vector< vector<double> >
         Log::trace("iteration %4d, mse: %5.10lf, v_mse: %5.10lf, bv_mse: %5.10lf, avg_norm: %5.10lf\n", iteration, training_mse, validation_mse, best_validation_mse, avg_norm);
     }
     delete rnn;
+    if (weight_rules->get_inherit_optimizer_state()) set_optimizer_state(best_velocity, best_prev_velocity);
     this->set_weights(best_parameters);
     Log::trace("backpropagation completed, getting mu/sigma\n");
     double _mu, _sigma;
@@ -1146,7 +1369,7 @@ void RNN_Genome::update_log_file(ofstream *output_log, int32_t iteration, long m
         << "," << avg_norm << endl;
 }
 
-double RNN_Genome::get_softmax(const vector<double> &parameters, const vector< vector< vector<double> > > &inputs, const vector< vector< vector<double> > > &outputs) {
+double RNN_Genome::get_softmax(const vector<double> &parameters, const vector<SeriesTensor> &inputs, const vector<SeriesTensor> &outputs) {
     RNN *rnn = get_rnn();
     rnn->set_weights(parameters);
 
@@ -1168,10 +1391,17 @@ double RNN_Genome::get_softmax(const vector<double> &parameters, const vector< v
     return avg_softmax;
 }
 
-double RNN_Genome::get_mse(const vector<double> &parameters, const vector< vector< vector<double> > > &inputs, const vector< vector< vector<double> > > &outputs) {
+double RNN_Genome::get_mse(const vector<double> &parameters, const vector<SeriesTensor> &inputs, const vector<SeriesTensor> &outputs) {
     RNN *rnn = get_rnn();
     rnn->set_weights(parameters);
 
+    double avg_mse = get_mse(rnn, inputs, outputs);
+
+    delete rnn;
+    return avg_mse;
+}
+
+double RNN_Genome::get_mse(RNN *rnn, const vector<SeriesTensor> &inputs, const vector<SeriesTensor> &outputs) {
     double mse = 0.0;
     double avg_mse = 0.0;
 
@@ -1183,17 +1413,22 @@ double RNN_Genome::get_mse(const vector<double> &parameters, const vector< vecto
         Log::trace("series[%5d]: MSE: %5.10lf\n", i, mse);
     }
 
-    delete rnn;
-
     avg_mse /= inputs.size();
     Log::trace("average MSE: %5.10lf\n", avg_mse);
     return avg_mse;
 }
 
-double RNN_Genome::get_mae(const vector<double> &parameters, const vector< vector< vector<double> > > &inputs, const vector< vector< vector<double> > > &outputs) {
+double RNN_Genome::get_mae(const vector<double> &parameters, const vector<SeriesTensor> &inputs, const vector<SeriesTensor> &outputs) {
     RNN *rnn = get_rnn();
     rnn->set_weights(parameters);
 
+    double avg_mae = get_mae(rnn, inputs, outputs);
+
+    delete rnn;
+    return avg_mae;
+}
+
+double RNN_Genome::get_mae(RNN *rnn, const vector<SeriesTensor> &inputs, const vector<SeriesTensor> &outputs) {
     double mae;
     double avg_mae = 0.0;
 
@@ -1205,14 +1440,12 @@ double RNN_Genome::get_mae(const vector<double> &parameters, const vector< vecto
         Log::debug("series[%5d] MAE: %5.10lf\n", i, mae);
     }
 
-    delete rnn;
-
     avg_mae /= inputs.size();
     Log::debug("average MAE: %5.10lf\n", avg_mae);
     return avg_mae;
 }
 
-vector< vector<double> > RNN_Genome::get_predictions(const vector<double> &parameters, const vector< vector< vector<double> > > &inputs, const vector< vector< vector<double> > > &outputs) {
+vector< vector<double> > RNN_Genome::get_predictions(const vector<double> &parameters, const vector<SeriesTensor> &inputs, const vector<SeriesTensor> &outputs) {
     RNN *rnn = get_rnn();
     rnn->set_weights(parameters);
 
@@ -1229,7 +1462,7 @@ vector< vector<double> > RNN_Genome::get_predictions(const vector<double> &param
 }
 
 
-void RNN_Genome::write_predictions(string output_directory, const vector<string> &input_filenames, const vector<double> &parameters, const vector< vector< vector<double> > > &inputs, const vector< vector< vector<double> > > &outputs, TimeSeriesSets *time_series_sets) {
+void RNN_Genome::write_predictions(string output_directory, const vector<string> &input_filenames, const vector<double> &parameters, const vector<SeriesTensor> &inputs, const vector<SeriesTensor> &outputs, TimeSeriesSets *time_series_sets, bool binary) {
     RNN *rnn = get_rnn();
     rnn->set_weights(parameters);
 
@@ -1238,7 +1471,7 @@ void RNN_Genome::write_predictions(string output_directory, const vector<string>
         Log::info("input filename[%5d]: '%s'\n", i, filename.c_str());
 
         int32_t last_dot_pos = filename.find_last_of(".");
-        string extension = filename.substr(last_dot_pos);
+        string extension = binary ? ".bin" : filename.substr(last_dot_pos);
         string prefix = filename.substr(0, last_dot_pos);
 
 
@@ -1247,7 +1480,7 @@ void RNN_Genome::write_predictions(string output_directory, const vector<string>
 
         Log::info("output filename: '%s'\n", output_filename.c_str());
 
-        rnn->write_predictions(output_filename, input_parameter_names, output_parameter_names, inputs[i], outputs[i], time_series_sets, use_dropout, dropout_probability);
+        rnn->write_predictions(output_filename, input_parameter_names, output_parameter_names, inputs[i], outputs[i], time_series_sets, use_dropout, dropout_probability, binary);
     }
 
     delete rnn;
@@ -1313,6 +1546,7 @@ bool RNN_Genome::equals(RNN_Genome* other) {
 
 void RNN_Genome::assign_reachability() {
     Log::trace("assigning reachability!\n");
+    signature_valid = false;
     Log::trace("%6d nodes, %6d edges, %6d recurrent edges\n", nodes.size(), edges.size(), recurrent_edges.size());
 
     for (int32_t i = 0; i < (int32_t)nodes.size(); i++) {
@@ -1662,24 +1896,24 @@ bool RNN_Genome::attempt_edge_insert(RNN_Node_Interface *n1, RNN_Node_Interface
         Log::debug("setting new edge weight with %s method \n", WEIGHT_TYPES_STRING[mutated_component_weight].c_str());
         if (weight_initialize == WeightType::XAVIER) {
             Log::debug("setting new edge weight to Xavier \n");
-            e->weight = get_xavier_weight(n2);
+            e->set_weight(get_xavier_weight(n2));
         } else if (weight_initialize == WeightType::KAIMING) {
             Log::debug("setting new edge weight to Kaiming \n");
-            e->weight = get_kaiming_weight(n2);
+            e->set_weight(get_kaiming_weight(n2));
         } else if (weight_initialize == WeightType::RANDOM) {
             Log::debug("setting new edge weight to Random \n");
-            e->weight = get_random_weight();
+            e->set_weight(get_random_weight());
         } else {
             Log::fatal("weight initialization method %d is not set correctly \n", weight_initialize);
         }
     } else if (mutated_component_weight == WeightType::LAMARCKIAN){
         Log::debug("setting new edge weight with Lamarckian method \n");
-        e->weight = bound(normal_distribution.random(generator, mu, sigma));
+        e->set_weight(bound(normal_distribution.random(generator, mu, sigma)));
     } else {
         Log::fatal("new component weight method is not set correctly, weight initialize: %s, new component weight: %s\n", WEIGHT_TYPES_STRING[weight_initialize].c_str(), WEIGHT_TYPES_STRING[mutated_component_weight].c_str());
     }
 
-    Log::trace("\tadding edge between nodes %d and %d, new edge weight: %lf\n", e->input_innovation_number, e->output_innovation_number, e->weight);
+    Log::trace("\tadding edge between nodes %d and %d, new edge weight: %lf\n", e->input_innovation_number, e->output_innovation_number, e->get_weight());
     edges.insert( upper_bound(edges.begin(), edges.end(), e, sort_RNN_Edges_by_depth()), e);
 
     return true;
@@ -1718,24 +1952,24 @@ bool RNN_Genome::attempt_recurrent_edge_insert(RNN_Node_Interface *n1, RNN_Node_
         Log::debug("setting new recurrent edge weight with %s method \n", WEIGHT_TYPES_STRING[mutated_component_weight].c_str());
         if (weight_initialize == WeightType::XAVIER) {
             Log::debug("setting new recurrent edge weight to Xavier \n");
-            e->weight = get_xavier_weight(n2);
+            e->set_weight(get_xavier_weight(n2));
         } else if (weight_initialize == WeightType::KAIMING) {
             Log::debug("setting new recurrent edge weight to Kaiming \n");
-            e->weight = get_kaiming_weight(n2);
+            e->set_weight(get_kaiming_weight(n2));
         } else if (weight_initialize == WeightType::RANDOM) {
             Log::debug("setting new recurrent edge weight to Random \n");
-            e->weight = get_random_weight();
+            e->set_weight(get_random_weight());
         } else {
             Log::fatal("Weight initialization method %d is not set correctly \n", weight_initialize);
         }
     } else if (mutated_component_weight == WeightType::LAMARCKIAN){
         Log::debug("setting new recurrent edge weight with Lamarckian method \n");
-        e->weight = bound(normal_distribution.random(generator, mu, sigma));
+        e->set_weight(bound(normal_distribution.random(generator, mu, sigma)));
     } else {
         Log::fatal("new component weight method is not set correctly, weight initialize: %s, new component weight: %s\n", WEIGHT_TYPES_STRING[weight_initialize].c_str(), WEIGHT_TYPES_STRING[mutated_component_weight].c_str());
     }
 
-    Log::trace("\tadding recurrent edge with innovation number %d between nodes %d and %d, new edge weight: %d\n", e->innovation_number, e->input_innovation_number, e->output_innovation_number, e->weight);
+    Log::trace("\tadding recurrent edge with innovation number %d between nodes %d and %d, new edge weight: %d\n", e->innovation_number, e->input_innovation_number, e->output_innovation_number, e->get_weight());
 
     recurrent_edges.insert( upper_bound(recurrent_edges.begin(), recurrent_edges.end(), e, sort_RNN_Recurrent_Edges_by_depth()), e);
     return true;
@@ -2211,12 +2445,12 @@ bool RNN_Genome::connect_node_to_hid_nodes( double mu, double sig, RNN_Node_Inte
                 // innovation_list.push_back(edge_innovation_count);
             }
 
-            e->weight = bound(normal_distribution.random(generator, mu, sigma));
-            Log::debug("\tadding recurrent edge between nodes %d and %d, new edge weight: %d\n", e->input_innovation_number, e->output_innovation_number, e->weight);
+            e->set_weight(bound(normal_distribution.random(generator, mu, sigma)));
+            Log::debug("\tadding recurrent edge between nodes %d and %d, new edge weight: %d\n", e->input_innovation_number, e->output_innovation_number, e->get_weight());
             recurrent_edges.insert( upper_bound(recurrent_edges.begin(), recurrent_edges.end(), e, sort_RNN_Recurrent_Edges_by_depth()), e);
 
-            initial_parameters.push_back(e->weight);
-            best_parameters.push_back(e->weight);
+            initial_parameters.push_back(e->get_weight());
+            best_parameters.push_back(e->get_weight());
 
             // attempt_recurrent_edge_insert(new_node, node, mu, sigma, dist, edge_innovation_count);
         }
@@ -2230,12 +2464,12 @@ bool RNN_Genome::connect_node_to_hid_nodes( double mu, double sig, RNN_Node_Inte
                 e = new RNN_Edge(++edge_innovation_count, node, new_node);
                 // innovation_list.push_back(edge_innovation_count);
             }
-            e->weight = bound(normal_distribution.random(generator, mu, sigma));
-            Log::trace("\tadding edge between nodes %d and %d, new edge weight: %lf\n", e->input_innovation_number, e->output_innovation_number, e->weight);
+            e->set_weight(bound(normal_distribution.random(generator, mu, sigma)));
+            Log::trace("\tadding edge between nodes %d and %d, new edge weight: %lf\n", e->input_innovation_number, e->output_innovation_number, e->get_weight());
             edges.insert( upper_bound(edges.begin(), edges.end(), e, sort_RNN_Edges_by_depth()), e);
 
-            initial_parameters.push_back(e->weight);
-            best_parameters.push_back(e->weight);
+            initial_parameters.push_back(e->get_weight());
+            best_parameters.push_back(e->get_weight());
 
             // attempt_edge_insert(node, new_node, mu, sig, edge_innovation_count);
         }
@@ -2701,19 +2935,19 @@ string RNN_Genome::get_color(double weight, bool is_recurrent) {
 
     if (!is_recurrent) {
         for (int32_t i = 0; i < (int32_t)edges.size(); i++) {
-            if (edges[i]->weight > max) {
-                max = edges[i]->weight;
-            } else if (edges[i]->weight < min) {
-                min = edges[i]->weight;
+            if (edges[i]->get_weight() > max) {
+                max = edges[i]->get_weight();
+            } else if (edges[i]->get_weight() < min) {
+                min = edges[i]->get_weight();
             }
         }
 
     } else {
         for (int32_t i = 0; i < (int32_t)recurrent_edges.size(); i++) {
-            if (recurrent_edges[i]->weight > max) {
-                max = recurrent_edges[i]->weight;
-            } else if (recurrent_edges[i]->weight < min) {
-                min = recurrent_edges[i]->weight;
+            if (recurrent_edges[i]->get_weight() > max) {
+                max = recurrent_edges[i]->get_weight();
+            } else if (recurrent_edges[i]->get_weight() < min) {
+                min = recurrent_edges[i]->get_weight();
             }
         }
     }
@@ -2843,7 +3077,7 @@ void RNN_Genome::write_graphviz(string filename) {
     for (int32_t i = 0; i < (int32_t)edges.size(); i++) {
         if (!edges[i]->is_reachable()) continue;
 
-        outfile << "\tnode" << edges[i]->get_input_node()->get_innovation_number() << " -> node" << edges[i]->get_output_node()->get_innovation_number() << " [color=\"#" << get_color(edges[i]->weight, false) << "\"]; /* weight: " << edges[i]->weight << " */" << endl;
+        outfile << "\tnode" << edges[i]->get_input_node()->get_innovation_number() << " -> node" << edges[i]->get_output_node()->get_innovation_number() << " [color=\"#" << get_color(edges[i]->get_weight(), false) << "\"]; /* weight: " << edges[i]->get_weight() << " */" << endl;
     }
     outfile << endl;
 
@@ -2851,7 +3085,7 @@ void RNN_Genome::write_graphviz(string filename) {
     for (int32_t i = 0; i < (int32_t)recurrent_edges.size(); i++) {
         if (!recurrent_edges[i]->is_reachable()) continue;
 
-        outfile << "\tnode" << recurrent_edges[i]->get_input_node()->get_innovation_number() << " -> node" << recurrent_edges[i]->get_output_node()->get_innovation_number() << " [color=\"#" << get_color(recurrent_edges[i]->weight, true) << "\",style=dotted]; /* weight: " << recurrent_edges[i]->weight << ", recurrent_depth: " << recurrent_edges[i]->recurrent_depth << " */" << endl;
+        outfile << "\tnode" << recurrent_edges[i]->get_input_node()->get_innovation_number() << " -> node" << recurrent_edges[i]->get_output_node()->get_innovation_number() << " [color=\"#" << get_color(recurrent_edges[i]->get_weight(), true) << "\",style=dotted]; /* weight: " << recurrent_edges[i]->get_weight() << ", recurrent_depth: " << recurrent_edges[i]->recurrent_depth << " */" << endl;
     }
     outfile << endl;
 
@@ -2964,7 +3198,37 @@ void RNN_Genome::read_from_array(char *array, int32_t length) {
     read_from_stream(iss);
 }
 
+static void write_optimizer_state(ostream &bin_ostream, const map<int32_t, vector<double>> &state) {
+    int32_t n_entries = (int32_t)state.size();
+    bin_ostream.write((char*)&n_entries, sizeof(int32_t));
+
+    for (auto it = state.begin(); it != state.end(); it++) {
+        int32_t innovation_number = it->first;
+        int32_t n_values = (int32_t)it->second.size();
+        bin_ostream.write((char*)&innovation_number, sizeof(int32_t));
+        bin_ostream.write((char*)&n_values, sizeof(int32_t));
+        bin_ostream.write((char*)&it->second[0], sizeof(double) * n_values);
+    }
+}
+
+static void read_optimizer_state(istream &bin_istream, map<int32_t, vector<double>> &state) {
+    int32_t n_entries;
+    bin_istream.read((char*)&n_entries, sizeof(int32_t));
+
+    for (int32_t i = 0; i < n_entries; i++) {
+        int32_t innovation_number;
+        int32_t n_values;
+        bin_istream.read((char*)&innovation_number, sizeof(int32_t));
+        bin_istream.read((char*)&n_values, sizeof(int32_t));
+
+        vector<double> &values = state[innovation_number];
+        values.resize(n_values);
+        bin_istream.read((char*)&values[0], sizeof(double) * n_values);
+    }
+}
+
 void RNN_Genome::read_from_stream(istream &bin_istream) {
+    ScopedTimer timer(PerformanceLog::DESERIALIZATION);
     Log::debug("READING GENOME FROM STREAM\n");
 
     bin_istream.read((char*)&generation_id, sizeof(int32_t));
@@ -3002,6 +3266,7 @@ void RNN_Genome::read_from_stream(istream &bin_istream) {
     read_binary_string(bin_istream, generator_str, "generator");
     istringstream generator_iss(generator_str);
     generator_iss >> generator;
+    random_stream_id = -1;
 
     string rng_0_1_str;
     read_binary_string(bin_istream, rng_0_1_str, "rng_0_1");
@@ -3190,6 +3455,23 @@ void RNN_Genome::read_from_stream(istream &bin_istream) {
     istringstream normalize_std_devs_iss(normalize_std_devs_str);
     read_map(normalize_std_devs_iss, normalize_std_devs);
 
+    //genomes written before optimizer state was added end here
+    clear_optimizer_state();
+    if (bin_istream.peek() != EOF) {
+        bool inherit_optimizer_state = false;
+        bin_istream.read((char*)&inherit_optimizer_state, sizeof(bool));
+        weight_rules->set_inherit_optimizer_state(inherit_optimizer_state);
+        if (inherit_optimizer_state) {
+            read_optimizer_state(bin_istream, node_optimizer_state);
+            read_optimizer_state(bin_istream, edge_optimizer_state);
+            read_optimizer_state(bin_istream, recurrent_edge_optimizer_state);
+        }
+    }
+
+    //genomes written before fidelity was added end here
+    fidelity = FULL_FIDELITY;
+    if (bin_istream.peek() != EOF) bin_istream.read((char*)&fidelity, sizeof(int32_t));
+
     assign_reachability();
 }
 
@@ -3213,6 +3495,7 @@ void RNN_Genome::write_to_file(string bin_filename) {
 
 
 void RNN_Genome::write_to_stream(ostream &bin_ostream) {
+    ScopedTimer timer(PerformanceLog::SERIALIZATION);
     Log::debug("WRITING GENOME TO STREAM\n");
     bin_ostream.write((char*)&generation_id, sizeof(int32_t));
     bin_ostream.write((char*)&group_id, sizeof(int32_t));
@@ -3332,6 +3615,16 @@ void RNN_Genome::write_to_stream(ostream &bin_ostream) {
     write_map(normalize_std_devs_oss, normalize_std_devs);
     string normalize_std_devs_str = normalize_std_devs_oss.str();
     write_binary_string(bin_ostream, normalize_std_devs_str, "normalize_std_devs");
+
+    bool inherit_optimizer_state = weight_rules->get_inherit_optimizer_state();
+    bin_ostream.write((char*)&inherit_optimizer_state, sizeof(bool));
+    if (inherit_optimizer_state) {
+        write_optimizer_state(bin_ostream, node_optimizer_state);
+        write_optimizer_state(bin_ostream, edge_optimizer_state);
+        write_optimizer_state(bin_ostream, recurrent_edge_optimizer_state);
+    }
+
+    bin_ostream.write((char*)&fidelity, sizeof(int32_t));
 }
 
 void RNN_Genome::update_innovation_counts(int32_t &node_innovation_count, int32_t &edge_innovation_count) {
@@ -3367,15 +3660,22 @@ void RNN_Genome::update_innovation_counts(int32_t &node_innovation_count, int32_
 }
 // return sorted innovation list
 vector<int32_t> RNN_Genome::get_innovation_list() {
-    vector<int32_t> innovations;
+    vector<int32_t> innovations(edges.size());
     for (int32_t i = 0; i < (int32_t)edges.size(); i++){
-        int32_t innovation = edges[i]->get_innovation_number();
-        auto it = std::upper_bound(innovations.begin(), innovations.end(), innovation);
-        innovations.insert(it, innovation);
+        innovations[i] = edges[i]->get_innovation_number();
     }
+    sort(innovations.begin(), innovations.end());
     return innovations;
 }
 
+const GenomeSignature& RNN_Genome::get_signature(int32_t minhash_size) {
+    if (!signature_valid || signature.get_minhash_size() != minhash_size) {
+        signature = GenomeSignature(get_innovation_list(), get_avg_edge_weight(), minhash_size);
+        signature_valid = true;
+    }
+    return signature;
+}
+
 
 string RNN_Genome::get_structural_hash() const {
     return structural_hash;
@@ -19,14 +19,17 @@ using std::mt19937;
 #include <vector>
 using std::vector;
 
+#include "genome_signature.hxx"
 #include "rnn.hxx"
 #include "rnn_node_interface.hxx"
 #include "rnn_edge.hxx"
 #include "rnn_recurrent_edge.hxx"
 
 #include "common/random.hxx"
+#include "weights/shared_weight_store.hxx"
 #include "weights/weight_rules.hxx"
 #include "weights/weight_update.hxx"
+#include "time_series/sequence_windows.hxx"
 #include "time_series/time_series.hxx"
 // #include "word_series/word_series.hxx"
 
@@ -36,12 +39,22 @@ using std::vector;
 string parse_fitness(double fitness);
 
 class RNN_Genome {
+    public:
+        const static int32_t FULL_FIDELITY = 0;
+        const static int32_t LOW_FIDELITY = 1;
+
     private:
         int32_t generation_id;
         int32_t group_id;
 
         int32_t bp_iterations;
 
+        /**
+         * FULL_FIDELITY genomes are trained on all the training data, LOW_FIDELITY genomes
+         * only on a subset of it (see EXAMM::set_low_fidelity).
+         */
+        int32_t fidelity;
+
         //SHO SY
         double learning_rate;
         double initial_learning_rate;
@@ -67,7 +80,27 @@ class RNN_Genome {
         double best_validation_mae;
         vector<double> best_parameters;
 
+        /**
+         * Optimizer state (the velocity and prev_velocity used by WeightUpdate) left over
+         * from training this genome or its ancestors, keyed by the innovation number of the
+         * node, edge or recurrent edge the weights belong to. Each entry holds the velocities
+         * for all of that component's weights followed by their prev_velocities. Only used
+         * if the WeightRules have inherit_optimizer_state set.
+         */
+        map<int32_t, vector<double>> node_optimizer_state;
+        map<int32_t, vector<double>> edge_optimizer_state;
+        map<int32_t, vector<double>> recurrent_edge_optimizer_state;
+
+        /**
+         * Cached NEAT signature, cleared whenever the weights or structure may have
+         * changed (set_weights and assign_reachability).
+         */
+        GenomeSignature signature;
+        bool signature_valid;
+
         minstd_rand0 generator;
+        //the generation id of the stream the generator was last seeded from, or -1
+        int32_t random_stream_id;
 
         uniform_real_distribution<double> rng;
         uniform_real_distribution<double> rng_0_1;
@@ -152,8 +185,13 @@ class RNN_Genome {
         void set_bp_iterations(int32_t _bp_iterations);
         int32_t get_bp_iterations();
 
+        int32_t get_fidelity() const;
+        void set_fidelity(int32_t _fidelity);
+
         void disable_dropout();
         void enable_dropout(double _dropout_probability);
+        bool get_use_dropout() const;
+        double get_dropout_probability() const;
         void set_log_filename(string _log_filename);
 
         void get_weights(vector<double> &parameters);
@@ -165,6 +203,42 @@ class RNN_Genome {
 
         double get_avg_edge_weight();
         void initialize_randomly();
+
+        bool has_optimizer_state() const;
+
+        /**
+         * Fills in velocity and prev_velocity (in the same order as get_weights) from the
+         * stored optimizer state. Weights without any stored state (e.g., those of newly
+         * added components) start at 0.
+         */
+        void get_optimizer_state(vector<double> &velocity, vector<double> &prev_velocity);
+
+        /**
+         * Replaces the stored optimizer state with velocity and prev_velocity (in the same
+         * order as get_weights).
+         */
+        void set_optimizer_state(const vector<double> &velocity, const vector<double> &prev_velocity);
+        void clear_optimizer_state();
+
+        /**
+         * Used by crossover, takes the optimizer state for each component from the more fit
+         * parent if it has it, otherwise from the less fit parent.
+         */
+        void inherit_optimizer_state(const RNN_Genome *more_fit_parent, const RNN_Genome *less_fit_parent);
+
+        /**
+         * Publishes the best parameters of each of this genome's nodes, edges and recurrent
+         * edges to the store.
+         */
+        void publish_shared_weights(SharedWeightStore *store);
+
+        /**
+         * Replaces the initial parameters of each component the store has weights for with
+         * those weights, the others keep their inherited or initialized weights.
+         *
+         * \return the number of components whose weights came from the store
+         */
+        int32_t initialize_from_shared_weights(const SharedWeightStore *store);
         void initialize_xavier(RNN_Node_Interface* n);
         void initialize_kaiming(RNN_Node_Interface* n);
         void initialize_node_randomly(RNN_Node_Interface* n);
@@ -180,6 +254,15 @@ class RNN_Genome {
         int32_t get_generation_id() const;
         void set_generation_id(int32_t generation_id);
 
+        /**
+         * Seeds the random number generator used to initialize and mutate this genome's
+         * weights from the RANDOM_PURPOSE_GENOME stream of the given generation id, so they
+         * only depend on the run seed and the id of the genome being generated, not on how
+         * many genomes were created before it. Does nothing if the generator was already
+         * seeded from that stream.
+         */
+        void set_random_stream(int32_t generation_id);
+
         void clear_generated_by();
         void update_generation_map(map<string, int32_t> &generation_map);
         void set_generated_by(string type);
@@ -192,19 +275,35 @@ class RNN_Genome {
         void set_best_parameters( vector<double> parameters);    //INFO: ADDED BY ABDELRAHMAN TO USE FOR TRANSFER LEARNING
         void set_initial_parameters( vector<double> parameters);  //INFO: ADDED BY ABDELRAHMAN TO USE FOR TRANSFER LEARNING
 
-        void get_analytic_gradient(vector<RNN*> &rnns, const vector<double> &parameters, const vector< vector< vector<double> > > &inputs, const vector< vector< vector<double> > > &outputs, double &mse, vector<double> &analytic_gradient, bool training);
+        void get_analytic_gradient(vector<RNN*> &rnns, const vector<double> &parameters, const vector<SeriesTensor> &inputs, const vector<SeriesTensor> &outputs, double &mse, vector<double> &analytic_gradient, bool training);
 
-        void backpropagate(const vector< vector< vector<double> > > &inputs, const vector< vector< vector<double> > > &outputs, const vector< vector< vector<double> > > &validation_inputs, const vector< vector< vector<double> > > &validation_outputs, WeightUpdate *weight_update_method);
+        void backpropagate(const vector<SeriesTensor> &inputs, const vector<SeriesTensor> &outputs, const vector<SeriesTensor> &validation_inputs, const vector<SeriesTensor> &validation_outputs, WeightUpdate *weight_update_method);
 
-        void backpropagate_stochastic(const vector< vector< vector<double> > > &inputs, const vector< vector< vector<double> > > &outputs, const vector< vector< vector<double> > > &validation_inputs, const vector< vector< vector<double> > > &validation_outputs, WeightUpdate *weight_update_method);        
+        /**
+         * \param sequence_windows if not NULL, each epoch trains on a new random set of
+         *      windows over the training series instead of the whole series
+         */
+        void backpropagate_stochastic(const vector<SeriesTensor> &inputs, const vector<SeriesTensor> &outputs, const vector<SeriesTensor> &validation_inputs, const vector<SeriesTensor> &validation_outputs, WeightUpdate *weight_update_method, const SequenceWindows *sequence_windows = NULL);
         
-        double get_softmax(const vector<double> &parameters, const vector< vector< vector<double> > > &inputs, const vector< vector< vector<double> > > &outputs);
-        double get_mse(const vector<double> &parameters, const vector< vector< vector<double> > > &inputs, const vector< vector< vector<double> > > &outputs);
-        double get_mae(const vector<double> &parameters, const vector< vector< vector<double> > > &inputs, const vector< vector< vector<double> > > &outputs);
+        double get_softmax(const vector<double> &parameters, const vector<SeriesTensor> &inputs, const vector<SeriesTensor> &outputs);
+        double get_mse(const vector<double> &parameters, const vector<SeriesTensor> &inputs, const vector<SeriesTensor> &outputs);
+        double get_mae(const vector<double> &parameters, const vector<SeriesTensor> &inputs, const vector<SeriesTensor> &outputs);
 
+        /**
+         * The same as the above, but using an RNN of this genome which already has the
+         * weights to evaluate, so a new RNN does not have to be created for every call.
+         */
+        double get_mse(RNN *rnn, const vector<SeriesTensor> &inputs, const vector<SeriesTensor> &outputs);
+        double get_mae(RNN *rnn, const vector<SeriesTensor> &inputs, const vector<SeriesTensor> &outputs);
 
-        vector< vector<double> > get_predictions(const vector<double> &parameters, const vector< vector< vector<double> > > &inputs, const vector< vector< vector<double> > > &outputs);
-        void write_predictions(string output_directory, const vector<string> &input_filenames, const vector<double> &parameters, const vector< vector< vector<double> > > &inputs, const vector< vector< vector<double> > > &outputs, TimeSeriesSets *time_series_sets);
+
+        vector< vector<double> > get_predictions(const vector<double> &parameters, const vector<SeriesTensor> &inputs, const vector<SeriesTensor> &outputs);
+        /**
+         * Writes the inputs, expected outputs and predictions for each series (denormalized)
+         * to <input filename>_predictions.csv in the output directory, or to a binary
+         * <input filename>_predictions.bin (see PredictionWriter) if binary is true.
+         */
+        void write_predictions(string output_directory, const vector<string> &input_filenames, const vector<double> &parameters, const vector<SeriesTensor> &inputs, const vector<SeriesTensor> &outputs, TimeSeriesSets *time_series_sets, bool binary);
         // void write_predictions(string output_directory, const vector<string> &input_filenames, const vector<double> &parameters, const vector< vector< vector<double> > > &inputs, const vector< vector< vector<double> > > &outputs, Corpus * word_series_sets);
 
         void get_mu_sigma(const vector<double> &p, double &mu, double &sigma);
@@ -269,6 +368,15 @@ class RNN_Genome {
         void update_innovation_counts(int32_t &node_innovation_count, int32_t &edge_innovation_count);
 
         vector<int32_t> get_innovation_list();
+
+        /**
+         * \param minhash_size is the size of the MinHash sketch to include (0 for none)
+         *
+         * \return this genome's NEAT signature, which is only recalculated if the genome
+         * has been modified since it was last requested. Not safe to call concurrently on
+         * the same genome.
+         */
+        const GenomeSignature& get_signature(int32_t minhash_size);
         /**
          * \return the structural hash (calculated when assign_reachaability is called)
          */
@@ -294,6 +402,7 @@ class RNN_Genome {
         friend class NeatSpeciationStrategy;
         friend class RecDepthFrequencyTable;
         friend class GenomeProperty;
+        friend class GenomeFitnessModel;
 };
 
 struct sort_genomes_by_fitness {
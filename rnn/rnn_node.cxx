@@ -7,8 +7,12 @@ using std::vector;
 
 #include "common/log.hxx"
 
+//a basic RNN node has no weights, only a bias
+#define NUMBER_RNN_NODE_WEIGHTS 1
+#define RNN_NODE_BIAS 0
 
-RNN_Node::RNN_Node(int32_t _innovation_number, int32_t _layer_type, double _depth, int32_t _node_type) : RNN_Node_Interface(_innovation_number, _layer_type, _depth), bias(0) {
+RNN_Node::RNN_Node(int32_t _innovation_number, int32_t _layer_type, double _depth, int32_t _node_type) : RNN_Node_Interface(_innovation_number, _layer_type, _depth) {
+    initialize_weight_storage(NUMBER_RNN_NODE_WEIGHTS);
 
     //node type will be simple, jordan or elman
     node_type = _node_type;
@@ -16,7 +20,8 @@ RNN_Node::RNN_Node(int32_t _innovation_number, int32_t _layer_type, double _dept
 }
 
 
-RNN_Node::RNN_Node(int32_t _innovation_number, int32_t _layer_type, double _depth, int32_t _node_type, string _parameter_name) : RNN_Node_Interface(_innovation_number, _layer_type, _depth, _parameter_name), bias(0) {
+RNN_Node::RNN_Node(int32_t _innovation_number, int32_t _layer_type, double _depth, int32_t _node_type, string _parameter_name) : RNN_Node_Interface(_innovation_number, _layer_type, _depth, _parameter_name) {
+    initialize_weight_storage(NUMBER_RNN_NODE_WEIGHTS);
 
     //node type will be simple, jordan or elman
     node_type = _node_type;
@@ -28,21 +33,21 @@ RNN_Node::~RNN_Node() {
 }
 
 void RNN_Node::initialize_lamarckian(minstd_rand0 &generator, NormalDistribution &normal_distribution, double mu, double sigma) {
-    bias = bound(normal_distribution.random(generator, mu, sigma));
+    weights[RNN_NODE_BIAS] = bound(normal_distribution.random(generator, mu, sigma));
 }
 
 void RNN_Node::initialize_xavier(minstd_rand0 &generator, uniform_real_distribution<double> &rng_1_1, double range) {
 
-    bias = range * (rng_1_1(generator));
+    weights[RNN_NODE_BIAS] = range * (rng_1_1(generator));
 }
 
 void RNN_Node::initialize_kaiming(minstd_rand0 &generator, NormalDistribution &normal_distribution, double range) {
 
-    bias = range * normal_distribution.random(generator, 0, 1);
+    weights[RNN_NODE_BIAS] = range * normal_distribution.random(generator, 0, 1);
 }
 
 void RNN_Node::initialize_uniform_random(minstd_rand0 &generator, uniform_real_distribution<double> &rng) {
-    bias = rng(generator);
+    weights[RNN_NODE_BIAS] = rng(generator);
 }
 
 void RNN_Node::input_fired(int32_t time, double incoming_output) {
@@ -58,7 +63,7 @@ void RNN_Node::input_fired(int32_t time, double incoming_output) {
 
     //Log::trace("node %d - input value[%d]: %lf\n", innovation_number, time, input_values[time]);
 
-    output_values[time] = tanh(input_values[time] + bias);
+    output_values[time] = tanh(input_values[time] + weights[RNN_NODE_BIAS]);
     ld_output[time] = tanh_derivative(output_values[time]);
 
     //output_values[time] = sigmoid(input_values[time] + bias);
@@ -68,7 +73,7 @@ void RNN_Node::input_fired(int32_t time, double incoming_output) {
     if (isnan(output_values[time]) || isinf(output_values[time])) {
         Log::fatal("ERROR: output_value[%d] becaome %lf on RNN node: %d\n", time, output_values[time], innovation_number);
         Log::fatal("\tinput_value[%dd]: %lf\n", time, input_values[time]);
-        Log::Fatal("\tnode bias: %lf", bias);
+        Log::Fatal("\tnode bias: %lf", weights[RNN_NODE_BIAS]);
         exit(1);
     }
 #endif
@@ -83,7 +88,7 @@ void RNN_Node::try_update_deltas(int32_t time) {
 
     d_input[time] *= ld_output[time];
 
-    d_bias += d_input[time];
+    d_weights[RNN_NODE_BIAS] += d_input[time];
 }
 
 void RNN_Node::error_fired(int32_t time, double error) {
@@ -116,38 +121,11 @@ void RNN_Node::reset(int32_t _series_length) {
     inputs_fired.assign(series_length, 0);
     outputs_fired.assign(series_length, 0);
 
-    d_bias = 0.0;
-}
-
-void RNN_Node::get_gradients(vector<double> &gradients) {
-    gradients.assign(1, d_bias);
+    d_weights[RNN_NODE_BIAS] = 0.0;
 }
 
 int32_t RNN_Node::get_number_weights() const {
-    return 1;
-}
-
-void RNN_Node::get_weights(vector<double> &parameters) const {
-    parameters.resize(get_number_weights());
-    //no weights to set in a basic RNN node, only a bias
-    int32_t offset = 0;
-    get_weights(offset, parameters);
-}
-
-void RNN_Node::set_weights(const vector<double> &parameters) {
-    //no weights to set in a basic RNN node, only a bias
-    int32_t offset = 0;
-    set_weights(offset, parameters);
-}
-
-void RNN_Node::get_weights(int32_t &offset, vector<double> &parameters) const {
-    //no weights to set in a basic RNN node, only a bias
-    parameters[offset++] = bias;
-}
-
-void RNN_Node::set_weights(int32_t &offset, const vector<double> &parameters) {
-    //no weights to set in a basic RNN node, only a bias
-    bias = bound(parameters[offset++]);
+    return NUMBER_RNN_NODE_WEIGHTS;
 }
 
 RNN_Node_Interface* RNN_Node::copy() const {
@@ -159,8 +137,7 @@ RNN_Node_Interface* RNN_Node::copy() const {
     }
 
     //copy RNN_Node values
-    n->bias = bias;
-    n->d_bias = d_bias;
+    copy_weights_to(n);
     n->ld_output = ld_output;
 
     //copy RNN_Node_Interface values
@@ -8,9 +8,6 @@ using std::vector;
 
 class RNN_Node : public RNN_Node_Interface {
     private:
-        double bias;
-        double d_bias;
-
         vector<double> ld_output;
 
     public:
@@ -34,15 +31,9 @@ class RNN_Node : public RNN_Node_Interface {
         void error_fired(int32_t time, double error);
 
         int32_t get_number_weights() const ;
-        void get_weights(vector<double> &parameters) const;
-        void set_weights(const vector<double> &parameters);
-        void get_weights(int32_t &offset, vector<double> &parameters) const;
-        void set_weights(int32_t &offset, const vector<double> &parameters);
 
         void reset(int32_t _series_length);
 
-        void get_gradients(vector<double> &gradients);
-
         RNN_Node_Interface* copy() const;
 
         void write_to_stream(ostream &out);
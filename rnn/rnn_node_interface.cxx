@@ -77,6 +77,9 @@ RNN_Node_Interface::RNN_Node_Interface(int32_t _innovation_number, int32_t _laye
     forward_reachable = false;
     backward_reachable = false;
 
+    weights = NULL;
+    d_weights = NULL;
+
     //outputs don't have an official output node but
     //deltas are passed in via the output_fired method
     if (layer_type != HIDDEN_LAYER) {
@@ -91,6 +94,9 @@ RNN_Node_Interface::RNN_Node_Interface(int32_t _innovation_number, int32_t _laye
     enabled = true;
     forward_reachable = false;
     backward_reachable = false;
+
+    weights = NULL;
+    d_weights = NULL;
     
     if (layer_type == HIDDEN_LAYER) {
         Log::fatal("ERROR: assigned a parameter name '%s' to a hidden node! This should never happen.", parameter_name.c_str());
@@ -152,6 +158,68 @@ bool RNN_Node_Interface::equals(RNN_Node_Interface *other) const {
     return false;
 }
 
+void RNN_Node_Interface::carry_state(int32_t from_time, int32_t to_time) {
+    output_values[to_time] = output_values[from_time];
+
+    //some nodes sum their output into output_values, so it needs to be cleared as well
+    input_values[from_time] = 0.0;
+    output_values[from_time] = 0.0;
+    inputs_fired[from_time] = 0;
+}
+
+void RNN_Node_Interface::initialize_weight_storage(int32_t number_weights) {
+    weight_storage.assign(2 * number_weights, 0.0);
+    weights = weight_storage.data();
+    d_weights = weights + number_weights;
+}
+
+void RNN_Node_Interface::copy_weights_to(RNN_Node_Interface *other) const {
+    int32_t number_weights = get_number_weights();
+    for (int32_t i = 0; i < number_weights; i++) {
+        other->weights[i] = weights[i];
+        other->d_weights[i] = d_weights[i];
+    }
+}
+
+void RNN_Node_Interface::set_weight_buffers(double *_weights, double *_d_weights) {
+    int32_t number_weights = get_number_weights();
+    for (int32_t i = 0; i < number_weights; i++) {
+        _weights[i] = weights[i];
+        _d_weights[i] = d_weights[i];
+    }
+    weights = _weights;
+    d_weights = _d_weights;
+
+    //the weights are not kept here any more
+    weight_storage.clear();
+    weight_storage.shrink_to_fit();
+}
+
+void RNN_Node_Interface::get_weights(vector<double> &parameters) const {
+    parameters.resize(get_number_weights());
+    int32_t offset = 0;
+    get_weights(offset, parameters);
+}
+
+void RNN_Node_Interface::set_weights(const vector<double> &parameters) {
+    int32_t offset = 0;
+    set_weights(offset, parameters);
+}
+
+void RNN_Node_Interface::get_weights(int32_t &offset, vector<double> &parameters) const {
+    int32_t number_weights = get_number_weights();
+    for (int32_t i = 0; i < number_weights; i++) {
+        parameters[offset++] = weights[i];
+    }
+}
+
+void RNN_Node_Interface::set_weights(int32_t &offset, const vector<double> &parameters) {
+    int32_t number_weights = get_number_weights();
+    for (int32_t i = 0; i < number_weights; i++) {
+        weights[i] = bound(parameters[offset++]);
+    }
+}
+
 void RNN_Node_Interface::write_to_stream(ostream &out) {
     out.write((char*)&innovation_number, sizeof(int32_t));
     out.write((char*)&layer_type, sizeof(int32_t));
@@ -17,6 +17,7 @@ using std::string;
 using std::vector;
 
 #include "common/random.hxx"
+#include "time_series/series_tensor.hxx"
 
 class RNN;
 
@@ -81,6 +82,29 @@ class RNN_Node_Interface {
         vector<int32_t> outputs_fired;
         int32_t total_inputs;
         int32_t total_outputs;
+
+        /**
+         * The node's weights and their gradients, get_number_weights() of each, in the
+         * order get_weights returns them. The backward pass adds to the gradients, and
+         * reset clears them. When the node is part of an RNN these point into the RNN's
+         * parameter and gradient buffers (see set_weight_buffers), so it is trained in
+         * place, otherwise into weight_storage.
+         */
+        double *weights;
+        double *d_weights;
+        vector<double> weight_storage;
+
+        /**
+         * Gives the node storage of its own for number_weights weights and their gradients,
+         * all zero. Called by the constructors of the node types.
+         */
+        void initialize_weight_storage(int32_t number_weights);
+
+        /**
+         * Copies the weights and their gradients to other, which is the same type of node.
+         */
+        void copy_weights_to(RNN_Node_Interface *other) const;
+
     public:
         //this constructor is for hidden nodes
         RNN_Node_Interface(int32_t _innovation_number, int32_t _layer_type, double _depth);
@@ -100,13 +124,33 @@ class RNN_Node_Interface {
 
         virtual int32_t  get_number_weights() const = 0;
 
-        virtual void get_weights(vector<double> &parameters) const = 0;
-        virtual void set_weights(const vector<double> &parameters) = 0;
-        virtual void get_weights(int32_t  &offset, vector<double> &parameters) const = 0;
-        virtual void set_weights(int32_t  &offset, const vector<double> &parameters) = 0;
+        void get_weights(vector<double> &parameters) const;
+        void set_weights(const vector<double> &parameters);
+        void get_weights(int32_t  &offset, vector<double> &parameters) const;
+
+        /**
+         * Sets the weights from parameters starting at offset, which is moved past them.
+         * The weights are bounded to [-10, 10]; in an RNN they are instead kept in bounds by
+         * the weight update.
+         */
+        void set_weights(int32_t  &offset, const vector<double> &parameters);
+
+        /**
+         * Moves the weights and their gradients to the given buffers, which have room for
+         * get_number_weights() of each, keeping their current values. RNN uses this to keep
+         * the weights of all its nodes in its parameter and gradient buffers.
+         */
+        virtual void set_weight_buffers(double *_weights, double *_d_weights);
+
         virtual void reset(int32_t _series_length) = 0;
 
-        virtual void get_gradients(vector<double> &gradients) = 0;
+        /**
+         * Used by RNN_Stream, which runs the nodes over an unbounded series with storage for
+         * two time steps. Copies the state read when calculating the next time step (the
+         * values at time - 1) from from_time to to_time, and clears the values at from_time
+         * so it can be used again.
+         */
+        virtual void carry_state(int32_t from_time, int32_t to_time);
 
         virtual RNN_Node_Interface* copy() const = 0;
 
@@ -128,9 +172,10 @@ class RNN_Node_Interface {
         friend class RNN_Recurrent_Edge;
         friend class RNN;
         friend class RNN_Genome;
+        friend class RNN_Stream;
 
-        friend void get_mse(RNN* genome, const vector< vector<double> > &expected, double &mse, vector< vector<double> > &deltas);
-        friend void get_mae(RNN* genome, const vector< vector<double> > &expected, double &mae, vector< vector<double> > &deltas);
+        friend void get_mse(RNN* genome, const SeriesTensor &expected, double &mse, vector< vector<double> > &deltas);
+        friend void get_mae(RNN* genome, const SeriesTensor &expected, double &mae, vector< vector<double> > &deltas);
 };
 
 
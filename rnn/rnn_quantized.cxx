@@ -0,0 +1,565 @@
+#include <algorithm>
+using std::stable_sort;
+
+#include <cmath>
+using std::ceil;
+using std::fabs;
+using std::ldexp;
+using std::log2;
+using std::llround;
+
+#include <vector>
+using std::vector;
+
+#include "common/log.hxx"
+#include "rnn_edge.hxx"
+#include "rnn_node_interface.hxx"
+#include "rnn_quantized.hxx"
+#include "rnn_recurrent_edge.hxx"
+
+//the operations done in a time step
+#define RECURRENT_INPUT_OPERATION 0
+#define INPUT_OPERATION 1
+#define EDGE_OPERATION 2
+#define NODE_OPERATION 3
+
+//the sigmoid and tanh lookup tables cover [-LUT_RANGE, LUT_RANGE] with 2^LUT_BITS entries per
+//unit, each with LUT_FRACTIONAL_BITS fractional bits; outside of this both have saturated
+//to exactly 0 or +/-1, which matters for gates such as an LSTM's forget gate, where
+//anything short of 1 slowly leaks the recurrent state
+#define LUT_RANGE 16
+#define LUT_BITS 8
+#define LUT_FRACTIONAL_BITS 15
+
+//the fractional bits sums and products are calculated with before being stored
+#define ACCUMULATOR_FRACTIONAL_BITS 24
+
+//the number of weights and separately scaled values each node type uses
+static int32_t get_number_node_weights(int32_t node_type) {
+    switch (node_type) {
+        case SIMPLE_NODE:
+        case JORDAN_NODE:
+        case ELMAN_NODE:
+            return 1;
+        case UGRNN_NODE:
+        case MGU_NODE:
+        case DELTA_NODE:
+            return 6;
+        case GRU_NODE:
+            return 9;
+        case LSTM_NODE:
+            return 11;
+        default:
+            return -1;
+    }
+}
+
+static int32_t get_number_node_slots(int32_t node_type) {
+    switch (node_type) {
+        case SIMPLE_NODE:
+        case JORDAN_NODE:
+        case ELMAN_NODE:
+            return 2;
+        case UGRNN_NODE:
+            return 4;
+        case MGU_NODE:
+            return 5;
+        case GRU_NODE:
+        case DELTA_NODE:
+            return 6;
+        case LSTM_NODE:
+            return 7;
+        default:
+            return -1;
+    }
+}
+
+static vector<int32_t> make_lookup_table(bool tanh_table) {
+    int32_t size = (2 * LUT_RANGE << LUT_BITS) + 1;
+    vector<int32_t> table(size);
+
+    for (int32_t i = 0; i < size; i++) {
+        double x = ldexp(i, -LUT_BITS) - LUT_RANGE;
+        table[i] = (int32_t)llround(ldexp(tanh_table ? tanh(x) : sigmoid(x), LUT_FRACTIONAL_BITS));
+    }
+    return table;
+}
+
+static const vector<int32_t>& get_lookup_table(bool tanh_table) {
+    static const vector<int32_t> sigmoid_values = make_lookup_table(false);
+    static const vector<int32_t> tanh_values = make_lookup_table(true);
+
+    if (tanh_table) return tanh_values;
+    else return sigmoid_values;
+}
+
+/**
+ * Runs the network in double precision, recording the largest magnitude each slot reaches.
+ */
+class CalibrationArithmetic {
+    private:
+        const vector<double> &weights;
+        vector<double> &slot_max;
+
+    public:
+        typedef double Value;
+
+        CalibrationArithmetic(const vector<double> &_weights, vector<double> &_slot_max) : weights(_weights), slot_max(_slot_max) {
+        }
+
+        inline Value zero() { return 0.0; }
+        inline Value one() { return 1.0; }
+        inline Value weight(int32_t index) { return weights[index]; }
+
+        inline Value store(Value a, int32_t slot) {
+            if (fabs(a) > slot_max[slot]) slot_max[slot] = fabs(a);
+            return a;
+        }
+
+        inline Value quantize(double value, int32_t slot) { return store(value, slot); }
+
+        inline Value add(Value a, Value b) { return a + b; }
+        inline Value subtract(Value a, Value b) { return a - b; }
+        inline Value multiply(Value a, Value b) { return a * b; }
+
+        inline Value sigmoid(Value a) { return ::sigmoid(a); }
+        inline Value tanh(Value a) { return std::tanh(a); }
+
+        inline double to_double(Value a) { return a; }
+};
+
+struct FixedPointValue {
+    int64_t value;
+    int32_t fractional_bits;
+};
+
+/**
+ * Runs the network in fixed point. Like integer hardware with a wide accumulator, sums
+ * and products are kept with ACCUMULATOR_FRACTIONAL_BITS fractional bits in 64 bit
+ * integers, and are only rounded and saturated to the number of bits and the scale of
+ * a slot when they are stored.
+ */
+class FixedPointArithmetic {
+    private:
+        int64_t max_value;
+
+        //sigmoid and tanh results keep one integer bit so that 1 can be represented exactly
+        int32_t activation_fractional_bits;
+
+        const vector<int32_t> &weight_values;
+        const vector<int32_t> &weight_fractional_bits;
+        const vector<int32_t> &slot_bits;
+        const vector<int32_t> &slot_fractional_bits;
+
+        const vector<int32_t> &sigmoid_table;
+        const vector<int32_t> &tanh_table;
+
+        //moves a value from one number of fractional bits to another, rounding to nearest
+        static inline int64_t rescale(int64_t value, int32_t from, int32_t to) {
+            if (to >= from) return value * ((int64_t)1 << (to - from));
+            int32_t shift = from - to;
+            return (value + ((int64_t)1 << (shift - 1))) >> shift;
+        }
+
+        static inline FixedPointValue saturate(int64_t value, int32_t fractional_bits, int64_t max_value) {
+            if (value > max_value) value = max_value;
+            else if (value < -max_value) value = -max_value;
+            return FixedPointValue{ value, fractional_bits };
+        }
+
+        inline int64_t get_slot_max_value(int32_t slot) {
+            return ((int64_t)1 << (slot_bits[slot] - 1)) - 1;
+        }
+
+        inline FixedPointValue lookup(FixedPointValue a, const vector<int32_t> &table) {
+            int64_t index = rescale(a.value, a.fractional_bits, 2 * LUT_BITS) + ((int64_t)LUT_RANGE << (2 * LUT_BITS));
+
+            int64_t result;
+            if (index <= 0) {
+                result = table.front();
+            } else if (index >= ((int64_t)(2 * LUT_RANGE) << (2 * LUT_BITS))) {
+                result = table.back();
+            } else {
+                int64_t entry = index >> LUT_BITS;
+                int64_t fraction = index & ((1 << LUT_BITS) - 1);
+                result = table[entry] + (((table[entry + 1] - table[entry]) * fraction + (1 << (LUT_BITS - 1))) >> LUT_BITS);
+            }
+
+            return saturate(rescale(result, LUT_FRACTIONAL_BITS, activation_fractional_bits), activation_fractional_bits, max_value);
+        }
+
+    public:
+        typedef FixedPointValue Value;
+
+        FixedPointArithmetic(int32_t bits, const vector<int32_t> &_weight_values, const vector<int32_t> &_weight_fractional_bits, const vector<int32_t> &_slot_bits, const vector<int32_t> &_slot_fractional_bits)
+            : max_value(((int64_t)1 << (bits - 1)) - 1), activation_fractional_bits(bits - 2),
+              weight_values(_weight_values), weight_fractional_bits(_weight_fractional_bits), slot_bits(_slot_bits), slot_fractional_bits(_slot_fractional_bits),
+              sigmoid_table(get_lookup_table(false)), tanh_table(get_lookup_table(true)) {
+        }
+
+        inline Value zero() { return Value{ 0, 0 }; }
+        inline Value one() { return Value{ (int64_t)1 << ACCUMULATOR_FRACTIONAL_BITS, ACCUMULATOR_FRACTIONAL_BITS }; }
+
+        inline Value weight(int32_t index) {
+            return Value{ weight_values[index], weight_fractional_bits[index] };
+        }
+
+        inline Value store(Value a, int32_t slot) {
+            return saturate(rescale(a.value, a.fractional_bits, slot_fractional_bits[slot]), slot_fractional_bits[slot], get_slot_max_value(slot));
+        }
+
+        inline Value quantize(double value, int32_t slot) {
+            return saturate(llround(ldexp(value, slot_fractional_bits[slot])), slot_fractional_bits[slot], get_slot_max_value(slot));
+        }
+
+        inline Value add(Value a, Value b) {
+            return Value{ rescale(a.value, a.fractional_bits, ACCUMULATOR_FRACTIONAL_BITS) + rescale(b.value, b.fractional_bits, ACCUMULATOR_FRACTIONAL_BITS), ACCUMULATOR_FRACTIONAL_BITS };
+        }
+
+        inline Value subtract(Value a, Value b) {
+            return Value{ rescale(a.value, a.fractional_bits, ACCUMULATOR_FRACTIONAL_BITS) - rescale(b.value, b.fractional_bits, ACCUMULATOR_FRACTIONAL_BITS), ACCUMULATOR_FRACTIONAL_BITS };
+        }
+
+        //at most one of a and b is ever an unstored (accumulator) value, so the product fits
+        inline Value multiply(Value a, Value b) {
+            return Value{ rescale(a.value * b.value, a.fractional_bits + b.fractional_bits, ACCUMULATOR_FRACTIONAL_BITS), ACCUMULATOR_FRACTIONAL_BITS };
+        }
+
+        inline Value sigmoid(Value a) { return lookup(a, sigmoid_table); }
+        inline Value tanh(Value a) { return lookup(a, tanh_table); }
+
+        inline double to_double(Value a) { return ldexp((double)a.value, -a.fractional_bits); }
+};
+
+RNN_Quantized::RNN_Quantized(RNN *rnn, int32_t _bits, bool using_dropout, double dropout_probability) : bits(_bits), calibrated(false), number_recurrent_values(0), number_slots(0) {
+    if (bits < 2 || bits > 16) {
+        Log::fatal("ERROR: cannot quantize an RNN to %d bits, the number of bits must be between 2 and 16\n", bits);
+        exit(1);
+    }
+
+    vector<int32_t> node_index(rnn->nodes.size(), -1);
+    vector<int32_t> total_inputs;
+
+    for (int32_t i = 0; i < (int32_t)rnn->nodes.size(); i++) {
+        RNN_Node_Interface *node = rnn->nodes[i];
+        if (!node->is_reachable()) continue;
+
+        int32_t node_type = node->get_node_type();
+        if (get_number_node_weights(node_type) < 0) {
+            Log::fatal("ERROR: cannot quantize node %d, quantization is not supported for %s nodes\n", node->get_innovation_number(), NODE_TYPES[node_type].c_str());
+            exit(1);
+        }
+
+        vector<double> parameters;
+        node->get_weights(parameters);
+
+        //the delta and LSTM nodes center some of their weights before using them
+        if (node_type == DELTA_NODE) {
+            parameters[0] += 2.0;
+            parameters[1] += 1.0;
+            parameters[2] += 1.0;
+        } else if (node_type == LSTM_NODE) {
+            parameters[8] += 1.0;
+        }
+
+        node_index[i] = (int32_t)nodes.size();
+        nodes.push_back(QuantizedNode{ node_type, (int32_t)weights.size(), number_slots });
+        total_inputs.push_back(node->get_total_inputs());
+
+        weights.insert(weights.end(), parameters.begin(), parameters.end());
+        number_slots += get_number_node_slots(node_type);
+
+        //an LSTM's cell value is the only recurrent state which is not bounded by its
+        //activation functions; it (and the output calculated from it) can integrate up to
+        //a much larger range than the other values while still needing the same precision,
+        //and can drift the furthest outside of the range seen during calibration, so (as in
+        //integer LSTM kernels) they are kept with twice the bits and more headroom
+        slot_bits.resize(number_slots, bits);
+        slot_headroom_bits.resize(number_slots, 2);
+        if (node_type == LSTM_NODE) {
+            for (int32_t j = number_slots - 2; j < number_slots; j++) {
+                slot_bits[j] = 2 * bits;
+                slot_headroom_bits[j] = 4;
+            }
+        }
+    }
+
+    auto get_node_index = [&](const RNN_Node_Interface *node) {
+        for (int32_t j = 0; j < (int32_t)rnn->nodes.size(); j++) {
+            if (rnn->nodes[j] == node) return node_index[j];
+        }
+        return -1;
+    };
+
+    for (int32_t i = 0; i < (int32_t)rnn->input_nodes.size(); i++) {
+        input_nodes.push_back(get_node_index(rnn->input_nodes[i]));
+    }
+
+    for (int32_t i = 0; i < (int32_t)rnn->output_nodes.size(); i++) {
+        output_nodes.push_back(get_node_index(rnn->output_nodes[i]));
+    }
+
+    //when predicting, genomes trained with dropout scale what the feed forward (but not the
+    //recurrent) edges send by (1 - dropout_probability)
+    double dropout_scale = using_dropout ? 1.0 - dropout_probability : 1.0;
+
+    for (int32_t i = 0; i < (int32_t)rnn->edges.size(); i++) {
+        RNN_Edge *edge = rnn->edges[i];
+        if (!edge->is_reachable()) continue;
+
+        edges.push_back(QuantizedEdge{ get_node_index(edge->input_node), get_node_index(edge->output_node), (int32_t)weights.size(), 0, 0 });
+        weights.push_back(edge->get_weight() * dropout_scale);
+    }
+
+    //the same order RNN_Stream delivers the recurrent edges' values in
+    vector<RNN_Recurrent_Edge*> reachable_recurrent_edges;
+    for (int32_t i = 0; i < (int32_t)rnn->recurrent_edges.size(); i++) {
+        if (rnn->recurrent_edges[i]->is_reachable()) reachable_recurrent_edges.push_back(rnn->recurrent_edges[i]);
+    }
+    stable_sort(reachable_recurrent_edges.begin(), reachable_recurrent_edges.end(), [](RNN_Recurrent_Edge *a, RNN_Recurrent_Edge *b) {
+        return a->recurrent_depth > b->recurrent_depth;
+    });
+
+    for (int32_t i = 0; i < (int32_t)reachable_recurrent_edges.size(); i++) {
+        RNN_Recurrent_Edge *edge = reachable_recurrent_edges[i];
+
+        recurrent_edges.push_back(QuantizedEdge{ get_node_index(edge->input_node), get_node_index(edge->output_node), (int32_t)weights.size(), edge->recurrent_depth, number_recurrent_values });
+        weights.push_back(edge->get_weight());
+        number_recurrent_values += edge->recurrent_depth;
+    }
+
+    //work out the order of the operations in a time step once, including when each
+    //node has all of its inputs and can be calculated
+    vector<int32_t> inputs_fired(nodes.size(), 0);
+    auto input_fired = [&](int32_t node) {
+        inputs_fired[node]++;
+        if (inputs_fired[node] == total_inputs[node]) operations.push_back(Operation{ NODE_OPERATION, node });
+    };
+
+    for (int32_t i = 0; i < (int32_t)recurrent_edges.size(); i++) {
+        operations.push_back(Operation{ RECURRENT_INPUT_OPERATION, i });
+        input_fired(recurrent_edges[i].output_node);
+    }
+
+    for (int32_t i = 0; i < (int32_t)input_nodes.size(); i++) {
+        if (input_nodes[i] < 0) continue;
+        operations.push_back(Operation{ INPUT_OPERATION, i });
+        input_fired(input_nodes[i]);
+    }
+
+    for (int32_t i = 0; i < (int32_t)edges.size(); i++) {
+        operations.push_back(Operation{ EDGE_OPERATION, i });
+        input_fired(edges[i].output_node);
+    }
+
+    weight_values.resize(weights.size());
+    weight_fractional_bits.resize(weights.size());
+    int64_t max_value = ((int64_t)1 << (bits - 1)) - 1;
+    for (int32_t i = 0; i < (int32_t)weights.size(); i++) {
+        weight_fractional_bits[i] = get_fractional_bits(fabs(weights[i]), bits);
+
+        int64_t value = llround(ldexp(weights[i], weight_fractional_bits[i]));
+        if (value > max_value) value = max_value;
+        else if (value < -max_value) value = -max_value;
+        weight_values[i] = (int32_t)value;
+    }
+
+    slot_max.assign(number_slots, 0.0);
+    slot_fractional_bits.assign(number_slots, bits - 1);
+}
+
+int32_t RNN_Quantized::get_fractional_bits(double max_magnitude, int32_t value_bits) const {
+    if (max_magnitude <= 0.0) return value_bits - 1;
+
+    //the most fractional bits which still leave room for max_magnitude
+    int32_t fractional_bits = (value_bits - 1) - (int32_t)ceil(log2(max_magnitude));
+    if (fractional_bits < 0) fractional_bits = 0;
+    if (fractional_bits > 30) fractional_bits = 30;
+    return fractional_bits;
+}
+
+template <class Arithmetic>
+typename Arithmetic::Value RNN_Quantized::calculate_node(Arithmetic &a, const QuantizedNode &node, typename Arithmetic::Value x, typename Arithmetic::Value &state) const {
+    typedef typename Arithmetic::Value Value;
+
+    int32_t w = node.weight_start;
+    int32_t s = node.slot_start;
+
+    //slot s is the node's input; the others are laid out per node type as commented, and
+    //the weights are in the order of each node's get_weights
+    switch (node.node_type) {
+        case SIMPLE_NODE:
+        case JORDAN_NODE:
+        case ELMAN_NODE: {
+            //s + 1: input + bias
+            return a.tanh(a.store(a.add(x, a.weight(w)), s + 1));
+        }
+
+        case UGRNN_NODE: {
+            //s + 1: c sum, s + 2: g sum, s + 3: output
+            Value h_prev = state;
+            Value c = a.tanh(a.store(a.add(a.add(a.multiply(x, a.weight(w)), a.multiply(h_prev, a.weight(w + 1))), a.weight(w + 2)), s + 1));
+            Value g = a.sigmoid(a.store(a.add(a.add(a.multiply(x, a.weight(w + 3)), a.multiply(h_prev, a.weight(w + 4))), a.weight(w + 5)), s + 2));
+            state = a.store(a.add(a.multiply(g, h_prev), a.multiply(a.subtract(a.one(), g), c)), s + 3);
+            return state;
+        }
+
+        case MGU_NODE: {
+            //s + 1: f sum, s + 2: f * h_prev, s + 3: h sum, s + 4: output
+            Value h_prev = state;
+            Value f = a.sigmoid(a.store(a.add(a.add(a.weight(w + 2), a.multiply(h_prev, a.weight(w + 1))), a.multiply(x, a.weight(w))), s + 1));
+            Value f_h_prev = a.store(a.multiply(f, h_prev), s + 2);
+            Value h_tanh = a.tanh(a.store(a.add(a.add(a.weight(w + 5), a.multiply(x, a.weight(w + 3))), a.multiply(a.weight(w + 4), f_h_prev)), s + 3));
+            state = a.store(a.add(a.multiply(a.subtract(a.one(), f), h_prev), a.multiply(f, h_tanh)), s + 4);
+            return state;
+        }
+
+        case GRU_NODE: {
+            //s + 1: z sum, s + 2: r sum, s + 3: r * h_prev, s + 4: h sum, s + 5: output
+            Value h_prev = state;
+            Value z = a.sigmoid(a.store(a.add(a.add(a.weight(w + 2), a.multiply(h_prev, a.weight(w + 1))), a.multiply(x, a.weight(w))), s + 1));
+            Value r = a.sigmoid(a.store(a.add(a.add(a.weight(w + 5), a.multiply(x, a.weight(w + 3))), a.multiply(h_prev, a.weight(w + 4))), s + 2));
+            Value r_h_prev = a.store(a.multiply(r, h_prev), s + 3);
+            Value h_tanh = a.tanh(a.store(a.add(a.add(a.weight(w + 8), a.multiply(x, a.weight(w + 6))), a.multiply(a.weight(w + 7), r_h_prev)), s + 4));
+            state = a.store(a.add(a.multiply(h_prev, z), a.multiply(a.subtract(a.one(), z), h_tanh)), s + 5);
+            return state;
+        }
+
+        case DELTA_NODE: {
+            //s + 1: d1, s + 2: d1 * x, s + 3: z hat sum, s + 4: r sum, s + 5: output sum
+            Value z_prev = state;
+            Value d1 = a.store(a.multiply(a.weight(w + 3), z_prev), s + 1);
+            Value d1_x = a.store(a.multiply(d1, x), s + 2);
+            Value z_hat_sum = a.add(a.add(a.add(a.multiply(d1_x, a.weight(w)), a.multiply(d1, a.weight(w + 1))), a.multiply(x, a.weight(w + 2))), a.weight(w + 5));
+            Value z_cap = a.tanh(a.store(z_hat_sum, s + 3));
+            Value r = a.sigmoid(a.store(a.add(x, a.weight(w + 4)), s + 4));
+            state = a.tanh(a.store(a.add(a.multiply(z_cap, a.subtract(a.one(), r)), a.multiply(r, z_prev)), s + 5));
+            return state;
+        }
+
+        case LSTM_NODE: {
+            //s + 1: output gate sum, s + 2: input gate sum, s + 3: forget gate sum,
+            //s + 4: cell input sum, s + 5: output, s + 6: cell value
+            Value previous_cell_value = state;
+            Value output_gate = a.sigmoid(a.store(a.add(a.add(a.multiply(a.weight(w + 1), x), a.multiply(a.weight(w), previous_cell_value)), a.weight(w + 2)), s + 1));
+            Value input_gate = a.sigmoid(a.store(a.add(a.add(a.multiply(a.weight(w + 4), x), a.multiply(a.weight(w + 3), previous_cell_value)), a.weight(w + 5)), s + 2));
+            Value forget_gate = a.sigmoid(a.store(a.add(a.add(a.multiply(a.weight(w + 7), x), a.multiply(a.weight(w + 6), previous_cell_value)), a.weight(w + 8)), s + 3));
+            Value cell_in = a.tanh(a.store(a.add(a.multiply(a.weight(w + 9), x), a.weight(w + 10)), s + 4));
+            state = a.store(a.add(a.multiply(forget_gate, previous_cell_value), a.multiply(input_gate, cell_in)), s + 6);
+            return a.store(a.multiply(output_gate, state), s + 5);
+        }
+
+        default:
+            Log::fatal("ERROR: quantized node had unsupported node type %d, this should never happen\n", node.node_type);
+            exit(1);
+    }
+}
+
+template <class Arithmetic>
+void RNN_Quantized::run(Arithmetic &arithmetic, const SeriesTensor &inputs, vector< vector<double> > &outputs) const {
+    typedef typename Arithmetic::Value Value;
+
+    if (inputs.get_number_parameters() != (int32_t)input_nodes.size()) {
+        Log::fatal("ERROR: running a quantized RNN with %d inputs on a series with %d parameters\n", input_nodes.size(), inputs.get_number_parameters());
+        exit(1);
+    }
+
+    int32_t series_length = inputs.get_number_timesteps();
+    outputs.assign(output_nodes.size(), vector<double>(series_length, 0.0));
+
+    vector<Value> node_inputs(nodes.size());
+    vector<Value> node_outputs(nodes.size(), arithmetic.zero());
+    vector<Value> node_states(nodes.size(), arithmetic.zero());
+    vector<Value> recurrent_values(number_recurrent_values, arithmetic.zero());
+
+    for (int32_t time = 0; time < series_length; time++) {
+        for (int32_t i = 0; i < (int32_t)nodes.size(); i++) node_inputs[i] = arithmetic.zero();
+
+        for (int32_t i = 0; i < (int32_t)operations.size(); i++) {
+            const Operation &operation = operations[i];
+
+            switch (operation.type) {
+                case RECURRENT_INPUT_OPERATION: {
+                    const QuantizedEdge &edge = recurrent_edges[operation.index];
+                    node_inputs[edge.output_node] = arithmetic.add(node_inputs[edge.output_node], recurrent_values[edge.value_start + (time % edge.recurrent_depth)]);
+                    break;
+                }
+
+                case INPUT_OPERATION: {
+                    int32_t node = input_nodes[operation.index];
+                    int32_t slot = nodes[node].slot_start;
+                    node_inputs[node] = arithmetic.add(node_inputs[node], arithmetic.quantize(inputs(operation.index, time), slot));
+                    break;
+                }
+
+                case EDGE_OPERATION: {
+                    const QuantizedEdge &edge = edges[operation.index];
+                    Value value = arithmetic.multiply(node_outputs[edge.input_node], arithmetic.weight(edge.weight));
+                    node_inputs[edge.output_node] = arithmetic.add(node_inputs[edge.output_node], value);
+                    break;
+                }
+
+                case NODE_OPERATION: {
+                    int32_t node = operation.index;
+                    Value x = arithmetic.store(node_inputs[node], nodes[node].slot_start);
+                    node_outputs[node] = calculate_node(arithmetic, nodes[node], x, node_states[node]);
+                    break;
+                }
+            }
+        }
+
+        //send the recurrent edges' values, replacing the ones delivered this time step; these
+        //are stored with the same scale as the input of the node they are sent to
+        for (int32_t i = 0; i < (int32_t)recurrent_edges.size(); i++) {
+            const QuantizedEdge &edge = recurrent_edges[i];
+            Value value = arithmetic.multiply(node_outputs[edge.input_node], arithmetic.weight(edge.weight));
+            recurrent_values[edge.value_start + (time % edge.recurrent_depth)] = arithmetic.store(value, nodes[edge.output_node].slot_start);
+        }
+
+        for (int32_t i = 0; i < (int32_t)output_nodes.size(); i++) {
+            if (output_nodes[i] >= 0) outputs[i][time] = arithmetic.to_double(node_outputs[output_nodes[i]]);
+        }
+    }
+}
+
+void RNN_Quantized::calibrate(const vector<SeriesTensor> &inputs) {
+    slot_max.assign(number_slots, 0.0);
+
+    CalibrationArithmetic arithmetic(weights, slot_max);
+    vector< vector<double> > outputs;
+    for (int32_t i = 0; i < (int32_t)inputs.size(); i++) {
+        run(arithmetic, inputs[i], outputs);
+    }
+
+    //leave some headroom, as other series will not stay within exactly the same range
+    for (int32_t i = 0; i < number_slots; i++) {
+        slot_fractional_bits[i] = get_fractional_bits(ldexp(slot_max[i], slot_headroom_bits[i]), slot_bits[i]);
+    }
+    calibrated = true;
+}
+
+void RNN_Quantized::predict(const SeriesTensor &inputs, vector< vector<double> > &outputs) const {
+    if (!calibrated) {
+        Log::fatal("ERROR: predicting with a quantized RNN which has not been calibrated\n");
+        exit(1);
+    }
+
+    FixedPointArithmetic arithmetic(bits, weight_values, weight_fractional_bits, slot_bits, slot_fractional_bits);
+    run(arithmetic, inputs, outputs);
+}
+
+int32_t RNN_Quantized::get_bits() const {
+    return bits;
+}
+
+int32_t RNN_Quantized::get_number_weights() const {
+    return (int32_t)weights.size();
+}
+
+int64_t RNN_Quantized::get_weight_bytes() const {
+    return ((int64_t)weights.size() * bits + 7) / 8;
+}
+
+int32_t RNN_Quantized::get_number_slots() const {
+    return number_slots;
+}
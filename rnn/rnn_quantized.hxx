@@ -0,0 +1,131 @@
+#ifndef EXAMM_RNN_QUANTIZED_HXX
+#define EXAMM_RNN_QUANTIZED_HXX
+
+#include <cstdint>
+
+#include <vector>
+using std::vector;
+
+#include "rnn.hxx"
+#include "time_series/series_tensor.hxx"
+
+/**
+ * Fixed point inference for a trained RNN, for deploying the best genomes where memory
+ * or floating point throughput is limited. Weights and all of the values stored during a
+ * time step (node inputs, gate sums, gate products, outputs and recurrent state) are
+ * signed integers of the given number of bits (e.g. 8 or 16); as with integer hardware,
+ * sums and products in between are kept in a wide (64 bit) accumulator and only rounded
+ * and saturated when they are stored. LSTM cell values (and the outputs calculated from
+ * them) are not bounded by an activation function, so they are stored with twice the
+ * bits. Sigmoid and tanh are done with a linearly interpolated lookup table.
+ *
+ * Every weight has its own power of two scale, chosen from its magnitude, and every
+ * value calculated in each node (each gate's sum, the node's input, its output, etc.)
+ * has its own power of two scale, chosen from the largest magnitude it reaches when
+ * calibrate runs the network (in double precision) over a set of calibration series.
+ * Values which exceed this range on other series are saturated.
+ *
+ * Simple, Jordan, Elman, UGRNN, MGU, GRU, delta and LSTM nodes are supported. As with
+ * RNN_Stream, the nodes and edges are done in the same order as RNN::forward_pass.
+ */
+class RNN_Quantized {
+    private:
+        struct QuantizedNode {
+            int32_t node_type;
+            int32_t weight_start;
+            int32_t slot_start;
+        };
+
+        struct QuantizedEdge {
+            int32_t input_node;
+            int32_t output_node;
+            int32_t weight;
+
+            //only used by recurrent edges: how many time steps later the value is
+            //delivered, and where the values in flight are stored
+            int32_t recurrent_depth;
+            int32_t value_start;
+        };
+
+        struct Operation {
+            int32_t type;
+            int32_t index;
+        };
+
+        int32_t bits;
+        bool calibrated;
+
+        vector<QuantizedNode> nodes;
+        vector<QuantizedEdge> edges;
+        vector<QuantizedEdge> recurrent_edges;
+        int32_t number_recurrent_values;
+
+        //the index in nodes of each input and output parameter's node, or -1 if the node
+        //is not reachable
+        vector<int32_t> input_nodes;
+        vector<int32_t> output_nodes;
+
+        //the operations done each time step, in order
+        vector<Operation> operations;
+
+        //every weight used, with the delta and LSTM nodes' offsets already added
+        vector<double> weights;
+        vector<int32_t> weight_values;
+        vector<int32_t> weight_fractional_bits;
+
+        //the largest magnitude each slot reached during calibration, how many bits of
+        //headroom above that it is given, how many bits it is stored in, and how many of
+        //those are fractional bits
+        int32_t number_slots;
+        vector<double> slot_max;
+        vector<int32_t> slot_headroom_bits;
+        vector<int32_t> slot_bits;
+        vector<int32_t> slot_fractional_bits;
+
+        int32_t get_fractional_bits(double max_magnitude, int32_t value_bits) const;
+
+        template <class Arithmetic>
+        void run(Arithmetic &arithmetic, const SeriesTensor &inputs, vector< vector<double> > &outputs) const;
+
+        template <class Arithmetic>
+        typename Arithmetic::Value calculate_node(Arithmetic &arithmetic, const QuantizedNode &node, typename Arithmetic::Value x, typename Arithmetic::Value &state) const;
+
+    public:
+        /**
+         * \param rnn is the network to quantize, with its weights already set; it is only
+         *      used by the constructor
+         * \param bits is the number of bits each weight and value is stored in (2 to 16)
+         * \param using_dropout and dropout_probability should be the settings the genome was
+         *      trained with, as predicting scales the feed forward edges by
+         *      (1 - dropout_probability); this is folded into their quantized weights
+         */
+        RNN_Quantized(RNN *rnn, int32_t bits, bool using_dropout, double dropout_probability);
+
+        /**
+         * Chooses the scale of every value from the range it covers when predicting the
+         * given (normalized) input series.
+         */
+        void calibrate(const vector<SeriesTensor> &inputs);
+
+        /**
+         * Predicts the given (normalized) input series with fixed point arithmetic.
+         *
+         * \param outputs will be set to the (normalized) predictions, [output][time]
+         */
+        void predict(const SeriesTensor &inputs, vector< vector<double> > &outputs) const;
+
+        int32_t get_bits() const;
+        int32_t get_number_weights() const;
+
+        /**
+         * \return the number of bytes needed to store the quantized weights
+         */
+        int64_t get_weight_bytes() const;
+
+        /**
+         * \return the number of separately scaled values calculated each time step
+         */
+        int32_t get_number_slots() const;
+};
+
+#endif
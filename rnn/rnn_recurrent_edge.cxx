@@ -4,6 +4,12 @@
 
 RNN_Recurrent_Edge::RNN_Recurrent_Edge(int32_t _innovation_number, int32_t _recurrent_depth, RNN_Node_Interface *_input_node, RNN_Node_Interface *_output_node) {
     innovation_number = _innovation_number;
+
+    weight = &weight_storage[0];
+    d_weight = &weight_storage[1];
+    *weight = 0.0;
+    *d_weight = 0.0;
+
     recurrent_depth = _recurrent_depth;
 
     if (recurrent_depth <= 0) {
@@ -32,6 +38,12 @@ RNN_Recurrent_Edge::RNN_Recurrent_Edge(int32_t _innovation_number, int32_t _recu
 
 RNN_Recurrent_Edge::RNN_Recurrent_Edge(int32_t _innovation_number, int32_t _recurrent_depth, int32_t _input_innovation_number, int32_t _output_innovation_number, const vector<RNN_Node_Interface*> &nodes) {
     innovation_number = _innovation_number;
+
+    weight = &weight_storage[0];
+    d_weight = &weight_storage[1];
+    *weight = 0.0;
+    *d_weight = 0.0;
+
     recurrent_depth = _recurrent_depth;
 
     input_innovation_number = _input_innovation_number;
@@ -83,11 +95,8 @@ RNN_Recurrent_Edge* RNN_Recurrent_Edge::copy(const vector<RNN_Node_Interface*> n
 
     e->recurrent_depth = recurrent_depth;
 
-    e->weight = weight;
-    e->d_weight = d_weight;
-
-    e->outputs = outputs;
-    e->deltas = deltas;
+    *e->weight = *weight;
+    *e->d_weight = *d_weight;
 
     e->enabled = enabled;
     e->forward_reachable = forward_reachable;
@@ -135,11 +144,10 @@ void RNN_Recurrent_Edge::propagate_forward(int32_t time) {
     }
 
 
-    double output = input_node->output_values[time] * weight;
+    double output = input_node->output_values[time] * (*weight);
     if (time < series_length - recurrent_depth) {
         //Log::trace("propagating forward on recurrent edge %d from time %d to time %d from node %d to node %d\n", innovation_number, time, time + recurrent_depth, input_innovation_number, output_innovation_number);
 
-        outputs[time + recurrent_depth] = output;
         output_node->input_fired(time + recurrent_depth, output);
     }
 }
@@ -178,17 +186,14 @@ void RNN_Recurrent_Edge::propagate_backward(int32_t time) {
     if (time - recurrent_depth >= 0) {
         //Log::trace("propagating backward on recurrent edge %d from time %d to time %d from node %d to node %d\n", innovation_number, time, time - recurrent_depth, output_innovation_number, input_innovation_number);
 
-        d_weight += delta * input_node->output_values[time - recurrent_depth];
-        deltas[time] = delta * weight;
-        input_node->output_fired(time - recurrent_depth, deltas[time]);
+        *d_weight += delta * input_node->output_values[time - recurrent_depth];
+        input_node->output_fired(time - recurrent_depth, delta * (*weight));
     }
 }
 
 void RNN_Recurrent_Edge::reset(int32_t _series_length) {
     series_length = _series_length;
-    d_weight = 0.0;
-    outputs.resize(series_length);
-    deltas.resize(series_length);
+    *d_weight = 0.0;
 }
 
 int32_t RNN_Recurrent_Edge::get_recurrent_depth() const {
@@ -196,7 +201,22 @@ int32_t RNN_Recurrent_Edge::get_recurrent_depth() const {
 }
 
 double RNN_Recurrent_Edge::get_gradient() {
-    return d_weight;
+    return *d_weight;
+}
+
+double RNN_Recurrent_Edge::get_weight() const {
+    return *weight;
+}
+
+void RNN_Recurrent_Edge::set_weight(double _weight) {
+    *weight = _weight;
+}
+
+void RNN_Recurrent_Edge::set_weight_buffers(double *_weight, double *_d_weight) {
+    *_weight = *weight;
+    *_d_weight = *d_weight;
+    weight = _weight;
+    d_weight = _d_weight;
 }
 
 bool RNN_Recurrent_Edge::is_enabled() const {
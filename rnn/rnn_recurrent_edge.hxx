@@ -13,11 +13,16 @@ class RNN_Recurrent_Edge {
         //how far in the past to get the value
         int32_t recurrent_depth;
 
-        vector<double> outputs;
-        vector<double> deltas;
+        //values are passed straight on to the output node's input at time + recurrent_depth
+        //(and deltas to the input node's at time - recurrent_depth), so recurrent edges
+        //keep no per time step state
 
-        double weight;
-        double d_weight;
+        //the weight and its gradient, which the backward pass adds to and reset clears. When
+        //the edge is part of an RNN these point into the RNN's parameter and gradient buffers
+        //(see set_weight_buffers), otherwise into weight_storage
+        double *weight;
+        double *d_weight;
+        double weight_storage[2];
 
         bool enabled;
         bool forward_reachable;
@@ -43,6 +48,16 @@ class RNN_Recurrent_Edge {
 
         int32_t get_recurrent_depth() const;
         double get_gradient();
+        double get_weight() const;
+        void set_weight(double _weight);
+
+        /**
+         * Moves the weight and its gradient to the given locations, keeping their current
+         * values. RNN uses this to keep the weights of all its edges in its parameter and
+         * gradient buffers.
+         */
+        void set_weight_buffers(double *_weight, double *_d_weight);
+
         bool is_enabled() const;
         bool is_reachable() const;
 
@@ -61,6 +76,9 @@ class RNN_Recurrent_Edge {
 
         friend class RNN_Genome;
         friend class RNN;
+        friend class RNN_Stream;
+        friend class RNN_Code_Generator;
+        friend class RNN_Quantized;
         friend class EXAMM;
         friend class RecDepthFrequencyTable;
 };
@@ -0,0 +1,119 @@
+#include <algorithm>
+using std::stable_sort;
+
+#include <vector>
+using std::vector;
+
+#include "common/log.hxx"
+#include "rnn_node_interface.hxx"
+#include "rnn_edge.hxx"
+#include "rnn_recurrent_edge.hxx"
+#include "rnn_stream.hxx"
+
+//the nodes only need the current time step, and the previous one for their recurrent state
+#define CURRENT_TIME 1
+#define PREVIOUS_TIME 0
+
+RNN_Stream::RNN_Stream(RNN *_rnn, bool _using_dropout, double _dropout_probability) : rnn(_rnn), using_dropout(_using_dropout), dropout_probability(_dropout_probability) {
+    //carry_state only moves a node's own values to the previous time step, so node types
+    //made of inner nodes with their own state (e.g. DNAS nodes) can't be streamed
+    for (int32_t i = 0; i < (int32_t)rnn->nodes.size(); i++) {
+        RNN_Node_Interface *node = rnn->nodes[i];
+
+        switch (node->get_node_type()) {
+            case SIMPLE_NODE:
+            case JORDAN_NODE:
+            case ELMAN_NODE:
+            case UGRNN_NODE:
+            case MGU_NODE:
+            case GRU_NODE:
+            case DELTA_NODE:
+            case LSTM_NODE:
+            case ENARC_NODE:
+            case ENAS_DAG_NODE:
+            case RANDOM_DAG_NODE:
+                break;
+            default:
+                Log::fatal("ERROR: cannot stream node %d, streaming is not supported for node type %d\n", node->get_innovation_number(), node->get_node_type());
+                exit(1);
+        }
+    }
+
+    for (int32_t i = 0; i < (int32_t)rnn->recurrent_edges.size(); i++) {
+        if (rnn->recurrent_edges[i]->is_reachable()) recurrent_edges.push_back(rnn->recurrent_edges[i]);
+    }
+
+    //RNN::forward_pass delivers the value a recurrent edge sends to time t at time
+    //t - recurrent_depth, so the deepest edges' values are added to a node's input first;
+    //keeping the same order keeps the sums (and the predictions) exactly the same
+    stable_sort(recurrent_edges.begin(), recurrent_edges.end(), [](RNN_Recurrent_Edge *a, RNN_Recurrent_Edge *b) {
+        return a->recurrent_depth > b->recurrent_depth;
+    });
+
+    reset();
+}
+
+void RNN_Stream::reset() {
+    time = 0;
+
+    for (int32_t i = 0; i < (int32_t)rnn->nodes.size(); i++) {
+        rnn->nodes[i]->reset(2);
+    }
+
+    for (int32_t i = 0; i < (int32_t)rnn->edges.size(); i++) {
+        rnn->edges[i]->reset(2);
+    }
+
+    recurrent_values.resize(recurrent_edges.size());
+    for (int32_t i = 0; i < (int32_t)recurrent_edges.size(); i++) {
+        recurrent_values[i].assign(recurrent_edges[i]->recurrent_depth, 0.0);
+    }
+}
+
+void RNN_Stream::step(const vector<double> &inputs, vector<double> &outputs) {
+    if (inputs.size() != rnn->input_nodes.size()) {
+        Log::fatal("ERROR: streaming %d input values to an RNN with %d input nodes\n", inputs.size(), rnn->input_nodes.size());
+        exit(1);
+    }
+
+    //deliver the values the recurrent edges sent recurrent_depth time steps ago, and
+    //before the slot is reused, the values they send now
+    for (int32_t i = 0; i < (int32_t)recurrent_edges.size(); i++) {
+        RNN_Recurrent_Edge *edge = recurrent_edges[i];
+        edge->output_node->input_fired(CURRENT_TIME, recurrent_values[i][time % edge->recurrent_depth]);
+    }
+
+    for (int32_t i = 0; i < (int32_t)rnn->input_nodes.size(); i++) {
+        if (rnn->input_nodes[i]->is_reachable()) rnn->input_nodes[i]->input_fired(CURRENT_TIME, inputs[i]);
+    }
+
+    for (int32_t i = 0; i < (int32_t)rnn->edges.size(); i++) {
+        if (!rnn->edges[i]->is_reachable()) continue;
+
+        if (using_dropout) {
+            rnn->edges[i]->propagate_forward(CURRENT_TIME, false, dropout_probability, 0);
+        } else {
+            rnn->edges[i]->propagate_forward(CURRENT_TIME);
+        }
+    }
+
+    for (int32_t i = 0; i < (int32_t)recurrent_edges.size(); i++) {
+        RNN_Recurrent_Edge *edge = recurrent_edges[i];
+        recurrent_values[i][time % edge->recurrent_depth] = edge->input_node->output_values[CURRENT_TIME] * edge->get_weight();
+    }
+
+    outputs.resize(rnn->output_nodes.size());
+    for (int32_t i = 0; i < (int32_t)rnn->output_nodes.size(); i++) {
+        outputs[i] = rnn->output_nodes[i]->output_values[CURRENT_TIME];
+    }
+
+    for (int32_t i = 0; i < (int32_t)rnn->nodes.size(); i++) {
+        rnn->nodes[i]->carry_state(CURRENT_TIME, PREVIOUS_TIME);
+    }
+
+    time++;
+}
+
+int64_t RNN_Stream::get_time() const {
+    return time;
+}
@@ -0,0 +1,68 @@
+#ifndef EXAMM_RNN_STREAM_HXX
+#define EXAMM_RNN_STREAM_HXX
+
+#include <cstdint>
+
+#include <vector>
+using std::vector;
+
+#include "rnn.hxx"
+#include "rnn_recurrent_edge.hxx"
+
+/**
+ * Stateful inference over a series which arrives one time step at a time (e.g., live
+ * sensor data). RNN::forward_pass resets the network and runs over a whole series, so
+ * predicting after each new row would take time proportional to the length of the
+ * series so far. An RNN_Stream keeps the RNN's state between calls instead: the nodes'
+ * recurrent state (e.g. hidden and cell values) and, for each recurrent edge, a ring
+ * buffer of the values it will deliver over the next recurrent_depth time steps. Each
+ * step then only propagates through the network once.
+ *
+ * The predictions are the same as those RNN::forward_pass makes for the same series
+ * with the same dropout settings. The stream uses the RNN's nodes and edges to do its
+ * calculations, so the RNN should not be used for anything else until the stream is done
+ * with it.
+ * Networks with node types made of inner nodes (DNAS nodes) are rejected.
+ */
+class RNN_Stream {
+    private:
+        RNN *rnn;
+        bool using_dropout;
+        double dropout_probability;
+
+        int64_t time;
+
+        //the reachable recurrent edges, in the order their values are delivered, and
+        //the values each will deliver (indexed by time % recurrent_depth)
+        vector<RNN_Recurrent_Edge*> recurrent_edges;
+        vector< vector<double> > recurrent_values;
+
+    public:
+        /**
+         * \param rnn is the network to run, with its weights already set; it is not owned
+         *      by the stream
+         * \param using_dropout and dropout_probability should be the settings the genome was
+         *      trained with, as predicting scales the feed forward edges by (1 - dropout_probability)
+         */
+        RNN_Stream(RNN *rnn, bool using_dropout, double dropout_probability);
+
+        /**
+         * Clears all state, so the next step is the first time step of a new series.
+         */
+        void reset();
+
+        /**
+         * Feeds the next time step of the series through the network.
+         *
+         * \param inputs are the values of each input parameter at this time step
+         * \param outputs will be set to the network's outputs (predictions) for this time step
+         */
+        void step(const vector<double> &inputs, vector<double> &outputs);
+
+        /**
+         * \return the number of time steps taken since the stream was created or reset
+         */
+        int64_t get_time() const;
+};
+
+#endif
@@ -25,9 +25,16 @@ using std::vector;
 
 
 #define NUMBER_UGRNN_WEIGHTS 6
+#define UGRNN_CW 0
+#define UGRNN_CH 1
+#define UGRNN_C_BIAS 2
+#define UGRNN_GW 3
+#define UGRNN_GH 4
+#define UGRNN_G_BIAS 5
 
 UGRNN_Node::UGRNN_Node(int32_t _innovation_number, int32_t _type, double _depth) : RNN_Node_Interface(_innovation_number, _type, _depth) {
     node_type = UGRNN_NODE;
+    initialize_weight_storage(NUMBER_UGRNN_WEIGHTS);
 }
 
 UGRNN_Node::~UGRNN_Node() {
@@ -35,69 +42,63 @@ UGRNN_Node::~UGRNN_Node() {
 
 void UGRNN_Node::initialize_lamarckian(minstd_rand0 &generator, NormalDistribution &normal_distribution, double mu, double sigma) {
 
-    cw = bound(normal_distribution.random(generator, mu, sigma));
-    ch = bound(normal_distribution.random(generator, mu, sigma));
-    c_bias = bound(normal_distribution.random(generator, mu, sigma));
+    weights[UGRNN_CW] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[UGRNN_CH] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[UGRNN_C_BIAS] = bound(normal_distribution.random(generator, mu, sigma));
 
-    gw = bound(normal_distribution.random(generator, mu, sigma));
-    gh = bound(normal_distribution.random(generator, mu, sigma));
-    g_bias = bound(normal_distribution.random(generator, mu, sigma));
+    weights[UGRNN_GW] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[UGRNN_GH] = bound(normal_distribution.random(generator, mu, sigma));
+    weights[UGRNN_G_BIAS] = bound(normal_distribution.random(generator, mu, sigma));
 }
 
 void UGRNN_Node::initialize_xavier(minstd_rand0 &generator, uniform_real_distribution<double> &rng_1_1, double range) {
 
-    cw = range * (rng_1_1(generator));
-    ch = range * (rng_1_1(generator));
-    c_bias = range * (rng_1_1(generator));
+    weights[UGRNN_CW] = range * (rng_1_1(generator));
+    weights[UGRNN_CH] = range * (rng_1_1(generator));
+    weights[UGRNN_C_BIAS] = range * (rng_1_1(generator));
 
-    gw = range * (rng_1_1(generator));
-    gh = range * (rng_1_1(generator));
-    g_bias = range * (rng_1_1(generator));
+    weights[UGRNN_GW] = range * (rng_1_1(generator));
+    weights[UGRNN_GH] = range * (rng_1_1(generator));
+    weights[UGRNN_G_BIAS] = range * (rng_1_1(generator));
 }
 
 void UGRNN_Node::initialize_kaiming(minstd_rand0 &generator, NormalDistribution &normal_distribution, double range){
-    cw = range * normal_distribution.random(generator, 0, 1);
-    ch = range * normal_distribution.random(generator, 0, 1);
-    c_bias = range * normal_distribution.random(generator, 0, 1);
+    weights[UGRNN_CW] = range * normal_distribution.random(generator, 0, 1);
+    weights[UGRNN_CH] = range * normal_distribution.random(generator, 0, 1);
+    weights[UGRNN_C_BIAS] = range * normal_distribution.random(generator, 0, 1);
 
-    gw = range * normal_distribution.random(generator, 0, 1);
-    gh = range * normal_distribution.random(generator, 0, 1);
-    g_bias = range * normal_distribution.random(generator, 0, 1);
+    weights[UGRNN_GW] = range * normal_distribution.random(generator, 0, 1);
+    weights[UGRNN_GH] = range * normal_distribution.random(generator, 0, 1);
+    weights[UGRNN_G_BIAS] = range * normal_distribution.random(generator, 0, 1);
 }
 
 void UGRNN_Node::initialize_uniform_random(minstd_rand0 &generator, uniform_real_distribution<double> &rng) {
-    cw = rng(generator);
-    ch = rng(generator);
-    c_bias = rng(generator);
+    weights[UGRNN_CW] = rng(generator);
+    weights[UGRNN_CH] = rng(generator);
+    weights[UGRNN_C_BIAS] = rng(generator);
 
-    gw = rng(generator);
-    gh = rng(generator);
-    g_bias = rng(generator);
+    weights[UGRNN_GW] = rng(generator);
+    weights[UGRNN_GH] = rng(generator);
+    weights[UGRNN_G_BIAS] = rng(generator);
 }
 
 double UGRNN_Node::get_gradient(string gradient_name) {
-    double gradient_sum = 0.0;
-
-    for (int32_t i = 0; i < series_length; i++ ) {
-        if (gradient_name == "cw") {
-            gradient_sum += d_cw[i];
-        } else if (gradient_name == "ch") {
-            gradient_sum += d_ch[i];
-        } else if (gradient_name == "c_bias") {
-            gradient_sum += d_c_bias[i];
-        } else if (gradient_name == "gw") {
-            gradient_sum += d_gw[i];
-        } else if (gradient_name == "gh") {
-            gradient_sum += d_gh[i];
-        } else if (gradient_name == "g_bias") {
-            gradient_sum += d_g_bias[i];
-        } else {
-            Log::fatal("ERROR: tried to get unknown gradient: '%s'\n", gradient_name.c_str());
-            exit(1);
-        }
+    if (gradient_name == "cw") {
+        return d_weights[UGRNN_CW];
+    } else if (gradient_name == "ch") {
+        return d_weights[UGRNN_CH];
+    } else if (gradient_name == "c_bias") {
+        return d_weights[UGRNN_C_BIAS];
+    } else if (gradient_name == "gw") {
+        return d_weights[UGRNN_GW];
+    } else if (gradient_name == "gh") {
+        return d_weights[UGRNN_GH];
+    } else if (gradient_name == "g_bias") {
+        return d_weights[UGRNN_G_BIAS];
+    } else {
+        Log::fatal("ERROR: tried to get unknown gradient: '%s'\n", gradient_name.c_str());
+        exit(1);
     }
-
-    return gradient_sum;
 }
 
 void UGRNN_Node::print_gradient(string gradient_name) {
@@ -123,15 +124,15 @@ void UGRNN_Node::input_fired(int32_t time, double incoming_output) {
     double h_prev = 0.0;
     if (time > 0) h_prev = output_values[time - 1];
 
-    double xcw = x * cw;
-    double hch = h_prev * ch;
-    double c_sum = xcw + hch + c_bias;
+    double xcw = x * weights[UGRNN_CW];
+    double hch = h_prev * weights[UGRNN_CH];
+    double c_sum = xcw + hch + weights[UGRNN_C_BIAS];
     c[time] = tanh(c_sum);
     ld_c[time] = tanh_derivative(c[time]);
 
-    double xgw = x * gw;
-    double hgh = h_prev * gh;
-    double g_sum = xgw + hgh + g_bias;
+    double xgw = x * weights[UGRNN_GW];
+    double hgh = h_prev * weights[UGRNN_GH];
+    double g_sum = xgw + hgh + weights[UGRNN_G_BIAS];
 
     g[time] = sigmoid(g_sum);
     ld_g[time] = sigmoid_derivative(g[time]);
@@ -168,21 +169,21 @@ void UGRNN_Node::try_update_deltas(int32_t time) {
     d_h_prev[time] = d_h * g[time];
 
     double d_g = ((d_h * h_prev) - (d_h * c[time])) * ld_g[time];
-    d_g_bias[time] = d_g;
-    d_gh[time] = d_g * h_prev;
-    d_h_prev[time] += d_g * gh;
-    d_gw[time] = d_g * x;
-    d_input[time] = d_g * gw;
+    d_weights[UGRNN_G_BIAS] += d_g;
+    d_weights[UGRNN_GH] += d_g * h_prev;
+    d_h_prev[time] += d_g * weights[UGRNN_GH];
+    d_weights[UGRNN_GW] += d_g * x;
+    d_input[time] = d_g * weights[UGRNN_GW];
 
     double d_c = (1 - g[time]) * d_h * ld_c[time];
 
-    d_input[time] += d_c * cw;
-    d_cw[time] = d_c * x;
+    d_input[time] += d_c * weights[UGRNN_CW];
+    d_weights[UGRNN_CW] += d_c * x;
 
-    d_c_bias[time] = d_c;
+    d_weights[UGRNN_C_BIAS] += d_c;
 
-    d_ch[time] = d_c * h_prev;
-    d_h_prev[time] += d_c * ch;
+    d_weights[UGRNN_CH] += d_c * h_prev;
+    d_h_prev[time] += d_c * weights[UGRNN_CH];
 
     //reset the reset gate bias to be around 0
     //g_bias -= 1.0;
@@ -209,77 +210,10 @@ int32_t UGRNN_Node::get_number_weights() const {
     return NUMBER_UGRNN_WEIGHTS;
 }
 
-void UGRNN_Node::get_weights(vector<double> &parameters) const {
-    parameters.resize(get_number_weights());
-    int32_t offset = 0;
-    get_weights(offset, parameters);
-}
-
-void UGRNN_Node::set_weights(const vector<double> &parameters) {
-    int32_t offset = 0;
-    set_weights(offset, parameters);
-}
-
-
-void UGRNN_Node::set_weights(int32_t &offset, const vector<double> &parameters) {
-    //int32_t start_offset = offset;
-
-    cw = bound(parameters[offset++]);
-    ch = bound(parameters[offset++]);
-    c_bias = bound(parameters[offset++]);
-
-    gw = bound(parameters[offset++]);
-    gh = bound(parameters[offset++]);
-    g_bias = bound(parameters[offset++]);
-
-    //int32_t end_offset = offset;
-    //Log::debug("set weights from offset %d to %d on UGRNN_Node %d\n", start_offset, end_offset, innovation_number);
-}
-
-void UGRNN_Node::get_weights(int32_t &offset, vector<double> &parameters) const {
-    //int32_t start_offset = offset;
-
-    parameters[offset++] = cw;
-    parameters[offset++] = ch;
-    parameters[offset++] = c_bias;
-
-    parameters[offset++] = gw;
-    parameters[offset++] = gh;
-    parameters[offset++] = g_bias;
-
-    //int32_t end_offset = offset;
-    //Log::debug("got weights from offset %d to %d on UGRNN_Node %d\n", start_offset, end_offset, innovation_number);
-}
-
-
-void UGRNN_Node::get_gradients(vector<double> &gradients) {
-    gradients.assign(NUMBER_UGRNN_WEIGHTS, 0.0);
-
-    for (int32_t i = 0; i < NUMBER_UGRNN_WEIGHTS; i++) {
-        gradients[i] = 0.0;
-    }
-
-    for (int32_t i = 0; i < series_length; i++) {
-        gradients[0] += d_cw[i];
-        gradients[1] += d_ch[i];
-        gradients[2] += d_c_bias[i];
-
-        gradients[3] += d_gw[i];
-        gradients[4] += d_gh[i];
-        gradients[5] += d_g_bias[i];
-    }
-}
-
 void UGRNN_Node::reset(int32_t _series_length) {
     series_length = _series_length;
 
-    d_cw.assign(series_length, 0.0);
-    d_ch.assign(series_length, 0.0);
-    d_c_bias.assign(series_length, 0.0);
-
-    d_gw.assign(series_length, 0.0);
-    d_gh.assign(series_length, 0.0);
-    d_g_bias.assign(series_length, 0.0);
+    for (int32_t i = 0; i < NUMBER_UGRNN_WEIGHTS; i++) d_weights[i] = 0.0;
 
     d_h_prev.assign(series_length, 0.0);
 
@@ -303,19 +237,7 @@ RNN_Node_Interface* UGRNN_Node::copy() const {
     UGRNN_Node* n = new UGRNN_Node(innovation_number, layer_type, depth);
 
     //copy UGRNN_Node values
-    n->cw = cw;
-    n->ch = ch;
-    n->c_bias = c_bias;
-    n->gw = gw;
-    n->gh = gh;
-    n->g_bias = g_bias;
-
-    n->d_cw = d_cw;
-    n->d_ch = d_ch;
-    n->d_c_bias = d_c_bias;
-    n->d_gw = d_gw;
-    n->d_gh = d_gh;
-    n->d_g_bias = d_g_bias;
+    copy_weights_to(n);
 
     n->d_h_prev = d_h_prev;
 
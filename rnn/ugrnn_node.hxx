@@ -17,21 +17,6 @@ using std::vector;
 
 class UGRNN_Node : public RNN_Node_Interface {
     private:
-        double cw;
-        double ch;
-        double c_bias;
-
-        double gw;
-        double gh;
-        double g_bias;
-
-        vector<double> d_cw;
-        vector<double> d_ch;
-        vector<double> d_c_bias;
-        vector<double> d_gw;
-        vector<double> d_gh;
-        vector<double> d_g_bias;
-
         vector<double> d_h_prev;
 
         vector<double> c;
@@ -60,14 +45,6 @@ class UGRNN_Node : public RNN_Node_Interface {
 
         int32_t get_number_weights() const;
 
-        void get_weights(vector<double> &parameters) const;
-        void set_weights(const vector<double> &parameters);
-
-        void get_weights(int32_t &offset, vector<double> &parameters) const;
-        void set_weights(int32_t &offset, const vector<double> &parameters);
-
-        void get_gradients(vector<double> &gradients);
-
         void reset(int32_t _series_length);
 
         void write_to_stream(ostream &out);
@@ -24,8 +24,8 @@ using std::vector;
 
 vector<string> arguments;
 
-vector<vector<vector<double> > > testing_inputs;
-vector<vector<vector<double> > > testing_outputs;
+vector<SeriesTensor> testing_inputs;
+vector<SeriesTensor> testing_outputs;
 
 int main(int argc, char** argv) {
     arguments = vector<string>(argv, argv + argc);
@@ -65,11 +65,14 @@ int main(int argc, char** argv) {
 
     time_series_sets->export_test_series(time_offset, testing_inputs, testing_outputs);
 
+    bool binary_predictions = argument_exists(arguments, "--binary_predictions");
+
     vector<double> best_parameters = genome->get_best_parameters();
     Log::info("MSE: %lf\n", genome->get_mse(best_parameters, testing_inputs, testing_outputs));
     Log::info("MAE: %lf\n", genome->get_mae(best_parameters, testing_inputs, testing_outputs));
     genome->write_predictions(
-        output_directory, testing_filenames, best_parameters, testing_inputs, testing_outputs, time_series_sets
+        output_directory, testing_filenames, best_parameters, testing_inputs, testing_outputs, time_series_sets,
+        binary_predictions
     );
 
     if (Log::at_level(Log::DEBUG)) {
@@ -90,7 +93,8 @@ int main(int argc, char** argv) {
             "duplicate MAE: %lf\n", duplicate_genome->get_mae(best_parameters_2, testing_inputs, testing_outputs)
         );
         duplicate_genome->write_predictions(
-            output_directory, testing_filenames, best_parameters_2, testing_inputs, testing_outputs, time_series_sets
+            output_directory, testing_filenames, best_parameters_2, testing_inputs, testing_outputs,
+            time_series_sets, binary_predictions
         );
     }
 
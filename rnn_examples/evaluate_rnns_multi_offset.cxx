@@ -59,8 +59,8 @@ using std::vector;
 
 vector<string> arguments;
 
-vector<vector<vector<double> > > testing_inputs;
-vector<vector<vector<double> > > testing_outputs;
+vector<SeriesTensor> testing_inputs;
+vector<SeriesTensor> testing_outputs;
 
 int main(int argc, char** argv) {
     arguments = vector<string>(argv, argv + argc);
@@ -26,10 +26,10 @@ using std::vector;
 #include "weights/weight_rules.hxx"
 #include "weights/weight_update.hxx"
 
-vector<vector<vector<double> > > training_inputs;
-vector<vector<vector<double> > > training_outputs;
-vector<vector<vector<double> > > test_inputs;
-vector<vector<vector<double> > > test_outputs;
+vector<SeriesTensor> training_inputs;
+vector<SeriesTensor> training_outputs;
+vector<SeriesTensor> test_inputs;
+vector<SeriesTensor> test_outputs;
 
 RNN_Genome* genome;
 RNN* rnn;
@@ -0,0 +1,116 @@
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include "common/arguments.hxx"
+#include "common/log.hxx"
+#include "rnn/mse.hxx"
+#include "rnn/rnn.hxx"
+#include "rnn/rnn_genome.hxx"
+#include "rnn/rnn_quantized.hxx"
+#include "time_series/time_series.hxx"
+
+vector<string> arguments;
+
+TimeSeriesSets* load_series(RNN_Genome* genome, const vector<string>& filenames) {
+    TimeSeriesSets* time_series_sets = TimeSeriesSets::generate_test(
+        filenames, genome->get_input_parameter_names(), genome->get_output_parameter_names()
+    );
+
+    string normalize_type = genome->get_normalize_type();
+    if (normalize_type.compare("min_max") == 0) {
+        time_series_sets->normalize_min_max(genome->get_normalize_mins(), genome->get_normalize_maxs());
+    } else if (normalize_type.compare("avg_std_dev") == 0) {
+        time_series_sets->normalize_avg_std_dev(
+            genome->get_normalize_avgs(), genome->get_normalize_std_devs(), genome->get_normalize_mins(),
+            genome->get_normalize_maxs()
+        );
+    }
+
+    return time_series_sets;
+}
+
+int main(int argc, char** argv) {
+    arguments = vector<string>(argv, argv + argc);
+
+    Log::initialize(arguments);
+    Log::set_id("main");
+
+    string genome_filename;
+    get_argument(arguments, "--genome_file", true, genome_filename);
+    RNN_Genome* genome = new RNN_Genome(genome_filename);
+
+    vector<string> validation_filenames;
+    get_argument_vector(arguments, "--validation_filenames", true, validation_filenames);
+
+    vector<string> testing_filenames;
+    get_argument_vector(arguments, "--testing_filenames", true, testing_filenames);
+
+    int32_t time_offset = 1;
+    get_argument(arguments, "--time_offset", true, time_offset);
+
+    vector<int32_t> bits;
+    if (!get_argument_vector(arguments, "--bits", false, bits)) bits = {16, 8};
+
+    vector<SeriesTensor> validation_inputs, validation_outputs;
+    TimeSeriesSets* validation_series = load_series(genome, validation_filenames);
+    validation_series->export_test_series(time_offset, validation_inputs, validation_outputs);
+
+    vector<SeriesTensor> testing_inputs, testing_outputs;
+    TimeSeriesSets* testing_series = load_series(genome, testing_filenames);
+    testing_series->export_test_series(time_offset, testing_inputs, testing_outputs);
+
+    vector<double> best_parameters = genome->get_best_parameters();
+    double mse = genome->get_mse(best_parameters, testing_inputs, testing_outputs);
+    double mae = genome->get_mae(best_parameters, testing_inputs, testing_outputs);
+    Log::info("double:  MSE: %lf, MAE: %lf\n", mse, mae);
+
+    RNN* rnn = genome->get_rnn();
+    rnn->set_weights(best_parameters);
+
+    for (int32_t i = 0; i < (int32_t)bits.size(); i++) {
+        RNN_Quantized quantized(rnn, bits[i], genome->get_use_dropout(), genome->get_dropout_probability());
+        quantized.calibrate(validation_inputs);
+
+        //the same error calculation as RNN_Genome::get_mse and get_mae: summed over the
+        //outputs and averaged over the series
+        double quantized_mse = 0.0;
+        double quantized_mae = 0.0;
+        for (int32_t j = 0; j < (int32_t)testing_inputs.size(); j++) {
+            vector<vector<double> > predictions;
+            quantized.predict(testing_inputs[j], predictions);
+
+            vector<vector<double> > expected;
+            testing_outputs[j].to_vectors(expected);
+
+            for (int32_t k = 0; k < (int32_t)expected.size(); k++) {
+                double error;
+                vector<double> deltas;
+
+                get_mse(predictions[k], expected[k], error, deltas);
+                quantized_mse += error;
+
+                get_mae(predictions[k], expected[k], error, deltas);
+                quantized_mae += error;
+            }
+        }
+        quantized_mse /= testing_inputs.size();
+        quantized_mae /= testing_inputs.size();
+
+        Log::info(
+            "%2d bits: MSE: %lf (%+lf), MAE: %lf (%+lf), %d weights in %d bytes (%d as doubles)\n", quantized.get_bits(),
+            quantized_mse, quantized_mse - mse, quantized_mae, quantized_mae - mae, quantized.get_number_weights(),
+            (int32_t)quantized.get_weight_bytes(), (int32_t)(quantized.get_number_weights() * sizeof(double))
+        );
+    }
+
+    delete rnn;
+    delete validation_series;
+    delete testing_series;
+    delete genome;
+
+    Log::release_id("main");
+    return 0;
+}
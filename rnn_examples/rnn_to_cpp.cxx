@@ -0,0 +1,50 @@
+#include <fstream>
+using std::ofstream;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include "common/arguments.hxx"
+#include "common/log.hxx"
+#include "rnn/rnn_code_generator.hxx"
+#include "rnn/rnn_genome.hxx"
+
+vector<string> arguments;
+
+int main(int argc, char** argv) {
+    arguments = vector<string>(argv, argv + argc);
+
+    Log::initialize(arguments);
+    Log::set_id("main");
+
+    string genome_filename;
+    get_argument(arguments, "--genome_file", true, genome_filename);
+
+    string output_filename;
+    get_argument(arguments, "--output_filename", true, output_filename);
+
+    string name_space = "examm_rnn";
+    get_argument(arguments, "--namespace", false, name_space);
+
+    RNN_Genome* genome = new RNN_Genome(genome_filename);
+
+    ofstream outfile(output_filename);
+    if (!outfile.is_open()) {
+        Log::fatal("ERROR: could not open '%s' to write the generated code to\n", output_filename.c_str());
+        exit(1);
+    }
+
+    RNN_Code_Generator generator(genome);
+    generator.write(outfile, name_space, genome_filename);
+    outfile.close();
+
+    Log::info("wrote genome '%s' to '%s' (namespace %s)\n", genome_filename.c_str(), output_filename.c_str(), name_space.c_str());
+
+    delete genome;
+
+    Log::release_id("main");
+    return 0;
+}
@@ -0,0 +1,299 @@
+/**
+ * Scores many genomes over many testing files at once, e.g.:
+ *
+ * ./rnn_examples/score_rnns --genome_filenames ./test_output/rnn_genome_*.bin
+ * --testing_filenames ../datasets/2018_coal/burner_1[01].csv --time_offset 1 --number_threads 8
+ * --scores_filename ./test_output/scores.csv --predictions_filename ./test_output/predictions.bin
+ *
+ * Genomes with the same input and output parameters and normalization share one loaded and
+ * normalized copy of the testing files, and the (genome, testing file) pairs are scored by a
+ * pool of threads. The scores file has the MSE and MAE of every pair.
+ *
+ * The predictions file is optional and binary: the 8 characters "EXAMMPRD", then the number
+ * of genomes and of testing files (int32), then a record for each pair as it finishes: the
+ * genome index, testing file index, number of outputs and number of time steps (int32),
+ * followed by the denormalized predictions (double), one output after another.
+ */
+
+#include <atomic>
+using std::atomic;
+
+#include <chrono>
+
+#include <cstdio>
+
+#include <iomanip>
+using std::setprecision;
+
+#include <map>
+using std::map;
+
+#include <mutex>
+using std::mutex;
+
+#include <sstream>
+using std::ostringstream;
+
+#include <string>
+using std::string;
+using std::to_string;
+
+#include <thread>
+using std::thread;
+
+#include <vector>
+using std::vector;
+
+#include "common/arguments.hxx"
+#include "common/log.hxx"
+#include "rnn/rnn.hxx"
+#include "rnn/rnn_genome.hxx"
+#include "time_series/time_series.hxx"
+
+vector<string> arguments;
+
+/**
+ * The testing files, loaded and normalized for the genomes which share input and output
+ * parameters and normalization.
+ */
+struct ScoringData {
+    vector<SeriesTensor> inputs;
+    vector<SeriesTensor> outputs;
+
+    // each output is denormalized with value * scale + offset
+    vector<double> denormalize_scales;
+    vector<double> denormalize_offsets;
+};
+
+vector<string> testing_filenames;
+int32_t time_offset = 1;
+
+vector<RNN_Genome*> genomes;
+vector<vector<double> > genome_parameters;
+vector<ScoringData*> genome_data;
+
+atomic<int32_t> next_pair(0);
+vector<double> pair_mses;
+vector<double> pair_maes;
+
+mutex predictions_mutex;
+FILE* predictions_file = NULL;
+
+string get_data_key(RNN_Genome* genome) {
+    ostringstream key;
+    key << setprecision(17) << genome->get_normalize_type();
+
+    vector<string> input_parameter_names = genome->get_input_parameter_names();
+    for (int32_t i = 0; i < (int32_t) input_parameter_names.size(); i++) {
+        key << ",input:" << input_parameter_names[i];
+    }
+
+    vector<string> output_parameter_names = genome->get_output_parameter_names();
+    for (int32_t i = 0; i < (int32_t) output_parameter_names.size(); i++) {
+        key << ",output:" << output_parameter_names[i];
+    }
+
+    vector<map<string, double> > normalize_values = {
+        genome->get_normalize_mins(), genome->get_normalize_maxs(), genome->get_normalize_avgs(),
+        genome->get_normalize_std_devs()};
+    for (int32_t i = 0; i < (int32_t) normalize_values.size(); i++) {
+        key << ";";
+        for (auto const& value : normalize_values[i]) {
+            key << "," << value.first << "=" << value.second;
+        }
+    }
+
+    return key.str();
+}
+
+ScoringData* load_scoring_data(RNN_Genome* genome) {
+    vector<string> output_parameter_names = genome->get_output_parameter_names();
+
+    TimeSeriesSets* time_series_sets = TimeSeriesSets::generate_test(
+        testing_filenames, genome->get_input_parameter_names(), output_parameter_names
+    );
+
+    string normalize_type = genome->get_normalize_type();
+    if (normalize_type.compare("min_max") == 0) {
+        time_series_sets->normalize_min_max(genome->get_normalize_mins(), genome->get_normalize_maxs());
+    } else if (normalize_type.compare("avg_std_dev") == 0) {
+        time_series_sets->normalize_avg_std_dev(
+            genome->get_normalize_avgs(), genome->get_normalize_std_devs(), genome->get_normalize_mins(),
+            genome->get_normalize_maxs()
+        );
+    }
+
+    ScoringData* data = new ScoringData();
+    time_series_sets->export_test_series(time_offset, data->inputs, data->outputs);
+
+    data->denormalize_scales.resize(output_parameter_names.size());
+    data->denormalize_offsets.resize(output_parameter_names.size());
+    for (int32_t i = 0; i < (int32_t) output_parameter_names.size(); i++) {
+        time_series_sets->get_denormalize_coefficients(
+            output_parameter_names[i], data->denormalize_scales[i], data->denormalize_offsets[i]
+        );
+    }
+
+    delete time_series_sets;
+    return data;
+}
+
+void score_thread(int32_t id) {
+    Log::set_id("thread_" + to_string(id));
+
+    int32_t number_files = (int32_t) testing_filenames.size();
+    int32_t number_pairs = (int32_t) genomes.size() * number_files;
+
+    // pairs are handed out genome by genome, so a thread can usually keep using the same RNN
+    RNN* rnn = NULL;
+    int32_t rnn_genome = -1;
+    vector<double> denormalized;
+
+    while (true) {
+        int32_t pair = next_pair++;
+        if (pair >= number_pairs) break;
+
+        int32_t genome = pair / number_files;
+        int32_t file = pair % number_files;
+
+        if (genome != rnn_genome) {
+            delete rnn;
+            rnn = genomes[genome]->get_rnn();
+            rnn->set_weights(genome_parameters[genome]);
+            rnn_genome = genome;
+        }
+
+        const ScoringData* data = genome_data[genome];
+        const SeriesTensor& expected = data->outputs[file];
+
+        //with the genome's dropout settings, as evaluate_rnn and RNN_Genome::get_mse use
+        vector<double> predictions = rnn->get_predictions(data->inputs[file], expected, genomes[genome]->get_use_dropout(), genomes[genome]->get_dropout_probability());
+        pair_mses[pair] = rnn->calculate_error_mse(expected);
+        pair_maes[pair] = rnn->calculate_error_mae(expected);
+
+        if (predictions_file != NULL) {
+            int32_t number_outputs = expected.get_number_parameters();
+            int32_t number_timesteps = expected.get_number_timesteps();
+
+            denormalized.resize((size_t) number_outputs * number_timesteps);
+            for (int32_t i = 0; i < number_outputs; i++) {
+                double scale = data->denormalize_scales[i];
+                double offset = data->denormalize_offsets[i];
+                for (int32_t j = 0; j < number_timesteps; j++) {
+                    denormalized[(size_t) i * number_timesteps + j] = predictions[(size_t) j * number_outputs + i] * scale + offset;
+                }
+            }
+
+            int32_t header[4] = {genome, file, number_outputs, number_timesteps};
+
+            predictions_mutex.lock();
+            fwrite(header, sizeof(int32_t), 4, predictions_file);
+            fwrite(denormalized.data(), sizeof(double), denormalized.size(), predictions_file);
+            predictions_mutex.unlock();
+        }
+    }
+
+    delete rnn;
+    Log::release_id("thread_" + to_string(id));
+}
+
+int main(int argc, char** argv) {
+    arguments = vector<string>(argv, argv + argc);
+
+    Log::initialize(arguments);
+    Log::set_id("main");
+
+    vector<string> genome_filenames;
+    get_argument_vector(arguments, "--genome_filenames", true, genome_filenames);
+    get_argument_vector(arguments, "--testing_filenames", true, testing_filenames);
+    get_argument(arguments, "--time_offset", false, time_offset);
+
+    int32_t number_threads = (int32_t) thread::hardware_concurrency();
+    get_argument(arguments, "--number_threads", false, number_threads);
+    if (number_threads < 1) number_threads = 1;
+
+    string scores_filename;
+    get_argument(arguments, "--scores_filename", true, scores_filename);
+
+    string predictions_filename;
+    get_argument(arguments, "--predictions_filename", false, predictions_filename);
+
+    auto start = std::chrono::steady_clock::now();
+
+    // load each distinct set of (normalized) testing data once
+    map<string, ScoringData*> data_cache;
+    for (int32_t i = 0; i < (int32_t) genome_filenames.size(); i++) {
+        Log::info("reading genome: %s\n", genome_filenames[i].c_str());
+        RNN_Genome* genome = new RNN_Genome(genome_filenames[i]);
+        genomes.push_back(genome);
+        genome_parameters.push_back(genome->get_best_parameters());
+
+        string key = get_data_key(genome);
+        if (data_cache.count(key) == 0) data_cache[key] = load_scoring_data(genome);
+        genome_data.push_back(data_cache[key]);
+    }
+    Log::info(
+        "loaded %d testing files for %d genomes (%d distinct parameter and normalization settings)\n",
+        (int32_t) testing_filenames.size(), (int32_t) genomes.size(), (int32_t) data_cache.size()
+    );
+
+    if (predictions_filename.compare("") != 0) {
+        predictions_file = fopen(predictions_filename.c_str(), "wb");
+        if (predictions_file == NULL) {
+            Log::fatal("ERROR: could not open predictions file '%s' for writing\n", predictions_filename.c_str());
+            exit(1);
+        }
+
+        int32_t counts[2] = {(int32_t) genomes.size(), (int32_t) testing_filenames.size()};
+        fwrite("EXAMMPRD", 1, 8, predictions_file);
+        fwrite(counts, sizeof(int32_t), 2, predictions_file);
+    }
+
+    int32_t number_pairs = (int32_t) (genomes.size() * testing_filenames.size());
+    pair_mses.assign(number_pairs, 0.0);
+    pair_maes.assign(number_pairs, 0.0);
+
+    vector<thread> threads;
+    for (int32_t i = 0; i < number_threads; i++) {
+        threads.push_back(thread(score_thread, i));
+    }
+
+    for (int32_t i = 0; i < number_threads; i++) {
+        threads[i].join();
+    }
+
+    if (predictions_file != NULL) fclose(predictions_file);
+
+    FILE* scores_file = fopen(scores_filename.c_str(), "w");
+    if (scores_file == NULL) {
+        Log::fatal("ERROR: could not open scores file '%s' for writing\n", scores_filename.c_str());
+        exit(1);
+    }
+
+    fprintf(scores_file, "#genome_file,testing_file,mse,mae\n");
+    for (int32_t i = 0; i < number_pairs; i++) {
+        int32_t genome = i / (int32_t) testing_filenames.size();
+        int32_t file = i % (int32_t) testing_filenames.size();
+        fprintf(
+            scores_file, "%s,%s,%.10lf,%.10lf\n", genome_filenames[genome].c_str(), testing_filenames[file].c_str(),
+            pair_mses[i], pair_maes[i]
+        );
+    }
+    fclose(scores_file);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    Log::info(
+        "scored %d genome and testing file pairs with %d threads in %lf seconds\n", number_pairs, number_threads,
+        seconds
+    );
+
+    for (auto const& data : data_cache) {
+        delete data.second;
+    }
+    for (int32_t i = 0; i < (int32_t) genomes.size(); i++) {
+        delete genomes[i];
+    }
+
+    Log::release_id("main");
+    return 0;
+}
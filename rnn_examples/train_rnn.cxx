@@ -24,18 +24,17 @@ using std::vector;
 #include "rnn/rnn_genome.hxx"
 #include "rnn/rnn_node.hxx"
 #include "rnn/rnn_node_interface.hxx"
+#include "time_series/sequence_windows.hxx"
 #include "time_series/time_series.hxx"
 #include "weights/weight_rules.hxx"
 #include "weights/weight_update.hxx"
 
-vector<vector<vector<double> > > training_inputs;
-vector<vector<vector<double> > > training_outputs;
-vector<vector<vector<double> > > test_inputs;
-vector<vector<vector<double> > > test_outputs;
+vector<SeriesTensor> training_inputs;
+vector<SeriesTensor> training_outputs;
+vector<SeriesTensor> test_inputs;
+vector<SeriesTensor> test_outputs;
 
-bool random_sequence_length;
-int32_t sequence_length_lower_bound = 30;
-int32_t sequence_length_upper_bound = 100;
+SequenceWindows* sequence_windows = NULL;
 
 RNN_Genome* genome;
 RNN* rnn;
@@ -215,14 +214,12 @@ int main(int argc, char** argv) {
 
     genome->disable_dropout();
 
-    random_sequence_length = argument_exists(arguments, "--random_sequence_length");
-    get_argument(arguments, "--sequence_length_lower_bound", false, sequence_length_lower_bound);
-    get_argument(arguments, "--sequence_length_upper_bound", false, sequence_length_upper_bound);
+    sequence_windows = SequenceWindows::generate_from_arguments(arguments);
 
     if (argument_exists(arguments, "--stochastic")) {
         Log::info("running stochastic back prop \n");
         genome->backpropagate_stochastic(
-            training_inputs, training_outputs, test_inputs, test_outputs, weight_update_method
+            training_inputs, training_outputs, test_inputs, test_outputs, weight_update_method, sequence_windows
         );
     } else {
         genome->backpropagate(training_inputs, training_outputs, test_inputs, test_outputs, weight_update_method);
@@ -0,0 +1,152 @@
+#include <algorithm>
+using std::find;
+
+#include <chrono>
+
+#include <cstdio>
+using std::fprintf;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include "common/arguments.hxx"
+#include "common/log.hxx"
+#include "rnn/rnn.hxx"
+#include "rnn/rnn_genome.hxx"
+#include "time_series/series_tensor.hxx"
+#include "weights/weight_rules.hxx"
+
+#include "rnn_test_genomes.hxx"
+
+void generate_random_series(int32_t number_parameters, int32_t series_length, int32_t layout, SeriesTensor &series) {
+    series = SeriesTensor(number_parameters, series_length, layout);
+    for (int32_t i = 0; i < number_parameters; i++) {
+        for (int32_t j = 0; j < series_length; j++) {
+            series.at(i, j) = rng(generator);
+        }
+    }
+}
+
+double elapsed_ns(std::chrono::time_point<std::chrono::steady_clock> start) {
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    vector<string> arguments = vector<string>(argv, argv + argc);
+
+    Log::initialize(arguments);
+    Log::set_id("main");
+
+    vector<int32_t> series_lengths;
+    vector<int32_t> hidden_nodes;
+    vector<int32_t> recurrent_depths;
+    vector<string> node_types;
+    int32_t hidden_layers = 1;
+    int32_t number_inputs = 4;
+    int32_t number_outputs = 1;
+    int32_t repeats = 10;
+    string output_filename = "rnn_benchmarks.json";
+
+    if (!get_argument_vector(arguments, "--series_lengths", false, series_lengths)) series_lengths = {50, 500};
+    if (!get_argument_vector(arguments, "--hidden_nodes", false, hidden_nodes)) hidden_nodes = {2, 8};
+    if (!get_argument_vector(arguments, "--recurrent_depths", false, recurrent_depths)) recurrent_depths = {1, 4};
+    get_argument_vector(arguments, "--node_types", false, node_types);
+    get_argument(arguments, "--hidden_layers", false, hidden_layers);
+    get_argument(arguments, "--number_inputs", false, number_inputs);
+    get_argument(arguments, "--number_outputs", false, number_outputs);
+    get_argument(arguments, "--repeats", false, repeats);
+    get_argument(arguments, "--output_file", false, output_filename);
+
+    WeightRules *weight_rules = new WeightRules();
+    weight_rules->generate_weight_initialize_from_arguments(arguments);
+
+    vector<string> input_parameter_names;
+    vector<string> output_parameter_names;
+    get_test_parameter_names(number_inputs, number_outputs, input_parameter_names, output_parameter_names);
+
+    FILE *output_file = fopen(output_filename.c_str(), "w");
+    if (output_file == NULL) {
+        Log::fatal("ERROR: could not open benchmark output file '%s'\n", output_filename.c_str());
+        exit(1);
+    }
+    fprintf(output_file, "[\n");
+    bool first_entry = true;
+
+    for (int32_t type = 0; type < NUMBER_TEST_TYPES; type++) {
+        if (node_types.size() > 0 && find(node_types.begin(), node_types.end(), TEST_TYPE_NAMES[type]) == node_types.end()) continue;
+
+        for (int32_t h = 0; h < (int32_t)hidden_nodes.size(); h++) {
+            for (int32_t d = 0; d < (int32_t)recurrent_depths.size(); d++) {
+                RNN_Genome *genome = TEST_CREATE_FUNCTIONS[type](input_parameter_names, hidden_layers, hidden_nodes[h], output_parameter_names, recurrent_depths[d], weight_rules);
+                genome->initialize_randomly();
+
+                vector<double> parameters;
+                genome->get_weights(parameters);
+                RNN *rnn = genome->get_rnn();
+                rnn->set_weights(parameters);
+                int32_t number_weights = rnn->get_number_weights();
+
+                for (int32_t s = 0; s < (int32_t)series_lengths.size(); s++) {
+                    int32_t series_length = series_lengths[s];
+                    SeriesTensor inputs, outputs;
+                    generate_random_series(number_inputs, series_length, SeriesTensor::TIME_MAJOR, inputs);
+                    generate_random_series(number_outputs, series_length, SeriesTensor::PARAMETER_MAJOR, outputs);
+
+                    //warm up the caches and size all the per timestep vectors
+                    rnn->forward_pass(inputs, false, true, 0.0);
+                    double error = rnn->calculate_error_mse(outputs);
+                    rnn->backward_pass(error * (1.0 / series_length) * 2.0, false, true, 0.0);
+
+                    double forward_ns = 0.0;
+                    double backward_ns = 0.0;
+                    double forward_backward_ns = 0.0;
+
+                    for (int32_t r = 0; r < repeats; r++) {
+                        auto start = std::chrono::steady_clock::now();
+                        rnn->forward_pass(inputs, false, true, 0.0);
+                        forward_ns += elapsed_ns(start);
+
+                        error = rnn->calculate_error_mse(outputs);
+
+                        start = std::chrono::steady_clock::now();
+                        rnn->backward_pass(error * (1.0 / series_length) * 2.0, false, true, 0.0);
+                        backward_ns += elapsed_ns(start);
+
+                        start = std::chrono::steady_clock::now();
+                        rnn->forward_pass(inputs, false, true, 0.0);
+                        error = rnn->calculate_error_mse(outputs);
+                        rnn->backward_pass(error * (1.0 / series_length) * 2.0, false, true, 0.0);
+                        forward_backward_ns += elapsed_ns(start);
+                    }
+
+                    double per_step_weight = (double)repeats * series_length * number_weights;
+
+                    Log::info("%-10s hidden: %3d, depth: %2d, length: %5d, weights: %6d, forward: %8.3lf ns, backward: %8.3lf ns, forward+backward: %8.3lf ns (per timestep per weight)\n",
+                            TEST_TYPE_NAMES[type].c_str(), hidden_nodes[h], recurrent_depths[d], series_length, number_weights,
+                            forward_ns / per_step_weight, backward_ns / per_step_weight, forward_backward_ns / per_step_weight);
+
+                    if (!first_entry) fprintf(output_file, ",\n");
+                    first_entry = false;
+                    fprintf(output_file, "  {\"node_type\": \"%s\", \"hidden_layers\": %d, \"hidden_nodes\": %d, \"recurrent_depth\": %d, \"series_length\": %d, \"number_weights\": %d, \"repeats\": %d, ",
+                            TEST_TYPE_NAMES[type].c_str(), hidden_layers, hidden_nodes[h], recurrent_depths[d], series_length, number_weights, repeats);
+                    fprintf(output_file, "\"forward_ns_per_step_weight\": %.4lf, \"backward_ns_per_step_weight\": %.4lf, \"forward_backward_ns_per_step_weight\": %.4lf}",
+                            forward_ns / per_step_weight, backward_ns / per_step_weight, forward_backward_ns / per_step_weight);
+                }
+
+                delete rnn;
+                delete genome;
+            }
+        }
+    }
+
+    fprintf(output_file, "\n]\n");
+    fclose(output_file);
+
+    Log::info("wrote benchmark results to '%s'\n", output_filename.c_str());
+    Log::release_id("main");
+
+    return 0;
+}
@@ -0,0 +1,28 @@
+#include <random>
+using std::minstd_rand0;
+using std::uniform_real_distribution;
+
+#include <string>
+using std::string;
+using std::to_string;
+
+#include <vector>
+using std::vector;
+
+#include "rnn/generate_nn.hxx"
+#include "rnn_test_genomes.hxx"
+
+const int32_t NUMBER_TEST_TYPES = 11;
+const int32_t NUMBER_FIXED_TEST_TYPES = 8;
+const string TEST_TYPE_NAMES[] = { "simple", "jordan", "elman", "UGRNN", "MGU", "GRU", "delta", "LSTM", "ENARC", "ENAS_DAG", "random_DAG" };
+const create_function TEST_CREATE_FUNCTIONS[] = { create_ff, create_jordan, create_elman, create_ugrnn, create_mgu, create_gru, create_delta, create_lstm, create_enarc, create_enas_dag, create_random_dag };
+
+minstd_rand0 generator(1337);
+uniform_real_distribution<double> rng(-0.5, 0.5);
+
+void get_test_parameter_names(int32_t number_inputs, int32_t number_outputs, vector<string> &input_parameter_names, vector<string> &output_parameter_names) {
+    input_parameter_names.clear();
+    for (int32_t i = 0; i < number_inputs; i++) input_parameter_names.push_back("input_" + to_string(i));
+    output_parameter_names.clear();
+    for (int32_t i = 0; i < number_outputs; i++) output_parameter_names.push_back("output_" + to_string(i));
+}
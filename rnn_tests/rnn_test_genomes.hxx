@@ -0,0 +1,37 @@
+#ifndef EXAMM_RNN_TEST_GENOMES
+#define EXAMM_RNN_TEST_GENOMES
+
+#include <random>
+using std::minstd_rand0;
+using std::uniform_real_distribution;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include "rnn/rnn_genome.hxx"
+#include "weights/weight_rules.hxx"
+
+typedef RNN_Genome* (*create_function)(const vector<string> &, int32_t, int32_t, const vector<string> &, int32_t, WeightRules*);
+
+/**
+ * One builder for each of the node types in generate_nn.cxx. The first
+ * NUMBER_FIXED_TEST_TYPES build their layers from a single fixed node type; the rest
+ * (ENARC, ENAS_DAG and random_DAG) are built from the DAG cell nodes.
+ */
+extern const int32_t NUMBER_TEST_TYPES;
+extern const int32_t NUMBER_FIXED_TEST_TYPES;
+extern const string TEST_TYPE_NAMES[];
+extern const create_function TEST_CREATE_FUNCTIONS[];
+
+/**
+ * Seeded with 1337, so the genomes and series the tests draw from it are the same every run.
+ */
+extern minstd_rand0 generator;
+extern uniform_real_distribution<double> rng;
+
+void get_test_parameter_names(int32_t number_inputs, int32_t number_outputs, vector<string> &input_parameter_names, vector<string> &output_parameter_names);
+
+#endif
@@ -0,0 +1,83 @@
+#include <cmath>
+using std::fabs;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include "common/log.hxx"
+#include "rnn/rnn.hxx"
+#include "rnn/rnn_genome.hxx"
+#include "time_series/series_tensor.hxx"
+
+#include "rnn_test_genomes.hxx"
+
+//written at build time by write_test_rnn_code
+#include "rnn_code_tests.hxx"
+
+/**
+ * Checks that the step functions RNN_Code_Generator wrote for the genomes in
+ * rnn_code_tests.hxx give exactly the same predictions as a forward pass of each genome
+ * with its best parameters, both with and without dropout.
+ */
+int main(int argc, char** argv) {
+    vector<string> arguments = vector<string>(argv, argv + argc);
+
+    Log::initialize(arguments);
+    Log::set_id("main");
+
+    int32_t series_length = 200;
+
+    int32_t failures = 0;
+    for (int32_t k = 0; k < NUMBER_RNN_CODE_TESTS; k++) {
+        RNN_Genome *genome = new RNN_Genome(RNN_CODE_TESTS[k].genome_filename);
+
+        int32_t number_inputs = genome->get_number_inputs();
+        int32_t number_outputs = genome->get_number_outputs();
+
+        //the test genomes are not normalized, so the generated code takes the same values
+        //as the forward pass
+        SeriesTensor inputs(number_inputs, series_length, SeriesTensor::TIME_MAJOR);
+        SeriesTensor outputs(number_outputs, series_length, SeriesTensor::PARAMETER_MAJOR);
+        vector<double> raw_inputs(series_length * number_inputs);
+        for (int32_t j = 0; j < series_length; j++) {
+            for (int32_t i = 0; i < number_inputs; i++) {
+                inputs.at(i, j) = rng(generator);
+                raw_inputs[j * number_inputs + i] = inputs(i, j);
+            }
+        }
+
+        RNN *rnn = genome->get_rnn();
+        rnn->set_weights(genome->get_best_parameters());
+        vector<double> expected = rnn->get_predictions(inputs, outputs, genome->get_use_dropout(), genome->get_dropout_probability());
+
+        vector<double> predictions(series_length * number_outputs);
+        RNN_CODE_TESTS[k].run(raw_inputs.data(), predictions.data(), series_length);
+
+        double max_difference = 0.0;
+        for (int32_t j = 0; j < series_length * number_outputs; j++) {
+            double difference = fabs(predictions[j] - expected[j]);
+            if (difference > max_difference) max_difference = difference;
+        }
+
+        if (max_difference > 0.0) {
+            Log::error("%-24s generated code predictions differ from the forward pass by up to %lg\n", RNN_CODE_TESTS[k].description, max_difference);
+            failures++;
+        } else {
+            Log::info("%-24s generated code predictions match the forward pass\n", RNN_CODE_TESTS[k].description);
+        }
+
+        delete rnn;
+        delete genome;
+    }
+
+    Log::release_id("main");
+
+    if (failures > 0) {
+        Log::error("%d generated code tests failed\n", failures);
+        return 1;
+    }
+    return 0;
+}
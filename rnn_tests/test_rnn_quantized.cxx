@@ -0,0 +1,114 @@
+#include <cmath>
+using std::fabs;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include "common/arguments.hxx"
+#include "common/log.hxx"
+#include "rnn/rnn.hxx"
+#include "rnn/rnn_genome.hxx"
+#include "rnn/rnn_quantized.hxx"
+#include "time_series/series_tensor.hxx"
+#include "weights/weight_rules.hxx"
+
+#include "rnn_test_genomes.hxx"
+
+//the largest difference allowed between the 16 bit and double precision predictions
+const double MAX_DIFFERENCE = 0.01;
+
+/**
+ * Checks that 16 bit RNN_Quantized predictions stay close to the double precision
+ * forward pass for every supported node type, a range of recurrent depths and with and
+ * without dropout, when calibrated on one series and run on another.
+ */
+int main(int argc, char** argv) {
+    vector<string> arguments = vector<string>(argv, argv + argc);
+
+    Log::initialize(arguments);
+    Log::set_id("main");
+
+    int32_t number_inputs = 3;
+    int32_t number_outputs = 2;
+    int32_t series_length = 200;
+
+    WeightRules *weight_rules = new WeightRules();
+    weight_rules->generate_weight_initialize_from_arguments(arguments);
+
+    vector<string> input_parameter_names;
+    vector<string> output_parameter_names;
+    get_test_parameter_names(number_inputs, number_outputs, input_parameter_names, output_parameter_names);
+
+    vector<SeriesTensor> calibration_inputs(1, SeriesTensor(number_inputs, series_length, SeriesTensor::TIME_MAJOR));
+    SeriesTensor inputs(number_inputs, series_length, SeriesTensor::TIME_MAJOR);
+    SeriesTensor outputs(number_outputs, series_length, SeriesTensor::PARAMETER_MAJOR);
+    for (int32_t j = 0; j < series_length; j++) {
+        for (int32_t i = 0; i < number_inputs; i++) {
+            calibration_inputs[0].at(i, j) = rng(generator);
+            inputs.at(i, j) = rng(generator);
+        }
+    }
+
+    int32_t failures = 0;
+    for (int32_t type = 0; type < NUMBER_FIXED_TEST_TYPES; type++) {
+        for (int32_t depth = 1; depth <= 5; depth += 2) {
+            RNN_Genome *genome = TEST_CREATE_FUNCTIONS[type](input_parameter_names, 2, 3, output_parameter_names, depth, weight_rules);
+
+            //weights from the seeded generator rather than initialize_randomly, so the
+            //networks (and how sensitive they are to rounding) are the same every run
+            vector<double> parameters;
+            genome->get_weights(parameters);
+            for (int32_t i = 0; i < (int32_t)parameters.size(); i++) parameters[i] = rng(generator);
+            RNN *rnn = genome->get_rnn();
+            rnn->set_weights(parameters);
+
+            //with dropout, predicting scales what the feed forward edges send
+            for (int32_t d = 0; d < 2; d++) {
+                bool using_dropout = (d == 1);
+                double dropout_probability = using_dropout ? 0.5 : 0.0;
+
+                vector<double> expected = rnn->get_predictions(inputs, outputs, using_dropout, dropout_probability);
+
+                double max_differences[2];
+                int32_t bits[2] = { 16, 8 };
+                for (int32_t k = 0; k < 2; k++) {
+                    RNN_Quantized quantized(rnn, bits[k], using_dropout, dropout_probability);
+                    quantized.calibrate(calibration_inputs);
+
+                    vector< vector<double> > predictions;
+                    quantized.predict(inputs, predictions);
+
+                    max_differences[k] = 0.0;
+                    for (int32_t j = 0; j < series_length; j++) {
+                        for (int32_t i = 0; i < number_outputs; i++) {
+                            double difference = fabs(predictions[i][j] - expected[j * number_outputs + i]);
+                            if (difference > max_differences[k]) max_differences[k] = difference;
+                        }
+                    }
+                }
+
+                if (max_differences[0] > MAX_DIFFERENCE) {
+                    Log::error("%-10s depth: %d, dropout: %.2lf, 16 bit predictions differ from the forward pass by up to %lg\n", TEST_TYPE_NAMES[type].c_str(), depth, dropout_probability, max_differences[0]);
+                    failures++;
+                } else {
+                    Log::info("%-10s depth: %d, dropout: %.2lf, predictions differ from the forward pass by up to %lg (16 bits), %lg (8 bits)\n", TEST_TYPE_NAMES[type].c_str(), depth, dropout_probability, max_differences[0], max_differences[1]);
+                }
+            }
+
+            delete rnn;
+            delete genome;
+        }
+    }
+
+    delete weight_rules;
+    Log::release_id("main");
+
+    if (failures > 0) {
+        Log::error("%d quantization tests failed\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <cmath>
+using std::fabs;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include "common/arguments.hxx"
+#include "common/log.hxx"
+#include "rnn/rnn.hxx"
+#include "rnn/rnn_genome.hxx"
+#include "rnn/rnn_stream.hxx"
+#include "time_series/series_tensor.hxx"
+#include "weights/weight_rules.hxx"
+
+#include "rnn_test_genomes.hxx"
+
+/**
+ * Checks that stepping an RNN_Stream through a series one time step at a time gives the
+ * same predictions as a forward pass over the whole series, for every node type the
+ * stream supports, a range of recurrent depths and with and without dropout, and that a
+ * reset stream starts the series over. DNAS nodes are rejected by the stream, and the
+ * tree has no generator for them, so they are not tested here.
+ */
+int main(int argc, char** argv) {
+    vector<string> arguments = vector<string>(argv, argv + argc);
+
+    Log::initialize(arguments);
+    Log::set_id("main");
+
+    int32_t number_inputs = 3;
+    int32_t number_outputs = 2;
+    int32_t series_length = 200;
+
+    WeightRules *weight_rules = new WeightRules();
+    weight_rules->generate_weight_initialize_from_arguments(arguments);
+
+    vector<string> input_parameter_names;
+    vector<string> output_parameter_names;
+    get_test_parameter_names(number_inputs, number_outputs, input_parameter_names, output_parameter_names);
+
+    SeriesTensor inputs(number_inputs, series_length, SeriesTensor::TIME_MAJOR);
+    SeriesTensor outputs(number_outputs, series_length, SeriesTensor::PARAMETER_MAJOR);
+    for (int32_t j = 0; j < series_length; j++) {
+        for (int32_t i = 0; i < number_inputs; i++) inputs.at(i, j) = rng(generator);
+    }
+
+    int32_t failures = 0;
+    for (int32_t type = 0; type < NUMBER_TEST_TYPES; type++) {
+        for (int32_t depth = 1; depth <= 5; depth += 2) {
+            RNN_Genome *genome = TEST_CREATE_FUNCTIONS[type](input_parameter_names, 2, 3, output_parameter_names, depth, weight_rules);
+            genome->initialize_randomly();
+
+            vector<double> parameters;
+            genome->get_weights(parameters);
+            RNN *rnn = genome->get_rnn();
+            rnn->set_weights(parameters);
+
+            //with dropout, predicting scales what the feed forward edges send
+            for (int32_t d = 0; d < 2; d++) {
+                bool using_dropout = (d == 1);
+                double dropout_probability = using_dropout ? 0.5 : 0.0;
+
+                vector<double> expected = rnn->get_predictions(inputs, outputs, using_dropout, dropout_probability);
+
+                RNN_Stream stream(rnn, using_dropout, dropout_probability);
+                double max_difference = 0.0;
+                for (int32_t pass = 0; pass < 2; pass++) {
+                    vector<double> row(number_inputs);
+                    vector<double> predictions;
+                    for (int32_t j = 0; j < series_length; j++) {
+                        for (int32_t i = 0; i < number_inputs; i++) row[i] = inputs(i, j);
+                        stream.step(row, predictions);
+
+                        for (int32_t i = 0; i < number_outputs; i++) {
+                            double difference = fabs(predictions[i] - expected[j * number_outputs + i]);
+                            if (difference > max_difference) max_difference = difference;
+                        }
+                    }
+                    stream.reset();
+                }
+
+                if (max_difference > 0.0) {
+                    Log::error("%-10s depth: %d, dropout: %.2lf, streamed predictions differ from the forward pass by up to %lg\n", TEST_TYPE_NAMES[type].c_str(), depth, dropout_probability, max_difference);
+                    failures++;
+                } else {
+                    Log::info("%-10s depth: %d, dropout: %.2lf, streamed predictions match the forward pass\n", TEST_TYPE_NAMES[type].c_str(), depth, dropout_probability);
+                }
+            }
+
+            delete rnn;
+            delete genome;
+        }
+    }
+
+    delete weight_rules;
+    Log::release_id("main");
+
+    if (failures > 0) {
+        Log::error("%d streaming tests failed\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include <fstream>
+using std::endl;
+using std::ofstream;
+
+#include <string>
+using std::string;
+using std::to_string;
+
+#include <vector>
+using std::vector;
+
+#include "common/arguments.hxx"
+#include "common/files.hxx"
+#include "common/log.hxx"
+#include "rnn/rnn_code_generator.hxx"
+#include "rnn/rnn_genome.hxx"
+#include "weights/weight_rules.hxx"
+
+#include "rnn_test_genomes.hxx"
+
+/**
+ * Writes the genomes test_rnn_code_generator checks, and the code RNN_Code_Generator
+ * generates for them, to --code_directory: genome_<n>.bin and rnn_code_<n>.hxx for each
+ * node type the generator supports, a range of recurrent depths and with and without
+ * dropout, and rnn_code_tests.hxx, which includes all of the generated code and has a
+ * table of the genomes with a function running each one's step over a series.
+ */
+int main(int argc, char** argv) {
+    vector<string> arguments = vector<string>(argv, argv + argc);
+
+    Log::initialize(arguments);
+    Log::set_id("main");
+
+    string code_directory;
+    get_argument(arguments, "--code_directory", true, code_directory);
+    mkpath(code_directory.c_str(), 0777);
+
+    int32_t number_inputs = 3;
+    int32_t number_outputs = 2;
+
+    WeightRules *weight_rules = new WeightRules();
+    weight_rules->generate_weight_initialize_from_arguments(arguments);
+
+    vector<string> input_parameter_names;
+    vector<string> output_parameter_names;
+    get_test_parameter_names(number_inputs, number_outputs, input_parameter_names, output_parameter_names);
+
+    string tests_filename = code_directory + "/rnn_code_tests.hxx";
+    ofstream tests(tests_filename);
+    if (!tests.is_open()) {
+        Log::fatal("ERROR: could not open '%s' to write the generated code tests to\n", tests_filename.c_str());
+        exit(1);
+    }
+
+    tests << "//generated by write_test_rnn_code, do not edit" << endl;
+    tests << "#ifndef RNN_CODE_TESTS_HXX" << endl;
+    tests << "#define RNN_CODE_TESTS_HXX" << endl;
+    tests << endl;
+
+    vector<string> genome_filenames;
+    vector<string> descriptions;
+    for (int32_t type = 0; type < NUMBER_FIXED_TEST_TYPES; type++) {
+        for (int32_t depth = 1; depth <= 3; depth += 2) {
+            for (int32_t d = 0; d < 2; d++) {
+                RNN_Genome *genome = TEST_CREATE_FUNCTIONS[type](input_parameter_names, 2, 3, output_parameter_names, depth, weight_rules);
+                if (d == 1) genome->enable_dropout(0.5);
+
+                //weights from the seeded generator, so the genomes are the same every build
+                vector<double> parameters;
+                genome->get_weights(parameters);
+                for (int32_t i = 0; i < (int32_t)parameters.size(); i++) parameters[i] = rng(generator);
+                genome->set_best_parameters(parameters);
+
+                int32_t n = (int32_t)genome_filenames.size();
+                string genome_filename = code_directory + "/genome_" + to_string(n) + ".bin";
+                genome->write_to_file(genome_filename);
+
+                string code_filename = code_directory + "/rnn_code_" + to_string(n) + ".hxx";
+                ofstream code(code_filename);
+                if (!code.is_open()) {
+                    Log::fatal("ERROR: could not open '%s' to write the generated code to\n", code_filename.c_str());
+                    exit(1);
+                }
+
+                RNN_Code_Generator code_generator(genome);
+                code_generator.write(code, "rnn_code_" + to_string(n), genome_filename);
+                code.close();
+
+                genome_filenames.push_back(genome_filename);
+                descriptions.push_back(TEST_TYPE_NAMES[type] + " depth: " + to_string(depth) + (d == 1 ? ", dropout" : ""));
+
+                tests << "#include \"rnn_code_" << n << ".hxx\"" << endl;
+                tests << "inline void run_rnn_code_" << n << "(const double *inputs, double *outputs, int length) {" << endl;
+                tests << "    rnn_code_" << n << "::State state{};" << endl;
+                tests << "    for (int t = 0; t < length; t++) {" << endl;
+                tests << "        rnn_code_" << n << "::step(state, inputs + (t * rnn_code_" << n << "::number_inputs), outputs + (t * rnn_code_" << n << "::number_outputs));" << endl;
+                tests << "    }" << endl;
+                tests << "}" << endl;
+                tests << endl;
+
+                delete genome;
+            }
+        }
+    }
+
+    tests << "struct RNN_Code_Test {" << endl;
+    tests << "    const char *description;" << endl;
+    tests << "    const char *genome_filename;" << endl;
+    tests << "    void (*run)(const double *inputs, double *outputs, int length);" << endl;
+    tests << "};" << endl;
+    tests << endl;
+
+    tests << "const int NUMBER_RNN_CODE_TESTS = " << genome_filenames.size() << ";" << endl;
+    tests << "const RNN_Code_Test RNN_CODE_TESTS[NUMBER_RNN_CODE_TESTS] = {";
+    for (int32_t i = 0; i < (int32_t)genome_filenames.size(); i++) {
+        tests << (i == 0 ? "" : ",") << endl << "    { \"" << descriptions[i] << "\", \"" << genome_filenames[i] << "\", run_rnn_code_" << i << " }";
+    }
+    tests << endl << "};" << endl;
+    tests << endl;
+    tests << "#endif" << endl;
+    tests.close();
+
+    Log::info("wrote %d genomes and their generated code to '%s'\n", (int32_t)genome_filenames.size(), code_directory.c_str());
+
+    delete weight_rules;
+    Log::release_id("main");
+
+    return 0;
+}
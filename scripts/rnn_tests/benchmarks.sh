@@ -0,0 +1,6 @@
+#!/bin/sh
+# Times the forward and backward passes of every node type over a grid of series lengths,
+# hidden node counts and recurrent depths. Results (in ns per timestep per weight) are
+# written to a json file which can be diffed between commits.
+
+./build/rnn_tests/rnn_benchmarks --output_directory results_benchmarks --output_file rnn_benchmarks.json --series_lengths 50 500 --hidden_nodes 2 8 --recurrent_depths 1 4 --repeats 10 --std_message_level INFO --file_message_level NONE
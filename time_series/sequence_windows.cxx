@@ -0,0 +1,83 @@
+#include <algorithm>
+using std::min;
+
+#include <random>
+using std::minstd_rand0;
+using std::uniform_int_distribution;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include "common/arguments.hxx"
+#include "common/log.hxx"
+#include "sequence_windows.hxx"
+
+SequenceWindows::SequenceWindows(int32_t _lower_bound, int32_t _upper_bound)
+    : lower_bound(_lower_bound), upper_bound(_upper_bound) {
+    if (lower_bound < 1 || upper_bound < lower_bound) {
+        Log::fatal(
+            "ERROR: invalid sequence length bounds, lower bound: %d, upper bound: %d (need 1 <= lower <= upper)\n",
+            lower_bound, upper_bound
+        );
+        exit(1);
+    }
+}
+
+SequenceWindows* SequenceWindows::generate_from_arguments(const vector<string>& arguments) {
+    if (!argument_exists(arguments, "--random_sequence_length")) {
+        return NULL;
+    }
+
+    int32_t lower_bound = 30;
+    int32_t upper_bound = 100;
+    get_argument(arguments, "--sequence_length_lower_bound", false, lower_bound);
+    get_argument(arguments, "--sequence_length_upper_bound", false, upper_bound);
+
+    Log::info("Training on random sequence windows of length %d to %d, resampled every epoch\n", lower_bound, upper_bound);
+    return new SequenceWindows(lower_bound, upper_bound);
+}
+
+int32_t SequenceWindows::get_lower_bound() const {
+    return lower_bound;
+}
+
+int32_t SequenceWindows::get_upper_bound() const {
+    return upper_bound;
+}
+
+void SequenceWindows::sample(
+    minstd_rand0& generator, const vector<SeriesTensor>& inputs, const vector<SeriesTensor>& outputs,
+    vector<SeriesTensor>& window_inputs, vector<SeriesTensor>& window_outputs
+) const {
+    window_inputs.clear();
+    window_outputs.clear();
+
+    uniform_int_distribution<int32_t> length_distribution(lower_bound, upper_bound);
+
+    for (int32_t i = 0; i < (int32_t) inputs.size(); i++) {
+        int32_t number_timesteps = inputs[i].get_number_timesteps();
+        if (number_timesteps <= lower_bound) {
+            window_inputs.push_back(inputs[i]);
+            window_outputs.push_back(outputs[i]);
+            continue;
+        }
+
+        // the first window starts somewhere within what would have been its length, so the
+        // windows do not always line up with the start of the series
+        int32_t length = length_distribution(generator);
+        uniform_int_distribution<int32_t> offset_distribution(0, min(length - 1, number_timesteps - lower_bound));
+        int32_t start = offset_distribution(generator);
+
+        while (start + lower_bound <= number_timesteps) {
+            length = min(length, number_timesteps - start);
+            window_inputs.push_back(inputs[i].slice_time(start, length));
+            window_outputs.push_back(outputs[i].slice_time(start, length));
+
+            start += length;
+            length = length_distribution(generator);
+        }
+    }
+}
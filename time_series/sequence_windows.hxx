@@ -0,0 +1,50 @@
+#ifndef EXAMM_SEQUENCE_WINDOWS_HXX
+#define EXAMM_SEQUENCE_WINDOWS_HXX
+
+#include <random>
+using std::minstd_rand0;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include "series_tensor.hxx"
+
+/**
+ * Randomly sized windows over the training series, drawn anew for each training epoch
+ * (as opposed to --sequence_length, which cuts the series into the same fixed length
+ * windows once). Each series is cut into consecutive windows with lengths uniformly
+ * distributed in [lower_bound, upper_bound], starting from a random offset so the
+ * window boundaries move between epochs. Windows are views of the series, so
+ * resampling them does not copy any data.
+ */
+class SequenceWindows {
+   private:
+    int32_t lower_bound;
+    int32_t upper_bound;
+
+   public:
+    SequenceWindows(int32_t _lower_bound, int32_t _upper_bound);
+
+    /**
+     * \return windows using the --sequence_length_lower_bound and --sequence_length_upper_bound
+     * arguments if --random_sequence_length was given, NULL otherwise
+     */
+    static SequenceWindows* generate_from_arguments(const vector<string>& arguments);
+
+    int32_t get_lower_bound() const;
+    int32_t get_upper_bound() const;
+
+    /**
+     * Replaces window_inputs and window_outputs with a new set of windows over the
+     * inputs and outputs. Series shorter than lower_bound are used whole.
+     */
+    void sample(
+        minstd_rand0& generator, const vector<SeriesTensor>& inputs, const vector<SeriesTensor>& outputs,
+        vector<SeriesTensor>& window_inputs, vector<SeriesTensor>& window_outputs
+    ) const;
+};
+
+#endif
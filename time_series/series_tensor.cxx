@@ -0,0 +1,140 @@
+#include <cstdlib>
+
+#include <memory>
+using std::make_shared;
+
+#include <vector>
+using std::vector;
+
+#include "common/log.hxx"
+#include "series_tensor.hxx"
+
+const int32_t SeriesTensor::PARAMETER_MAJOR;
+const int32_t SeriesTensor::TIME_MAJOR;
+
+SeriesTensor::SeriesTensor()
+    : data(NULL), number_parameters(0), number_timesteps(0), parameter_stride(0), time_stride(0) {
+}
+
+SeriesTensor::SeriesTensor(int32_t _number_parameters, int32_t _number_timesteps, int32_t layout)
+    : number_parameters(_number_parameters), number_timesteps(_number_timesteps) {
+    storage = make_shared<vector<double> >((size_t) number_parameters * number_timesteps, 0.0);
+    data = storage->data();
+
+    if (layout == TIME_MAJOR) {
+        parameter_stride = 1;
+        time_stride = number_parameters;
+    } else {
+        parameter_stride = number_timesteps;
+        time_stride = 1;
+    }
+}
+
+SeriesTensor::SeriesTensor(const vector<vector<double> >& series, int32_t layout)
+    : SeriesTensor((int32_t) series.size(), series.size() > 0 ? (int32_t) series[0].size() : 0, layout) {
+    for (int32_t i = 0; i < number_parameters; i++) {
+        if ((int32_t) series[i].size() != number_timesteps) {
+            Log::fatal(
+                "ERROR: creating series tensor, parameter %d had %d time steps but parameter 0 had %d\n", i,
+                (int32_t) series[i].size(), number_timesteps
+            );
+            exit(1);
+        }
+
+        for (int32_t j = 0; j < number_timesteps; j++) {
+            at(i, j) = series[i][j];
+        }
+    }
+}
+
+SeriesTensor SeriesTensor::view(
+    const double* data, int32_t number_parameters, int32_t number_timesteps, int32_t parameter_stride,
+    int32_t time_stride
+) {
+    SeriesTensor tensor;
+    tensor.data = const_cast<double*>(data);
+    tensor.number_parameters = number_parameters;
+    tensor.number_timesteps = number_timesteps;
+    tensor.parameter_stride = parameter_stride;
+    tensor.time_stride = time_stride;
+    return tensor;
+}
+
+void SeriesTensor::from_vectors(
+    const vector<vector<vector<double> > >& series, vector<SeriesTensor>& tensors, int32_t layout
+) {
+    tensors.clear();
+    tensors.reserve(series.size());
+    for (int32_t i = 0; i < (int32_t) series.size(); i++) {
+        tensors.push_back(SeriesTensor(series[i], layout));
+    }
+}
+
+int32_t SeriesTensor::get_number_parameters() const {
+    return number_parameters;
+}
+
+int32_t SeriesTensor::get_number_timesteps() const {
+    return number_timesteps;
+}
+
+int32_t SeriesTensor::get_parameter_stride() const {
+    return parameter_stride;
+}
+
+int32_t SeriesTensor::get_time_stride() const {
+    return time_stride;
+}
+
+bool SeriesTensor::is_view() const {
+    return storage == NULL;
+}
+
+SeriesTensor SeriesTensor::slice_time(int32_t start, int32_t length) const {
+    if (start < 0 || length < 0 || start + length > number_timesteps) {
+        Log::fatal(
+            "ERROR: slicing time steps [%d, %d) from a series tensor with %d time steps\n", start, start + length,
+            number_timesteps
+        );
+        exit(1);
+    }
+
+    SeriesTensor slice = *this;
+    slice.data = data + (size_t) start * time_stride;
+    slice.number_timesteps = length;
+    return slice;
+}
+
+SeriesTensor SeriesTensor::slice_parameters(int32_t start, int32_t count) const {
+    if (start < 0 || count < 0 || start + count > number_parameters) {
+        Log::fatal(
+            "ERROR: slicing parameters [%d, %d) from a series tensor with %d parameters\n", start, start + count,
+            number_parameters
+        );
+        exit(1);
+    }
+
+    SeriesTensor slice = *this;
+    slice.data = data + (size_t) start * parameter_stride;
+    slice.number_parameters = count;
+    return slice;
+}
+
+SeriesTensor SeriesTensor::copy(int32_t layout) const {
+    SeriesTensor tensor(number_parameters, number_timesteps, layout);
+    for (int32_t i = 0; i < number_parameters; i++) {
+        for (int32_t j = 0; j < number_timesteps; j++) {
+            tensor.at(i, j) = (*this)(i, j);
+        }
+    }
+    return tensor;
+}
+
+void SeriesTensor::to_vectors(vector<vector<double> >& series) const {
+    series.assign(number_parameters, vector<double>(number_timesteps));
+    for (int32_t i = 0; i < number_parameters; i++) {
+        for (int32_t j = 0; j < number_timesteps; j++) {
+            series[i][j] = (*this)(i, j);
+        }
+    }
+}
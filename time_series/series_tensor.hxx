@@ -0,0 +1,106 @@
+#ifndef EXAMM_SERIES_TENSOR_HXX
+#define EXAMM_SERIES_TENSOR_HXX
+
+#include <cstdint>
+
+#include <memory>
+using std::shared_ptr;
+
+#include <vector>
+using std::vector;
+
+/**
+ * A single time series as a contiguous [parameter][time] or [time][parameter] block of
+ * doubles. Element (p, t) is at data[p * parameter_stride + t * time_stride], so the
+ * same type can describe either layout, as well as non-owning views (slices of another
+ * tensor, or memory owned by something else such as an MPI shared memory window).
+ *
+ * Copies are cheap: tensors which own their storage share it through a shared_ptr, and
+ * slices keep a reference to it so they remain valid after the original goes away.
+ */
+class SeriesTensor {
+   private:
+    shared_ptr<vector<double> > storage;
+    double* data;
+
+    int32_t number_parameters;
+    int32_t number_timesteps;
+    int32_t parameter_stride;
+    int32_t time_stride;
+
+   public:
+    /**
+     * [parameter][time]: each parameter's values are contiguous
+     */
+    static const int32_t PARAMETER_MAJOR = 0;
+
+    /**
+     * [time][parameter]: all of the parameter values at a time step are contiguous
+     */
+    static const int32_t TIME_MAJOR = 1;
+
+    SeriesTensor();
+
+    /**
+     * Allocates a zeroed tensor.
+     */
+    SeriesTensor(int32_t _number_parameters, int32_t _number_timesteps, int32_t layout);
+
+    /**
+     * Copies a [parameter][time] nested vector into a newly allocated tensor; every
+     * parameter must have the same number of time steps.
+     */
+    SeriesTensor(const vector<vector<double> >& series, int32_t layout = PARAMETER_MAJOR);
+
+    /**
+     * \return a tensor which does not own its data, for memory which will outlive it
+     */
+    static SeriesTensor view(
+        const double* data, int32_t number_parameters, int32_t number_timesteps, int32_t parameter_stride,
+        int32_t time_stride
+    );
+
+    /**
+     * Copies each of the [series][parameter][time] nested vectors into a tensor.
+     */
+    static void from_vectors(
+        const vector<vector<vector<double> > >& series, vector<SeriesTensor>& tensors, int32_t layout
+    );
+
+    inline double operator()(int32_t parameter, int32_t time) const {
+        return data[parameter * parameter_stride + time * time_stride];
+    }
+
+    inline double& at(int32_t parameter, int32_t time) {
+        return data[parameter * parameter_stride + time * time_stride];
+    }
+
+    int32_t get_number_parameters() const;
+    int32_t get_number_timesteps() const;
+    int32_t get_parameter_stride() const;
+    int32_t get_time_stride() const;
+
+    /**
+     * \return true if this tensor does not own (or share ownership of) its data
+     */
+    bool is_view() const;
+
+    /**
+     * \return a view of time steps [start, start + length) of every parameter
+     */
+    SeriesTensor slice_time(int32_t start, int32_t length) const;
+
+    /**
+     * \return a view of parameters [start, start + count) over every time step
+     */
+    SeriesTensor slice_parameters(int32_t start, int32_t count) const;
+
+    /**
+     * \return a newly allocated copy of this tensor (or view) in the given layout
+     */
+    SeriesTensor copy(int32_t layout) const;
+
+    void to_vectors(vector<vector<double> >& series) const;
+};
+
+#endif
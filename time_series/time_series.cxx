@@ -885,41 +885,47 @@ TimeSeriesSets* TimeSeriesSets::generate_test(
     return tss;
 }
 
-double TimeSeriesSets::denormalize(string field_name, double value) {
+void TimeSeriesSets::get_denormalize_coefficients(string field_name, double& scale, double& offset) const {
     if (normalize_type.compare("none") == 0) {
-        return value;
-    } else if (normalize_type.compare("min_max") == 0) {
-        double min = normalize_mins[field_name];
-        double max = normalize_maxs[field_name];
+        scale = 1.0;
+        offset = 0.0;
 
-        value = (value * (max - min)) + min;
+    } else if (normalize_type.compare("min_max") == 0) {
+        double min = normalize_mins.at(field_name);
+        double max = normalize_maxs.at(field_name);
 
-        return value;
+        scale = max - min;
+        offset = min;
 
     } else if (normalize_type.compare("avg_std_dev") == 0) {
-        double min = normalize_mins[field_name];
-        double max = normalize_maxs[field_name];
-        double avg = normalize_avgs[field_name];
-        double std_dev = normalize_std_devs[field_name];
+        double min = normalize_mins.at(field_name);
+        double max = normalize_maxs.at(field_name);
+        double avg = normalize_avgs.at(field_name);
+        double std_dev = normalize_std_devs.at(field_name);
 
         double norm_min = (min - avg) / std_dev;
         double norm_max = (max - avg) / std_dev;
 
         norm_max = fmax(norm_min, norm_max);
 
-        value = (value * norm_max * std_dev) + avg;
-
-        return value;
+        scale = norm_max * std_dev;
+        offset = avg;
 
     } else {
         Log::fatal(
-            "Unknown normalize type on denormalize for '%s' and '%lf', '%s', this should never happen.\n",
-            field_name.c_str(), value, normalize_type.c_str()
+            "Unknown normalize type on denormalize for '%s', '%s', this should never happen.\n", field_name.c_str(),
+            normalize_type.c_str()
         );
         exit(1);
     }
 }
 
+double TimeSeriesSets::denormalize(string field_name, double value) {
+    double scale, offset;
+    get_denormalize_coefficients(field_name, scale, offset);
+    return (value * scale) + offset;
+}
+
 void TimeSeriesSets::normalize_min_max() {
     Log::info("doing min/max normalization:\n");
 
@@ -1165,21 +1171,25 @@ void TimeSeriesSets::normalize_avg_std_dev(
  * initially loaded that are to be exported
  */
 void TimeSeriesSets::export_time_series(
-    const vector<int>& series_indexes, int32_t time_offset, vector<vector<vector<double> > >& inputs,
-    vector<vector<vector<double> > >& outputs
+    const vector<int>& series_indexes, int32_t time_offset, vector<SeriesTensor>& inputs,
+    vector<SeriesTensor>& outputs
 ) {
     inputs.resize(series_indexes.size());
     outputs.resize(series_indexes.size());
 
+    vector<vector<double> > series;
     for (int32_t i = 0; i < (int32_t) series_indexes.size(); i++) {
         int32_t series_index = series_indexes[i];
 
         time_series[series_index]->export_time_series(
-            inputs[i], input_parameter_names, shift_parameter_names, -time_offset
+            series, input_parameter_names, shift_parameter_names, -time_offset
         );
+        inputs[i] = SeriesTensor(series, SeriesTensor::TIME_MAJOR);
+
         time_series[series_index]->export_time_series(
-            outputs[i], output_parameter_names, shift_parameter_names, time_offset
+            series, output_parameter_names, shift_parameter_names, time_offset
         );
+        outputs[i] = SeriesTensor(series, SeriesTensor::PARAMETER_MAJOR);
     }
 }
 
@@ -1187,7 +1197,7 @@ void TimeSeriesSets::export_time_series(
  * This exports the time series marked as training series by the training_indexes vector.
  */
 void TimeSeriesSets::export_training_series(
-    int32_t time_offset, vector<vector<vector<double> > >& inputs, vector<vector<vector<double> > >& outputs
+    int32_t time_offset, vector<SeriesTensor>& inputs, vector<SeriesTensor>& outputs
 ) {
     if (training_indexes.size() == 0) {
         Log::fatal(
@@ -1202,9 +1212,7 @@ void TimeSeriesSets::export_training_series(
 /**
  * This exports the time series marked as test series by the test_indexes vector.
  */
-void TimeSeriesSets::export_test_series(
-    int32_t time_offset, vector<vector<vector<double> > >& inputs, vector<vector<vector<double> > >& outputs
-) {
+void TimeSeriesSets::export_test_series(int32_t time_offset, vector<SeriesTensor>& inputs, vector<SeriesTensor>& outputs) {
     if (test_indexes.size() == 0) {
         Log::fatal("ERROR: attempting to export test time series, however the test_indexes were not specified.\n");
         exit(1);
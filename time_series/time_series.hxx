@@ -13,6 +13,8 @@ using std::map;
 #include <vector>
 using std::vector;
 
+#include "series_tensor.hxx"
+
 class TimeSeries {
    private:
     string name;
@@ -163,21 +165,26 @@ class TimeSeriesSets {
 
     void write_time_series_sets(string base_filename);
 
+    /**
+     * Inputs are exported time major (as the RNN reads every input at each time step) and
+     * outputs parameter major (as the errors are calculated one output at a time).
+     */
     void export_time_series(
-        const vector<int>& series_indexes, int32_t time_offset, vector<vector<vector<double> > >& inputs,
-        vector<vector<vector<double> > >& outputs
+        const vector<int>& series_indexes, int32_t time_offset, vector<SeriesTensor>& inputs,
+        vector<SeriesTensor>& outputs
     );
 
-    void export_training_series(
-        int32_t time_offset, vector<vector<vector<double> > >& inputs, vector<vector<vector<double> > >& outputs
-    );
+    void export_training_series(int32_t time_offset, vector<SeriesTensor>& inputs, vector<SeriesTensor>& outputs);
 
-    void export_test_series(
-        int32_t time_offset, vector<vector<vector<double> > >& inputs, vector<vector<vector<double> > >& outputs
-    );
+    void export_test_series(int32_t time_offset, vector<SeriesTensor>& inputs, vector<SeriesTensor>& outputs);
 
     void export_series_by_name(string field_name, vector<vector<double> >& exported_series);
 
+    /**
+     * Every normalization is linear, so a field's values are denormalized with
+     * value * scale + offset; getting these once avoids looking the field up for every value.
+     */
+    void get_denormalize_coefficients(string field_name, double& scale, double& offset) const;
     double denormalize(string field_name, double value);
 
     string get_normalize_type() const;
@@ -0,0 +1,75 @@
+#include <cstdlib>
+
+#include <map>
+using std::map;
+
+#include <mutex>
+using std::mutex;
+using std::unique_lock;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+#include "weights/shared_weight_store.hxx"
+#include "common/log.hxx"
+
+SharedWeightStore::SharedWeightStore(SharedWeightPolicy _policy) : policy(_policy), number_updates(0) {
+}
+
+SharedWeightPolicy SharedWeightStore::get_policy_from_string(string policy_name) {
+    if (policy_name.compare("recent") == 0) {
+        return SHARED_WEIGHTS_RECENT;
+    } else if (policy_name.compare("average") == 0) {
+        return SHARED_WEIGHTS_AVERAGE;
+    } else {
+        Log::fatal("ERROR: unknown shared weight policy '%s', options are 'recent' and 'average'\n", policy_name.c_str());
+        exit(1);
+    }
+}
+
+SharedWeightPolicy SharedWeightStore::get_policy() const {
+    return policy;
+}
+
+void SharedWeightStore::update(SharedWeightComponent component, int32_t innovation_number, int32_t n_weights, int32_t current, const vector<double> &parameters) {
+    unique_lock<mutex> lock(store_mutex);
+    number_updates++;
+
+    SharedWeights &shared = component_weights[component][innovation_number];
+    if (policy == SHARED_WEIGHTS_RECENT || (int32_t)shared.weights.size() != n_weights) {
+        shared.weights.assign(parameters.begin() + current, parameters.begin() + current + n_weights);
+        shared.count = 1;
+        return;
+    }
+
+    //running average, so the store does not need to keep every published weight
+    shared.count++;
+    for (int32_t j = 0; j < n_weights; j++) {
+        shared.weights[j] += (parameters[current + j] - shared.weights[j]) / shared.count;
+    }
+}
+
+bool SharedWeightStore::get(SharedWeightComponent component, int32_t innovation_number, int32_t n_weights, int32_t current, vector<double> &parameters) const {
+    unique_lock<mutex> lock(store_mutex);
+
+    auto it = component_weights[component].find(innovation_number);
+    if (it == component_weights[component].end() || (int32_t)it->second.weights.size() != n_weights) return false;
+
+    for (int32_t j = 0; j < n_weights; j++) {
+        parameters[current + j] = it->second.weights[j];
+    }
+    return true;
+}
+
+int32_t SharedWeightStore::get_number_updates() const {
+    unique_lock<mutex> lock(store_mutex);
+    return number_updates;
+}
+
+int32_t SharedWeightStore::get_number_components() const {
+    unique_lock<mutex> lock(store_mutex);
+    return (int32_t)(component_weights[SHARED_NODE].size() + component_weights[SHARED_EDGE].size() + component_weights[SHARED_RECURRENT_EDGE].size());
+}
@@ -0,0 +1,93 @@
+#ifndef SHARED_WEIGHT_STORE_HXX
+#define SHARED_WEIGHT_STORE_HXX
+
+#include <cstdint>
+
+#include <map>
+using std::map;
+
+#include <mutex>
+using std::mutex;
+
+#include <string>
+using std::string;
+
+#include <vector>
+using std::vector;
+
+enum SharedWeightPolicy {
+    SHARED_WEIGHTS_RECENT = 0,  /**< keep the weights of the most recently published genome */
+    SHARED_WEIGHTS_AVERAGE = 1  /**< keep the average of all the published weights */
+};
+
+enum SharedWeightComponent {
+    SHARED_NODE = 0,
+    SHARED_EDGE = 1,
+    SHARED_RECURRENT_EDGE = 2
+};
+
+/**
+ * Weights shared across the whole population, keyed by the innovation number of the
+ * node, edge or recurrent edge they belong to. Trained genomes publish their weights to
+ * the store, and new genomes can start from the store's weights for every component it
+ * has seen, instead of only from their parents'. Nodes, edges and recurrent edges have
+ * separate innovation numbers, so each has its own map.
+ *
+ * The store locks itself, so it can be published to and read from by multiple threads.
+ */
+class SharedWeightStore {
+    private:
+        SharedWeightPolicy policy;
+
+        /**
+         * Each entry holds the component's weights, and (for the average policy) how many
+         * times they have been published.
+         */
+        struct SharedWeights {
+            vector<double> weights;
+            int32_t count;
+        };
+
+        map<int32_t, SharedWeights> component_weights[3];
+        int32_t number_updates;
+
+        mutable mutex store_mutex;
+
+    public:
+        SharedWeightStore(SharedWeightPolicy _policy);
+
+        /**
+         * \param policy_name is either "recent" or "average"
+         */
+        static SharedWeightPolicy get_policy_from_string(string policy_name);
+
+        SharedWeightPolicy get_policy() const;
+
+        /**
+         * Publishes the n_weights weights of a component, starting at parameters[current].
+         * If the component's number of weights differs from what was stored, the stored
+         * weights are replaced.
+         */
+        void update(SharedWeightComponent component, int32_t innovation_number, int32_t n_weights, int32_t current, const vector<double> &parameters);
+
+        /**
+         * Copies the stored weights of a component into parameters[current] to
+         * parameters[current + n_weights - 1].
+         *
+         * \return false (leaving parameters unchanged) if there are no stored weights for the
+         *      component or they are a different size
+         */
+        bool get(SharedWeightComponent component, int32_t innovation_number, int32_t n_weights, int32_t current, vector<double> &parameters) const;
+
+        /**
+         * \return the number of times update has been called
+         */
+        int32_t get_number_updates() const;
+
+        /**
+         * \return the number of nodes, edges and recurrent edges with stored weights
+         */
+        int32_t get_number_components() const;
+};
+
+#endif
@@ -1,3 +1,5 @@
+#include <cstdlib>
+
 #include "weights/weight_rules.hxx"
 #include "common/arguments.hxx"
 #include "common/log.hxx"
@@ -6,6 +8,7 @@ WeightRules::WeightRules() {
     weight_initialize = XAVIER;
     weight_inheritance = LAMARCKIAN;
     mutated_components_weight = LAMARCKIAN;
+    inherit_optimizer_state = false;
 }
 
 void WeightRules::generate_weight_initialize_from_arguments(const vector<string> &arguments) {
@@ -24,6 +27,15 @@ void WeightRules::generate_weight_initialize_from_arguments(const vector<string>
     get_argument(arguments, "--mutated_component_weight", false, mutated_component_weight_string);
     mutated_components_weight = get_enum_from_string(mutated_component_weight_string);
     Log::info("Mutated component weight update method is set to %s\n", mutated_component_weight_string.c_str());
+
+    inherit_optimizer_state = argument_exists(arguments, "--inherit_optimizer_state");
+    if (inherit_optimizer_state) {
+        if (weight_inheritance != LAMARCKIAN) {
+            Log::fatal("ERROR: --inherit_optimizer_state requires lamarckian weight inheritance, but weight inheritance is %s\n", weight_inheritance_string.c_str());
+            exit(1);
+        }
+        Log::info("Genomes will inherit their parents' optimizer state\n");
+    }
 }
 
 WeightType WeightRules::get_weight_initialize_method() {
@@ -50,6 +62,14 @@ void WeightRules::set_mutated_components_weight_method(WeightType _mutated_compo
     mutated_components_weight = _mutated_components_weight;
 }
 
+bool WeightRules::get_inherit_optimizer_state() {
+    return inherit_optimizer_state;
+}
+
+void WeightRules::set_inherit_optimizer_state(bool _inherit_optimizer_state) {
+    inherit_optimizer_state = _inherit_optimizer_state;
+}
+
 string WeightRules::get_weight_initialize_method_name() {
     return WEIGHT_TYPES_STRING[weight_initialize];
 }
@@ -65,6 +85,7 @@ WeightRules* WeightRules::copy() {
     weight_rule_copy->set_weight_initialize_method(weight_initialize);
     weight_rule_copy->set_weight_inheritance_method(weight_inheritance);
     weight_rule_copy->set_mutated_components_weight_method(mutated_components_weight);
+    weight_rule_copy->set_inherit_optimizer_state(inherit_optimizer_state);
     
     return weight_rule_copy;
 }
\ No newline at end of file
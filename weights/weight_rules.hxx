@@ -44,6 +44,12 @@ class WeightRules {
         WeightType weight_inheritance;
         WeightType mutated_components_weight;
 
+        /**
+         * If true, genomes keep the optimizer state (e.g., Adam's moments) from their
+         * last training and pass it on to their children along with their weights.
+         */
+        bool inherit_optimizer_state;
+
     public:
         WeightRules();
         void generate_weight_initialize_from_arguments(const vector<string> &arguments);
@@ -58,6 +64,9 @@ class WeightRules {
         void set_weight_initialize_method(WeightType _weight_initialize);
         void set_weight_inheritance_method(WeightType _weight_inheritance);
         void set_mutated_components_weight_method(WeightType _mutated_components_weight);
+
+        bool get_inherit_optimizer_state();
+        void set_inherit_optimizer_state(bool _inherit_optimizer_state);
         WeightRules* copy();
 
 };
@@ -4,6 +4,7 @@
 
 #include "common/arguments.hxx"
 #include "common/log.hxx"
+#include "common/performance_log.hxx"
 
 WeightUpdate::WeightUpdate() {
     // By default use RMSProp weight update
@@ -20,6 +21,8 @@ WeightUpdate::WeightUpdate() {
     low_threshold = 0.05;
     use_high_norm = true;
     use_low_norm = true;
+
+    select_update_kernel();
 }
 
 void WeightUpdate::generate_from_arguments(const vector<string> &arguments) {
@@ -54,6 +57,7 @@ void WeightUpdate::generate_from_arguments(const vector<string> &arguments) {
             Log::info("Adam-bias weight update eps=%f, beta1=%f, beta2=%f\n", epsilon, beta1, beta2);
         }
     } else Log::info("Backprop weight update method not set, using default method %s and default parameters\n", WEIGHT_UPDATE_METHOD_STRING[weight_update_method].c_str());
+    select_update_kernel();
 
     get_argument(arguments, "--learning_rate", false, learning_rate);
     get_argument(arguments, "--high_threshold", false, high_threshold);
@@ -63,105 +67,123 @@ void WeightUpdate::generate_from_arguments(const vector<string> &arguments) {
     Log::info("Use low norm is set to %s, low norm is %f\n", use_low_norm ? "True" : "False", low_threshold);
 }
 
-void WeightUpdate::update_weights(vector<double> &parameters, vector<double> &velocity, vector<double> &prev_velocity, vector<double> &gradient, int32_t epoch, double _learning_rate) {
-    //Log::error("Learning rate before update_weights: %lf",learning_rate);
-    learning_rate = _learning_rate;
-    //Log::error("Learning rate after update_weights: %lf",learning_rate);
+void WeightUpdate::select_update_kernel() {
     if (weight_update_method == VANILLA) {
-        vanilla_weight_update(parameters, velocity, prev_velocity, gradient, epoch);
+        update_kernel = &WeightUpdate::fused_weight_update<VANILLA>;
     } else if (weight_update_method == MOMENTUM) {
-        momentum_weight_update(parameters, velocity, prev_velocity, gradient, epoch);
+        update_kernel = &WeightUpdate::fused_weight_update<MOMENTUM>;
     } else if (weight_update_method == NESTEROV) {
-        nesterov_weight_update(parameters, velocity, prev_velocity, gradient, epoch);
+        update_kernel = &WeightUpdate::fused_weight_update<NESTEROV>;
     } else if (weight_update_method == ADAGRAD) {
-        adagrad_weight_update(parameters, velocity, prev_velocity, gradient, epoch);
+        update_kernel = &WeightUpdate::fused_weight_update<ADAGRAD>;
     } else if (weight_update_method == RMSPROP) {
-        rmsprop_weight_update(parameters, velocity, prev_velocity, gradient, epoch);
+        update_kernel = &WeightUpdate::fused_weight_update<RMSPROP>;
     } else if (weight_update_method == ADAM) {
-        adam_weight_update(parameters, velocity, prev_velocity, gradient, epoch);
+        update_kernel = &WeightUpdate::fused_weight_update<ADAM>;
     } else if (weight_update_method == ADAM_BIAS) {
-        adam_bias_weight_update(parameters, velocity, prev_velocity, gradient, epoch);
+        update_kernel = &WeightUpdate::fused_weight_update<ADAM_BIAS>;
     } else {
         Log::fatal("Unrecognized weight update method's enom number: %d, this should never happen!\n", weight_update_method);
         exit(1);
     }
-
 }
 
-void WeightUpdate::vanilla_weight_update(vector<double> &parameters, vector<double> &velocity, vector<double> &prev_velocity, vector<double> &gradient, int32_t epoch) {
-    Log::trace("Doing weight update with method: %s \n", WEIGHT_UPDATE_METHOD_STRING[weight_update_method].c_str());
-    for (int32_t i = 0; i < (int32_t)parameters.size(); i++) {
-        parameters[i] -= learning_rate * gradient[i];
-        gradient_clip(parameters[i]);
-    }
+static inline double clip_parameter(double parameter) {
+    return parameter < -10.0 ? -10.0 : (parameter > 10.0 ? 10.0 : parameter);
 }
 
-void WeightUpdate::momentum_weight_update(vector<double> &parameters, vector<double> &velocity, vector<double> &prev_velocity, vector<double> &gradient, int32_t epoch) {
-    Log::trace("Doing weight update with method: %s \n", WEIGHT_UPDATE_METHOD_STRING[weight_update_method].c_str());
-    for (int32_t i = 0; i < (int32_t)parameters.size(); i++) {
-        velocity[i] = momentum * velocity[i] - learning_rate * gradient[i];
-        parameters[i] += velocity[i];
-        gradient_clip(parameters[i]);
-    }
-}
+template <WeightUpdateMethod METHOD>
+void WeightUpdate::fused_weight_update(double * __restrict__ parameters, double * __restrict__ velocity, double * __restrict__ prev_velocity, const double * __restrict__ gradient, int32_t n_parameters, double gradient_scale, int32_t epoch) {
+    //copy the hyperparameters into locals so the compiler knows the stores
+    //to the parameter arrays cannot change them, and the loops can be vectorized
+    const double lr = learning_rate;
+    const double mu = momentum;
+    const double eps = epsilon;
+    const double decay = decay_rate;
+    const double b1 = beta1;
+    const double b2 = beta2;
 
-void WeightUpdate::nesterov_weight_update(vector<double> &parameters, vector<double> &velocity, vector<double> &prev_velocity, vector<double> &gradient, int32_t epoch)  {
-    Log::info("Doing weight update with method: %s \n", WEIGHT_UPDATE_METHOD_STRING[weight_update_method].c_str());
-    for (int32_t i = 0; i < (int32_t)parameters.size(); i++) {
-        prev_velocity[i] = velocity[i];
-        velocity[i] = momentum * velocity[i] - learning_rate * gradient[i];
-        parameters[i] += -momentum * prev_velocity[i] + (1 + momentum) * velocity[i];
-        gradient_clip(parameters[i]);
-    }
-}
+    if constexpr (METHOD == VANILLA) {
+        for (int32_t i = 0; i < n_parameters; i++) {
+            parameters[i] = clip_parameter(parameters[i] - lr * gradient_scale * gradient[i]);
+        }
 
-void WeightUpdate::adagrad_weight_update(vector<double> &parameters, vector<double> &velocity, vector<double> &prev_velocity, vector<double> &gradient, int32_t epoch) {
-    Log::trace("Doing weight update with method: %s \n", WEIGHT_UPDATE_METHOD_STRING[weight_update_method].c_str());
-    for (int32_t i = 0; i < (int32_t)parameters.size(); i++) {
-        // here the velocity is the "cache" in Adagrad
-        velocity[i] += gradient[i] * gradient[i];
-        parameters[i] += -learning_rate * gradient[i] / (sqrt(velocity[i]) + epsilon);
-        gradient_clip(parameters[i]);
-    }
-}
+    } else if constexpr (METHOD == MOMENTUM) {
+        for (int32_t i = 0; i < n_parameters; i++) {
+            double v = mu * velocity[i] - lr * gradient_scale * gradient[i];
+            velocity[i] = v;
+            parameters[i] = clip_parameter(parameters[i] + v);
+        }
 
-void WeightUpdate::rmsprop_weight_update(vector<double> &parameters, vector<double> &velocity, vector<double> &prev_velocity, vector<double> &gradient, int32_t epoch) {
-    Log::trace("Doing weight update with method: %s \n", WEIGHT_UPDATE_METHOD_STRING[weight_update_method].c_str());
-    for (int32_t i = 0; i < (int32_t)parameters.size(); i++) {
-        // here the velocity is the "cache" in RMSProp
-        velocity[i] = decay_rate * velocity[i] + (1 - decay_rate) * gradient[i] * gradient[i];
-        parameters[i] += -learning_rate * gradient[i] / (sqrt(velocity[i]) + epsilon);
-        gradient_clip(parameters[i]);
-    }
-}
+    } else if constexpr (METHOD == NESTEROV) {
+        for (int32_t i = 0; i < n_parameters; i++) {
+            double pv = velocity[i];
+            double v = mu * pv - lr * gradient_scale * gradient[i];
+            prev_velocity[i] = pv;
+            velocity[i] = v;
+            parameters[i] = clip_parameter(parameters[i] - mu * pv + (1 + mu) * v);
+        }
+
+    } else if constexpr (METHOD == ADAGRAD) {
+        for (int32_t i = 0; i < n_parameters; i++) {
+            // here the velocity is the "cache" in Adagrad
+            double g = gradient_scale * gradient[i];
+            double cache = velocity[i] + g * g;
+            velocity[i] = cache;
+            parameters[i] = clip_parameter(parameters[i] - lr * g / (sqrt(cache) + eps));
+        }
 
-void WeightUpdate::adam_weight_update(vector<double> &parameters, vector<double> &velocity, vector<double> &prev_velocity, vector<double> &gradient, int32_t epoch) {
-    Log::trace("Doing weight update with method: %s \n", WEIGHT_UPDATE_METHOD_STRING[weight_update_method].c_str());
-    for (int32_t i = 0; i < (int32_t)parameters.size(); i++) {
+    } else if constexpr (METHOD == RMSPROP) {
+        for (int32_t i = 0; i < n_parameters; i++) {
+            // here the velocity is the "cache" in RMSProp
+            double g = gradient_scale * gradient[i];
+            double cache = decay * velocity[i] + (1 - decay) * g * g;
+            velocity[i] = cache;
+            parameters[i] = clip_parameter(parameters[i] - lr * g / (sqrt(cache) + eps));
+        }
+
+    } else if constexpr (METHOD == ADAM || METHOD == ADAM_BIAS) {
         // here the velocity is the "v" in adam, the prev_velocity is "m" in adam
-        prev_velocity[i] = beta1 * prev_velocity[i] + (1 - beta1) * gradient[i];
-        velocity[i] = beta2 * velocity[i] + (1 - beta2) * (gradient[i] * gradient[i]);
-        parameters[i] += -learning_rate * prev_velocity[i] / (sqrt(velocity[i]) + epsilon);
-        gradient_clip(parameters[i]);
+        double m_correction = 1.0;
+        double v_correction = 1.0;
+        if constexpr (METHOD == ADAM_BIAS) {
+            //the bias corrections only depend on the epoch so are calculated once
+            //per update; steps are counted from 1 as the correction is undefined
+            //for the first epoch (0)
+            m_correction = 1.0 / (1.0 - pow(b1, epoch + 1));
+            v_correction = 1.0 / (1.0 - pow(b2, epoch + 1));
+        }
+
+        for (int32_t i = 0; i < n_parameters; i++) {
+            double g = gradient_scale * gradient[i];
+            double m = b1 * prev_velocity[i] + (1 - b1) * g;
+            double v = b2 * velocity[i] + (1 - b2) * (g * g);
+            prev_velocity[i] = m;
+            velocity[i] = v;
+            parameters[i] = clip_parameter(parameters[i] - lr * (m * m_correction) / (sqrt(v * v_correction) + eps));
+        }
     }
 }
 
-void WeightUpdate::adam_bias_weight_update(vector<double> &parameters, vector<double> &velocity, vector<double> &prev_velocity, vector<double> &gradient, int32_t epoch) {
-    Log::trace("Doing weight update with method: %s \n", WEIGHT_UPDATE_METHOD_STRING[weight_update_method].c_str());
-    for (int32_t i = 0; i < (int32_t)parameters.size(); i++) {
-        // here the velocity is the "v" in adam, the prev_velocity is "m" in adam
-        prev_velocity[i] = beta1 * prev_velocity[i] + (1 - beta1) * gradient[i];
-        double mt = prev_velocity[i] / (1 - pow(beta1, epoch));
-        velocity[i] = beta2 * velocity[i] + (1 - beta2) * (gradient[i] * gradient[i]);
-        double vt = velocity[i] / (1 - pow(beta2, epoch));
-        parameters[i] += -learning_rate * mt / (sqrt(vt) + epsilon);
-        gradient_clip(parameters[i]);
-    }
+void WeightUpdate::update_weights(vector<double> &parameters, vector<double> &velocity, vector<double> &prev_velocity, vector<double> &gradient, int32_t epoch, double _learning_rate) {
+    ScopedTimer timer(PerformanceLog::WEIGHT_UPDATE);
+    learning_rate = _learning_rate;
+    (this->*update_kernel)(parameters.data(), velocity.data(), prev_velocity.data(), gradient.data(), (int32_t)parameters.size(), 1.0, epoch);
 }
 
-void WeightUpdate::gradient_clip(double &parameter) {
-    if (parameter < -10.0) parameter = -10.0;
-    else if (parameter > 10.0) parameter = 10.0;
+double WeightUpdate::normalize_and_update_weights(vector<double> &parameters, vector<double> &velocity, vector<double> &prev_velocity, const vector<double> &gradient, int32_t epoch, double _learning_rate) {
+    return normalize_and_update_weights(parameters.data(), velocity, prev_velocity, gradient.data(), (int32_t)parameters.size(), epoch, _learning_rate);
+}
+
+double WeightUpdate::normalize_and_update_weights(double *parameters, vector<double> &velocity, vector<double> &prev_velocity, const double *gradient, int32_t n_parameters, int32_t epoch, double _learning_rate) {
+    ScopedTimer timer(PerformanceLog::WEIGHT_UPDATE);
+    learning_rate = _learning_rate;
+
+    double norm = get_norm(gradient, n_parameters);
+    double gradient_scale = get_gradient_scale(norm);
+    (this->*update_kernel)(parameters, velocity.data(), prev_velocity.data(), gradient, n_parameters, gradient_scale, epoch);
+
+    return norm;
 }
 
 double WeightUpdate::get_learning_rate() {
@@ -198,30 +220,38 @@ void WeightUpdate::enable_low_threshold(double _low_threshold) {
     low_threshold = _low_threshold;
 }
 
-double WeightUpdate::get_norm(vector<double> &analytic_gradient) {
+double WeightUpdate::get_norm(const vector<double> &analytic_gradient) {
+    return get_norm(analytic_gradient.data(), (int32_t)analytic_gradient.size());
+}
+
+double WeightUpdate::get_norm(const double *analytic_gradient, int32_t n_parameters) {
     double norm = 0.0;
-    for (int32_t i = 0; i < (int32_t)analytic_gradient.size(); i++) {
+    for (int32_t i = 0; i < n_parameters; i++) {
         norm += analytic_gradient[i] * analytic_gradient[i];
     }
     norm = sqrt(norm);
     return norm;
 }
 
-void WeightUpdate::norm_gradients(vector<double> &analytic_gradient, double norm) {
+double WeightUpdate::get_gradient_scale(double norm) {
     if (use_high_norm && norm > high_threshold) {
-    double high_threshold_norm = high_threshold / norm;
-    Log::debug_no_header(", OVER THRESHOLD, multiplier: %lf", high_threshold_norm);
-
-    for (int32_t i = 0; i < (int32_t)analytic_gradient.size(); i++) {
-        analytic_gradient[i] = high_threshold_norm * analytic_gradient[i];
-    }
+        double high_threshold_norm = high_threshold / norm;
+        Log::debug_no_header(", OVER THRESHOLD, multiplier: %lf", high_threshold_norm);
+        return high_threshold_norm;
 
     } else if (use_low_norm && norm < low_threshold) {
         double low_threshold_norm = low_threshold / norm;
         Log::debug_no_header(", UNDER THRESHOLD, multiplier: %lf", low_threshold_norm);
+        return low_threshold_norm;
+    }
+    return 1.0;
+}
 
-        for (int32_t i = 0; i < (int32_t)analytic_gradient.size(); i++) {
-            analytic_gradient[i] = low_threshold_norm * analytic_gradient[i];
-        }
+void WeightUpdate::norm_gradients(vector<double> &analytic_gradient, double norm) {
+    double gradient_scale = get_gradient_scale(norm);
+    if (gradient_scale == 1.0) return;
+
+    for (int32_t i = 0; i < (int32_t)analytic_gradient.size(); i++) {
+        analytic_gradient[i] = gradient_scale * analytic_gradient[i];
     }
-}
\ No newline at end of file
+}
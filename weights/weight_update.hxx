@@ -51,21 +51,51 @@ class WeightUpdate {
         bool use_low_norm;
         double low_threshold;
 
+        typedef void (WeightUpdate::*weight_update_kernel)(double *parameters, double *velocity, double *prev_velocity, const double *gradient, int32_t n_parameters, double gradient_scale, int32_t epoch);
+
+        /**
+         * The kernel for weight_update_method, set whenever the method is, so
+         * updates do not need to check which method is being used.
+         */
+        weight_update_kernel update_kernel;
+
+        void select_update_kernel();
+
+        /**
+         * Applies a single fused pass over the parameters: the gradient is scaled by
+         * gradient_scale (for norm clipping), the method's moments are updated and
+         * the new parameters are clipped to [-10, 10].
+         */
+        template <WeightUpdateMethod METHOD>
+        void fused_weight_update(double *parameters, double *velocity, double *prev_velocity, const double *gradient, int32_t n_parameters, double gradient_scale, int32_t epoch);
+
+        /**
+         * \return the multiplier which moves the gradient's norm back within the
+         * high and low thresholds (or 1.0 if it is already within them)
+         */
+        double get_gradient_scale(double norm);
+
     public:
         WeightUpdate();
         void generate_from_arguments(const vector<string> &arguments);
 
         void update_weights(vector<double> &parameters, vector<double> &velocity, vector<double> &prev_velocity, vector<double> &gradient, int32_t epoch, double _learning_rate);
-        
-        void vanilla_weight_update(vector<double> &parameters, vector<double> &velocity, vector<double> &prev_velocity, vector<double> &gradient, int32_t epoch);
-        void momentum_weight_update(vector<double> &parameters, vector<double> &velocity, vector<double> &prev_velocity, vector<double> &gradient, int32_t epoch);
-        void nesterov_weight_update(vector<double> &parameters, vector<double> &velocity, vector<double> &prev_velocity, vector<double> &gradient, int32_t epoch);
-        void adagrad_weight_update(vector<double> &parameters, vector<double> &velocity, vector<double> &prev_velocity, vector<double> &gradient, int32_t epoch);
-        void rmsprop_weight_update(vector<double> &parameters, vector<double> &velocity, vector<double> &prev_velocity, vector<double> &gradient, int32_t epoch);
-        void adam_weight_update(vector<double> &parameters, vector<double> &velocity, vector<double> &prev_velocity, vector<double> &gradient, int32_t epoch);
-        void adam_bias_weight_update(vector<double> &parameters, vector<double> &velocity, vector<double> &prev_velocity, vector<double> &gradient, int32_t epoch);
-        
-        void gradient_clip(double &parameter);
+
+        /**
+         * Does the same as get_norm, norm_gradients and update_weights, but without
+         * modifying the gradient and with only one pass over it after calculating its
+         * norm.
+         *
+         * \return the norm of the gradient (before it was normalized)
+         */
+        double normalize_and_update_weights(vector<double> &parameters, vector<double> &velocity, vector<double> &prev_velocity, const vector<double> &gradient, int32_t epoch, double _learning_rate);
+
+        /**
+         * Does the same as the above, for parameters and a gradient kept outside of a
+         * vector (e.g., the RNN's parameter and gradient buffers), which are updated in
+         * place.
+         */
+        double normalize_and_update_weights(double *parameters, vector<double> &velocity, vector<double> &prev_velocity, const double *gradient, int32_t n_parameters, int32_t epoch, double _learning_rate);
 
         void set_learning_rate(double _learning_rate);
         void disable_high_threshold();
@@ -77,7 +107,8 @@ class WeightUpdate {
         double get_low_threshold();
         double get_high_threshold();
 
-        double get_norm(vector<double> &analytic_gradient);
+        double get_norm(const vector<double> &analytic_gradient);
+        double get_norm(const double *analytic_gradient, int32_t n_parameters);
         void norm_gradients(vector<double> &analytic_gradient, double norm);
 };
 